@@ -23,6 +23,10 @@
 #include <ql/cashflows/cashflows.hpp>
 #include <ql/cashflows/coupon.hpp>
 #include <ql/cashflows/couponpricer.hpp>
+#include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/cashflows/iborcoupon.hpp>
+#include <ql/cashflows/overnightindexedcoupon.hpp>
+#include <ql/cashflows/overnightindexedcouponpricer.hpp>
 #include <ql/math/solvers1d/brent.hpp>
 #include <ql/math/solvers1d/newtonsafe.hpp>
 #include <ql/patterns/visitor.hpp>
@@ -507,6 +511,92 @@ namespace QuantLib {
         return { npv, bps };
     }
 
+    std::vector<std::pair<Date, Real> >
+    CashFlows::npvGradient(const Leg& leg,
+                           const YieldTermStructure& discountCurve,
+                           bool includeSettlementDateFlows,
+                           Date settlementDate,
+                           Date npvDate) {
+        std::vector<std::pair<Date, Real> > gradient;
+
+        if (leg.empty())
+            return gradient;
+
+        if (settlementDate == Date())
+            settlementDate = Settings::instance().evaluationDate();
+
+        if (npvDate == Date())
+            npvDate = settlementDate;
+
+        const DiscountFactor d = discountCurve.discount(npvDate);
+        Real npv = 0.0;
+        for (const auto& i : leg) {
+            CashFlow& cf = *i;
+            if (cf.hasOccurred(settlementDate, includeSettlementDateFlows) ||
+                cf.tradingExCoupon(settlementDate))
+                continue;
+
+            const Real amount = cf.amount();
+            const DiscountFactor df = discountCurve.discount(cf.date());
+            npv += amount * df;
+            gradient.emplace_back(cf.date(), amount / d);
+
+            if (ext::dynamic_pointer_cast<Coupon>(i) == nullptr ||
+                ext::dynamic_pointer_cast<FixedRateCoupon>(i) != nullptr)
+                continue;
+
+            if (auto overnight =
+                    ext::dynamic_pointer_cast<OvernightIndexedCoupon>(i)) {
+                const auto pricer = ext::dynamic_pointer_cast<
+                    CompoundingOvernightIndexedCouponPricer>(overnight->pricer());
+                QL_REQUIRE(pricer != nullptr,
+                           "NPV gradient not available for overnight "
+                           "coupons without compounding");
+                const auto index =
+                    ext::dynamic_pointer_cast<IborIndex>(overnight->index());
+                if (index->forwardingTermStructure().currentLink().get()
+                    != &discountCurve || overnight->gearing() == 0.0)
+                    continue;
+
+                // amount = N*(gearing*(F-1) + spread*T), F being the
+                // compound factor of the fixings
+                const Real T = overnight->accrualPeriod();
+                const Real compoundFactor =
+                    1.0 + (overnight->rate() - overnight->spread()) * T /
+                    overnight->gearing();
+                pricer->initialize(*overnight);
+                pricer->addCompoundFactorGradient(
+                    discountCurve, compoundFactor,
+                    overnight->nominal() * overnight->gearing() * df / d,
+                    gradient);
+                continue;
+            }
+
+            auto coupon = ext::dynamic_pointer_cast<IborCoupon>(i);
+            QL_REQUIRE(coupon != nullptr && !coupon->isInArrears(),
+                       "NPV gradient not available for coupons other than "
+                       "fixed-rate, Ibor ones paid in advance and "
+                       "compounded overnight ones");
+            if (coupon->hasFixed() ||
+                coupon->iborIndex()->forwardingTermStructure().currentLink().get()
+                    != &discountCurve)
+                continue;
+
+            // amount = N*T*(gearing*(P(d1)/P(d2)-1)/t + spread)
+            const Date& d1 = coupon->fixingValueDate();
+            const Date& d2 = coupon->fixingEndDate();
+            const DiscountFactor df1 = discountCurve.discount(d1);
+            const DiscountFactor df2 = discountCurve.discount(d2);
+            const Real w = coupon->nominal() * coupon->accrualPeriod() *
+                coupon->gearing() * df / (coupon->spanningTime() * df2 * d);
+            gradient.emplace_back(d1, w);
+            gradient.emplace_back(d2, -w * df1 / df2);
+        }
+        gradient.emplace_back(npvDate, -npv / (d * d));
+
+        return gradient;
+    }
+
     Rate CashFlows::atmRate(const Leg& leg,
                             const YieldTermStructure& discountCurve,
                             bool includeSettlementDateFlows,
@@ -197,6 +197,22 @@ namespace QuantLib {
                                             Date settlementDate = Date(),
                                             Date npvDate = Date());
 
+        //! Gradient of the NPV with respect to discount factors.
+        /*! The result holds the derivatives of the NPV with respect
+            to the discount factors of the given term structure at the
+            returned dates, which might be repeated.  Ibor coupons
+            and compounded overnight coupons forecast on the same
+            term structure also contribute through their fixings; the
+            amounts of other cash flows are taken as fixed, and other
+            kinds of coupons are not supported.
+        */
+        static std::vector<std::pair<Date, Real> >
+        npvGradient(const Leg& leg,
+                    const YieldTermStructure& discountCurve,
+                    bool includeSettlementDateFlows,
+                    Date settlementDate = Date(),
+                    Date npvDate = Date());
+
         //! At-the-money rate of the cash flows.
         /*! The result is the fixed rate for which a fixed rate cash flow
             vector, equivalent to the input vector, has the required NPV
@@ -176,6 +176,80 @@ namespace QuantLib {
         return coupon_->gearing() * rate + coupon_->spread();
     }
 
+    void CompoundingOvernightIndexedCouponPricer::addCompoundFactorGradient(
+                        const YieldTermStructure& forwardingCurve,
+                        Real compoundFactor,
+                        Real weight,
+                        std::vector<std::pair<Date, Real> >& gradient) const {
+        // The forecast part of the compound factor is split as in
+        // averageRate() into telescopic ratios P(a)/P(b) and single
+        // fixings (1 + span*(P(s)/P(e)-1)/t); the derivative of the
+        // factor with respect to each of them is the factor divided
+        // by it.
+        const Date today = Settings::instance().evaluationDate();
+
+        const ext::shared_ptr<OvernightIndex> index =
+            ext::dynamic_pointer_cast<OvernightIndex>(coupon_->index());
+
+        const Date& date = coupon_->accrualEndDate();
+        const auto& fixingDates = coupon_->fixingDates();
+        const auto& valueDates = coupon_->valueDates();
+        const auto& interestDates = coupon_->interestDates();
+        const auto& dt = coupon_->dt();
+        const Size n = determineNumberOfFixings(interestDates, date,
+                                                coupon_->applyObservationShift());
+
+        const auto isForecast = [&](Size i) {
+            return fixingDates[i] > today ||
+                (fixingDates[i] == today && !index->hasHistoricalFixing(today));
+        };
+        const Real x = weight * compoundFactor;
+
+        const auto addRatio = [&](const Date& a, const Date& b) {
+            if (a == b)
+                return;
+            gradient.emplace_back(a, x / forwardingCurve.discount(a));
+            gradient.emplace_back(b, -x / forwardingCurve.discount(b));
+        };
+        const auto addFixing = [&](Size i) {
+            if (!isForecast(i))
+                return;
+            const Date s = index->valueDate(fixingDates[i]);
+            const Date e = index->maturityDate(s);
+            const Time t = index->dayCounter().yearFraction(s, e);
+            const Time span = (date >= interestDates[i + 1] ?
+                                   dt[i] :
+                                   index->dayCounter().yearFraction(interestDates[i], date));
+            const DiscountFactor ds = forwardingCurve.discount(s);
+            const DiscountFactor de = forwardingCurve.discount(e);
+            const Real w = x * span / (t * de * (1.0 + span * (ds / de - 1.0) / t));
+            gradient.emplace_back(s, w);
+            gradient.emplace_back(e, -w * ds / de);
+        };
+
+        Size i = 0;
+        while (i < n && !isForecast(i))
+            ++i;
+        if (i == n)
+            return;
+
+        if (!coupon_->canApplyTelescopicFormula()) {
+            for (; i < n; ++i)
+                addFixing(i);
+        } else {
+            const Size nLockout = n - coupon_->lockoutDays();
+            const Date& start = valueDates[std::min<Size>(nLockout, i)];
+            if (interestDates[n] == date || coupon_->lockoutDays() > 0) {
+                addRatio(start, valueDates[std::min<Size>(nLockout, n)]);
+                for (i = std::max(nLockout, i); i < n; ++i)
+                    addFixing(i);
+            } else {
+                addRatio(start, valueDates[n - 1]);
+                addFixing(n - 1);
+            }
+        }
+    }
+
     void
     ArithmeticAveragedOvernightIndexedCouponPricer::initialize(const FloatingRateCoupon& coupon) {
         coupon_ = dynamic_cast<const OvernightIndexedCoupon*>(&coupon);
@@ -32,6 +32,8 @@
 #include <ql/cashflows/couponpricer.hpp>
 #include <ql/cashflows/floatingratecoupon.hpp>
 #include <ql/cashflows/overnightindexedcoupon.hpp>
+#include <utility>
+#include <vector>
 
 namespace QuantLib {
 
@@ -49,6 +51,17 @@ namespace QuantLib {
         Rate floorletRate(Rate) const override { QL_FAIL("floorletRate not available"); }
         //@}
         Rate averageRate(const Date& date) const;
+        /*! Adds to the gradient the derivatives of weight times the
+            given compound factor of the fixings up to the accrual
+            end date with respect to the discount factors of the
+            forwarding curve, at the dates they are read by
+            averageRate().  Fixings already known don't contribute.
+        */
+        void addCompoundFactorGradient(
+                          const YieldTermStructure& forwardingCurve,
+                          Real compoundFactor,
+                          Real weight,
+                          std::vector<std::pair<Date, Real> >& gradient) const;
 
       protected:
         const OvernightIndexedCoupon* coupon_ = nullptr;
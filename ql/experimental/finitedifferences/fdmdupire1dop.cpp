@@ -63,4 +63,8 @@ std::vector<SparseMatrix> FdmDupire1dOp::toMatrixDecomp() const {
     return std::vector<SparseMatrix>(1, mapT_.toMatrix());
 }
 
+std::vector<CsrMatrix> FdmDupire1dOp::toCsrMatrixDecomp() const {
+    return std::vector<CsrMatrix>(1, mapT_.toCsrMatrix());
+}
+
 }
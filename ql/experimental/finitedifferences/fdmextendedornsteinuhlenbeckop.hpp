@@ -55,6 +55,7 @@ namespace QuantLib {
         Array preconditioner(const Array& r, Real s) const override;
 
         std::vector<SparseMatrix> toMatrixDecomp() const override;
+        std::vector<CsrMatrix> toCsrMatrixDecomp() const override;
 
       private:
         const ext::shared_ptr<FdmMesher> mesher_;
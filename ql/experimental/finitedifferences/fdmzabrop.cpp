@@ -114,4 +114,12 @@ std::vector<SparseMatrix> FdmZabrOp::toMatrixDecomp() const {
     };
 }
 
+std::vector<CsrMatrix> FdmZabrOp::toCsrMatrixDecomp() const {
+    return {
+        dxMap_.getMap().toCsrMatrix(),
+        dyMap_.getMap().toCsrMatrix(),
+        dxyMap_.toCsrMatrix()
+    };
+}
+
 }
@@ -83,6 +83,7 @@ class FdmZabrOp : public FdmLinearOpComposite {
     Array preconditioner(const Array& r, Real s) const override;
 
     std::vector<SparseMatrix> toMatrixDecomp() const override;
+    std::vector<CsrMatrix> toCsrMatrixDecomp() const override;
 
   private:
     const Array volatilityValues_;
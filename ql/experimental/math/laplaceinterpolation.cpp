@@ -24,7 +24,7 @@
 #include <ql/experimental/math/laplaceinterpolation.hpp>
 #include <ql/math/matrix.hpp>
 #include <ql/math/matrixutilities/bicgstab.hpp>
-#include <ql/math/matrixutilities/sparsematrix.hpp>
+#include <ql/math/matrixutilities/csrmatrix.hpp>
 #include <ql/methods/finitedifferences/meshers/fdm1dmesher.hpp>
 #include <ql/methods/finitedifferences/meshers/fdmmeshercomposite.hpp>
 #include <ql/methods/finitedifferences/meshers/predefined1dmesher.hpp>
@@ -110,12 +110,6 @@ for (auto const& m : map_)
         Array rhs(N, 0.0), guess(N, 0.0);
         Real guessTmp = 0.0;
 
-        struct f_A {
-            const SparseMatrix& g;
-            explicit f_A(const SparseMatrix& g) : g(g) {}
-            Array operator()(const Array& x) const { return prod(g, x); }
-        };
-
         auto rowit = op.begin1();
         Size count = 0;
         std::vector<Real> corner_h(dim.size());
@@ -174,7 +168,8 @@ for (auto const& m : map_)
             ++rowit;
         }
 
-        interpolatedValues_ = BiCGstab(f_A(g), maxIterMultiplier_ * N, relTol_).solve(rhs, guess).x;
+        interpolatedValues_ =
+            BiCGstab(CsrMatrix(g), maxIterMultiplier_ * N, relTol_).solve(rhs, guess).x;
     }
 
     std::vector<Size>
@@ -45,6 +45,14 @@ namespace QuantLib {
         return blackVolatility()->blackVol(t, x, true);
     }
 
+    void ExtendedBlackScholesMertonProcess::evolveBatch(
+                                               Time t0, Size paths, Real* x,
+                                               Time dt, const Real* dw) const {
+        // skip the shortcut of the base class, which uses the exact
+        // solution instead of the chosen scheme
+        StochasticProcess1D::evolveBatch(t0, paths, x, dt, dw);
+    }
+
     Real ExtendedBlackScholesMertonProcess::evolve(Time t0, Real x0,
                                                    Time dt, Real dw) const {
         Real predictor, sigma0, sigma1;
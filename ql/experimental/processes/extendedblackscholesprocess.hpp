@@ -48,6 +48,11 @@ namespace QuantLib {
         Real drift(Time t, Real x) const override;
         Real diffusion(Time t, Real x) const override;
         Real evolve(Time t0, Real x0, Time dt, Real dw) const override;
+        void evolveBatch(Time t0,
+                         Size paths,
+                         Real* x,
+                         Time dt,
+                         const Real* dw) const override;
 
       private:
         const Discretization discretization_;
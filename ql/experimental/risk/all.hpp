@@ -1,6 +1,7 @@
 /* This file is automatically generated; do not edit.     */
 /* Add the files to be included into Makefile.am instead. */
 
+#include <ql/experimental/risk/bucketsensitivities.hpp>
 #include <ql/experimental/risk/creditriskplus.hpp>
 #include <ql/experimental/risk/sensitivityanalysis.hpp>
 
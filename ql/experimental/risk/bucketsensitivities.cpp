@@ -0,0 +1,106 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/experimental/risk/bucketsensitivities.hpp>
+#include <ql/instrument.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/utilities/parallel.hpp>
+#include <algorithm>
+
+namespace QuantLib {
+
+    BucketSensitivities::BucketSensitivities(
+                                const std::function<Scenario()>& factory,
+                                Real shift,
+                                bool centered,
+                                Size threads) {
+        QL_REQUIRE(shift != 0.0, "null shift given");
+        QL_REQUIRE(threads > 0, "at least one thread required");
+
+        // the factory might touch global state (e.g., the observers
+        // of the evaluation date), so the copies are built here
+        std::vector<Scenario> scenarios(1, factory());
+        const Size m = scenarios[0].instruments.size();
+        const Size n = scenarios[0].quotes.size();
+        QL_REQUIRE(m > 0, "no instruments given");
+
+        threads = std::min(threads, std::max<Size>(n, 1));
+        for (Size k=1; k<threads; ++k) {
+            scenarios.push_back(factory());
+            QL_REQUIRE(scenarios[k].instruments.size() == m &&
+                       scenarios[k].quotes.size() == n,
+                       "the factory returned scenarios of different sizes");
+        }
+        for (const auto& scenario : scenarios) {
+            for (const auto& quote : scenario.quotes)
+                QL_REQUIRE(quote != nullptr, "null quote given");
+            for (const auto& instrument : scenario.instruments)
+                QL_REQUIRE(instrument != nullptr, "null instrument given");
+        }
+
+        npv_ = Array(m);
+        delta_ = Matrix(m, n);
+        if (centered)
+            gamma_ = Matrix(m, n);
+
+        const Size blockSize = detail::parallelBlockSize(n, threads);
+
+        detail::runInParallel(threads, [&](Size k) {
+            const Scenario& scenario = scenarios[k];
+            const std::vector<ext::shared_ptr<Instrument> >& instruments =
+                scenario.instruments;
+
+            const auto reprice = [&scenario, &instruments, m](Array& npv) {
+                if (scenario.reset)
+                    scenario.reset();
+                for (Size i=0; i<m; ++i)
+                    npv[i] = instruments[i]->NPV();
+            };
+
+            Array base(m);
+            reprice(base);
+            if (k == 0)
+                npv_ = base;
+
+            Array up(m), down(m);
+            const Size begin = k*blockSize, end = std::min(begin+blockSize, n);
+            for (Size j=begin; j<end; ++j) {
+                const ext::shared_ptr<SimpleQuote>& quote = scenario.quotes[j];
+                const Real value = quote->value();
+
+                quote->setValue(value + shift);
+                reprice(up);
+
+                if (centered) {
+                    quote->setValue(value - shift);
+                    reprice(down);
+                    for (Size i=0; i<m; ++i) {
+                        delta_[i][j] = (up[i] - down[i]) / (2.0 * shift);
+                        gamma_[i][j] =
+                            (up[i] - 2.0 * base[i] + down[i]) / (shift * shift);
+                    }
+                } else {
+                    for (Size i=0; i<m; ++i)
+                        delta_[i][j] = (up[i] - base[i]) / shift;
+                }
+
+                quote->setValue(value);
+            }
+        });
+    }
+
+}
@@ -0,0 +1,89 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file bucketsensitivities.hpp
+    \brief bucketed quote sensitivities computed on several threads
+*/
+
+#ifndef quantlib_bucket_sensitivities_hpp
+#define quantlib_bucket_sensitivities_hpp
+
+#include <ql/math/matrix.hpp>
+#include <ql/shared_ptr.hpp>
+#include <functional>
+#include <vector>
+
+namespace QuantLib {
+
+    class SimpleQuote;
+    class Instrument;
+
+    //! bucketed sensitivities of a portfolio to a set of quotes
+    /*! Each quote is bumped in turn and all instruments are
+        repriced, giving an instruments-by-quotes matrix of first
+        (and, for centered differences, second) derivatives.
+
+        The bumps are split into contiguous blocks, one per thread.
+        Since the observer graph cannot be shared among threads, each
+        thread works on its own copy of the market and portfolio,
+        obtained from the passed factory; the factory is called on
+        the calling thread, once per thread, and must return objects
+        (quotes, curves, indexes, instruments, engines) that are not
+        shared with other copies.  Global settings, such as the
+        evaluation date or the index fixings, must not be changed
+        while the calculation runs.
+
+        Before each repricing, the reset function of the scenario
+        (if any) is called; it should discard any state left by
+        previous calculations, e.g., by calling
+        PiecewiseYieldCurve::reset() so that curves are bootstrapped
+        from scratch rather than from the previous solution.  The
+        results then do not depend on the order of the bumps, and are
+        the same for any number of threads.
+    */
+    class BucketSensitivities {
+      public:
+        //! market and portfolio built by each thread
+        struct Scenario {
+            //! quotes to be bumped
+            std::vector<ext::shared_ptr<SimpleQuote> > quotes;
+            //! portfolio
+            std::vector<ext::shared_ptr<Instrument> > instruments;
+            //! called before each repricing, if given
+            std::function<void()> reset;
+        };
+
+        BucketSensitivities(const std::function<Scenario()>& factory,
+                            Real shift = 0.0001,
+                            bool centered = true,
+                            Size threads = 1);
+
+        //! base NPVs of the instruments
+        const Array& npv() const { return npv_; }
+        //! first derivatives; rows are instruments, columns are quotes
+        const Matrix& delta() const { return delta_; }
+        //! second derivatives; empty for one-sided differences
+        const Matrix& gamma() const { return gamma_; }
+
+      private:
+        Array npv_;
+        Matrix delta_, gamma_;
+    };
+
+}
+
+#endif
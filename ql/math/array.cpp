@@ -0,0 +1,133 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file array.cpp
+    \brief vectorized kernels for Array
+*/
+
+#include <ql/math/array.hpp>
+
+/* On x86-64 ELF platforms, GCC and clang can compile each kernel for
+   several instruction sets and select the best one when the library
+   is loaded; elsewhere, the kernels are compiled for the target
+   architecture and left to the auto-vectorizer.
+
+   Fused multiply-adds are disabled so that every version returns
+   exactly the same results. */
+
+#if defined(__x86_64__) && defined(__ELF__) && defined(__has_attribute)
+#  if __has_attribute(target_clones)
+#    define QL_ARRAY_KERNELS_DISPATCH
+#  endif
+#endif
+
+#if defined(QL_ARRAY_KERNELS_DISPATCH)
+#  define QL_ARRAY_KERNEL \
+    __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#  define QL_ARRAY_KERNEL
+#endif
+
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC push_options
+#  pragma GCC optimize("tree-vectorize", "fp-contract=off")
+#endif
+
+#if defined(__clang__)
+#  define QL_ARRAY_KERNEL_NO_CONTRACT _Pragma("clang fp contract(off)")
+#else
+#  define QL_ARRAY_KERNEL_NO_CONTRACT
+#endif
+
+namespace QuantLib {
+
+    namespace detail {
+
+        QL_ARRAY_KERNEL
+        Real arrayVectorizedDotProduct(const Real* v1, const Real* v2, Size n) {
+            QL_ARRAY_KERNEL_NO_CONTRACT
+            // eight independent partial sums fill a whole AVX-512
+            // register (or two AVX2 and four SSE2 ones) and are added
+            // in a fixed order, so the result doesn't depend on the
+            // instruction set.
+            Real s[8] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+            Size i = 0;
+            for (; i+8 <= n; i+=8) {
+                for (Size j=0; j<8; ++j)
+                    s[j] += v1[i+j]*v2[i+j];
+            }
+            Real result = ((s[0]+s[1]) + (s[2]+s[3]))
+                        + ((s[4]+s[5]) + (s[6]+s[7]));
+            for (; i<n; ++i)
+                result += v1[i]*v2[i];
+            return result;
+        }
+
+        QL_ARRAY_KERNEL
+        void arrayAdd(Real* v1, const Real* v2, Size n) {
+            for (Size i=0; i<n; ++i)
+                v1[i] += v2[i];
+        }
+
+        QL_ARRAY_KERNEL
+        void arraySubtract(Real* v1, const Real* v2, Size n) {
+            for (Size i=0; i<n; ++i)
+                v1[i] -= v2[i];
+        }
+
+        QL_ARRAY_KERNEL
+        void arrayMultiply(Real* v1, const Real* v2, Size n) {
+            for (Size i=0; i<n; ++i)
+                v1[i] *= v2[i];
+        }
+
+        QL_ARRAY_KERNEL
+        void arrayDivide(Real* v1, const Real* v2, Size n) {
+            for (Size i=0; i<n; ++i)
+                v1[i] /= v2[i];
+        }
+
+        QL_ARRAY_KERNEL
+        void arrayScale(Real* v, Real x, Size n) {
+            for (Size i=0; i<n; ++i)
+                v[i] *= x;
+        }
+
+        std::string arrayKernelsInstructionSet() {
+            #if defined(QL_ARRAY_KERNELS_DISPATCH)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f"))
+                return "AVX-512";
+            if (__builtin_cpu_supports("avx2"))
+                return "AVX2";
+            return "SSE2";
+            #else
+            return "generic";
+            #endif
+        }
+
+    }
+
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC pop_options
+#endif
+
+#undef QL_ARRAY_KERNELS_DISPATCH
+#undef QL_ARRAY_KERNEL
+#undef QL_ARRAY_KERNEL_NO_CONTRACT
@@ -28,6 +28,7 @@
 
 #include <ql/types.hpp>
 #include <ql/errors.hpp>
+#include <ql/math/arrayexpression.hpp>
 #include <ql/utilities/null.hpp>
 #include <iterator>
 #include <functional>
@@ -38,9 +39,43 @@
 #include <iomanip>
 #include <memory>
 #include <type_traits>
+#include <string>
+#include <new>
 
 namespace QuantLib {
 
+    namespace detail {
+
+        /* Array storage is aligned on cache-line boundaries, which is
+           also the width of an AVX-512 register; this doesn't apply
+           when Real is not a fundamental type, in which case the
+           storage is allocated and released through new[]/delete[]. */
+        constexpr std::size_t array_alignment = 64;
+
+        struct ArrayStorageDeleter {
+            void operator()(Real* p) const noexcept;
+        };
+
+        typedef std::unique_ptr<Real[], ArrayStorageDeleter> ArrayStorage;
+
+        ArrayStorage allocateArrayStorage(Size n);
+
+        /* vectorized kernels used by Array; see array.cpp.  Below
+           this size, the out-of-line call costs more than it saves
+           and the operators loop inline instead. */
+        constexpr Size array_kernel_min_size = 8;
+
+        Real arrayVectorizedDotProduct(const Real* v1, const Real* v2, Size n);
+        void arrayAdd(Real* v1, const Real* v2, Size n);
+        void arraySubtract(Real* v1, const Real* v2, Size n);
+        void arrayMultiply(Real* v1, const Real* v2, Size n);
+        void arrayDivide(Real* v1, const Real* v2, Size n);
+        void arrayScale(Real* v, Real x, Size n);
+        //! instruction set selected at run time for the kernels above
+        std::string arrayKernelsInstructionSet();
+
+    }
+
     //! 1-D array used in linear algebra.
     /*! This class implements the concept of vector as used in linear
         algebra.
@@ -69,10 +104,20 @@ namespace QuantLib {
         //! creates the array from an iterable sequence
         template <class ForwardIterator>
         Array(ForwardIterator begin, ForwardIterator end);
+        //! evaluates a lazy expression (see arrayexpression.hpp)
+        template <class E>
+        Array(const detail::ArrayExpression<E>&);
         ~Array() = default;
 
         Array& operator=(const Array&);
         Array& operator=(Array&&) noexcept;
+        /*! evaluates a lazy expression in a single loop, reusing the
+            existing storage if the size matches.  The target can also
+            appear in the expression, since each element is read
+            before being written.
+        */
+        template <class E>
+        Array& operator=(const detail::ArrayExpression<E>&);
 
         bool operator==(const Array&) const;
         bool operator!=(const Array&) const;
@@ -142,7 +187,7 @@ namespace QuantLib {
         //@}
 
       private:
-        std::unique_ptr<Real[]> data_;
+        detail::ArrayStorage data_;
         Size n_;
     };
 
@@ -166,12 +211,32 @@ namespace QuantLib {
 
     #endif
 
-    /*! \relates Array */
+    /*! \relates Array
+        The products are summed sequentially, so that results don't
+        change with the platform; see VectorizedDotProduct for a
+        faster version.
+    */
     Real DotProduct(const Array&, const Array&);
 
-    /*! \relates Array */
+    /*! \relates Array
+        Same as DotProduct, but the products are accumulated in eight
+        partial sums that can be vectorized.  The result can differ
+        from the sequential sum returned by DotProduct in the last
+        bits for arrays of eight elements or more; it doesn't depend
+        on the instruction set, though.
+    */
+    Real VectorizedDotProduct(const Array&, const Array&);
+
+    /*! \relates Array
+        Sequential sum, as in DotProduct; see VectorizedNorm2.
+    */
     Real Norm2(const Array&);
 
+    /*! \relates Array
+        Same as Norm2, but based on VectorizedDotProduct.
+    */
+    Real VectorizedNorm2(const Array&);
+
     // unary operators
     /*! \relates Array */
     Array operator+(const Array& v);
@@ -257,7 +322,12 @@ namespace QuantLib {
     Array Sqrt(const Array&);
     /*! \relates Array */
     Array Sqrt(Array&&);
-    /*! \relates Array */
+    /*! \relates Array
+        Log and Exp call std::log and std::exp on each element.
+        Vectorized versions would need polynomial approximations
+        whose results differ from the standard library ones, and
+        are therefore not provided.
+    */
     Array Log(const Array&);
     /*! \relates Array */
     Array Log(Array&&);
@@ -281,28 +351,50 @@ namespace QuantLib {
 
     // inline definitions
 
+    namespace detail {
+
+        inline void ArrayStorageDeleter::operator()(Real* p) const noexcept {
+            if constexpr (std::is_fundamental<Real>::value)
+                ::operator delete[](p, std::align_val_t(array_alignment));
+            else
+                delete[] p;
+        }
+
+        inline ArrayStorage allocateArrayStorage(Size n) {
+            if (n == 0)
+                return ArrayStorage();
+            if constexpr (std::is_fundamental<Real>::value)
+                return ArrayStorage(static_cast<Real*>(
+                    ::operator new[](n * sizeof(Real),
+                                     std::align_val_t(array_alignment))));
+            else
+                return ArrayStorage(new Real[n]);
+        }
+
+    }
+
     inline Array::Array(Size size)
-    : data_(size != 0U ? new Real[size] : (Real*)nullptr), n_(size) {}
+    : data_(detail::allocateArrayStorage(size)), n_(size) {}
 
     inline Array::Array(Size size, Real value)
-    : data_(size != 0U ? new Real[size] : (Real*)nullptr), n_(size) {
+    : data_(detail::allocateArrayStorage(size)), n_(size) {
         std::fill(begin(),end(),value);
     }
 
     inline Array::Array(Size size, Real value, Real increment)
-    : data_(size != 0U ? new Real[size] : (Real*)nullptr), n_(size) {
+    : data_(detail::allocateArrayStorage(size)), n_(size) {
         for (iterator i=begin(); i!=end(); ++i, value+=increment)
             *i = value;
     }
 
     inline Array::Array(const Array& from)
-    : data_(from.n_ != 0U ? new Real[from.n_] : (Real*)nullptr), n_(from.n_) {
+    : data_(detail::allocateArrayStorage(from.n_)), n_(from.n_) {
         if (data_)
             std::copy(from.begin(),from.end(),begin());
     }
 
     inline Array::Array(Array&& from) noexcept
-    : data_((Real*)nullptr), n_(0) {
+    : n_(0) {
         swap(from);
     }
 
@@ -310,7 +402,7 @@ namespace QuantLib {
 
         template <class I>
         inline void _fill_array_(Array& a,
-                                 std::unique_ptr<Real[]>& data_,
+                                 ArrayStorage& data_,
                                  Size& n_,
                                  I begin, I end,
                                  const std::true_type&) {
@@ -320,20 +412,20 @@ namespace QuantLib {
             // Array with a given value, which we do here.
             Size n = begin;
             Real value = end;
-            data_.reset(n ? new Real[n] : (Real*)nullptr);
+            data_ = allocateArrayStorage(n);
             n_ = n;
             std::fill(a.begin(),a.end(),value);
         }
 
         template <class I>
         inline void _fill_array_(Array& a,
-                                 std::unique_ptr<Real[]>& data_,
+                                 ArrayStorage& data_,
                                  Size& n_,
                                  I begin, I end,
                                  const std::false_type&) {
             // true iterators
             Size n = std::distance(begin, end);
-            data_.reset(n ? new Real[n] : (Real*)nullptr);
+            data_ = allocateArrayStorage(n);
             n_ = n;
             #if defined(QL_PATCH_MSVC) && defined(QL_DEBUG)
             if (n_)
@@ -357,9 +449,14 @@ namespace QuantLib {
     }
 
     inline Array& Array::operator=(const Array& from) {
-        // strong guarantee
-        Array temp(from);
-        swap(temp);
+        if (n_ == from.n_) {
+            // reuse the existing storage; copying can't throw
+            std::copy(from.begin(), from.end(), begin());
+        } else {
+            // strong guarantee
+            Array temp(from);
+            swap(temp);
+        }
         return *this;
     }
 
@@ -368,6 +465,23 @@ namespace QuantLib {
         return *this;
     }
 
+    template <class E>
+    inline Array::Array(const detail::ArrayExpression<E>& e)
+    : Array(e.size()) {
+        detail::evaluate(e, begin());
+    }
+
+    template <class E>
+    inline Array& Array::operator=(const detail::ArrayExpression<E>& e) {
+        if (n_ == e.size()) {
+            detail::evaluate(e, begin());
+        } else {
+            Array temp(e);
+            swap(temp);
+        }
+        return *this;
+    }
+
     inline bool Array::operator==(const Array& to) const {
         return (n_ == to.n_) && std::equal(begin(), end(), to.begin());
     }
@@ -380,7 +494,10 @@ namespace QuantLib {
         QL_REQUIRE(n_ == v.n_,
                    "arrays with different sizes (" << n_ << ", "
                    << v.n_ << ") cannot be added");
-        std::transform(begin(),end(),v.begin(),begin(), std::plus<>());
+        if (n_ < detail::array_kernel_min_size)
+            std::transform(begin(),end(),v.begin(),begin(), std::plus<>());
+        else
+            detail::arrayAdd(begin(), v.begin(), n_);
         return *this;
     }
 
@@ -394,7 +511,10 @@ namespace QuantLib {
         QL_REQUIRE(n_ == v.n_,
                    "arrays with different sizes (" << n_ << ", "
                    << v.n_ << ") cannot be subtracted");
-        std::transform(begin(), end(), v.begin(), begin(), std::minus<>());
+        if (n_ < detail::array_kernel_min_size)
+            std::transform(begin(), end(), v.begin(), begin(), std::minus<>());
+        else
+            detail::arraySubtract(begin(), v.begin(), n_);
         return *this;
     }
 
@@ -407,12 +527,18 @@ namespace QuantLib {
         QL_REQUIRE(n_ == v.n_,
                    "arrays with different sizes (" << n_ << ", "
                    << v.n_ << ") cannot be multiplied");
-        std::transform(begin(), end(), v.begin(), begin(), std::multiplies<>());
+        if (n_ < detail::array_kernel_min_size)
+            std::transform(begin(), end(), v.begin(), begin(), std::multiplies<>());
+        else
+            detail::arrayMultiply(begin(), v.begin(), n_);
         return *this;
     }
 
     inline const Array& Array::operator*=(Real x) {
-        std::transform(begin(), end(), begin(), [=](Real y) -> Real { return y * x; });
+        if (n_ < detail::array_kernel_min_size)
+            std::transform(begin(), end(), begin(), [=](Real y) -> Real { return y * x; });
+        else
+            detail::arrayScale(begin(), x, n_);
         return *this;
     }
 
@@ -420,7 +546,10 @@ namespace QuantLib {
         QL_REQUIRE(n_ == v.n_,
                    "arrays with different sizes (" << n_ << ", "
                    << v.n_ << ") cannot be divided");
-        std::transform(begin(), end(), v.begin(), begin(), std::divides<>());
+        if (n_ < detail::array_kernel_min_size)
+            std::transform(begin(), end(), v.begin(), begin(), std::divides<>());
+        else
+            detail::arrayDivide(begin(), v.begin(), n_);
         return *this;
     }
 
@@ -548,6 +677,10 @@ namespace QuantLib {
         std::swap(n_, from.n_);
     }
 
+    inline detail::ArrayReference lazy(const Array& v) {
+        return detail::ArrayReference(v.begin(), v.size(), 1);
+    }
+
     // dot product and norm
 
     inline Real DotProduct(const Array& v1, const Array& v2) {
@@ -557,10 +690,22 @@ namespace QuantLib {
         return std::inner_product(v1.begin(),v1.end(),v2.begin(),Real(0.0));
     }
 
+    inline Real VectorizedDotProduct(const Array& v1, const Array& v2) {
+        QL_REQUIRE(v1.size() == v2.size(),
+                   "arrays with different sizes (" << v1.size() << ", "
+                   << v2.size() << ") cannot be multiplied");
+        return detail::arrayVectorizedDotProduct(v1.begin(), v2.begin(),
+                                                 v1.size());
+    }
+
     inline Real Norm2(const Array& v) {
         return std::sqrt(DotProduct(v, v));
     }
 
+    inline Real VectorizedNorm2(const Array& v) {
+        return std::sqrt(VectorizedDotProduct(v, v));
+    }
+
     // overloaded operators
 
     // unary
@@ -0,0 +1,221 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file arrayexpression.hpp
+    \brief lazy element-wise expressions on arrays and matrices
+*/
+
+#ifndef quantlib_array_expression_hpp
+#define quantlib_array_expression_hpp
+
+#include <ql/errors.hpp>
+#include <functional>
+#include <type_traits>
+
+namespace QuantLib {
+
+    class Array;
+    class Matrix;
+
+    namespace detail {
+
+        //! base class for lazily-evaluated element-wise expressions
+        /*! Expressions are built by the <tt>lazy()</tt> functions and
+            by the operators below; no element is computed until the
+            expression is assigned to an Array or a Matrix, at which
+            point the whole chain is evaluated in a single loop.
+            All operations are element-wise; in particular, the product
+            of two lazy matrices is <b>not</b> the matrix product.
+
+            Leaves hold references to their operands, so expressions
+            must be evaluated within the full-expression that creates
+            them and should never be stored (e.g., with <tt>auto</tt>).
+        */
+        template <class E>
+        class ArrayExpression {
+          public:
+            const E& derived() const { return static_cast<const E&>(*this); }
+            Real operator[](Size i) const { return derived()[i]; }
+            Size size() const { return derived().rows() * derived().columns(); }
+            Size rows() const { return derived().rows(); }
+            Size columns() const { return derived().columns(); }
+        };
+
+        //! leaf wrapping the contiguous storage of an Array or a Matrix
+        class ArrayReference : public ArrayExpression<ArrayReference> {
+          public:
+            ArrayReference(const Real* data, Size rows, Size columns)
+            : data_(data), rows_(rows), columns_(columns) {}
+            Real operator[](Size i) const { return data_[i]; }
+            Size rows() const { return rows_; }
+            Size columns() const { return columns_; }
+          private:
+            const Real* data_;
+            Size rows_, columns_;
+        };
+
+        template <class L, class R, class Op>
+        class BinaryArrayExpression
+            : public ArrayExpression<BinaryArrayExpression<L, R, Op> > {
+          public:
+            BinaryArrayExpression(const L& l, const R& r) : l_(l), r_(r) {
+                QL_REQUIRE(l.rows() == r.rows() && l.columns() == r.columns(),
+                           "operands with different sizes ("
+                           << l.rows() << "x" << l.columns() << ", "
+                           << r.rows() << "x" << r.columns()
+                           << ") cannot be combined");
+            }
+            Real operator[](Size i) const { return Op()(l_[i], r_[i]); }
+            Size rows() const { return l_.rows(); }
+            Size columns() const { return l_.columns(); }
+          private:
+            L l_;
+            R r_;
+        };
+
+        template <class E, class Op>
+        class ScalarRightArrayExpression
+            : public ArrayExpression<ScalarRightArrayExpression<E, Op> > {
+          public:
+            ScalarRightArrayExpression(const E& e, Real x) : e_(e), x_(x) {}
+            Real operator[](Size i) const { return Op()(e_[i], x_); }
+            Size rows() const { return e_.rows(); }
+            Size columns() const { return e_.columns(); }
+          private:
+            E e_;
+            Real x_;
+        };
+
+        template <class E, class Op>
+        class ScalarLeftArrayExpression
+            : public ArrayExpression<ScalarLeftArrayExpression<E, Op> > {
+          public:
+            ScalarLeftArrayExpression(Real x, const E& e) : x_(x), e_(e) {}
+            Real operator[](Size i) const { return Op()(x_, e_[i]); }
+            Size rows() const { return e_.rows(); }
+            Size columns() const { return e_.columns(); }
+          private:
+            Real x_;
+            E e_;
+        };
+
+        template <class E>
+        class NegatedArrayExpression
+            : public ArrayExpression<NegatedArrayExpression<E> > {
+          public:
+            explicit NegatedArrayExpression(const E& e) : e_(e) {}
+            Real operator[](Size i) const { return -e_[i]; }
+            Size rows() const { return e_.rows(); }
+            Size columns() const { return e_.columns(); }
+          private:
+            E e_;
+        };
+
+    }
+
+    /*! \relates Array
+        returns a lazy view of the array, to be combined with other
+        arrays, matrices or scalars through the usual operators.
+        For instance,
+        \code
+        y = lazy(x)*a + b*z - w;
+        \endcode
+        computes the result in a single loop without temporaries.
+    */
+    detail::ArrayReference lazy(const Array&);
+
+    /*! \relates Matrix
+        returns a lazy view of the matrix; see lazy(const Array&).
+    */
+    detail::ArrayReference lazy(const Matrix&);
+
+    namespace detail {
+
+        /* Operators are only defined when at least one operand is an
+           expression; plain Array and Matrix arithmetic keeps using
+           the eager operators declared in array.hpp and matrix.hpp. */
+
+        template <class T>
+        using enable_if_array_or_matrix =
+            typename std::enable_if<
+                std::is_same<typename std::decay<T>::type, Array>::value ||
+                std::is_same<typename std::decay<T>::type, Matrix>::value>::type;
+
+        #define QL_ARRAY_EXPRESSION_OPERATOR(OP, FUNCTOR)                     \
+        template <class L, class R>                                           \
+        inline BinaryArrayExpression<L, R, FUNCTOR>                           \
+        operator OP(const ArrayExpression<L>& l,                              \
+                    const ArrayExpression<R>& r) {                            \
+            return BinaryArrayExpression<L, R, FUNCTOR>(l.derived(),          \
+                                                        r.derived());         \
+        }                                                                     \
+        template <class L, class T, class = enable_if_array_or_matrix<T> >    \
+        inline BinaryArrayExpression<L, ArrayReference, FUNCTOR>              \
+        operator OP(const ArrayExpression<L>& l, T&& r) {                     \
+            return BinaryArrayExpression<L, ArrayReference, FUNCTOR>(         \
+                l.derived(), lazy(r));                                        \
+        }                                                                     \
+        template <class T, class R, class = enable_if_array_or_matrix<T> >    \
+        inline BinaryArrayExpression<ArrayReference, R, FUNCTOR>              \
+        operator OP(T&& l, const ArrayExpression<R>& r) {                     \
+            return BinaryArrayExpression<ArrayReference, R, FUNCTOR>(         \
+                lazy(l), r.derived());                                        \
+        }                                                                     \
+        template <class E>                                                    \
+        inline ScalarRightArrayExpression<E, FUNCTOR>                         \
+        operator OP(const ArrayExpression<E>& e, Real x) {                    \
+            return ScalarRightArrayExpression<E, FUNCTOR>(e.derived(), x);    \
+        }                                                                     \
+        template <class E>                                                    \
+        inline ScalarLeftArrayExpression<E, FUNCTOR>                          \
+        operator OP(Real x, const ArrayExpression<E>& e) {                    \
+            return ScalarLeftArrayExpression<E, FUNCTOR>(x, e.derived());     \
+        }
+
+        QL_ARRAY_EXPRESSION_OPERATOR(+, std::plus<Real>)
+        QL_ARRAY_EXPRESSION_OPERATOR(-, std::minus<Real>)
+        QL_ARRAY_EXPRESSION_OPERATOR(*, std::multiplies<Real>)
+        QL_ARRAY_EXPRESSION_OPERATOR(/, std::divides<Real>)
+
+        #undef QL_ARRAY_EXPRESSION_OPERATOR
+
+        template <class E>
+        inline NegatedArrayExpression<E>
+        operator-(const ArrayExpression<E>& e) {
+            return NegatedArrayExpression<E>(e.derived());
+        }
+
+        template <class E>
+        inline const ArrayExpression<E>&
+        operator+(const ArrayExpression<E>& e) {
+            return e;
+        }
+
+        //! evaluates the expression into the given storage
+        template <class E, class I>
+        inline void evaluate(const ArrayExpression<E>& e, I out) {
+            const E& expr = e.derived();
+            const Size n = expr.size();
+            for (Size i=0; i<n; ++i)
+                out[i] = expr[i];
+        }
+
+    }
+
+}
+
+#endif
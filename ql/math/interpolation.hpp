@@ -29,8 +29,9 @@
 #include <ql/math/interpolations/extrapolation.hpp>
 #include <ql/math/comparison.hpp>
 #include <ql/errors.hpp>
-#include <vector>
 #include <algorithm>
+#include <atomic>
+#include <vector>
 
 namespace QuantLib {
 
@@ -65,6 +66,12 @@ namespace QuantLib {
             virtual std::vector<Real> yValues() const = 0;
             virtual bool isInRange(Real) const = 0;
             virtual Real value(Real) const = 0;
+            /*! value at x, with the segment of the previous point
+                passed by the caller; by default it is ignored.
+            */
+            virtual Real valueFrom(Real x, Size& /*segment*/) const {
+                return value(x);
+            }
             virtual Real primitive(Real) const = 0;
             virtual Real derivative(Real) const = 0;
             virtual Real secondDerivative(Real) const = 0;
@@ -82,6 +89,18 @@ namespace QuantLib {
                            "not enough points to interpolate: at least " <<
                            requiredPoints <<
                            " required, " << static_cast<int>(xEnd_-xBegin_)<< " provided");
+                // equally-spaced nodes can be located directly; the
+                // guess is checked, so later changes in the data are
+                // harmless
+                const Size n = xEnd_-xBegin_;
+                if (n >= 2) {
+                    const Real spacing = (*(xEnd_-1) - *xBegin_) / (n-1);
+                    bool uniform = spacing > 0.0;
+                    for (Size i=1; i<n-1 && uniform; ++i)
+                        uniform = close_enough(xBegin_[i], *xBegin_ + i*spacing);
+                    if (uniform)
+                        inverseSpacing_ = 1.0 / spacing;
+                }
             }
             Real xMin() const override { return *xBegin_; }
             Real xMax() const override { return *(xEnd_ - 1); }
@@ -98,21 +117,108 @@ namespace QuantLib {
                 return (x >= x1 && x <= x2) || close(x,x1) || close(x,x2);
             }
 
+            Real valueFrom(Real x, Size& segment) const override {
+                // lookups made by value(x) on this thread start from
+                // the caller's segment and update it
+                const Cursor* previous = cursor_;
+                const Cursor cursor = {this, &segment};
+                cursor_ = &cursor;
+                try {
+                    const Real y = value(x);
+                    cursor_ = previous;
+                    return y;
+                } catch (...) {
+                    cursor_ = previous;
+                    throw;
+                }
+            }
+
           protected:
+            /*! Returns the index of the segment containing x.  The
+                last located segment is remembered, so that queries
+                with close or increasing x are located in constant
+                time, as are queries on equally-spaced nodes; other
+                queries fall back to a binary search.
+
+                The last segment is shared by all callers; since any
+                stored value is a valid guess that is checked before
+                use, it is accessed with relaxed atomic operations
+                and only written when it changes.  During a call to
+                Interpolation::values(), the segment is instead kept
+                by the caller.
+            */
             Size locate(Real x) const {
                 #if defined(QL_EXTRA_SAFETY_CHECKS)
                 for (I1 i=xBegin_, j=xBegin_+1; j!=xEnd_; ++i, ++j)
                     QL_REQUIRE(*j > *i, "unsorted x values");
                 #endif
+                const Size last = xEnd_-xBegin_-2;
                 if (x < *xBegin_)
                     return 0;
                 else if (x > *(xEnd_-1))
-                    return xEnd_-xBegin_-2;
-                else
-                    return std::upper_bound(xBegin_,xEnd_-1,x)-xBegin_-1;
+                    return last;
+
+                // a NaN passes the range checks above and would make
+                // the conversion below undefined
+                const Real u = (x - *xBegin_) * inverseSpacing_;
+                if (inverseSpacing_ != 0.0 && u >= 0.0 && u < Real(last+1)) {
+                    Size i = static_cast<Size>(u);
+                    // rounding might move x to a neighbouring segment
+                    if (i > 0 && x < xBegin_[i])
+                        --i;
+                    else if (i < last && x >= xBegin_[i+1])
+                        ++i;
+                    if (contains(i, x))
+                        return remember(i);
+                }
+
+                // look around the last segment...
+                Size i = std::min(hint(), last);
+                if (x >= xBegin_[i]) {
+                    // the scan stops at the last segment at the latest,
+                    // since the latter contains any x >= xMax
+                    for (Size k=0; k<4; ++k, ++i) {
+                        if (contains(i, x))
+                            return remember(i);
+                    }
+                    // ...and then search the rest of the nodes
+                    i = std::upper_bound(xBegin_+i, xEnd_-1, x)-xBegin_-1;
+                } else if (x < xBegin_[i]) {
+                    i = std::upper_bound(xBegin_, xBegin_+i, x)-xBegin_-1;
+                } else {
+                    // NaN; same result as a search on all the nodes
+                    return last;
+                }
+                return remember(i);
             }
             I1 xBegin_, xEnd_;
             I2 yBegin_;
+
+          private:
+            // whether x is in the i-th segment as returned by locate
+            bool contains(Size i, Real x) const {
+                return xBegin_[i] <= x &&
+                    (x < xBegin_[i+1] || i == Size(xEnd_-xBegin_-2));
+            }
+            Size hint() const {
+                if (cursor_ != nullptr && cursor_->owner == this)
+                    return *(cursor_->segment);
+                return hint_.load(std::memory_order_relaxed);
+            }
+            Size remember(Size i) const {
+                if (cursor_ != nullptr && cursor_->owner == this)
+                    *(cursor_->segment) = i;
+                else if (hint_.load(std::memory_order_relaxed) != i)
+                    hint_.store(i, std::memory_order_relaxed);
+                return i;
+            }
+            struct Cursor {
+                const templateImpl* owner;
+                Size* segment;
+            };
+            static thread_local const Cursor* cursor_;
+            Real inverseSpacing_ = 0.0;
+            mutable std::atomic<Size> hint_{0};
         };
 
         Interpolation() = default;
@@ -122,6 +228,21 @@ namespace QuantLib {
             checkRange(x,allowExtrapolation);
             return impl_->value(x);
         }
+        //! interpolated values at a range of points
+        /*! Sorted points are located in a single pass over the
+            nodes, since each lookup starts from the segment of the
+            previous point; the segment is kept locally and is not
+            shared with other callers.
+        */
+        template <class I, class O>
+        void values(I xBegin, I xEnd, O out,
+                    bool allowExtrapolation = false) const {
+            Size segment = 0;
+            for (; xBegin != xEnd; ++xBegin, ++out) {
+                checkRange(*xBegin, allowExtrapolation);
+                *out = impl_->valueFrom(*xBegin, segment);
+            }
+        }
         Real primitive(Real x, bool allowExtrapolation = false) const {
             checkRange(x,allowExtrapolation);
             return impl_->primitive(x);
@@ -156,6 +277,10 @@ namespace QuantLib {
         }
     };
 
+    template <class I1, class I2>
+    thread_local const typename Interpolation::templateImpl<I1,I2>::Cursor*
+    Interpolation::templateImpl<I1,I2>::cursor_ = nullptr;
+
 }
 
 #endif
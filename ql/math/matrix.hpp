@@ -58,10 +58,18 @@ namespace QuantLib {
         Matrix(const Matrix&);
         Matrix(Matrix&&) noexcept;
         Matrix(std::initializer_list<std::initializer_list<Real>>);
+        //! evaluates a lazy element-wise expression (see arrayexpression.hpp)
+        template <class E>
+        Matrix(const detail::ArrayExpression<E>&);
         ~Matrix() = default;
 
         Matrix& operator=(const Matrix&);
         Matrix& operator=(Matrix&&) noexcept;
+        /*! evaluates a lazy element-wise expression in a single loop,
+            reusing the existing storage if the dimensions match.
+        */
+        template <class E>
+        Matrix& operator=(const detail::ArrayExpression<E>&);
 
         bool operator==(const Matrix&) const;
         bool operator!=(const Matrix&) const;
@@ -268,9 +276,14 @@ namespace QuantLib {
     }
 
     inline Matrix& Matrix::operator=(const Matrix& from) {
-        // strong guarantee
-        Matrix temp(from);
-        swap(temp);
+        if (rows_ == from.rows_ && columns_ == from.columns_) {
+            // reuse the existing storage; copying can't throw
+            std::copy(from.begin(), from.end(), begin());
+        } else {
+            // strong guarantee
+            Matrix temp(from);
+            swap(temp);
+        }
         return *this;
     }
 
@@ -279,6 +292,23 @@ namespace QuantLib {
         return *this;
     }
 
+    template <class E>
+    inline Matrix::Matrix(const detail::ArrayExpression<E>& e)
+    : Matrix(e.rows(), e.columns()) {
+        detail::evaluate(e, begin());
+    }
+
+    template <class E>
+    inline Matrix& Matrix::operator=(const detail::ArrayExpression<E>& e) {
+        if (rows_ == e.rows() && columns_ == e.columns()) {
+            detail::evaluate(e, begin());
+        } else {
+            Matrix temp(e);
+            swap(temp);
+        }
+        return *this;
+    }
+
     inline bool Matrix::operator==(const Matrix& to) const {
         return rows_ == to.rows_ && columns_ == to.columns_ &&
                std::equal(begin(), end(), to.begin());
@@ -521,6 +551,10 @@ namespace QuantLib {
         return rows_ == 0 || columns_ == 0;
     }
 
+    inline detail::ArrayReference lazy(const Matrix& m) {
+        return detail::ArrayReference(m.begin(), m.rows(), m.columns());
+    }
+
     inline Matrix operator+(const Matrix& m1, const Matrix& m2) {
         QL_REQUIRE(m1.rows() == m2.rows() &&
                    m1.columns() == m2.columns(),
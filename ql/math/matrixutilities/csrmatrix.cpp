@@ -0,0 +1,224 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/math/matrixutilities/csrmatrix.hpp>
+#include <ql/utilities/parallel.hpp>
+#include <algorithm>
+
+namespace QuantLib {
+
+    CsrMatrix::CsrMatrix(Size rows,
+                         Size columns,
+                         std::vector<Size> rowOffsets,
+                         std::vector<Size> columnIndices,
+                         std::vector<Real> values)
+    : rows_(rows), columns_(columns), rowOffsets_(std::move(rowOffsets)),
+      columnIndices_(std::move(columnIndices)), values_(std::move(values)) {
+        QL_REQUIRE(rowOffsets_.size() == rows_+1,
+                   "wrong number of row offsets (" << rowOffsets_.size()
+                   << ", " << rows_+1 << " required)");
+        QL_REQUIRE(rowOffsets_.front() == 0
+                   && rowOffsets_.back() == values_.size(),
+                   "row offsets don't match the number of elements");
+        QL_REQUIRE(columnIndices_.size() == values_.size(),
+                   "column indices and values have different sizes");
+        for (Size i=0; i < rows_; ++i) {
+            QL_REQUIRE(rowOffsets_[i] <= rowOffsets_[i+1],
+                       "decreasing row offsets");
+            for (Size k=rowOffsets_[i]; k < rowOffsets_[i+1]; ++k) {
+                QL_REQUIRE(columnIndices_[k] < columns_,
+                           "column index out of range");
+                QL_REQUIRE(k == rowOffsets_[i]
+                           || columnIndices_[k-1] < columnIndices_[k],
+                           "column indices not increasing in row " << i);
+            }
+        }
+    }
+
+    CsrMatrix::CsrMatrix(const SparseMatrix& m)
+    : rows_(m.size1()), columns_(m.size2()), rowOffsets_(m.size1()+1, 0) {
+        columnIndices_.reserve(m.nnz());
+        values_.reserve(m.nnz());
+        for (auto i1 = m.begin1(); i1 != m.end1(); ++i1) {
+            for (auto i2 = i1.begin(); i2 != i1.end(); ++i2) {
+                columnIndices_.push_back(i2.index2());
+                values_.push_back(*i2);
+            }
+            rowOffsets_[i1.index1()+1] = values_.size();
+        }
+        // rows without elements might have been skipped
+        for (Size i=0; i < rows_; ++i)
+            rowOffsets_[i+1] = std::max(rowOffsets_[i+1], rowOffsets_[i]);
+    }
+
+    Real CsrMatrix::operator()(Size i, Size j) const {
+        QL_REQUIRE(i < rows_ && j < columns_,
+                   "element (" << i << ", " << j << ") out of range");
+        const auto begin = columnIndices_.begin() + rowOffsets_[i];
+        const auto end = columnIndices_.begin() + rowOffsets_[i+1];
+        const auto iter = std::lower_bound(begin, end, j);
+        return (iter != end && *iter == j)
+            ? values_[iter - columnIndices_.begin()] : 0.0;
+    }
+
+    void CsrMatrix::multiply(const Array& x, Array& y, Size threads) const {
+        QL_REQUIRE(x.size() == columns_,
+                   "vectors and sparse matrices with different sizes ("
+                   << x.size() << ", " << rows_ << "x" << columns_ <<
+                   ") cannot be multiplied");
+        QL_REQUIRE(&x != &y, "input and output arrays must differ");
+        if (y.size() != rows_)
+            y = Array(rows_);
+
+        const Size* offsets = rowOffsets_.data();
+        const Size* indices = columnIndices_.data();
+        const Real* values = values_.data();
+
+        const Size blockSize = detail::parallelBlockSize(rows_, threads);
+        const Size tasks = (blockSize > 0) ? (rows_+blockSize-1)/blockSize : 0;
+        detail::runInParallel(tasks, [&](Size task) {
+            const Size to = std::min(rows_, (task+1)*blockSize);
+            for (Size i=task*blockSize; i < to; ++i) {
+                Real t = 0.0;
+                for (Size k=offsets[i]; k < offsets[i+1]; ++k)
+                    t += values[k]*x[indices[k]];
+                y[i] = t;
+            }
+        });
+    }
+
+    SparseMatrix CsrMatrix::toSparseMatrix() const {
+        SparseMatrix m(rows_, columns_, values_.size());
+        for (Size i=0; i < rows_; ++i)
+            for (Size k=rowOffsets_[i]; k < rowOffsets_[i+1]; ++k)
+                m.push_back(i, columnIndices_[k], values_[k]);
+        return m;
+    }
+
+    CsrMatrix operator+(const CsrMatrix& a, const CsrMatrix& b) {
+        QL_REQUIRE(a.rows() == b.rows() && a.columns() == b.columns(),
+                   "sparse matrices with different sizes ("
+                   << a.rows() << "x" << a.columns() << ", "
+                   << b.rows() << "x" << b.columns()
+                   << ") cannot be added");
+
+        const std::vector<Size>& aOffsets = a.rowOffsets();
+        const std::vector<Size>& aIndices = a.columnIndices();
+        const std::vector<Real>& aValues = a.values();
+        const std::vector<Size>& bOffsets = b.rowOffsets();
+        const std::vector<Size>& bIndices = b.columnIndices();
+        const std::vector<Real>& bValues = b.values();
+
+        std::vector<Size> offsets(a.rows()+1, 0), indices;
+        std::vector<Real> values;
+        indices.reserve(a.nonZeros() + b.nonZeros());
+        values.reserve(a.nonZeros() + b.nonZeros());
+
+        for (Size i=0; i < a.rows(); ++i) {
+            Size k = aOffsets[i], l = bOffsets[i];
+            while (k < aOffsets[i+1] || l < bOffsets[i+1]) {
+                if (l == bOffsets[i+1]
+                    || (k < aOffsets[i+1] && aIndices[k] < bIndices[l])) {
+                    indices.push_back(aIndices[k]);
+                    values.push_back(aValues[k++]);
+                }
+                else if (k == aOffsets[i+1] || bIndices[l] < aIndices[k]) {
+                    indices.push_back(bIndices[l]);
+                    values.push_back(bValues[l++]);
+                }
+                else {
+                    indices.push_back(aIndices[k]);
+                    values.push_back(aValues[k++] + bValues[l++]);
+                }
+            }
+            offsets[i+1] = values.size();
+        }
+
+        return {a.rows(), a.columns(),
+                std::move(offsets), std::move(indices), std::move(values)};
+    }
+
+    CsrMatrix sum(const std::vector<CsrMatrix>& terms) {
+        QL_REQUIRE(!terms.empty(), "no matrices to add");
+        const Size rows = terms.front().rows();
+        const Size columns = terms.front().columns();
+
+        Size nonZeros = 0, rowLength = 0;
+        for (const auto& m : terms) {
+            QL_REQUIRE(m.rows() == rows && m.columns() == columns,
+                       "sparse matrices with different sizes ("
+                       << rows << "x" << columns << ", "
+                       << m.rows() << "x" << m.columns()
+                       << ") cannot be added");
+            nonZeros += m.nonZeros();
+            const std::vector<Size>& offsets = m.rowOffsets();
+            for (Size i=0; i < rows; ++i)
+                rowLength = std::max(rowLength, offsets[i+1] - offsets[i]);
+        }
+
+        std::vector<Size> offsets(rows+1, 0), indices;
+        std::vector<Real> values;
+        indices.reserve(nonZeros);
+        values.reserve(nonZeros);
+
+        std::vector<std::pair<Size, Real> > row(terms.size()*rowLength);
+        for (Size i=0; i < rows; ++i) {
+            auto end = row.begin();
+            for (const auto& m : terms) {
+                const std::vector<Size>& mIndices = m.columnIndices();
+                const std::vector<Real>& mValues = m.values();
+                for (Size k=m.rowOffsets()[i]; k < m.rowOffsets()[i+1]; ++k)
+                    *end++ = {mIndices[k], mValues[k]};
+            }
+            detail::appendCsrRow(row.data(), row.data() + (end - row.begin()),
+                                 indices, values);
+            offsets[i+1] = values.size();
+        }
+
+        return {rows, columns,
+                std::move(offsets), std::move(indices), std::move(values)};
+    }
+
+    namespace detail {
+
+        void appendCsrRow(std::pair<Size, Real>* begin,
+                          std::pair<Size, Real>* end,
+                          std::vector<Size>& columnIndices,
+                          std::vector<Real>& values) {
+            // rows are short, and insertion sort keeps the given
+            // order of entries in the same column
+            for (auto i = begin; i != end; ++i) {
+                const std::pair<Size, Real> entry = *i;
+                auto j = i;
+                for (; j != begin && (j-1)->first > entry.first; --j)
+                    *j = *(j-1);
+                *j = entry;
+            }
+
+            for (auto i = begin; i != end; ++i) {
+                if (i != begin && (i-1)->first == i->first) {
+                    values.back() += i->second;
+                } else {
+                    columnIndices.push_back(i->first);
+                    values.push_back(i->second);
+                }
+            }
+        }
+
+    }
+
+}
@@ -0,0 +1,126 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file csrmatrix.hpp
+    \brief sparse matrix in compressed-sparse-row format
+*/
+
+#ifndef quantlib_csr_matrix_hpp
+#define quantlib_csr_matrix_hpp
+
+#include <ql/math/matrixutilities/sparsematrix.hpp>
+#include <utility>
+#include <vector>
+
+namespace QuantLib {
+
+    //! sparse matrix in compressed-sparse-row format
+    /*! The elements of each row are stored contiguously, sorted by
+        column; the elements of the i-th row are the ones between
+        positions rowOffsets()[i] and rowOffsets()[i+1].
+
+        Unlike SparseMatrix, the structure of the matrix is fixed at
+        construction, which makes it fast to assemble from operators
+        and to multiply by vectors.  The matrix can be passed directly
+        as the matrix-vector product to iterative solvers such as
+        BiCGstab and GMRES, and can be decomposed by
+        SparseILUPreconditioner.
+
+        \ingroup matrices
+    */
+    class CsrMatrix {
+      public:
+        CsrMatrix() = default;
+        CsrMatrix(Size rows,
+                  Size columns,
+                  std::vector<Size> rowOffsets,
+                  std::vector<Size> columnIndices,
+                  std::vector<Real> values);
+        explicit CsrMatrix(const SparseMatrix& m);
+
+        //! \name inspectors
+        //@{
+        Size rows() const { return rows_; }
+        Size columns() const { return columns_; }
+        Size nonZeros() const { return values_.size(); }
+        const std::vector<Size>& rowOffsets() const { return rowOffsets_; }
+        const std::vector<Size>& columnIndices() const { return columnIndices_; }
+        const std::vector<Real>& values() const { return values_; }
+        //! element (i,j), or zero if it is not stored
+        Real operator()(Size i, Size j) const;
+        //@}
+
+        //! \name matrix-vector product
+        //@{
+        /*! y must not be the same array as x; rows are split among
+            the given number of threads.
+        */
+        void multiply(const Array& x, Array& y, Size threads = 1) const;
+        Array operator()(const Array& x) const;
+        //@}
+
+        SparseMatrix toSparseMatrix() const;
+
+      private:
+        Size rows_ = 0, columns_ = 0;
+        std::vector<Size> rowOffsets_ = std::vector<Size>(1, 0);
+        std::vector<Size> columnIndices_;
+        std::vector<Real> values_;
+    };
+
+    /*! \relates CsrMatrix */
+    CsrMatrix operator+(const CsrMatrix&, const CsrMatrix&);
+
+    /*! \relates CsrMatrix
+        Sum of several matrices of the same size, assembled in a
+        single pass; entries in the same position are added in the
+        order of the terms, as in a chain of additions.
+    */
+    CsrMatrix sum(const std::vector<CsrMatrix>& terms);
+
+    /*! \relates CsrMatrix */
+    Array prod(const CsrMatrix& A, const Array& x);
+
+    namespace detail {
+
+        /* appends a row to the given columns and values; the entries
+           are given as (column, value) pairs in any order, and the
+           values of entries in the same column are added in the
+           order in which they are given. */
+        void appendCsrRow(std::pair<Size, Real>* begin,
+                          std::pair<Size, Real>* end,
+                          std::vector<Size>& columnIndices,
+                          std::vector<Real>& values);
+
+    }
+
+
+    // inline definitions
+
+    inline Array CsrMatrix::operator()(const Array& x) const {
+        Array y(rows_);
+        multiply(x, y);
+        return y;
+    }
+
+    inline Array prod(const CsrMatrix& A, const Array& x) {
+        return A(x);
+    }
+
+}
+
+#endif
@@ -0,0 +1,237 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/math/matrixutilities/sparseamgpreconditioner.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace QuantLib {
+
+    namespace {
+
+        // largest coarsest level solved exactly
+        const Size maxDirectSize = 1000;
+
+        // groups each point with the points it is strongly coupled to
+        std::vector<Size> aggregate(const CsrMatrix& A, Real threshold,
+                                    Size& nAggregates) {
+            const Size n = A.rows();
+            const std::vector<Size>& offsets = A.rowOffsets();
+            const std::vector<Size>& indices = A.columnIndices();
+            const std::vector<Real>& values = A.values();
+
+            const Size none = Size(-1);
+            std::vector<Size> aggregates(n, none);
+            std::vector<Real> limits(n, 0.0);
+
+            for (Size i=0; i < n; ++i) {
+                Real maxOffDiagonal = 0.0;
+                for (Size k=offsets[i]; k < offsets[i+1]; ++k) {
+                    if (indices[k] != i)
+                        maxOffDiagonal =
+                            std::max(maxOffDiagonal, std::fabs(values[k]));
+                }
+                limits[i] = threshold*maxOffDiagonal;
+            }
+            const auto isStrong = [&](Size i, Size k) {
+                return indices[k] != i && values[k] != 0.0
+                    && std::fabs(values[k]) >= limits[i];
+            };
+
+            // first pass: points whose strong neighbours are all free
+            // start a new aggregate together with them
+            nAggregates = 0;
+            for (Size i=0; i < n; ++i) {
+                if (aggregates[i] != none)
+                    continue;
+                bool free = true;
+                for (Size k=offsets[i]; k < offsets[i+1] && free; ++k)
+                    free = !isStrong(i, k) || aggregates[indices[k]] == none;
+                if (free) {
+                    aggregates[i] = nAggregates;
+                    for (Size k=offsets[i]; k < offsets[i+1]; ++k) {
+                        if (isStrong(i, k))
+                            aggregates[indices[k]] = nAggregates;
+                    }
+                    ++nAggregates;
+                }
+            }
+
+            // second pass: the remaining points join the aggregate of
+            // their strongest neighbour, or form one of their own
+            for (Size i=0; i < n; ++i) {
+                if (aggregates[i] != none)
+                    continue;
+                Size best = none;
+                Real strongest = 0.0;
+                for (Size k=offsets[i]; k < offsets[i+1]; ++k) {
+                    const Size j = indices[k];
+                    if (j != i && aggregates[j] != none
+                        && std::fabs(values[k]) > strongest) {
+                        best = aggregates[j];
+                        strongest = std::fabs(values[k]);
+                    }
+                }
+                aggregates[i] = (best != none) ? best : nAggregates++;
+            }
+
+            return aggregates;
+        }
+
+        // Galerkin product P^T A P for piecewise-constant interpolation
+        CsrMatrix coarsen(const CsrMatrix& A,
+                          const std::vector<Size>& aggregates,
+                          Size nAggregates) {
+            const std::vector<Size>& offsets = A.rowOffsets();
+            const std::vector<Size>& indices = A.columnIndices();
+            const std::vector<Real>& values = A.values();
+
+            // points sorted by aggregate
+            std::vector<Size> start(nAggregates+1, 0), members(A.rows());
+            for (Size a : aggregates)
+                ++start[a+1];
+            std::partial_sum(start.begin(), start.end(), start.begin());
+            std::vector<Size> next(start.begin(), start.end()-1);
+            for (Size i=0; i < A.rows(); ++i)
+                members[next[aggregates[i]]++] = i;
+
+            std::vector<Size> cOffsets(nAggregates+1, 0), cIndices;
+            std::vector<Real> cValues;
+            std::vector<Real> row(nAggregates, 0.0);
+            std::vector<bool> used(nAggregates, false);
+            std::vector<Size> columns;
+
+            for (Size I=0; I < nAggregates; ++I) {
+                for (Size m=start[I]; m < start[I+1]; ++m) {
+                    const Size i = members[m];
+                    for (Size k=offsets[i]; k < offsets[i+1]; ++k) {
+                        const Size J = aggregates[indices[k]];
+                        if (!used[J]) {
+                            used[J] = true;
+                            columns.push_back(J);
+                        }
+                        row[J] += values[k];
+                    }
+                }
+                std::sort(columns.begin(), columns.end());
+                for (Size J : columns) {
+                    cIndices.push_back(J);
+                    cValues.push_back(row[J]);
+                    row[J] = 0.0;
+                    used[J] = false;
+                }
+                columns.clear();
+                cOffsets[I+1] = cValues.size();
+            }
+
+            return {nAggregates, nAggregates, std::move(cOffsets),
+                    std::move(cIndices), std::move(cValues)};
+        }
+
+    }
+
+    SparseAMGPreconditioner::SparseAMGPreconditioner(const CsrMatrix& A,
+                                                     Size smoothingSteps,
+                                                     Size maxCoarsestSize,
+                                                     Real strengthThreshold)
+    : smoothingSteps_(smoothingSteps) {
+        QL_REQUIRE(A.rows() == A.columns(),
+                   "algebraic multigrid works only with square matrices");
+        QL_REQUIRE(A.rows() > 0, "empty matrix given");
+
+        levels_.push_back({A, SparseILUPreconditioner(A, 0), {}});
+        while (levels_.back().A.rows() > maxCoarsestSize) {
+            Level& fine = levels_.back();
+            Size nAggregates;
+            std::vector<Size> aggregates =
+                aggregate(fine.A, strengthThreshold, nAggregates);
+            // stop when the matrix cannot be coarsened any further
+            if (10*nAggregates > 9*fine.A.rows())
+                break;
+
+            CsrMatrix coarse = coarsen(fine.A, aggregates, nAggregates);
+            fine.aggregates = std::move(aggregates);
+            SparseILUPreconditioner smoother(coarse, 0);
+            levels_.push_back(
+                {std::move(coarse), std::move(smoother), {}});
+        }
+
+        const CsrMatrix& coarsest = levels_.back().A;
+        if (coarsest.rows() <= maxDirectSize) {
+            Matrix m(coarsest.rows(), coarsest.rows(), 0.0);
+            for (Size i=0; i < coarsest.rows(); ++i)
+                for (Size k=coarsest.rowOffsets()[i];
+                     k < coarsest.rowOffsets()[i+1]; ++k)
+                    m[i][coarsest.columnIndices()[k]] = coarsest.values()[k];
+            coarsestInverse_ = inverse(m);
+        }
+    }
+
+    Array SparseAMGPreconditioner::apply(const Array& b) const {
+        QL_REQUIRE(b.size() == levels_.front().A.rows(),
+                   "wrong size of right-hand side (" << b.size() << ", "
+                   << levels_.front().A.rows() << " required)");
+        return cycle(0, b);
+    }
+
+    Array SparseAMGPreconditioner::cycle(Size l, const Array& b) const {
+        const Level& level = levels_[l];
+
+        if (l == levels_.size()-1) {
+            if (!coarsestInverse_.empty())
+                return coarsestInverse_*b;
+
+            // too large to be inverted, the coarsest level is smoothed
+            Array x(b.size(), 0.0);
+            for (Size k=0; k < 10*std::max<Size>(smoothingSteps_, 1); ++k)
+                smooth(level, b, x);
+            return x;
+        }
+
+        const std::vector<Size>& aggregates = level.aggregates;
+
+        Array x(b.size(), 0.0);
+        for (Size k=0; k < smoothingSteps_; ++k)
+            smooth(level, b, x);
+
+        Array r(b.size());
+        level.A.multiply(x, r);
+        Array coarseResidual(levels_[l+1].A.rows(), 0.0);
+        for (Size i=0; i < b.size(); ++i)
+            coarseResidual[aggregates[i]] += b[i] - r[i];
+
+        const Array correction = cycle(l+1, coarseResidual);
+        for (Size i=0; i < b.size(); ++i)
+            x[i] += correction[aggregates[i]];
+
+        for (Size k=0; k < smoothingSteps_; ++k)
+            smooth(level, b, x);
+
+        return x;
+    }
+
+    void SparseAMGPreconditioner::smooth(const Level& level,
+                                         const Array& b, Array& x) const {
+        Array r(b.size());
+        level.A.multiply(x, r);
+        for (Size i=0; i < b.size(); ++i)
+            r[i] = b[i] - r[i];
+        x += level.smoother.apply(r);
+    }
+
+}
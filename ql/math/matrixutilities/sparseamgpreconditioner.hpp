@@ -0,0 +1,85 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file sparseamgpreconditioner.hpp
+    \brief Algebraic multigrid preconditioner for sparse matrices
+*/
+
+#ifndef quantlib_sparse_amg_preconditioner_hpp
+#define quantlib_sparse_amg_preconditioner_hpp
+
+#include <ql/math/matrix.hpp>
+#include <ql/math/matrixutilities/csrmatrix.hpp>
+#include <ql/math/matrixutilities/sparseilupreconditioner.hpp>
+
+namespace QuantLib {
+
+    //! Algebraic multigrid preconditioner
+    /*! Applies a multigrid V-cycle to approximate the inverse of a
+        sparse matrix.  Coarse levels are built by aggregating points
+        that are strongly coupled in the matrix, so that no geometric
+        information is needed; coarse operators are the Galerkin
+        products of the finer ones with the piecewise-constant
+        interpolation between levels.  On each level, the error is
+        smoothed before and after the coarse-grid correction by
+        incomplete LU factorizations without fill-in; unlike
+        Gauss-Seidel sweeps, these remain convergent for the matrices
+        without diagonal dominance produced by strongly correlated
+        mixed-derivative terms.  The coarsest level is solved exactly
+        unless it is too large to be inverted.
+
+        The V-cycle is a fixed linear operator, so that it can be
+        used as the preconditioner of BiCGstab and GMRES; it is
+        especially effective for the diffusion-dominated systems of
+        implicit finite-difference schemes, whose convergence with
+        simpler preconditioners degrades as the grid is refined.
+
+        References:
+        Stueben, K. 2001, A review of algebraic multigrid,
+        Journal of Computational and Applied Mathematics 128, 281-309
+    */
+    class SparseAMGPreconditioner {
+      public:
+        explicit SparseAMGPreconditioner(const CsrMatrix& A,
+                                         Size smoothingSteps = 1,
+                                         Size maxCoarsestSize = 200,
+                                         Real strengthThreshold = 0.25);
+
+        Array apply(const Array& b) const;
+
+        //! number of levels, including the finest and the coarsest
+        Size levels() const { return levels_.size(); }
+
+      private:
+        struct Level {
+            CsrMatrix A;
+            SparseILUPreconditioner smoother;
+            // coarse point of each point; empty on the coarsest level
+            std::vector<Size> aggregates;
+        };
+
+        Array cycle(Size level, const Array& b) const;
+        void smooth(const Level& level, const Array& b, Array& x) const;
+
+        Size smoothingSteps_;
+        std::vector<Level> levels_;
+        Matrix coarsestInverse_;
+    };
+
+}
+
+#endif
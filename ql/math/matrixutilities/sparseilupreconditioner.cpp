@@ -18,139 +18,139 @@ FOR A PARTICULAR PURPOSE.  See the license for more details.
 */
 
 #include <ql/math/matrixutilities/sparseilupreconditioner.hpp>
-#include <ql/math/matrix.hpp>
-
-#include <set>
+#include <algorithm>
+#include <functional>
+#include <queue>
 
 namespace QuantLib {
 
-    using namespace boost::numeric::ublas;
-
     SparseILUPreconditioner::SparseILUPreconditioner(const SparseMatrix& A,
                                                      Integer lfil)
-    : L_(A.size1(),A.size2()),
-      U_(A.size1(),A.size2()) {
-
-        QL_REQUIRE(A.size1() == A.size2(),
-                   "sparse ILU preconditioner works only with square matrices");
+    : SparseILUPreconditioner(CsrMatrix(A), lfil) {}
 
-        for (SparseMatrix::size_type i=0; i < L_.size1(); ++i)
-            L_(i,i) = 1.0;
+    SparseILUPreconditioner::SparseILUPreconditioner(const CsrMatrix& A,
+                                                     Integer lfil) {
 
-        const Integer n = A.size1();
-        std::set<Integer> lBandSet, uBandSet;
-
-        compressed_matrix<Integer> levs(n,n);
-        Integer lfilp = lfil + 1;
-
-        for (Integer ii=0; ii<n; ++ii) {
-            Array w(n);
-            for(Integer k=0; k<n; ++k) {
-                w[k] = A(ii,k);
-            }
+        QL_REQUIRE(A.rows() == A.columns(),
+                   "sparse ILU preconditioner works only with square matrices");
 
-            std::vector<Integer> levii(n, 0);
-            for (Integer i=0; i<n; ++i) {
-                if(   w[i] > QL_EPSILON
-                      || w[i] < -1.0*QL_EPSILON) levii[i] = 1;
-            }
-            Integer jj = -1;
-            while (jj < ii) {
-                for (Integer k=jj+1; k<n; ++k) {
-                    if (levii[k] != 0) {
-                        jj = k;
-                        break;
-                    }
+        const Size n = A.rows();
+        const Integer lfilp = lfil + 1;
+
+        const auto isNonZero = [](Real x) {
+            return x > QL_EPSILON || x < -1.0*QL_EPSILON;
+        };
+
+        // L is stored with its unit diagonal; the levels of fill of
+        // the elements of U are kept alongside.
+        std::vector<Size> lOffsets(n+1, 0), lIndices;
+        std::vector<Real> lValues;
+        std::vector<Size> uOffsets(n+1, 0), uIndices;
+        std::vector<Real> uValues;
+        std::vector<Integer> uLevels;
+
+        // the current row and its levels of fill are stored densely,
+        // but only the touched elements are visited and reset
+        std::vector<Real> w(n, 0.0);
+        std::vector<Integer> levii(n, 0);
+        std::vector<bool> touched(n, false);
+        std::vector<Size> touchedColumns;
+        std::priority_queue<Size, std::vector<Size>, std::greater<> > pending;
+
+        const std::vector<Size>& aOffsets = A.rowOffsets();
+        const std::vector<Size>& aIndices = A.columnIndices();
+        const std::vector<Real>& aValues = A.values();
+
+        for (Size ii=0; ii<n; ++ii) {
+            const auto touch = [&](Size j) {
+                if (!touched[j]) {
+                    touched[j] = true;
+                    touchedColumns.push_back(j);
                 }
-                if (jj >= ii) {
-                    break;
+            };
+
+            for (Size k=aOffsets[ii]; k<aOffsets[ii+1]; ++k) {
+                const Size j = aIndices[k];
+                touch(j);
+                w[j] = aValues[k];
+                if (isNonZero(w[j])) {
+                    levii[j] = 1;
+                    if (j < ii)
+                        pending.push(j);
                 }
-                Integer jlev = levii[jj];
+            }
+
+            // eliminate the elements left of the diagonal in
+            // increasing column order, including fill-ins
+            while (!pending.empty()) {
+                const Size jj = pending.top();
+                pending.pop();
+
+                const Integer jlev = levii[jj];
                 if (jlev <= lfilp) {
-                    std::vector<Integer> nonZeros;
-                    std::vector<Real> nonZeroEntries;
-                    nonZeros.reserve(uBandSet.size()+1);
-                    nonZeroEntries.reserve(uBandSet.size()+1);
-                    const Real entry = U_(jj,jj);
-                    if(entry > QL_EPSILON || entry < -1.0*QL_EPSILON) {
-                        nonZeros.push_back(jj);
-                        nonZeroEntries.push_back(entry);
-                    }
-                    auto iter = uBandSet.begin();
-                    auto end = uBandSet.end();
-                    for (; iter != end; ++iter) {
-                        const Real entry = U_(jj,jj+*iter);
-                        if(entry > QL_EPSILON || entry < -1.0*QL_EPSILON) {
-                            nonZeros.push_back(jj+*iter);
-                            nonZeroEntries.push_back(entry);
-                        }
-                    }
+                    const Size begin = uOffsets[jj], end = uOffsets[jj+1];
                     Real fact = w[jj];
-                    if(!nonZeroEntries.empty()) {
-                        fact /= nonZeroEntries[0];
+                    if (begin != end) {
+                        fact /= uValues[begin];
                     }
-                    for (Size k=0; k<nonZeros.size(); ++k) {
-                        const Integer j = nonZeros[k] ;
-                        const Integer temp = levs(jj,j) + jlev ;
+                    for (Size k=begin; k<end; ++k) {
+                        const Size j = uIndices[k];
+                        const Integer temp = uLevels[k] + jlev;
                         if (levii[j] == 0) {
                             if (temp <= lfilp) {
-                                w[j] =  - fact*nonZeroEntries[k];
+                                touch(j);
+                                w[j] = - fact*uValues[k];
                                 levii[j] = temp;
+                                if (j < ii)
+                                    pending.push(j);
                             }
                         }
                         else {
-                            w[j] -= fact*nonZeroEntries[k];
+                            w[j] -= fact*uValues[k];
                             levii[j] = std::min(levii[j],temp);
                         }
                     }
                     w[jj] = fact;
                 }
             }
-            std::vector<Integer> wNonZeros;
-            std::vector<Real> wNonZeroEntries;
-            wNonZeros.reserve(w.size());
-            wNonZeroEntries.reserve(w.size());
-            for (Size i=0; i<w.size(); ++i) {
-                const Real entry = w[i];
-                if(entry > QL_EPSILON || entry < -1.0*QL_EPSILON) {
-                    wNonZeros.push_back(i);
-                    wNonZeroEntries.push_back(entry);
-                }
-            }
-            std::vector<Integer> leviiNonZeroEntries;
-            leviiNonZeroEntries.reserve(levii.size());
-            for (int entry : levii) {
-                if (entry > QL_EPSILON || entry < -1.0 * QL_EPSILON) {
-                    leviiNonZeroEntries.push_back(entry);
-                }
-            }
-            for (Size k=0; k<wNonZeros.size(); ++k) {
-                Integer j = wNonZeros[k];
-                if (j < ii) {
-                    L_(ii,j) = wNonZeroEntries[k];
-                    lBandSet.insert(ii-j);
-                }
-                else {
-                    U_(ii,j) = wNonZeroEntries[k];
-                    levs(ii,j) = leviiNonZeroEntries[k];
-                    if(j-ii > 0) {
-                        uBandSet.insert(j-ii);
+
+            std::sort(touchedColumns.begin(), touchedColumns.end());
+            for (Size j : touchedColumns) {
+                if (isNonZero(w[j])) {
+                    if (j < ii) {
+                        lIndices.push_back(j);
+                        lValues.push_back(w[j]);
+                    }
+                    else {
+                        uIndices.push_back(j);
+                        uValues.push_back(w[j]);
+                        uLevels.push_back(levii[j]);
                     }
                 }
+                w[j] = 0.0;
+                levii[j] = 0;
+                touched[j] = false;
             }
+            touchedColumns.clear();
+
+            lIndices.push_back(ii);
+            lValues.push_back(1.0);
+            lOffsets[ii+1] = lValues.size();
+            uOffsets[ii+1] = uValues.size();
         }
-        lBands_.resize(lBandSet.size());
-        uBands_.resize(uBandSet.size());
-        std::copy(lBandSet.begin(), lBandSet.end(), lBands_.begin());
-        std::copy(uBandSet.begin(), uBandSet.end(), uBands_.begin());
+
+        L_ = CsrMatrix(n, n, std::move(lOffsets),
+                       std::move(lIndices), std::move(lValues));
+        U_ = CsrMatrix(n, n, std::move(uOffsets),
+                       std::move(uIndices), std::move(uValues));
     }
 
-    const SparseMatrix& SparseILUPreconditioner::L() const {
-        return L_;
+    SparseMatrix SparseILUPreconditioner::L() const {
+        return L_.toSparseMatrix();
     }
 
-    const SparseMatrix& SparseILUPreconditioner::U() const {
-        return U_;
+    SparseMatrix SparseILUPreconditioner::U() const {
+        return U_.toSparseMatrix();
     }
 
     Array SparseILUPreconditioner::apply(const Array& b) const {
@@ -158,33 +158,38 @@ namespace QuantLib {
     }
 
     Array SparseILUPreconditioner::forwardSolve(const Array& b) const {
-        Integer n = b.size();
+        const std::vector<Size>& offsets = L_.rowOffsets();
+        const std::vector<Size>& indices = L_.columnIndices();
+        const std::vector<Real>& values = L_.values();
+
+        const Size n = b.size();
         Array y(n, 0.0);
-        y[0]=b[0]/L_(0,0);
-        for (Integer i=1; i<=n-1; ++i) {
-            y[i] = b[i]/L_(i,i);
-            for (Integer j=lBands_.size()-1;
-                 j>=0 && i-Integer(lBands_[j]) <= i-1; --j) {
-                const Integer k = i-Integer(lBands_[j]);
-                if (k >= 0)
-                    y[i]-=L_(i,k)*y[k]/L_(i,i);
-            }
+        for (Size i=0; i<n; ++i) {
+            // the last element of each row is the unit diagonal
+            const Size diag = offsets[i+1]-1;
+            y[i] = b[i]/values[diag];
+            for (Size k=offsets[i]; k<diag; ++k)
+                y[i] -= values[k]*y[indices[k]]/values[diag];
         }
         return y;
     }
 
     Array SparseILUPreconditioner::backwardSolve(const Array& y) const {
-        Size n = y.size();
+        const std::vector<Size>& offsets = U_.rowOffsets();
+        const std::vector<Size>& indices = U_.columnIndices();
+        const std::vector<Real>& values = U_.values();
+
+        const Size n = y.size();
         Array x(n, 0.0);
-        x[n-1] = y[n-1]/U_(n-1,n-1);
-        for (Integer i=n-2; i>=0; --i) {
-            x[i] = y[i]/U_(i,i);
-            for (Size j=0; j<uBands_.size() && i+uBands_[j] <= n-1; ++j) {
-                x[i] -= U_(i,i+uBands_[j])*x[i+uBands_[j]]/U_(i,i);
-            }
+        for (Size i=n; i-- > 0;) {
+            Size k = offsets[i];
+            const Real diag =
+                (k < offsets[i+1] && indices[k] == i) ? values[k++] : 0.0;
+            x[i] = y[i]/diag;
+            for (; k<offsets[i+1]; ++k)
+                x[i] -= values[k]*x[indices[k]]/diag;
         }
         return x;
     }
 
 }
-
@@ -25,7 +25,7 @@ FOR A PARTICULAR PURPOSE.  See the license for more details.
 #define quantlib_sparse_ilu_preconditioner_hpp
 
 #include <ql/math/array.hpp>
-#include <ql/math/matrixutilities/sparsematrix.hpp>
+#include <ql/math/matrixutilities/csrmatrix.hpp>
 
 namespace QuantLib {
 
@@ -36,15 +36,15 @@ namespace QuantLib {
     class SparseILUPreconditioner  {
       public:
         explicit SparseILUPreconditioner(const SparseMatrix& A, Integer lfil = 1);
+        explicit SparseILUPreconditioner(const CsrMatrix& A, Integer lfil = 1);
 
-        const SparseMatrix& L() const;
-        const SparseMatrix& U() const;
+        SparseMatrix L() const;
+        SparseMatrix U() const;
 
         Array apply(const Array& b) const;
 
       private:
-        SparseMatrix L_, U_;
-        std::vector<Size> lBands_, uBands_;
+        CsrMatrix L_, U_;
 
         Array forwardSolve(const Array& b) const;
         Array backwardSolve(const Array& y) const;
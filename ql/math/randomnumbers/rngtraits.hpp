@@ -28,15 +28,88 @@
 
 #include <ql/methods/montecarlo/pathgenerator.hpp>
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <ql/math/randomnumbers/xoshiro256starstaruniformrng.hpp>
 #include <ql/math/randomnumbers/inversecumulativerng.hpp>
 #include <ql/math/randomnumbers/randomsequencegenerator.hpp>
 #include <ql/math/randomnumbers/sobolrsg.hpp>
 #include <ql/math/randomnumbers/inversecumulativersg.hpp>
 #include <ql/math/distributions/normaldistribution.hpp>
 #include <ql/math/distributions/poissondistribution.hpp>
+#include <cstdint>
+#include <type_traits>
 
 namespace QuantLib {
 
+    namespace detail {
+
+        //! uniform generator for the given stream of a parallel simulation
+        /*! Stream 0 uses the given seed, so that it reproduces the
+            sequential simulation; the other streams are seeded by
+            scrambling the seed and the stream number.  A null seed
+            gives random streams, as it does for a single generator.
+        */
+        template <class URNG>
+        inline URNG make_urng_stream(BigNatural seed, Size stream) {
+            if (seed == 0 || stream == 0)
+                return URNG(seed);
+            // SplitMix64 finalizer, see https://prng.di.unimi.it/splitmix64.c
+            std::uint64_t z = std::uint64_t(seed)
+                + 0x9e3779b97f4a7c15ULL * std::uint64_t(stream);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            z ^= (z >> 31);
+            const auto streamSeed = static_cast<BigNatural>(z);
+            return URNG(streamSeed != 0 ? streamSeed : 1);
+        }
+
+        //! xoshiro256** streams are non-overlapping by jump-ahead
+        template <>
+        inline Xoshiro256StarStarUniformRng
+        make_urng_stream<Xoshiro256StarStarUniformRng>(BigNatural seed,
+                                                       Size stream) {
+            Xoshiro256StarStarUniformRng rng(seed);
+            for (Size i=0; i<stream; ++i)
+                rng.jump();
+            return rng;
+        }
+
+        template <class URSG, class = void>
+        struct has_skip_to : std::false_type {};
+
+        template <class URSG>
+        struct has_skip_to<URSG, std::void_t<decltype(
+            std::declval<URSG&>().skipTo(0U))> > : std::true_type {};
+
+        template <class RNG, class = void>
+        struct has_stream_factory : std::false_type {};
+
+        template <class RNG>
+        struct has_stream_factory<RNG, std::void_t<decltype(
+            RNG::make_sequence_generator(Size(), BigNatural(), Size(), Size()))> >
+        : std::true_type {};
+
+        //! sequence generator for a stream of a parallel simulation
+        /*! Falls back to the plain factory for traits that don't
+            support streams, in which case only the first stream
+            starting at the first sample is available.
+        */
+        template <class RNG>
+        inline typename RNG::rsg_type
+        make_stream_sequence_generator(Size dimension, BigNatural seed,
+                                       Size stream, Size firstSample) {
+            if constexpr (has_stream_factory<RNG>::value) {
+                return RNG::make_sequence_generator(dimension, seed,
+                                                    stream, firstSample);
+            } else {
+                QL_REQUIRE(stream == 0 && firstSample == 0,
+                           "random-number traits do not support "
+                           "parallel streams");
+                return RNG::make_sequence_generator(dimension, seed);
+            }
+        }
+
+    }
+
     // random number traits
 
     template <class URNG, class IC>
@@ -54,6 +127,18 @@ namespace QuantLib {
             ursg_type g(dimension, seed);
             return (icInstance ? rsg_type(g, *icInstance) : rsg_type(g));
         }
+        /*! generator for the given stream of a parallel simulation;
+            streams are independent of each other, and the first
+            sample is not used.
+        */
+        static rsg_type make_sequence_generator(Size dimension,
+                                                BigNatural seed,
+                                                Size stream,
+                                                Size /*firstSample*/) {
+            ursg_type g(dimension,
+                        detail::make_urng_stream<urng_type>(seed, stream));
+            return (icInstance ? rsg_type(g, *icInstance) : rsg_type(g));
+        }
         // data
         static ext::shared_ptr<IC> icInstance;
     };
@@ -91,6 +176,23 @@ namespace QuantLib {
             ursg_type g(dimension, seed);
             return (icInstance ? rsg_type(g, *icInstance) : rsg_type(g));
         }
+        /*! generator for a stream of a parallel simulation; all streams
+            share the same sequence, and each one is moved ahead to the
+            first sample it has to produce.
+        */
+        static rsg_type make_sequence_generator(Size dimension,
+                                                BigNatural seed,
+                                                Size /*stream*/,
+                                                Size firstSample) {
+            ursg_type g(dimension, seed);
+            if (firstSample != 0) {
+                if constexpr (detail::has_skip_to<ursg_type>::value)
+                    g.skipTo(firstSample);
+                else
+                    QL_FAIL("sequence generator does not support skip-ahead");
+            }
+            return (icInstance ? rsg_type(g, *icInstance) : rsg_type(g));
+        }
         // data
         static ext::shared_ptr<IC> icInstance;
     };
@@ -61,6 +61,10 @@ namespace QuantLib {
         return gen_.numberOfFactors() * gen_.numberOfSteps();
     }
 
+    void SobolBrownianBridgeRsg::skipTo(std::uint32_t n) const {
+        gen_.skipTo(n);
+    }
+
     Burley2020SobolBrownianBridgeRsg::Burley2020SobolBrownianBridgeRsg(
         Size factors,
         Size steps,
@@ -86,4 +90,8 @@ namespace QuantLib {
         return gen_.numberOfFactors() * gen_.numberOfSteps();
     }
 
+    void Burley2020SobolBrownianBridgeRsg::skipTo(std::uint32_t n) const {
+        gen_.skipTo(n);
+    }
+
 }
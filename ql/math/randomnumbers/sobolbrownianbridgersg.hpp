@@ -43,6 +43,10 @@ namespace QuantLib {
         const sample_type& nextSequence() const;
         const sample_type& lastSequence() const;
         Size dimension() const;
+        /*! moves the generator as if n sequences had been drawn;
+            see SobolBrownianGenerator::skipTo.
+        */
+        void skipTo(std::uint32_t n) const;
 
       private:
         mutable sample_type seq_;
@@ -64,6 +68,10 @@ namespace QuantLib {
         const sample_type& nextSequence() const;
         const sample_type& lastSequence() const;
         Size dimension() const;
+        /*! moves the generator as if n sequences had been drawn;
+            see SobolBrownianGenerator::skipTo.
+        */
+        void skipTo(std::uint32_t n) const;
 
       private:
         mutable sample_type seq_;
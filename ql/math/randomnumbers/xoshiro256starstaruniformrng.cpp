@@ -65,4 +65,27 @@ namespace QuantLib {
                                                                std::uint64_t s3)
     : s0_(s0), s1_(s1), s2_(s2), s3_(s3) {}
 
+    void Xoshiro256StarStarUniformRng::jump() {
+        // see https://prng.di.unimi.it/xoshiro256starstar.c
+        static const std::uint64_t JUMP[] = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c,
+                                             0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+
+        std::uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        for (auto j : JUMP) {
+            for (int b = 0; b < 64; ++b) {
+                if ((j & std::uint64_t(1) << b) != 0U) {
+                    s0 ^= s0_;
+                    s1 ^= s1_;
+                    s2 ^= s2_;
+                    s3 ^= s3_;
+                }
+                nextInt64();
+            }
+        }
+
+        s0_ = s0;
+        s1_ = s1;
+        s2_ = s2;
+        s3_ = s3;
+    }
 }
@@ -90,6 +90,11 @@ namespace QuantLib {
             return result;
         }
 
+        /*! advances the generator by 2**128 steps; it can be used to
+            generate 2**128 non-overlapping subsequences for parallel
+            computations. */
+        void jump();
+
       private:
         static std::uint64_t rotl(std::uint64_t x, std::int32_t k) { return (x << k) | (x >> (64 - k)); }
         mutable std::uint64_t s0_, s1_, s2_, s3_;
@@ -0,0 +1,261 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file adaptivefinitedifferencemodel.hpp
+    \brief Finite difference model with adaptive time steps
+*/
+
+#ifndef quantlib_adaptive_finite_difference_model_hpp
+#define quantlib_adaptive_finite_difference_model_hpp
+
+#include <ql/methods/finitedifferences/operatortraits.hpp>
+#include <ql/methods/finitedifferences/stepcondition.hpp>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace QuantLib {
+
+    //! Finite difference model with adaptive time steps
+    /*! For a scheme of order \f$ p \f$, the local error of a step
+        of size \f$ h \f$ is, up to a constant depending on the
+        scheme, \f$ h^{p+1} u^{(p+1)}/(p+1)! \f$.  The derivative is
+        estimated by the divided difference of the new solution and
+        of the last \f$ p+1 \f$ accepted ones, so that each trial
+        step costs a single evolver step.  A step is accepted if the
+        maximum of the estimate over the grid is below the given
+        tolerance; in any case, the next step size is chosen so that
+        the estimate is expected to be just below the tolerance.
+
+        Until enough solutions are available, i.e., for the first
+        steps of the rollback and after each stopping time, where the
+        condition might make the solution jump, the error is
+        estimated by step doubling instead: the step is taken once
+        with the full step size and twice with half of it, and the
+        difference of the results divided by \f$ 2^p-1 \f$ estimates
+        the error of the latter, which is kept.  These steps cost
+        three evolver steps each.
+
+        Steps are shortened so that they end exactly on the stopping
+        times.  As in FiniteDifferenceModel, the condition, if any,
+        is applied at the end of every step, including the
+        intermediate ones used for step doubling.
+
+        \ingroup findiff
+    */
+    template <class Evolver>
+    class AdaptiveFiniteDifferenceModel {
+      public:
+        typedef typename Evolver::traits traits;
+        typedef typename traits::operator_type operator_type;
+        typedef typename traits::array_type array_type;
+        typedef typename traits::bc_set bc_set;
+        typedef typename traits::condition_type condition_type;
+
+        /*! \param tolerance  maximum local error of a step
+            \param order      order of the scheme used by the evolver
+            \param minStep    steps this short are accepted regardless
+                              of their error
+        */
+        AdaptiveFiniteDifferenceModel(Evolver evolver,
+                                      std::vector<Time> stoppingTimes,
+                                      Real tolerance,
+                                      Size order = 2,
+                                      Time minStep = 1e-6)
+        : evolver_(std::move(evolver)), stoppingTimes_(std::move(stoppingTimes)),
+          tolerance_(tolerance), order_(order), minStep_(minStep) {
+            QL_REQUIRE(tolerance > 0.0, "positive tolerance required");
+            QL_REQUIRE(order > 0, "positive order required");
+            std::sort(stoppingTimes_.begin(), stoppingTimes_.end());
+            auto last = std::unique(stoppingTimes_.begin(), stoppingTimes_.end());
+            stoppingTimes_.erase(last, stoppingTimes_.end());
+        }
+
+        const Evolver& evolver() const { return evolver_; }
+
+        /*! solves the problem between the given times, starting
+            with the given step size.
+            \warning being this a rollback, <tt>from</tt> must be a later
+                     time than <tt>to</tt>.
+        */
+        void rollback(array_type& a, Time from, Time to, Time initialStep) {
+            rollbackImpl(a, from, to, initialStep, nullptr);
+        }
+        /*! solves the problem between the given times, starting
+            with the given step size and applying a condition at
+            every step.
+            \warning being this a rollback, <tt>from</tt> must be a later
+                     time than <tt>to</tt>.
+        */
+        void rollback(array_type& a, Time from, Time to, Time initialStep,
+                      const condition_type& condition) {
+            rollbackImpl(a, from, to, initialStep, &condition);
+        }
+
+        //! \name step history of the last rollback
+        //@{
+        //! times of the accepted steps, starting with <tt>from</tt>
+        const std::vector<Time>& stepTimes() const { return stepTimes_; }
+        //! number of steps rejected because of their error
+        Size rejectedSteps() const { return rejectedSteps_; }
+        //! number of evolver steps, including rejected and doubled steps
+        Size evolverSteps() const { return evolverSteps_; }
+        //@}
+
+      private:
+        void rollbackImpl(array_type& a, Time from, Time to, Time initialStep,
+                          const condition_type* condition);
+        void evolve(array_type& a, Time t, Time h);
+
+        Evolver evolver_;
+        std::vector<Time> stoppingTimes_;
+        Real tolerance_;
+        Size order_;
+        Time minStep_;
+        std::vector<Time> stepTimes_;
+        Size rejectedSteps_ = 0, evolverSteps_ = 0;
+    };
+
+
+    // template definitions
+
+    template <class Evolver>
+    void AdaptiveFiniteDifferenceModel<Evolver>::evolve(array_type& a,
+                                                        Time t, Time h) {
+        evolver_.setStep(h);
+        evolver_.step(a, t);
+        ++evolverSteps_;
+    }
+
+    template <class Evolver>
+    void AdaptiveFiniteDifferenceModel<Evolver>::rollbackImpl(
+                                           array_type& a,
+                                           Time from, Time to,
+                                           Time initialStep,
+                                           const condition_type* condition) {
+
+        QL_REQUIRE(from >= to,
+                   "trying to roll back from " << from << " to " << to);
+        QL_REQUIRE(initialStep > 0.0, "positive initial step required");
+
+        const Real eps = std::sqrt(QL_EPSILON);
+        const Real doublingScale = 1.0/((1 << order_) - 1.0);
+        const Real exponent = -1.0/(order_ + 1.0);
+
+        stepTimes_.assign(1, from);
+        rejectedSteps_ = evolverSteps_ = 0;
+
+        if (!stoppingTimes_.empty() && stoppingTimes_.back() == from) {
+            if (condition != nullptr)
+                condition->applyTo(a, from);
+        }
+
+        // the last accepted solutions since the start or the last
+        // stopping time, oldest first
+        std::vector<std::pair<Time, array_type> > history(1, {from, a});
+        std::vector<Real> weights(order_ + 2);
+
+        Time t = from, dt = initialStep;
+        while (t - to > eps) {
+            // the step must not go past the next stopping time
+            Time target = to;
+            for (auto s = stoppingTimes_.rbegin(); s != stoppingTimes_.rend(); ++s) {
+                if (*s < t - eps) {
+                    target = std::max(*s, to);
+                    break;
+                }
+            }
+
+            // avoid leaving a tiny step before the target by taking
+            // two equal steps instead; the step is never lengthened,
+            // so that a rejected step is retried with a shorter one
+            Time h = dt;
+            const bool hitsTarget = (t - h <= target + eps);
+            if (hitsTarget)
+                h = t - target;
+            else if (t - h < target + 0.2*h)
+                h = 0.5*(t - target);
+            const Time next = hitsTarget ? target : t - h;
+
+            array_type result = a;
+            Real error = 0.0;
+            if (history.size() <= order_) {
+                array_type full = a;
+                evolve(full, t, h);
+
+                evolve(result, t, 0.5*h);
+                if (condition != nullptr)
+                    condition->applyTo(result, t - 0.5*h);
+                evolve(result, t - 0.5*h, 0.5*h);
+
+                for (Size i=0; i < result.size(); ++i)
+                    error = std::max(error, std::fabs(result[i] - full[i]));
+                error *= doublingScale;
+            } else {
+                evolve(result, t, h);
+
+                // weights of the divided difference over the times
+                // of the history and of the new solution
+                const Size m = history.size();
+                for (Size k=0; k <= m; ++k) {
+                    const Time tk = (k < m) ? history[k].first : next;
+                    Real w = 1.0;
+                    for (Size j=0; j <= m; ++j) {
+                        if (j != k)
+                            w *= tk - ((j < m) ? history[j].first : next);
+                    }
+                    weights[k] = 1.0/w;
+                }
+
+                const Real hp = std::pow(h, Real(order_ + 1));
+                for (Size i=0; i < result.size(); ++i) {
+                    Real d = weights[m]*result[i];
+                    for (Size k=0; k < m; ++k)
+                        d += weights[k]*history[k].second[i];
+                    error = std::max(error, std::fabs(d));
+                }
+                error *= hp;
+            }
+            error /= tolerance_;
+
+            if (error <= 1.0 || h <= minStep_) {
+                a = std::move(result);
+                if (condition != nullptr)
+                    condition->applyTo(a, next);
+                t = next;
+                stepTimes_.push_back(t);
+
+                if (hitsTarget && target != to)
+                    history.clear();
+                else if (history.size() > order_)
+                    history.erase(history.begin());
+                history.emplace_back(t, a);
+            } else {
+                ++rejectedSteps_;
+            }
+
+            const Real factor = (error > 0.0)
+                ? std::min(5.0, std::max(0.2, 0.9*std::pow(error, exponent)))
+                : 5.0;
+            dt = std::max(factor*h, minStep_);
+        }
+    }
+}
+
+
+#endif
@@ -1,6 +1,7 @@
 /* This file is automatically generated; do not edit.     */
 /* Add the files to be included into Makefile.am instead. */
 
+#include <ql/methods/finitedifferences/adaptivefinitedifferencemodel.hpp>
 #include <ql/methods/finitedifferences/boundarycondition.hpp>
 #include <ql/methods/finitedifferences/bsmoperator.hpp>
 #include <ql/methods/finitedifferences/bsmtermoperator.hpp>
@@ -155,4 +155,21 @@ namespace QuantLib {
         };
     }
 
+    std::vector<CsrMatrix> Fdm2dBlackScholesOp::toCsrMatrixDecomp() const {
+        const Size n = mesher_->layout()->size();
+        std::vector<Size> offsets(n+1), indices(n);
+        for (Size i=0; i < n; ++i) {
+            offsets[i+1] = i+1;
+            indices[i] = i;
+        }
+        const CsrMatrix rate(n, n, std::move(offsets), std::move(indices),
+                             std::vector<Real>(n, currentForwardRate_));
+
+        return {
+            opX_.toCsrMatrix(),
+            opY_.toCsrMatrix(),
+            corrMapT_.toCsrMatrix() + rate
+        };
+    }
+
 }
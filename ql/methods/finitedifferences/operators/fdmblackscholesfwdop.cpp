@@ -116,4 +116,8 @@ namespace QuantLib {
         return std::vector<SparseMatrix>(1, mapT_.toMatrix());
     }
 
+    std::vector<CsrMatrix> FdmBlackScholesFwdOp::toCsrMatrixDecomp() const {
+        return std::vector<CsrMatrix>(1, mapT_.toCsrMatrix());
+    }
+
 }
@@ -53,6 +53,7 @@ class FdmBlackScholesFwdOp : public FdmLinearOpComposite {
         Array preconditioner(const Array& r, Real s) const override;
 
         std::vector<SparseMatrix> toMatrixDecomp() const override;
+        std::vector<CsrMatrix> toCsrMatrixDecomp() const override;
       private:
         const ext::shared_ptr<FdmMesher> mesher_;
         const ext::shared_ptr<YieldTermStructure> rTS_, qTS_;
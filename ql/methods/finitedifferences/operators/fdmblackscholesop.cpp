@@ -54,19 +54,26 @@ namespace QuantLib {
 
         if (localVol_ != nullptr) {
             Array v(mesher_->layout()->size());
+            // the local volatility only depends on the coordinate in
+            // the operator direction, each value is evaluated once
+            Array lv(mesher_->layout()->dim()[direction_], -1.0);
             for (const auto& iter : *mesher_->layout()) {
                 const Size i = iter.index();
+                const Size j = iter.coordinates()[direction_];
 
-                if (illegalLocalVolOverwrite_ < 0.0) {
-                    v[i] = squared(localVol_->localVol(0.5*(t1+t2), x_[i], true));
-                }
-                else {
-                    try {
-                        v[i] = squared(localVol_->localVol(0.5*(t1+t2), x_[i], true));
-                    } catch (Error&) {
-                        v[i] = squared(illegalLocalVolOverwrite_);
+                if (lv[j] < 0.0) {
+                    if (illegalLocalVolOverwrite_ < 0.0) {
+                        lv[j] = squared(localVol_->localVol(0.5*(t1+t2), x_[i], true));
+                    }
+                    else {
+                        try {
+                            lv[j] = squared(localVol_->localVol(0.5*(t1+t2), x_[i], true));
+                        } catch (Error&) {
+                            lv[j] = squared(illegalLocalVolOverwrite_);
+                        }
                     }
                 }
+                v[i] = lv[j];
             }
 
             if (quantoHelper_ != nullptr) {
@@ -130,8 +137,41 @@ namespace QuantLib {
         return solve_splitting(direction_, r, dt);
     }
 
+    void FdmBlackScholesOp::apply_into(const Array& u, Array& out) const {
+        mapT_.apply_into(u, out);
+    }
+
+    void FdmBlackScholesOp::apply_direction_into(Size direction,
+                                                 const Array& r, Array& out) const {
+        if (direction == direction_)
+            mapT_.apply_into(r, out);
+        else
+            apply_mixed_into(r, out);
+    }
+
+    void FdmBlackScholesOp::apply_mixed_into(const Array& r, Array& out) const {
+        if (out.size() != r.size())
+            out = Array(r.size());
+        std::fill(out.begin(), out.end(), 0.0);
+    }
+
+    void FdmBlackScholesOp::solve_splitting_into(Size direction, const Array& r,
+                                                 Real dt, Array& out) const {
+        if (direction == direction_)
+            mapT_.solve_splitting_into(r, dt, 1.0, out);
+        else {
+            if (out.size() != r.size())
+                out = Array(r.size());
+            std::copy(r.begin(), r.end(), out.begin());
+        }
+    }
+
     std::vector<SparseMatrix> FdmBlackScholesOp::toMatrixDecomp() const {
         return std::vector<SparseMatrix>(1, mapT_.toMatrix());
     }
 
+    std::vector<CsrMatrix> FdmBlackScholesOp::toCsrMatrixDecomp() const {
+        return std::vector<CsrMatrix>(1, mapT_.toCsrMatrix());
+    }
+
 }
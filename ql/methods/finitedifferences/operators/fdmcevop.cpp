@@ -83,5 +83,9 @@ namespace QuantLib {
         return std::vector<SparseMatrix>(1, mapT_.toMatrix());
     }
 
+    std::vector<CsrMatrix> FdmCEVOp::toCsrMatrixDecomp() const {
+        return std::vector<CsrMatrix>(1, mapT_.toCsrMatrix());
+    }
+
 }
 
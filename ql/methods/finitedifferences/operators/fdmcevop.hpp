@@ -58,6 +58,7 @@ namespace QuantLib {
         Array preconditioner(const Array& r, Real s) const override;
 
         std::vector<SparseMatrix> toMatrixDecomp() const override;
+        std::vector<CsrMatrix> toCsrMatrixDecomp() const override;
 
       private:
         const ext::shared_ptr<YieldTermStructure>& rTS_;
@@ -172,4 +172,12 @@ namespace QuantLib {
         };
     }
 
+    std::vector<CsrMatrix> FdmCIROp::toCsrMatrixDecomp() const {
+        return {
+            dxMap_.getMap().toCsrMatrix(),
+            dyMap_.getMap().toCsrMatrix(),
+            dzMap_.getMap().toCsrMatrix()
+        };
+    }
+
 }
@@ -112,6 +112,7 @@ namespace QuantLib {
         Array preconditioner(const Array& r, Real s) const override;
 
         std::vector<SparseMatrix> toMatrixDecomp() const override;
+        std::vector<CsrMatrix> toCsrMatrixDecomp() const override;
 
       private:
         FdmCIREquityPart dxMap_;
@@ -114,5 +114,13 @@ namespace QuantLib {
         };
     }
 
+    std::vector<CsrMatrix> FdmG2Op::toCsrMatrixDecomp() const {
+        return {
+            mapX_.toCsrMatrix(),
+            mapY_.toCsrMatrix(),
+            corrMap_.toCsrMatrix()
+        };
+    }
+
 }
 
@@ -51,6 +51,7 @@ namespace QuantLib {
         Array preconditioner(const Array& r, Real s) const override;
 
         std::vector<SparseMatrix> toMatrixDecomp() const override;
+        std::vector<CsrMatrix> toCsrMatrixDecomp() const override;
 
       private:
         const Size direction1_, direction2_;
@@ -227,4 +227,15 @@ namespace QuantLib {
         return retVal;
     }
 
+    std::vector<CsrMatrix> FdmHestonFwdOp::toCsrMatrixDecomp() const {
+
+        std::vector<CsrMatrix> retVal(3);
+
+        retVal[0] = mapX_->toCsrMatrix();
+        retVal[1] = mapY_->toCsrMatrix();
+        retVal[2] = correlation_->toCsrMatrix();
+
+        return retVal;
+    }
+
 }
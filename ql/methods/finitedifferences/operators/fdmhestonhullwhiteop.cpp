@@ -150,4 +150,13 @@ namespace QuantLib {
         };
     }
 
+    std::vector<CsrMatrix> FdmHestonHullWhiteOp::toCsrMatrixDecomp() const {
+        return {
+            dxMap_.getMap().toCsrMatrix(),
+            dyMap_.toCsrMatrix(),
+            hullWhiteOp_.toCsrMatrixDecomp().front(),
+            hestonCorrMap_.toCsrMatrix() + equityIrCorrMap_.toCsrMatrix()
+        };
+    }
+
 }
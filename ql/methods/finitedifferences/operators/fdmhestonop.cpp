@@ -25,10 +25,29 @@
 #include <ql/methods/finitedifferences/operators/fdmlinearoplayout.hpp>
 #include <ql/methods/finitedifferences/operators/secondderivativeop.hpp>
 #include <ql/methods/finitedifferences/operators/secondordermixedderivativeop.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <algorithm>
 #include <utility>
 
 namespace QuantLib {
 
+    namespace {
+
+        // scratch space for FdmHestonOp::apply_into; it's kept per
+        // thread, since operators might be applied concurrently
+        Array& workspace(Size size) {
+            thread_local Array workspace;
+            if (workspace.size() != size)
+                workspace = Array(size);
+            return workspace;
+        }
+
+        bool isFlat(const ext::shared_ptr<YieldTermStructure>& ts) {
+            return ext::dynamic_pointer_cast<FlatForward>(ts) != nullptr;
+        }
+
+    }
+
     FdmHestonEquityPart::FdmHestonEquityPart(const ext::shared_ptr<FdmMesher>& mesher,
                                              ext::shared_ptr<YieldTermStructure> rTS,
                                              ext::shared_ptr<YieldTermStructure> qTS,
@@ -55,6 +74,20 @@ namespace QuantLib {
         const Rate r = rTS_->forwardRate(t1, t2, Continuous).rate();
         const Rate q = qTS_->forwardRate(t1, t2, Continuous).rate();
 
+        if (!leverageFct_ && !quantoHelper_) {
+            // the leverage is identically one and the operators
+            // don't need to be rescaled at each step
+            if (L_.empty()) {
+                L_ = getLeverageFctSlice(t1, t2);
+                drift_ = Array(varianceValues_.size());
+            }
+            std::transform(varianceValues_.begin(), varianceValues_.end(),
+                           drift_.begin(),
+                           [r, q](Real v) { return r - q - v; });
+            mapT_.axpyb(drift_, dxMap_, dxxMap_, Array(1, -0.5*r));
+            return;
+        }
+
         L_ = getLeverageFctSlice(t1, t2);
         const Array Lsquare = L_*L_;
 
@@ -110,6 +143,11 @@ namespace QuantLib {
                  .add(FirstDerivativeOp(1, mesher).mult(kappa * (theta - mesher->locations(1))))),
       mapT_(1, mesher), rTS_(std::move(rTS)) {}
 
+    bool FdmHestonEquityPart::isTimeDependent() const {
+        return leverageFct_ != nullptr || quantoHelper_ != nullptr
+            || !isFlat(rTS_) || !isFlat(qTS_);
+    }
+
     void FdmHestonVariancePart::setTime(Time t1, Time t2) {
         const Rate r = rTS_->forwardRate(t1, t2, Continuous).rate();
         mapT_.axpyb(Array(), dyMap_, dyMap_, Array(1,-0.5*r));
@@ -145,6 +183,12 @@ namespace QuantLib {
         dyMap_.setTime(t1, t2);
     }
 
+    bool FdmHestonOp::isTimeDependent() const {
+        // the variance part only depends on the risk-free rate,
+        // which is checked by the equity part as well
+        return dxMap_.isTimeDependent();
+    }
+
     Size FdmHestonOp::size() const {
         return 2;
     }
@@ -181,6 +225,41 @@ namespace QuantLib {
             QL_FAIL("direction too large");
     }
 
+    void FdmHestonOp::apply_into(const Array& u, Array& out) const {
+        Array& tmp = workspace(u.size());
+        dyMap_.getMap().apply_into(u, out);
+        dxMap_.getMap().apply_into(u, tmp);
+        out += tmp;
+        correlationMap_.apply_into(u, tmp);
+        tmp *= dxMap_.getL();
+        out += tmp;
+    }
+
+    void FdmHestonOp::apply_direction_into(Size direction,
+                                           const Array& r, Array& out) const {
+        if (direction == 0)
+            dxMap_.getMap().apply_into(r, out);
+        else if (direction == 1)
+            dyMap_.getMap().apply_into(r, out);
+        else
+            QL_FAIL("direction too large");
+    }
+
+    void FdmHestonOp::apply_mixed_into(const Array& r, Array& out) const {
+        correlationMap_.apply_into(r, out);
+        out *= dxMap_.getL();
+    }
+
+    void FdmHestonOp::solve_splitting_into(Size direction, const Array& r,
+                                           Real a, Array& out) const {
+        if (direction == 0)
+            dxMap_.getMap().solve_splitting_into(r, a, 1.0, out);
+        else if (direction == 1)
+            dyMap_.getMap().solve_splitting_into(r, a, 1.0, out);
+        else
+            QL_FAIL("direction too large");
+    }
+
     Array FdmHestonOp::preconditioner(const Array& r, Real dt) const {
         return solve_splitting(1, solve_splitting(0, r, dt), dt) ;
     }
@@ -193,4 +272,12 @@ namespace QuantLib {
         };
     }
 
+    std::vector<CsrMatrix> FdmHestonOp::toCsrMatrixDecomp() const {
+        return {
+            dxMap_.getMap().toCsrMatrix(),
+            dyMap_.getMap().toCsrMatrix(),
+            correlationMap_.toCsrMatrix()
+        };
+    }
+
 }
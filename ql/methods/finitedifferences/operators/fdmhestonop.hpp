@@ -47,13 +47,14 @@ namespace QuantLib {
                                 ext::shared_ptr<LocalVolTermStructure>());
 
         void setTime(Time t1, Time t2);
+        bool isTimeDependent() const;
         const TripleBandLinearOp& getMap() const;
         const Array& getL() const { return L_; }
 
       protected:
         Array getLeverageFctSlice(Time t1, Time t2) const;
 
-        Array varianceValues_, volatilityValues_, L_;
+        Array varianceValues_, volatilityValues_, L_, drift_;
         const FirstDerivativeOp  dxMap_;
         const TripleBandLinearOp dxxMap_;
         TripleBandLinearOp mapT_;
@@ -95,6 +96,8 @@ namespace QuantLib {
 
         Size size() const override;
         void setTime(Time t1, Time t2) override;
+        //! the operator is constant for flat rates without leverage or quanto
+        bool isTimeDependent() const override;
 
         Array apply(const Array& r) const override;
         Array apply_mixed(const Array& r) const override;
@@ -103,7 +106,15 @@ namespace QuantLib {
         Array solve_splitting(Size direction, const Array& r, Real s) const override;
         Array preconditioner(const Array& r, Real s) const override;
 
+        void apply_into(const Array& r, Array& out) const override;
+        void apply_mixed_into(const Array& r, Array& out) const override;
+        void apply_direction_into(Size direction,
+                                  const Array& r, Array& out) const override;
+        void solve_splitting_into(Size direction, const Array& r,
+                                  Real s, Array& out) const override;
+
         std::vector<SparseMatrix> toMatrixDecomp() const override;
+        std::vector<CsrMatrix> toCsrMatrixDecomp() const override;
 
       private:
         NinePointLinearOp correlationMap_;
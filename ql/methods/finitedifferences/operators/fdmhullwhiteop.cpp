@@ -89,5 +89,9 @@ namespace QuantLib {
         return std::vector<SparseMatrix>(1, mapT_.toMatrix());
     }
 
+    std::vector<CsrMatrix> FdmHullWhiteOp::toCsrMatrixDecomp() const {
+        return std::vector<CsrMatrix>(1, mapT_.toCsrMatrix());
+    }
+
 }
 
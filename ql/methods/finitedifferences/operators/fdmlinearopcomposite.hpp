@@ -39,12 +39,42 @@ namespace QuantLib {
         //! Time \f$t1 <= t2\f$ is required
         virtual void setTime(Time t1, Time t2) = 0;
 
+        /*! Returns false if setTime() leaves the operator unchanged,
+            up to rounding errors; this allows schemes to reuse
+            whatever they derived from it in previous steps.
+        */
+        virtual bool isTimeDependent() const { return true; }
+
         virtual Array apply_mixed(const Array& r) const = 0;
         
         virtual Array apply_direction(Size direction, const Array& r) const = 0;
         virtual Array solve_splitting(Size direction, const Array& r, Real s) const = 0;
         virtual Array preconditioner(const Array& r, Real s) const = 0;
 
+        /*! \name In-place variants
+            These write their result into a preallocated array, so
+            that schemes can reuse their buffers across time steps.
+            The default implementations forward to the methods above;
+            operators can override them to avoid allocations.
+            The output array must not be the same as the input one.
+        */
+        //@{
+        virtual void apply_into(const Array& r, Array& out) const {
+            out = apply(r);
+        }
+        virtual void apply_mixed_into(const Array& r, Array& out) const {
+            out = apply_mixed(r);
+        }
+        virtual void apply_direction_into(Size direction,
+                                          const Array& r, Array& out) const {
+            out = apply_direction(direction, r);
+        }
+        virtual void solve_splitting_into(Size direction, const Array& r,
+                                          Real s, Array& out) const {
+            out = solve_splitting(direction, r, s);
+        }
+        //@}
+
         virtual std::vector<SparseMatrix> toMatrixDecomp() const {
             QL_FAIL(" ublas representation is not implemented");
         }
@@ -55,6 +85,19 @@ namespace QuantLib {
                                    SparseMatrix(dcmp.front()));
         }
 
+        /*! The default implementation converts the terms returned
+            by toMatrixDecomp(); operators built from band operators
+            should override it to assemble their terms directly.
+        */
+        virtual std::vector<CsrMatrix> toCsrMatrixDecomp() const {
+            const std::vector<SparseMatrix> dcmp = toMatrixDecomp();
+            return std::vector<CsrMatrix>(dcmp.begin(), dcmp.end());
+        }
+
+        CsrMatrix toCsrMatrix() const override {
+            return sum(toCsrMatrixDecomp());
+        }
+
     };
 }
 
@@ -89,4 +89,8 @@ namespace QuantLib {
         return std::vector<SparseMatrix>(1, mapT_.toMatrix());
     }
 
+    std::vector<CsrMatrix> FdmLocalVolFwdOp::toCsrMatrixDecomp() const {
+        return std::vector<CsrMatrix>(1, mapT_.toCsrMatrix());
+    }
+
 }
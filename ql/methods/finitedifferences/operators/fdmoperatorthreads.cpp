@@ -0,0 +1,187 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/errors.hpp>
+#include <ql/methods/finitedifferences/operators/fdmoperatorthreads.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace QuantLib {
+
+    namespace {
+
+        thread_local FdmOperatorThreads* currentSetting = nullptr;
+
+        // minimum number of grid points worth a thread of their own
+        const Size minPointsPerTask = 8192;
+
+    }
+
+    // fork-join pool; the calling thread runs the first task and the
+    // i-th worker runs the (i+1)-th one
+    class FdmOperatorThreads::Pool {
+      public:
+        explicit Pool(Size workers);
+        ~Pool();
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
+
+        Size size() const { return workers_.size() + 1; }
+        void run(Size tasks, Task task, const void* context);
+
+      private:
+        void work(Size i);
+        void execute(Size i);
+        void stop();
+
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        std::condition_variable started_, done_;
+        Task task_ = nullptr;
+        const void* context_ = nullptr;
+        Size tasks_ = 0, pending_ = 0, generation_ = 0;
+        bool stopping_ = false;
+        std::vector<std::exception_ptr> errors_;
+    };
+
+    FdmOperatorThreads::Pool::Pool(Size workers) {
+        workers_.reserve(workers);
+        try {
+            for (Size i=1; i<=workers; ++i)
+                workers_.emplace_back([this, i]() { work(i); });
+        } catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    FdmOperatorThreads::Pool::~Pool() {
+        stop();
+    }
+
+    void FdmOperatorThreads::Pool::run(Size tasks, Task task,
+                                       const void* context) {
+        QL_REQUIRE(tasks <= size(), "too many tasks for the thread pool");
+        errors_.assign(tasks, std::exception_ptr());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = task;
+            context_ = context;
+            tasks_ = tasks;
+            pending_ = tasks - 1;
+            ++generation_;
+        }
+        started_.notify_all();
+
+        execute(0);
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this]() { return pending_ == 0; });
+        }
+
+        for (const auto& error : errors_) {
+            if (error)
+                std::rethrow_exception(error);
+        }
+    }
+
+    void FdmOperatorThreads::Pool::work(Size i) {
+        Size generation = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                started_.wait(lock, [&]() {
+                    return stopping_ || generation_ != generation;
+                });
+                if (stopping_)
+                    return;
+                generation = generation_;
+                if (i >= tasks_)
+                    continue;
+            }
+            execute(i);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--pending_ == 0)
+                    done_.notify_one();
+            }
+        }
+    }
+
+    void FdmOperatorThreads::Pool::execute(Size i) {
+        try {
+            task_(context_, i);
+        } catch (...) {
+            errors_[i] = std::current_exception();
+        }
+    }
+
+    void FdmOperatorThreads::Pool::stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        started_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable())
+                worker.join();
+        }
+    }
+
+
+    FdmOperatorThreads::FdmOperatorThreads(Size threads)
+    : threads_(threads), previous_(currentSetting) {
+        QL_REQUIRE(threads > 0, "at least one thread required");
+        currentSetting = this;
+    }
+
+    FdmOperatorThreads::~FdmOperatorThreads() {
+        currentSetting = previous_;
+    }
+
+    Size FdmOperatorThreads::current() {
+        return currentSetting != nullptr ? currentSetting->threads_ : 1;
+    }
+
+    Size FdmOperatorThreads::tasks(Size points) {
+        return std::max<Size>(
+            std::min(current(), points / minPointsPerTask), 1);
+    }
+
+    void FdmOperatorThreads::run(Size tasks, Task task, const void* context) {
+        // the pool is started at the first parallel call
+        QL_REQUIRE(currentSetting != nullptr && tasks <= current(),
+                   "too many tasks for the operator threads");
+        FdmOperatorThreads& setting = *currentSetting;
+        if (setting.pool_ == nullptr)
+            setting.pool_ = std::make_unique<Pool>(setting.threads_ - 1);
+
+        // operators used within the tasks run on a single thread
+        // rather than reentering the pool
+        struct Restore {
+            FdmOperatorThreads* setting;
+            ~Restore() { currentSetting = setting; }
+        } restore = { currentSetting };
+        currentSetting = nullptr;
+        setting.pool_->run(tasks, task, context);
+    }
+
+}
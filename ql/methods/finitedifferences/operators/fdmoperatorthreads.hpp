@@ -0,0 +1,101 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file fdmoperatorthreads.hpp
+    \brief number of threads used by finite-difference operators
+*/
+
+#ifndef quantlib_fdm_operator_threads_hpp
+#define quantlib_fdm_operator_threads_hpp
+
+#include <ql/utilities/parallel.hpp>
+#include <algorithm>
+#include <memory>
+
+namespace QuantLib {
+
+    //! number of threads used by finite-difference operators
+    /*! An instance sets the number of threads used by
+        TripleBandLinearOp and NinePointLinearOp when they are applied
+        or solved on the calling thread; the previous setting is
+        restored when the instance goes out of scope.  The setting is
+        kept per thread, so that calculations running concurrently on
+        different threads don't interfere with each other.
+
+        The worker threads are started when an operator is first
+        split among them, and are reused for each following
+        application or solution until the instance is destroyed; an
+        instance should therefore enclose a whole calculation, e.g., a
+        rollback, rather than a single step.  Operators on small grids
+        are not split among threads, since the cost of synchronizing
+        them would outweigh the gain.
+    */
+    class FdmOperatorThreads {
+      public:
+        explicit FdmOperatorThreads(Size threads);
+        ~FdmOperatorThreads();
+        FdmOperatorThreads(const FdmOperatorThreads&) = delete;
+        FdmOperatorThreads& operator=(const FdmOperatorThreads&) = delete;
+
+        //! number of threads set for the calling thread
+        static Size current();
+        //! number of tasks into which the given number of points are split
+        static Size tasks(Size points);
+
+        //! calls <tt>f(from, to)</tt> on contiguous blocks covering [0, n)
+        /*! The blocks are processed in parallel when the underlying
+            grid, having the given number of points, is large enough.
+        */
+        template <class F>
+        static void forEachBlock(Size n, Size points, const F& f);
+
+      private:
+        class Pool;
+        typedef void (*Task)(const void* context, Size i);
+        //! calls <tt>task(context, i)</tt> for each i in [0, tasks)
+        static void run(Size tasks, Task task, const void* context);
+
+        Size threads_;
+        FdmOperatorThreads* previous_;
+        std::unique_ptr<Pool> pool_;
+    };
+
+
+    template <class F>
+    inline void FdmOperatorThreads::forEachBlock(Size n, Size points,
+                                                 const F& f) {
+        const Size nTasks = std::min(tasks(points), std::max<Size>(n, 1));
+        const Size blockSize = detail::parallelBlockSize(n, nTasks);
+        const auto block = [&](Size task) {
+            const Size from = std::min(task*blockSize, n);
+            f(from, std::min(from+blockSize, n));
+        };
+        if (nTasks == 1) {
+            block(0);
+        } else {
+            typedef decltype(block) Block;
+            run(nTasks,
+                [](const void* context, Size task) {
+                    (*static_cast<const Block*>(context))(task);
+                },
+                &block);
+        }
+    }
+
+}
+
+#endif
@@ -104,4 +104,12 @@ namespace QuantLib {
         };
     }
 
+    std::vector<CsrMatrix> FdmSabrOp::toCsrMatrixDecomp() const {
+        return {
+            mapA_.toCsrMatrix(),
+            mapF_.toCsrMatrix(),
+            correlationMap_.toCsrMatrix()
+        };
+    }
+
 }
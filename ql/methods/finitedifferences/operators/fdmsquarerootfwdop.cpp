@@ -324,4 +324,8 @@ namespace QuantLib {
         return std::vector<SparseMatrix>(1, mapX_->toMatrix());
     }
 
+    std::vector<CsrMatrix> FdmSquareRootFwdOp::toCsrMatrixDecomp() const {
+        return std::vector<CsrMatrix>(1, mapX_->toCsrMatrix());
+    }
+
 }
@@ -53,6 +53,7 @@ namespace QuantLib {
         Array preconditioner(const Array& r, Real s) const override;
 
         std::vector<SparseMatrix> toMatrixDecomp() const override;
+        std::vector<CsrMatrix> toCsrMatrixDecomp() const override;
 
         Real lowerBoundaryFactor(TransformationType type = Plain) const;
         Real upperBoundaryFactor(TransformationType type = Plain) const;
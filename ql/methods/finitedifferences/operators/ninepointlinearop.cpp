@@ -21,6 +21,7 @@
 
 #include <ql/methods/finitedifferences/meshers/fdmmesher.hpp>
 #include <ql/methods/finitedifferences/operators/fdmlinearoplayout.hpp>
+#include <ql/methods/finitedifferences/operators/fdmoperatorthreads.hpp>
 #include <ql/methods/finitedifferences/operators/ninepointlinearop.hpp>
 
 namespace QuantLib {
@@ -108,11 +109,20 @@ namespace QuantLib {
     }
 
     Array NinePointLinearOp::apply(const Array& u) const {
+        Array retVal(u.size());
+        apply_into(u, retVal);
+        return retVal;
+    }
+
+    void NinePointLinearOp::apply_into(const Array& u, Array& retVal) const {
 
         QL_REQUIRE(u.size() == mesher_->layout()->size(),"inconsistent length of r "
                     << u.size() << " vs " << mesher_->layout()->size());
+        QL_REQUIRE(&u != &retVal, "input and output arrays must differ");
+
+        if (retVal.size() != u.size())
+            retVal = Array(u.size());
 
-        Array retVal(u.size());
         // direct access to make the following code faster.
         const Real *a00(a00_.get()), *a01(a01_.get()), *a02(a02_.get());
         const Real *a10(a10_.get()), *a11(a11_.get()), *a12(a12_.get());
@@ -121,38 +131,46 @@ namespace QuantLib {
         const Size *i10(i10_.get()),                   *i12(i12_.get());
         const Size *i20(i20_.get()), *i21(i21_.get()), *i22(i22_.get());
 
-        //#pragma omp parallel for
-        for (Size i=0; i < retVal.size(); ++i) {
-            retVal[i] =   a00[i]*u[i00[i]]
-                        + a01[i]*u[i01[i]]
-                        + a02[i]*u[i02[i]]
-                        + a10[i]*u[i10[i]]
-                        + a11[i]*u[i]
-                        + a12[i]*u[i12[i]]
-                        + a20[i]*u[i20[i]]
-                        + a21[i]*u[i21[i]]
-                        + a22[i]*u[i22[i]];
-        }
-        return retVal;
+        const Size size = retVal.size();
+        FdmOperatorThreads::forEachBlock(size, size, [&](Size from, Size to) {
+            for (Size i=from; i < to; ++i) {
+                retVal[i] =   a00[i]*u[i00[i]]
+                            + a01[i]*u[i01[i]]
+                            + a02[i]*u[i02[i]]
+                            + a10[i]*u[i10[i]]
+                            + a11[i]*u[i]
+                            + a12[i]*u[i12[i]]
+                            + a20[i]*u[i20[i]]
+                            + a21[i]*u[i21[i]]
+                            + a22[i]*u[i22[i]];
+            }
+        });
     }
 
     SparseMatrix NinePointLinearOp::toMatrix() const {
+        return toCsrMatrix().toSparseMatrix();
+    }
+
+    CsrMatrix NinePointLinearOp::toCsrMatrix() const {
         const Size n = mesher_->layout()->size();
 
-        SparseMatrix retVal(n, n, 9*n);
-        for (Size i=0; i < mesher_->layout()->size(); ++i) {
-            retVal(i, i00_[i]) += a00_[i];
-            retVal(i, i01_[i]) += a01_[i];
-            retVal(i, i02_[i]) += a02_[i];
-            retVal(i, i10_[i]) += a10_[i];
-            retVal(i, i      ) += a11_[i];
-            retVal(i, i12_[i]) += a12_[i];
-            retVal(i, i20_[i]) += a20_[i];
-            retVal(i, i21_[i]) += a21_[i];
-            retVal(i, i22_[i]) += a22_[i];
+        std::vector<Size> offsets(n+1, 0), indices;
+        std::vector<Real> values;
+        indices.reserve(9*n);
+        values.reserve(9*n);
+
+        for (Size i=0; i < n; ++i) {
+            std::pair<Size, Real> row[] = {
+                {i00_[i], a00_[i]}, {i01_[i], a01_[i]}, {i02_[i], a02_[i]},
+                {i10_[i], a10_[i]}, {i,       a11_[i]}, {i12_[i], a12_[i]},
+                {i20_[i], a20_[i]}, {i21_[i], a21_[i]}, {i22_[i], a22_[i]}
+            };
+            detail::appendCsrRow(std::begin(row), std::end(row),
+                                 indices, values);
+            offsets[i+1] = values.size();
         }
 
-        return retVal;
+        return {n, n, std::move(offsets), std::move(indices), std::move(values)};
     }
 
 
@@ -45,11 +45,14 @@ namespace QuantLib {
         ~NinePointLinearOp() override = default;
 
         Array apply(const Array& r) const override;
+        //! in-place version of apply; out must not be the same as r
+        void apply_into(const Array& r, Array& out) const;
         NinePointLinearOp mult(const Array& u) const;
 
         void swap(NinePointLinearOp& m) noexcept;
 
         SparseMatrix toMatrix() const override;
+        CsrMatrix toCsrMatrix() const override;
 
       protected:
         NinePointLinearOp() = default;
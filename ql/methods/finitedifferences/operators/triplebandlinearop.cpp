@@ -23,38 +23,41 @@
 #include <ql/methods/finitedifferences/meshers/fdmmesher.hpp>
 #include <ql/methods/finitedifferences/tridiagonaloperator.hpp>
 #include <ql/methods/finitedifferences/operators/fdmlinearoplayout.hpp>
+#include <ql/methods/finitedifferences/operators/fdmoperatorthreads.hpp>
 #include <ql/methods/finitedifferences/operators/triplebandlinearop.hpp>
+#include <algorithm>
 
 namespace QuantLib {
 
+    namespace {
+
+        // scratch space for solve_splitting_into; it's kept per
+        // thread, since operators might be solved concurrently
+        Array& workspace(Size size) {
+            thread_local Array workspace;
+            if (workspace.size() < size)
+                workspace = Array(size);
+            return workspace;
+        }
+
+    }
+
     TripleBandLinearOp::TripleBandLinearOp(
         Size direction,
         const ext::shared_ptr<FdmMesher>& mesher)
     : direction_(direction),
       i0_       (new Size[mesher->layout()->size()]),
       i2_       (new Size[mesher->layout()->size()]),
-      reverseIndex_ (new Size[mesher->layout()->size()]),
       lower_    (new Real[mesher->layout()->size()]),
       diag_     (new Real[mesher->layout()->size()]),
       upper_    (new Real[mesher->layout()->size()]),
       mesher_(mesher) {
 
-        std::vector<Size> newDim(mesher->layout()->dim());
-        std::iter_swap(newDim.begin(), newDim.begin()+direction_);
-        std::vector<Size> newSpacing = FdmLinearOpLayout(newDim).spacing();
-        std::iter_swap(newSpacing.begin(), newSpacing.begin()+direction_);
-
         for (const auto& iter : *mesher->layout()) {
             const Size i = iter.index();
 
             i0_[i] = mesher->layout()->neighbourhood(iter, direction, -1);
             i2_[i] = mesher->layout()->neighbourhood(iter, direction,  1);
-
-            const std::vector<Size>& coordinates = iter.coordinates();
-            const Size newIndex =
-                  std::inner_product(coordinates.begin(), coordinates.end(),
-                                     newSpacing.begin(), Size(0));
-            reverseIndex_[newIndex] = i;
         }
     }
 
@@ -62,7 +65,6 @@ namespace QuantLib {
     : direction_(m.direction_),
       i0_   (new Size[m.mesher_->layout()->size()]),
       i2_   (new Size[m.mesher_->layout()->size()]),
-      reverseIndex_(new Size[m.mesher_->layout()->size()]),
       lower_(new Real[m.mesher_->layout()->size()]),
       diag_ (new Real[m.mesher_->layout()->size()]),
       upper_(new Real[m.mesher_->layout()->size()]),
@@ -70,8 +72,6 @@ namespace QuantLib {
         const Size len = m.mesher_->layout()->size();
         std::copy(m.i0_.get(), m.i0_.get() + len, i0_.get());
         std::copy(m.i2_.get(), m.i2_.get() + len, i2_.get());
-        std::copy(m.reverseIndex_.get(), m.reverseIndex_.get()+len,
-                  reverseIndex_.get());
         std::copy(m.lower_.get(), m.lower_.get() + len, lower_.get());
         std::copy(m.diag_.get(),  m.diag_.get() + len,  diag_.get());
         std::copy(m.upper_.get(), m.upper_.get() + len, upper_.get());
@@ -82,7 +82,6 @@ namespace QuantLib {
         std::swap(direction_, m.direction_);
 
         i0_.swap(m.i0_); i2_.swap(m.i2_);
-        reverseIndex_.swap(m.reverseIndex_);
         lower_.swap(m.lower_); diag_.swap(m.diag_); upper_.swap(m.upper_);
     }
 
@@ -222,7 +221,17 @@ namespace QuantLib {
     }
 
     Array TripleBandLinearOp::apply(const Array& r) const {
+        array_type retVal(r.size());
+        apply_into(r, retVal);
+        return retVal;
+    }
+
+    void TripleBandLinearOp::apply_into(const Array& r, Array& retVal) const {
         QL_REQUIRE(r.size() == mesher_->layout()->size(), "inconsistent length of r");
+        QL_REQUIRE(&r != &retVal, "input and output arrays must differ");
+
+        if (retVal.size() != r.size())
+            retVal = Array(r.size());
 
         const Real* lptr = lower_.get();
         const Real* dptr = diag_.get();
@@ -230,30 +239,54 @@ namespace QuantLib {
         const Size* i0ptr = i0_.get();
         const Size* i2ptr = i2_.get();
 
-        array_type retVal(r.size());
-        //#pragma omp parallel for
-        for (Size i=0; i < mesher_->layout()->size(); ++i) {
-            retVal[i] = r[i0ptr[i]]*lptr[i]+r[i]*dptr[i]+r[i2ptr[i]]*uptr[i];
-        }
-
-        return retVal;
+        const Size size = mesher_->layout()->size();
+        FdmOperatorThreads::forEachBlock(size, size, [&](Size from, Size to) {
+            for (Size i=from; i < to; ++i) {
+                retVal[i] = r[i0ptr[i]]*lptr[i]+r[i]*dptr[i]+r[i2ptr[i]]*uptr[i];
+            }
+        });
     }
 
     SparseMatrix TripleBandLinearOp::toMatrix() const {
+        return toCsrMatrix().toSparseMatrix();
+    }
+
+    CsrMatrix TripleBandLinearOp::toCsrMatrix() const {
         const Size n = mesher_->layout()->size();
 
-        SparseMatrix retVal(n, n, 3*n);
+        std::vector<Size> offsets(n+1, 0), indices;
+        std::vector<Real> values;
+        indices.reserve(3*n);
+        values.reserve(3*n);
+
         for (Size i=0; i < n; ++i) {
-            retVal(i, i0_[i]) += lower_[i];
-            retVal(i, i     ) += diag_[i];
-            retVal(i, i2_[i]) += upper_[i];
+            std::pair<Size, Real> row[] = {
+                {i0_[i], lower_[i]}, {i, diag_[i]}, {i2_[i], upper_[i]}
+            };
+            detail::appendCsrRow(std::begin(row), std::end(row),
+                                 indices, values);
+            offsets[i+1] = values.size();
         }
 
-        return retVal;
+        return {n, n, std::move(offsets), std::move(indices), std::move(values)};
     }
 
 
     Array TripleBandLinearOp::solve_splitting(const Array& r, Real a, Real b) const {
+        Array retVal(r.size()), tmp(r.size());
+        solve(r, a, b, retVal, tmp);
+        return retVal;
+    }
+
+    void TripleBandLinearOp::solve_splitting_into(const Array& r, Real a, Real b,
+                                                  Array& out) const {
+        if (out.size() != r.size())
+            out = Array(r.size());
+        solve(r, a, b, out, workspace(r.size()));
+    }
+
+    void TripleBandLinearOp::solve(const Array& r, Real a, Real b,
+                                   Array& retVal, Array& tmp) const {
         QL_REQUIRE(r.size() == mesher_->layout()->size(), "inconsistent size of rhs");
 
 #ifdef QL_EXTRA_SAFETY_CHECKS
@@ -266,36 +299,86 @@ namespace QuantLib {
         }
 #endif
 
-        Array retVal(r.size()), tmp(r.size());
+        // The system splits into independent tridiagonal systems, one
+        // for each line along the direction, since the entries coupling
+        // the ends of neighbouring lines are zero; the lines are solved
+        // in parallel on large grids.
+        const Size size = mesher_->layout()->size();
+        const Size lines = size/mesher_->layout()->dim()[direction_];
+        FdmOperatorThreads::forEachBlock(lines, size, [&](Size from, Size to) {
+            solveLines(r, a, b, retVal, tmp, from, to);
+        });
+    }
 
+    void TripleBandLinearOp::solveLines(const Array& r, Real a, Real b,
+                                        Array& retVal, Array& tmp,
+                                        Size from, Size to) const {
+        // retVal can be the same array as r, since each element of
+        // r is read before the corresponding element of retVal is
+        // written and never used afterwards.
         const Real* lptr = lower_.get();
         const Real* dptr = diag_.get();
         const Real* uptr = upper_.get();
 
-        // Thomson algorithm to solve a tridiagonal system.
-        // Example code taken from Tridiagonalopertor and
-        // changed to fit for the triple band operator.
-        Size rim1 = reverseIndex_[0];
-        Real bet=1.0/(a*dptr[rim1]+b);
-        QL_REQUIRE(bet != 0.0, "division by zero");
-        retVal[reverseIndex_[0]] = r[rim1]*bet;
+        // The points form a panel for each value of the coordinates
+        // above the direction.  Within a panel, the j-th points of the
+        // lines along the direction are stored next to each other,
+        // starting at j*stride; the k-th line of the panel is made of
+        // the k-th points of these rows.  Lines are numbered panel by
+        // panel, and a chunk of neighbouring lines is swept together,
+        // so that memory is read in contiguous runs without any
+        // transposition.  Along the first direction each line is a
+        // panel of its own, and a few of them are interleaved instead
+        // to hide the latency of the recursion.
+        const Size length = mesher_->layout()->dim()[direction_];
+        const Size stride = mesher_->layout()->spacing()[direction_];
+        const Size step = (stride == 1) ? length : 1;
+
+        const Size chunkSize = 64, interleavedLines = 4;
+        Real bet[chunkSize];
+
+        for (Size l=from; l < to;) {
+            const Size panel = l/stride;
+            const Size k0 = l - panel*stride;
+            const Size m = (stride == 1)
+                ? std::min(interleavedLines, to-l)
+                : std::min({chunkSize, stride-k0, to-l});
+            const Size first = panel*length*stride + k0;
+
+            // Thomson algorithm to solve a tridiagonal system.
+            // Example code taken from Tridiagonalopertor and
+            // changed to fit for the triple band operator.
+            for (Size k=0; k < m; ++k) {
+                const Size i = first + k*step;
+                bet[k] = 1.0/(a*dptr[i]+b);
+                QL_REQUIRE(bet[k] != 0.0, "division by zero");
+                retVal[i] = r[i]*bet[k];
+            }
 
-        for (Size j=1; j<=mesher_->layout()->size()-1; j++){
-            const Size ri = reverseIndex_[j];
-            tmp[j] = a*uptr[rim1]*bet;
+            for (Size j=1; j < length; ++j) {
+                const Size row = first + j*stride;
+                for (Size k=0; k < m; ++k) {
+                    const Size i = row + k*step;
+                    const Size im1 = i - stride;
+                    tmp[i] = a*uptr[im1]*bet[k];
 
-            bet=b+a*(dptr[ri]-tmp[j]*lptr[ri]);
-            QL_ENSURE(bet != 0.0, "division by zero");
-            bet=1.0/bet;
+                    const Real d = b+a*(dptr[i]-tmp[i]*lptr[i]);
+                    QL_ENSURE(d != 0.0, "division by zero");
+                    bet[k] = 1.0/d;
 
-            retVal[ri] = (r[ri]-a*lptr[ri]*retVal[rim1])*bet;
-            rim1 = ri;
-        }
-        // cannot be j>=0 with Size j
-        for (Size j=mesher_->layout()->size()-2; j>0; --j)
-            retVal[reverseIndex_[j]] -= tmp[j+1]*retVal[reverseIndex_[j+1]];
-        retVal[reverseIndex_[0]] -= tmp[1]*retVal[reverseIndex_[1]];
+                    retVal[i] = (r[i]-a*lptr[i]*retVal[im1])*bet[k];
+                }
+            }
 
-        return retVal;
+            for (Size j=length-1; j > 0; --j) {
+                const Size row = first + j*stride;
+                for (Size k=0; k < m; ++k) {
+                    const Size i = row + k*step;
+                    retVal[i-stride] -= tmp[i]*retVal[i];
+                }
+            }
+
+            l += m;
+        }
     }
 }
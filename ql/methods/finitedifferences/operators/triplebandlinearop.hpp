@@ -48,6 +48,13 @@ namespace QuantLib {
         Array apply(const Array& r) const override;
         Array solve_splitting(const Array& r, Real a, Real b = 1.0) const;
 
+        /*! in-place versions of the above, writing into a
+            preallocated array; out must not be the same as r in
+            apply_into.
+        */
+        void apply_into(const Array& r, Array& out) const;
+        void solve_splitting_into(const Array& r, Real a, Real b, Array& out) const;
+
         TripleBandLinearOp mult(const Array& u) const;
         // interpret u as the diagonal of a diagonal matrix, multiplied on LHS
         TripleBandLinearOp multR(const Array& u) const;
@@ -62,13 +69,17 @@ namespace QuantLib {
         void swap(TripleBandLinearOp& m) noexcept;
 
         SparseMatrix toMatrix() const override;
+        CsrMatrix toCsrMatrix() const override;
 
       protected:
         TripleBandLinearOp() = default;
 
+        void solve(const Array& r, Real a, Real b, Array& retVal, Array& tmp) const;
+        void solveLines(const Array& r, Real a, Real b, Array& retVal,
+                        Array& tmp, Size from, Size to) const;
+
         Size direction_;
         std::unique_ptr<Size[]> i0_, i2_;
-        std::unique_ptr<Size[]> reverseIndex_;
         std::unique_ptr<Real[]> lower_, diag_, upper_;
 
         ext::shared_ptr<FdmMesher> mesher_;
@@ -33,17 +33,25 @@ namespace QuantLib {
         map_->setTime(std::max(0.0, t-dt_), t);
         bcSet_.setTime(std::max(0.0, t-dt_));
 
+        // the operations are carried out in place on buffers that
+        // are reused across steps, and lazy expressions fuse the
+        // element-wise updates into single loops; the results are
+        // the same as
+        //   y = a + dt*A(a)
+        //   y = solve_i(y - theta*dt*A_i(a))
         bcSet_.applyBeforeApplying(*map_);
-        Array y = a + dt_*map_->apply(a);
-        bcSet_.applyAfterApplying(y);
+        map_->apply_into(a, y_);
+        y_ = lazy(y_)*dt_ + a;
+        bcSet_.applyAfterApplying(y_);
 
         for (Size i=0; i < map_->size(); ++i) {
-            Array rhs = y - theta_*dt_*map_->apply_direction(i, a);
-            y = map_->solve_splitting(i, rhs, -theta_*dt_);
+            map_->apply_direction_into(i, a, rhs_);
+            rhs_ = lazy(rhs_)*(-theta_*dt_) + y_;
+            map_->solve_splitting_into(i, rhs_, -theta_*dt_, y_);
         }
-        bcSet_.applyAfterSolving(y);
+        bcSet_.applyAfterSolving(y_);
 
-        a = y;
+        a.swap(y_);
     }
 
     void DouglasScheme::setStep(Time dt) {
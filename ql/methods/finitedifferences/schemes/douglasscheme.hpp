@@ -54,6 +54,9 @@ namespace QuantLib {
         const Real theta_;
         const ext::shared_ptr<FdmLinearOpComposite> map_;
         const BoundaryConditionSchemeHelper bcSet_;
+
+        // buffers reused across steps
+        array_type y_, rhs_;
     };
 }
 
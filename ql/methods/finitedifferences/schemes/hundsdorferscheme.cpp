@@ -36,28 +36,39 @@ namespace QuantLib {
         map_->setTime(std::max(0.0, t-dt_), t);
         bcSet_.setTime(std::max(0.0, t-dt_));
 
+        // the operations are carried out in place on buffers that
+        // are reused across steps, and lazy expressions fuse the
+        // element-wise updates into single loops; the results are
+        // the same as
+        //   y  = a + dt*A(a),       y  = solve_i(y  - theta*dt*A_i(a))
+        //   yt = y0 + mu*dt*A(y-a), yt = solve_i(yt - theta*dt*A_i(y))
         bcSet_.applyBeforeApplying(*map_);
-        Array y = a + dt_*map_->apply(a);
-        bcSet_.applyAfterApplying(y);
+        map_->apply_into(a, y_);
+        y_ = lazy(y_)*dt_ + a;
+        bcSet_.applyAfterApplying(y_);
 
-        Array y0 = y;
+        y0_ = y_;
 
         for (Size i=0; i < map_->size(); ++i) {
-            Array rhs = y - theta_*dt_*map_->apply_direction(i, a);
-            y = map_->solve_splitting(i, rhs, -theta_*dt_);
+            map_->apply_direction_into(i, a, rhs_);
+            rhs_ = lazy(rhs_)*(-theta_*dt_) + y_;
+            map_->solve_splitting_into(i, rhs_, -theta_*dt_, y_);
         }
 
         bcSet_.applyBeforeApplying(*map_);
-        Array yt = y0 + mu_*dt_*map_->apply(y-a);
-        bcSet_.applyAfterApplying(yt);
+        diff_ = lazy(y_) - a;
+        map_->apply_into(diff_, yt_);
+        yt_ = lazy(yt_)*(mu_*dt_) + y0_;
+        bcSet_.applyAfterApplying(yt_);
 
         for (Size i=0; i < map_->size(); ++i) {
-            Array rhs = yt - theta_*dt_*map_->apply_direction(i, y);
-            yt = map_->solve_splitting(i, rhs, -theta_*dt_);
+            map_->apply_direction_into(i, y_, rhs_);
+            rhs_ = lazy(rhs_)*(-theta_*dt_) + yt_;
+            map_->solve_splitting_into(i, rhs_, -theta_*dt_, yt_);
         }
-        bcSet_.applyAfterSolving(yt);
+        bcSet_.applyAfterSolving(yt_);
 
-        a = yt;
+        a.swap(yt_);
     }
 
     void HundsdorferScheme::setStep(Time dt) {
@@ -60,6 +60,9 @@ namespace QuantLib {
 
         const ext::shared_ptr<FdmLinearOpComposite> map_;
         const BoundaryConditionSchemeHelper bcSet_;
+
+        // buffers reused across steps
+        array_type y_, y0_, yt_, diff_, rhs_;
     };
 }
 
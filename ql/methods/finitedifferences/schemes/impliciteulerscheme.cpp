@@ -22,7 +22,9 @@
 #include <ql/functional.hpp>
 #include <ql/math/matrixutilities/bicgstab.hpp>
 #include <ql/math/matrixutilities/gmres.hpp>
+#include <ql/math/matrixutilities/sparseamgpreconditioner.hpp>
 #include <ql/methods/finitedifferences/schemes/impliciteulerscheme.hpp>
+#include <algorithm>
 #include <utility>
 
 namespace QuantLib {
@@ -30,14 +32,37 @@ namespace QuantLib {
     ImplicitEulerScheme::ImplicitEulerScheme(ext::shared_ptr<FdmLinearOpComposite> map,
                                              const bc_set& bcSet,
                                              Real relTol,
-                                             SolverType solverType)
+                                             SolverType solverType,
+                                             PreconditionerType preconditionerType)
     : dt_(Null<Real>()), iterations_(ext::make_shared<Size>(0U)), relTol_(relTol),
-      map_(std::move(map)), bcSet_(bcSet), solverType_(solverType) {}
+      map_(std::move(map)), bcSet_(bcSet), solverType_(solverType),
+      preconditionerType_(preconditionerType),
+      amgSetups_(ext::make_shared<Size>(0U)) {}
 
     Array ImplicitEulerScheme::apply(const Array& r, Real theta) const {
         return r - (theta*dt_)*map_->apply(r);
     }
 
+    CsrMatrix ImplicitEulerScheme::systemMatrix(const CsrMatrix& m,
+                                                Real theta) const {
+        const Size n = m.rows();
+
+        std::vector<Real> values(m.values());
+        for (Real& v : values)
+            v *= -theta*dt_;
+
+        std::vector<Size> identityOffsets(n+1), identityIndices(n);
+        for (Size i=0; i < n; ++i) {
+            identityOffsets[i+1] = i+1;
+            identityIndices[i] = i;
+        }
+
+        return CsrMatrix(n, n, std::move(identityOffsets),
+                         std::move(identityIndices), std::vector<Real>(n, 1.0))
+            + CsrMatrix(n, n, m.rowOffsets(), m.columnIndices(),
+                        std::move(values));
+    }
+
     void ImplicitEulerScheme::step(array_type& a, Time t) {
         step(a, t, 1.0);
     }
@@ -53,7 +78,23 @@ namespace QuantLib {
             a = map_->solve_splitting(0, a, -theta*dt_);
         }
         else {
-            auto preconditioner = [&](const Array& _a){ return map_->preconditioner(_a, -theta*dt_); };
+            std::function<Array(const Array&)> preconditioner;
+            if (preconditionerType_ == Multigrid) {
+                // the setup is expensive; it's only repeated when the
+                // system matrix changes, i.e., for a different step or
+                // theta, or for an operator depending on time.
+                if (amg_ == nullptr || theta*dt_ != amgScale_
+                    || map_->isTimeDependent()) {
+                    amg_ = ext::make_shared<SparseAMGPreconditioner>(
+                        systemMatrix(map_->toCsrMatrix(), theta));
+                    amgScale_ = theta*dt_;
+                    ++(*amgSetups_);
+                }
+                const auto amg = amg_;
+                preconditioner = [amg](const Array& _a){ return amg->apply(_a); };
+            }
+            else
+                preconditioner = [&](const Array& _a){ return map_->preconditioner(_a, -theta*dt_); };
             auto applyF = [&](const Array& _a){ return apply(_a, theta); };
 
             if (solverType_ == BiCGstab) {
@@ -86,4 +127,8 @@ namespace QuantLib {
     Size ImplicitEulerScheme::numberOfIterations() const {
         return *iterations_;
     }
+
+    Size ImplicitEulerScheme::numberOfPreconditionerSetups() const {
+        return *amgSetups_;
+    }
 }
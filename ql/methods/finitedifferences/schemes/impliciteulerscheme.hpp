@@ -32,9 +32,27 @@
 
 namespace QuantLib {
 
+    class SparseAMGPreconditioner;
+
+    //! Implicit-Euler scheme
+    /*! The linear system of each step is solved iteratively.  By
+        default, the solver is preconditioned by the operator
+        splitting of the composite operator; the Multigrid
+        preconditioner assembles the system matrix and applies an
+        algebraic multigrid cycle instead, which keeps the number of
+        iterations low on fine multi-dimensional grids.  Its setup is
+        reused as long as the system matrix doesn't change, i.e., it's
+        repeated only when the step size changes or the operator
+        depends on time (see FdmLinearOpComposite::isTimeDependent).
+        It requires the operator to provide its matrix decomposition.
+
+        Copies of the scheme, e.g., the ones made by the finite
+        difference models, share the iteration and setup counters.
+    */
     class ImplicitEulerScheme {
       public:
         enum SolverType { BiCGstab, GMRES };
+        enum PreconditionerType { Splitting, Multigrid };
 
         // typedefs
         typedef OperatorTraits<FdmLinearOp> traits;
@@ -47,17 +65,24 @@ namespace QuantLib {
         explicit ImplicitEulerScheme(ext::shared_ptr<FdmLinearOpComposite> map,
                                      const bc_set& bcSet = bc_set(),
                                      Real relTol = 1e-8,
-                                     SolverType solverType = BiCGstab);
+                                     SolverType solverType = BiCGstab,
+                                     PreconditionerType preconditionerType
+                                         = Splitting);
 
         void step(array_type& a, Time t);
         void setStep(Time dt);
 
         Size numberOfIterations() const;
+        //! number of times the multigrid preconditioner was set up
+        Size numberOfPreconditionerSetups() const;
       protected:
         friend class CrankNicolsonScheme;
         void step(array_type& a, Time t, Real theta);
 
         Array apply(const Array& r, Real theta) const;
+        // matrix of the linear system solved by step(a, t, theta),
+        // given the matrix of the operator
+        CsrMatrix systemMatrix(const CsrMatrix& m, Real theta) const;
           
         Time dt_;
         ext::shared_ptr<Size> iterations_;
@@ -66,6 +91,12 @@ namespace QuantLib {
         const ext::shared_ptr<FdmLinearOpComposite> map_;
         const BoundaryConditionSchemeHelper bcSet_;
         const SolverType solverType_;
+        const PreconditionerType preconditionerType_;
+
+        // multigrid preconditioner and the theta*dt it was set up for
+        ext::shared_ptr<SparseAMGPreconditioner> amg_;
+        Real amgScale_ = Null<Real>();
+        ext::shared_ptr<Size> amgSetups_;
     };
 }
 
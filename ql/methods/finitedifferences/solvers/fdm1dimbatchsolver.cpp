@@ -0,0 +1,202 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/math/interpolations/cubicinterpolation.hpp>
+#include <ql/methods/finitedifferences/meshers/fdmmesher.hpp>
+#include <ql/methods/finitedifferences/operators/fdmlinearoplayout.hpp>
+#include <ql/methods/finitedifferences/solvers/fdm1dimbatchsolver.hpp>
+#include <ql/methods/finitedifferences/stepconditions/fdmsnapshotcondition.hpp>
+#include <ql/methods/finitedifferences/stepconditions/fdmstepconditioncomposite.hpp>
+#include <ql/methods/finitedifferences/utilities/fdminnervaluecalculator.hpp>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace QuantLib {
+
+    namespace {
+
+        // sets the values of the payoffs expiring at a stopping time
+        // to their inner values
+        class FdmBatchMaturityCondition : public StepCondition<Array> {
+          public:
+            FdmBatchMaturityCondition(ext::shared_ptr<FdmMesher> mesher,
+                                      ext::shared_ptr<FdmInnerValueCalculator> calculator,
+                                      std::vector<Time> maturities)
+            : mesher_(std::move(mesher)), calculator_(std::move(calculator)),
+              maturities_(std::move(maturities)) {}
+
+            void applyTo(Array& a, Time t) const override {
+                if (std::find(maturities_.begin(), maturities_.end(), t)
+                        == maturities_.end())
+                    return;
+
+                for (const auto& iter : *mesher_->layout()) {
+                    if (maturities_[iter.coordinates()[1]] == t)
+                        a[iter.index()] = calculator_->avgInnerValue(iter, t);
+                }
+            }
+
+          private:
+            const ext::shared_ptr<FdmMesher> mesher_;
+            const ext::shared_ptr<FdmInnerValueCalculator> calculator_;
+            const std::vector<Time> maturities_;
+        };
+
+    }
+
+    Fdm1DimBatchSolver::Fdm1DimBatchSolver(
+                                const FdmSolverDesc& solverDesc,
+                                std::vector<Time> maturities,
+                                const FdmSchemeDesc& schemeDesc,
+                                ext::shared_ptr<FdmLinearOpComposite> op)
+    : solverDesc_(solverDesc), maturities_(std::move(maturities)),
+      schemeDesc_(schemeDesc), op_(std::move(op)),
+      thetaCondition_(ext::make_shared<FdmSnapshotCondition>(
+          0.99 * std::min(1.0 / 365.0,
+                          solverDesc.condition->stoppingTimes().empty() ?
+                              *std::min_element(maturities_.begin(),
+                                                maturities_.end()) :
+                              std::min(solverDesc.condition->stoppingTimes().front(),
+                                       *std::min_element(maturities_.begin(),
+                                                         maturities_.end()))))),
+      x_(solverDesc.mesher->layout()->dim()[0]),
+      initialValues_(solverDesc.mesher->layout()->size(), 0.0),
+      resultValues_(solverDesc.mesher->layout()->size()),
+      interpolations_(maturities_.size()) {
+
+        const ext::shared_ptr<FdmLinearOpLayout> layout =
+            solverDesc.mesher->layout();
+        QL_REQUIRE(layout->dim().size() == 2,
+                   "two-dimensional mesher required");
+        QL_REQUIRE(layout->dim()[1] == maturities_.size(),
+                   "number of maturities (" << maturities_.size()
+                   << ") differs from the size of the batch direction ("
+                   << layout->dim()[1] << ")");
+
+        for (Time maturity : maturities_) {
+            QL_REQUIRE(maturity > 0.0 && maturity <= solverDesc.maturity,
+                       "maturity " << maturity << " out of range (0, "
+                       << solverDesc.maturity << "]");
+            if (maturity < solverDesc.maturity)
+                earlierMaturities_.push_back(maturity);
+        }
+        std::sort(earlierMaturities_.begin(), earlierMaturities_.end());
+        earlierMaturities_.erase(
+            std::unique(earlierMaturities_.begin(), earlierMaturities_.end()),
+            earlierMaturities_.end());
+
+        for (const auto& iter : *layout) {
+            const Size i = iter.coordinates()[1];
+            if (maturities_[i] == solverDesc.maturity)
+                initialValues_[iter.index()]
+                    = solverDesc_.calculator->avgInnerValue(
+                        iter, solverDesc.maturity);
+            if (i == 0)
+                x_[iter.coordinates()[0]] = solverDesc.mesher->location(iter, 0);
+        }
+
+        FdmStepConditionComposite::Conditions conditions(
+            1, ext::make_shared<FdmBatchMaturityCondition>(
+                solverDesc.mesher, solverDesc.calculator, maturities_));
+        conditions.push_back(solverDesc.condition);
+
+        std::list<std::vector<Time> > stoppingTimes(1, earlierMaturities_);
+        stoppingTimes.push_back(solverDesc.condition->stoppingTimes());
+
+        conditions_ = FdmStepConditionComposite::joinConditions(
+            thetaCondition_,
+            ext::make_shared<FdmStepConditionComposite>(
+                stoppingTimes, conditions));
+    }
+
+    void Fdm1DimBatchSolver::performCalculations() const {
+        Array rhs = initialValues_;
+
+        // the rollback is split at the earlier maturities, so that
+        // the kinks of the payoffs reset there are smoothed by
+        // damping steps as the ones at the final maturity.  The
+        // conditions at the start of each later part were already
+        // applied at the end of the previous one.
+        std::vector<Time> times(earlierMaturities_.rbegin(),
+                                earlierMaturities_.rend());
+        times.push_back(0.0);
+
+        Time from = solverDesc_.maturity;
+        for (Time to : times) {
+            ext::shared_ptr<FdmStepConditionComposite> conditions = conditions_;
+            if (from < solverDesc_.maturity) {
+                std::vector<Time> stoppingTimes;
+                for (Time t : conditions_->stoppingTimes()) {
+                    if (t < from)
+                        stoppingTimes.push_back(t);
+                }
+                conditions = ext::make_shared<FdmStepConditionComposite>(
+                    std::list<std::vector<Time> >(1, stoppingTimes),
+                    conditions_->conditions());
+            }
+
+            const Size steps = std::max<Size>(1, std::lround(
+                solverDesc_.timeSteps*(from - to)/solverDesc_.maturity));
+            FdmBackwardSolver(op_, solverDesc_.bcSet, conditions, schemeDesc_)
+                .rollback(rhs, from, to, steps, solverDesc_.dampingSteps);
+            from = to;
+        }
+
+        std::copy(rhs.begin(), rhs.end(), resultValues_.begin());
+
+        const Size n = x_.size();
+        for (Size i=0; i < interpolations_.size(); ++i) {
+            interpolations_[i] = ext::make_shared<MonotonicCubicNaturalSpline>(
+                x_.begin(), x_.end(), resultValues_.begin() + i*n);
+        }
+    }
+
+    Real Fdm1DimBatchSolver::interpolateAt(Size i, Real x) const {
+        calculate();
+        QL_REQUIRE(i < interpolations_.size(), "payoff " << i << " out of range");
+        return (*interpolations_[i])(x);
+    }
+
+    Real Fdm1DimBatchSolver::thetaAt(Size i, Real x) const {
+        if (conditions_->stoppingTimes().front() == 0.0)
+            return Null<Real>();
+
+        calculate();
+        QL_REQUIRE(i < interpolations_.size(), "payoff " << i << " out of range");
+
+        const Size n = x_.size();
+        const Array& rhs = thetaCondition_->getValues();
+        const Array thetaValues(rhs.begin() + i*n, rhs.begin() + (i+1)*n);
+
+        const Real temp = MonotonicCubicNaturalSpline(
+            x_.begin(), x_.end(), thetaValues.begin())(x);
+        return ( temp - interpolateAt(i, x) ) / thetaCondition_->getTime();
+    }
+
+    Real Fdm1DimBatchSolver::derivativeX(Size i, Real x) const {
+        calculate();
+        QL_REQUIRE(i < interpolations_.size(), "payoff " << i << " out of range");
+        return interpolations_[i]->derivative(x);
+    }
+
+    Real Fdm1DimBatchSolver::derivativeXX(Size i, Real x) const {
+        calculate();
+        QL_REQUIRE(i < interpolations_.size(), "payoff " << i << " out of range");
+        return interpolations_[i]->secondDerivative(x);
+    }
+}
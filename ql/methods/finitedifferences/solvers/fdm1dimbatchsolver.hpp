@@ -0,0 +1,89 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file fdm1dimbatchsolver.hpp
+    \brief solves a batch of one-dimensional problems on a shared mesh
+*/
+
+#ifndef quantlib_fdm_1_dim_batch_solver_hpp
+#define quantlib_fdm_1_dim_batch_solver_hpp
+
+#include <ql/patterns/lazyobject.hpp>
+#include <ql/methods/finitedifferences/solvers/fdmsolverdesc.hpp>
+#include <ql/methods/finitedifferences/solvers/fdmbackwardsolver.hpp>
+
+namespace QuantLib {
+
+    class CubicInterpolation;
+    class FdmSnapshotCondition;
+
+    //! solves a batch of one-dimensional problems on a shared mesh
+    /*! The mesher of the solver description has two dimensions: the
+        first is the state variable of the problems and the second
+        indexes the payoffs of the batch, whose inner values are given
+        by the calculator.  The operator must act on the first
+        direction only, so that all payoffs are rolled back together
+        by a single backward solver; each time step then sets up the
+        operator once and sweeps the tridiagonal systems of all
+        payoffs in lockstep.
+
+        Payoffs can expire at different times.  The rollback starts
+        at the solver-description maturity, which must be the latest
+        one, and the values of each payoff are set to its inner value
+        when its maturity is reached; before that, whatever the step
+        conditions do to them is discarded.  The step conditions must
+        therefore be valid for all payoffs up to their maturities.
+        The damping steps of the solver description are taken after
+        each maturity, so that the new kinks don't cause oscillations.
+    */
+    class Fdm1DimBatchSolver : public LazyObject {
+      public:
+        Fdm1DimBatchSolver(const FdmSolverDesc& solverDesc,
+                           std::vector<Time> maturities,
+                           const FdmSchemeDesc& schemeDesc,
+                           ext::shared_ptr<FdmLinearOpComposite> op);
+
+        //! number of payoffs in the batch
+        Size size() const { return maturities_.size(); }
+
+        Real interpolateAt(Size i, Real x) const;
+        Real thetaAt(Size i, Real x) const;
+
+        Real derivativeX(Size i, Real x) const;
+        Real derivativeXX(Size i, Real x) const;
+
+      protected:
+        void performCalculations() const override;
+
+      private:
+        const FdmSolverDesc solverDesc_;
+        const std::vector<Time> maturities_;
+        const FdmSchemeDesc schemeDesc_;
+        const ext::shared_ptr<FdmLinearOpComposite> op_;
+
+        const ext::shared_ptr<FdmSnapshotCondition> thetaCondition_;
+        ext::shared_ptr<FdmStepConditionComposite> conditions_;
+
+        std::vector<Time> earlierMaturities_;
+        std::vector<Real> x_;
+        Array initialValues_;
+        mutable Array resultValues_;
+        mutable std::vector<ext::shared_ptr<CubicInterpolation> > interpolations_;
+    };
+}
+
+#endif
@@ -17,11 +17,11 @@
  FOR A PARTICULAR PURPOSE.  See the license for more details.
 */
 
-#include <ql/math/interpolations/cubicinterpolation.hpp>
 #include <ql/methods/finitedifferences/finitedifferencemodel.hpp>
 #include <ql/methods/finitedifferences/meshers/fdmmesher.hpp>
 #include <ql/methods/finitedifferences/operators/fdmlinearoplayout.hpp>
 #include <ql/methods/finitedifferences/solvers/fdm1dimsolver.hpp>
+#include <ql/methods/finitedifferences/solvers/fdmvaluesurface.hpp>
 #include <ql/methods/finitedifferences/stepconditions/fdmsnapshotcondition.hpp>
 #include <ql/methods/finitedifferences/stepconditions/fdmstepconditioncomposite.hpp>
 #include <ql/methods/finitedifferences/utilities/fdminnervaluecalculator.hpp>
@@ -39,8 +39,7 @@ namespace QuantLib {
                               solverDesc.maturity :
                               solverDesc.condition->stoppingTimes().front()))),
       conditions_(FdmStepConditionComposite::joinConditions(thetaCondition_, solverDesc.condition)),
-      x_(solverDesc.mesher->layout()->size()), initialValues_(solverDesc.mesher->layout()->size()),
-      resultValues_(solverDesc.mesher->layout()->size()) {
+      x_(solverDesc.mesher->layout()->size()), initialValues_(solverDesc.mesher->layout()->size()) {
 
         for (const auto& iter : *solverDesc.mesher->layout()) {
             initialValues_[iter.index()]
@@ -59,39 +58,37 @@ namespace QuantLib {
             .rollback(rhs, solverDesc_.maturity, 0.0,
                       solverDesc_.timeSteps, solverDesc_.dampingSteps);
 
-        std::copy(rhs.begin(), rhs.end(), resultValues_.begin());
-        interpolation_ = ext::make_shared<MonotonicCubicNaturalSpline>(x_.begin(), x_.end(),
-                                        resultValues_.begin());
+        const bool hasTheta = (conditions_->stoppingTimes().front() != 0.0);
+        surface_ = ext::make_shared<Fdm1DimValueSurface>(
+            x_, std::move(rhs),
+            hasTheta ? thetaCondition_->getValues() : Array(),
+            hasTheta ? thetaCondition_->getTime() : Null<Time>());
     }
 
     Real Fdm1DimSolver::interpolateAt(Real x) const {
         calculate();
-        return (*interpolation_)(x);
+        return surface_->valueAt(x);
     }
 
     Real Fdm1DimSolver::thetaAt(Real x) const {
-        if (conditions_->stoppingTimes().front() == 0.0)
-            return Null<Real>();
-
         calculate();
-        Array thetaValues(resultValues_.size());
-
-        const Array& rhs = thetaCondition_->getValues();
-        std::copy(rhs.begin(), rhs.end(), thetaValues.begin());
-
-        Real temp = MonotonicCubicNaturalSpline(
-            x_.begin(), x_.end(), thetaValues.begin())(x);
-        return ( temp - interpolateAt(x) ) / thetaCondition_->getTime();
+        return surface_->thetaAt(x);
     }
 
 
     Real Fdm1DimSolver::derivativeX(Real x) const {
         calculate();
-        return interpolation_->derivative(x);
+        return surface_->derivativeX(x);
     }
 
     Real Fdm1DimSolver::derivativeXX(Real x) const {
         calculate();
-        return interpolation_->secondDerivative(x);
+        return surface_->derivativeXX(x);
+    }
+
+    ext::shared_ptr<const Fdm1DimValueSurface>
+    Fdm1DimSolver::valueSurface() const {
+        calculate();
+        return surface_;
     }
 }
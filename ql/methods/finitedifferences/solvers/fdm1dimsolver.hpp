@@ -32,7 +32,7 @@
 
 namespace QuantLib {
 
-    class CubicInterpolation;
+    class Fdm1DimValueSurface;
     class FdmSnapshotCondition;
 
     class Fdm1DimSolver : public LazyObject {
@@ -47,6 +47,9 @@ namespace QuantLib {
         Real derivativeX(Real x) const;
         Real derivativeXX(Real x) const;
 
+        //! solved values, which stay valid after recalculations
+        ext::shared_ptr<const Fdm1DimValueSurface> valueSurface() const;
+
       protected:
         void performCalculations() const override;
 
@@ -59,8 +62,7 @@ namespace QuantLib {
         const ext::shared_ptr<FdmStepConditionComposite> conditions_;
 
         std::vector<Real> x_, initialValues_;
-        mutable Array resultValues_;
-        mutable ext::shared_ptr<CubicInterpolation> interpolation_;
+        mutable ext::shared_ptr<Fdm1DimValueSurface> surface_;
     };
 }
 
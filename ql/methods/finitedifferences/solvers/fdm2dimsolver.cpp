@@ -17,11 +17,11 @@
  FOR A PARTICULAR PURPOSE.  See the license for more details.
 */
 
-#include <ql/math/interpolations/bicubicsplineinterpolation.hpp>
 #include <ql/methods/finitedifferences/finitedifferencemodel.hpp>
 #include <ql/methods/finitedifferences/meshers/fdmmesher.hpp>
 #include <ql/methods/finitedifferences/operators/fdmlinearoplayout.hpp>
 #include <ql/methods/finitedifferences/solvers/fdm2dimsolver.hpp>
+#include <ql/methods/finitedifferences/solvers/fdmvaluesurface.hpp>
 #include <ql/methods/finitedifferences/stepconditions/fdmsnapshotcondition.hpp>
 #include <ql/methods/finitedifferences/stepconditions/fdmstepconditioncomposite.hpp>
 #include <ql/methods/finitedifferences/utilities/fdminnervaluecalculator.hpp>
@@ -39,8 +39,7 @@ namespace QuantLib {
                               solverDesc.maturity :
                               solverDesc.condition->stoppingTimes().front()))),
       conditions_(FdmStepConditionComposite::joinConditions(thetaCondition_, solverDesc.condition)),
-      initialValues_(solverDesc.mesher->layout()->size()),
-      resultValues_(solverDesc.mesher->layout()->dim()[1], solverDesc.mesher->layout()->dim()[0]) {
+      initialValues_(solverDesc.mesher->layout()->size()) {
 
         x_.reserve(solverDesc.mesher->layout()->dim()[0]);
         y_.reserve(solverDesc.mesher->layout()->dim()[1]);
@@ -68,56 +67,62 @@ namespace QuantLib {
             .rollback(rhs, solverDesc_.maturity, 0.0,
                       solverDesc_.timeSteps, solverDesc_.dampingSteps);
 
-        std::copy(rhs.begin(), rhs.end(), resultValues_.begin());
-        interpolation_ = ext::make_shared<BicubicSpline>(x_.begin(), x_.end(),
-                              y_.begin(), y_.end(),
-                              resultValues_);
+        Matrix resultValues(y_.size(), x_.size());
+        std::copy(rhs.begin(), rhs.end(), resultValues.begin());
+
+        Matrix thetaValues;
+        const bool hasTheta = (conditions_->stoppingTimes().front() != 0.0);
+        if (hasTheta) {
+            const Array& values = thetaCondition_->getValues();
+            thetaValues = Matrix(y_.size(), x_.size());
+            std::copy(values.begin(), values.end(), thetaValues.begin());
+        }
+
+        surface_ = ext::make_shared<Fdm2DimValueSurface>(
+            x_, y_, std::move(resultValues), std::move(thetaValues),
+            hasTheta ? thetaCondition_->getTime() : Null<Time>());
     }
 
     Real Fdm2DimSolver::interpolateAt(Real x, Real y) const {
         calculate();
-        return (*interpolation_)(x, y);
+        return surface_->valueAt(x, y);
     }
 
     Real Fdm2DimSolver::thetaAt(Real x, Real y) const {
-        if (conditions_->stoppingTimes().front() == 0.0)
-            return Null<Real>();
-
         calculate();
-        Matrix thetaValues(resultValues_.rows(), resultValues_.columns());
-
-        const Array& rhs = thetaCondition_->getValues();
-        std::copy(rhs.begin(), rhs.end(), thetaValues.begin());
-
-        return (BicubicSpline(x_.begin(), x_.end(), y_.begin(), y_.end(),
-                              thetaValues)(x, y) - interpolateAt(x, y))
-              / thetaCondition_->getTime();
+        return surface_->thetaAt(x, y);
     }
 
 
     Real Fdm2DimSolver::derivativeX(Real x, Real y) const {
         calculate();
-        return interpolation_->derivativeX(x, y);
+        return surface_->derivativeX(x, y);
     }
 
     Real Fdm2DimSolver::derivativeY(Real x, Real y) const {
         calculate();
-        return interpolation_->derivativeY(x, y);
+        return surface_->derivativeY(x, y);
     }
 
     Real Fdm2DimSolver::derivativeXX(Real x, Real y) const {
         calculate();
-        return interpolation_->secondDerivativeX(x, y);
+        return surface_->derivativeXX(x, y);
     }
 
     Real Fdm2DimSolver::derivativeYY(Real x, Real y) const {
         calculate();
-        return interpolation_->secondDerivativeY(x, y);
+        return surface_->derivativeYY(x, y);
     }
 
     Real Fdm2DimSolver::derivativeXY(Real x, Real y) const {
         calculate();
-        return interpolation_->derivativeXY(x, y);
+        return surface_->derivativeXY(x, y);
+    }
+
+    ext::shared_ptr<const Fdm2DimValueSurface>
+    Fdm2DimSolver::valueSurface() const {
+        calculate();
+        return surface_;
     }
 
 }
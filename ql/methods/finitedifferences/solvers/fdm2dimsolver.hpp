@@ -32,7 +32,7 @@
 
 namespace QuantLib {
 
-    class BicubicSpline;
+    class Fdm2DimValueSurface;
     class FdmSnapshotCondition;
 
     class Fdm2DimSolver : public LazyObject {
@@ -50,6 +50,9 @@ namespace QuantLib {
         Real derivativeYY(Real x, Real y) const;
         Real derivativeXY(Real x, Real y) const;
 
+        //! solved values, which stay valid after recalculations
+        ext::shared_ptr<const Fdm2DimValueSurface> valueSurface() const;
+
       protected:
         void performCalculations() const override;
 
@@ -62,8 +65,7 @@ namespace QuantLib {
         const ext::shared_ptr<FdmStepConditionComposite> conditions_;
 
         std::vector<Real> x_, y_, initialValues_;
-        mutable Matrix resultValues_;
-        mutable ext::shared_ptr<BicubicSpline> interpolation_;
+        mutable ext::shared_ptr<Fdm2DimValueSurface> surface_;
     };
 }
 
@@ -22,7 +22,9 @@
 /*! \file fdmbackwardsolver.cpp
 */
 
+#include <ql/methods/finitedifferences/adaptivefinitedifferencemodel.hpp>
 #include <ql/methods/finitedifferences/finitedifferencemodel.hpp>
+#include <ql/methods/finitedifferences/operators/fdmoperatorthreads.hpp>
 #include <ql/methods/finitedifferences/schemes/craigsneydscheme.hpp>
 #include <ql/methods/finitedifferences/schemes/cranknicolsonscheme.hpp>
 #include <ql/methods/finitedifferences/schemes/douglasscheme.hpp>
@@ -34,14 +36,88 @@
 #include <ql/methods/finitedifferences/schemes/trbdf2scheme.hpp>
 #include <ql/methods/finitedifferences/solvers/fdmbackwardsolver.hpp>
 #include <ql/methods/finitedifferences/stepconditions/fdmstepconditioncomposite.hpp>
+#include <ql/math/comparison.hpp>
 #include <ql/mathconstants.hpp>
+#include <algorithm>
 #include <utility>
 
 
 namespace QuantLib {
-    
-    FdmSchemeDesc::FdmSchemeDesc(FdmSchemeType aType, Real aTheta, Real aMu)
-    : type(aType), theta(aTheta), mu(aMu) { }
+
+    namespace {
+
+        ImplicitEulerScheme::PreconditionerType implicitPreconditioner(
+                                           const FdmSchemeDesc& schemeDesc) {
+            switch (schemeDesc.preconditioner) {
+              case FdmSchemeDesc::SplittingPreconditioner:
+                return ImplicitEulerScheme::Splitting;
+              case FdmSchemeDesc::MultigridPreconditioner:
+                return ImplicitEulerScheme::Multigrid;
+              default:
+                QL_FAIL("unknown preconditioner type");
+            }
+        }
+
+        // order of consistency of the schemes, following K. J. in 't
+        // Hout and S. Foulon, ADI finite difference schemes for option
+        // pricing in the Heston model with correlation (2010).  Mixed
+        // derivatives are assumed to be present in more than one
+        // dimension; they are treated explicitly by the ADI schemes.
+        Size schemeOrder(const FdmSchemeDesc& desc, bool mixedTerms) {
+            const bool crankNicolson = close_enough(desc.theta, 0.5);
+            switch (desc.type) {
+              case FdmSchemeDesc::ImplicitEulerType:
+              case FdmSchemeDesc::ExplicitEulerType:
+                return 1;
+              case FdmSchemeDesc::CrankNicolsonType:
+                return crankNicolson ? 2 : 1;
+              case FdmSchemeDesc::DouglasType:
+                return (crankNicolson && !mixedTerms) ? 2 : 1;
+              case FdmSchemeDesc::CraigSneydType:
+                return (crankNicolson
+                        && (!mixedTerms || close_enough(desc.mu, 0.5))) ? 2 : 1;
+              case FdmSchemeDesc::ModifiedCraigSneydType:
+                return close_enough(desc.mu, desc.theta) ? 2 : 1;
+              case FdmSchemeDesc::HundsdorferType:
+                return close_enough(desc.mu, 0.5) ? 2 : 1;
+              case FdmSchemeDesc::TrBDF2Type:
+                // second order, provided the trapezoidal stage is
+                return std::min<Size>(
+                    2, schemeOrder(FdmSchemeDesc::CraigSneyd(), mixedTerms));
+              case FdmSchemeDesc::MethodOfLinesType:
+                // Cash-Karp pair of orders 4 and 5; the inner error
+                // control keeps the lower one
+                return 4;
+              default:
+                QL_FAIL("unknown scheme type");
+            }
+        }
+
+    }
+
+    FdmSchemeDesc::FdmSchemeDesc(FdmSchemeType aType, Real aTheta, Real aMu,
+                                 Size aThreads,
+                                 FdmPreconditionerType aPreconditioner,
+                                 Real aStepTolerance)
+    : type(aType), theta(aTheta), mu(aMu), threads(aThreads),
+      preconditioner(aPreconditioner), stepTolerance(aStepTolerance) {
+        QL_REQUIRE(threads > 0, "at least one thread required");
+        QL_REQUIRE(stepTolerance == Null<Real>() || stepTolerance > 0.0,
+                   "positive step tolerance required");
+    }
+
+    FdmSchemeDesc FdmSchemeDesc::withThreads(Size threads) const {
+        return {type, theta, mu, threads, preconditioner, stepTolerance};
+    }
+
+    FdmSchemeDesc FdmSchemeDesc::withPreconditioner(
+                               FdmPreconditionerType preconditioner) const {
+        return {type, theta, mu, threads, preconditioner, stepTolerance};
+    }
+
+    FdmSchemeDesc FdmSchemeDesc::withAdaptiveSteps(Real stepTolerance) const {
+        return {type, theta, mu, threads, preconditioner, stepTolerance};
+    }
 
     FdmSchemeDesc FdmSchemeDesc::Douglas() { return {FdmSchemeDesc::DouglasType, 0.5, 0.0}; }
 
@@ -89,56 +165,82 @@ namespace QuantLib {
                          std::list<std::vector<Time> >(), FdmStepConditionComposite::Conditions())),
       schemeDesc_(schemeDesc) {}
 
+    template <class Evolver>
+    void FdmBackwardSolver::rollbackWith(Evolver& evolver, array_type& a,
+                                         Time from, Time to,
+                                         Size steps, Size order) {
+        if (schemeDesc_.stepTolerance == Null<Real>()) {
+            FiniteDifferenceModel<Evolver>
+                model(evolver, condition_->stoppingTimes());
+            model.rollback(a, from, to, steps, *condition_);
+        }
+        else {
+            AdaptiveFiniteDifferenceModel<Evolver>
+                model(evolver, condition_->stoppingTimes(),
+                      schemeDesc_.stepTolerance, order);
+            model.rollback(a, from, to, (from-to)/steps, *condition_);
+
+            const std::vector<Time>& times = model.stepTimes();
+            stepTimes_.insert(stepTimes_.end(),
+                              times.begin() + (stepTimes_.empty() ? 0 : 1),
+                              times.end());
+            rejectedSteps_ += model.rejectedSteps();
+            evolverSteps_ += model.evolverSteps();
+        }
+    }
+
     void FdmBackwardSolver::rollback(FdmBackwardSolver::array_type& rhs, 
                                      Time from, Time to,
                                      Size steps, Size dampingSteps) {
 
+        const FdmOperatorThreads operatorThreads(schemeDesc_.threads);
+
         const Time deltaT = from - to;
         const Size allSteps = steps + dampingSteps;
         const Time dampingTo = from - (deltaT*dampingSteps)/allSteps;
 
+        stepTimes_.clear();
+        rejectedSteps_ = evolverSteps_ = preconditionerSetups_ = 0;
+
         if ((dampingSteps != 0U) && schemeDesc_.type != FdmSchemeDesc::ImplicitEulerType) {
-            ImplicitEulerScheme implicitEvolver(map_, bcSet_);    
-            FiniteDifferenceModel<ImplicitEulerScheme> 
-                    dampingModel(implicitEvolver, condition_->stoppingTimes());
-            dampingModel.rollback(rhs, from, dampingTo, 
-                                  dampingSteps, *condition_);
+            ImplicitEulerScheme implicitEvolver(
+                map_, bcSet_, 1e-8, ImplicitEulerScheme::BiCGstab,
+                implicitPreconditioner(schemeDesc_));
+            rollbackWith(implicitEvolver, rhs, from, dampingTo, dampingSteps, 1);
+            preconditionerSetups_ += implicitEvolver.numberOfPreconditionerSetups();
         }
 
+        const Size order = schemeOrder(schemeDesc_, map_->size() > 1);
+
         switch (schemeDesc_.type) {
           case FdmSchemeDesc::HundsdorferType:
             {
                 HundsdorferScheme hsEvolver(schemeDesc_.theta, schemeDesc_.mu, 
                                             map_, bcSet_);
-                FiniteDifferenceModel<HundsdorferScheme> 
-                               hsModel(hsEvolver, condition_->stoppingTimes());
-                hsModel.rollback(rhs, dampingTo, to, steps, *condition_);
+                rollbackWith(hsEvolver, rhs, dampingTo, to, steps, order);
             }
             break;
           case FdmSchemeDesc::DouglasType:
             {
                 DouglasScheme dsEvolver(schemeDesc_.theta, map_, bcSet_);
-                FiniteDifferenceModel<DouglasScheme> 
-                               dsModel(dsEvolver, condition_->stoppingTimes());
-                dsModel.rollback(rhs, dampingTo, to, steps, *condition_);
+                rollbackWith(dsEvolver, rhs, dampingTo, to, steps, order);
             }
             break;
           case FdmSchemeDesc::CrankNicolsonType:
             {
-              CrankNicolsonScheme cnEvolver(schemeDesc_.theta, map_, bcSet_);
-              FiniteDifferenceModel<CrankNicolsonScheme>
-                             cnModel(cnEvolver, condition_->stoppingTimes());
-              cnModel.rollback(rhs, dampingTo, to, steps, *condition_);
-
+              CrankNicolsonScheme cnEvolver(
+                  schemeDesc_.theta, map_, bcSet_, 1e-8,
+                  ImplicitEulerScheme::BiCGstab,
+                  implicitPreconditioner(schemeDesc_));
+              rollbackWith(cnEvolver, rhs, dampingTo, to, steps, order);
+              preconditionerSetups_ += cnEvolver.numberOfPreconditionerSetups();
             }
             break;
           case FdmSchemeDesc::CraigSneydType:
             {
                 CraigSneydScheme csEvolver(schemeDesc_.theta, schemeDesc_.mu, 
                                            map_, bcSet_);
-                FiniteDifferenceModel<CraigSneydScheme> 
-                               csModel(csEvolver, condition_->stoppingTimes());
-                csModel.rollback(rhs, dampingTo, to, steps, *condition_);
+                rollbackWith(csEvolver, rhs, dampingTo, to, steps, order);
             }
             break;
           case FdmSchemeDesc::ModifiedCraigSneydType:
@@ -146,34 +248,29 @@ namespace QuantLib {
                 ModifiedCraigSneydScheme csEvolver(schemeDesc_.theta, 
                                                    schemeDesc_.mu,
                                                    map_, bcSet_);
-                FiniteDifferenceModel<ModifiedCraigSneydScheme> 
-                              mcsModel(csEvolver, condition_->stoppingTimes());
-                mcsModel.rollback(rhs, dampingTo, to, steps, *condition_);
+                rollbackWith(csEvolver, rhs, dampingTo, to, steps, order);
             }
             break;
           case FdmSchemeDesc::ImplicitEulerType:
             {
-                ImplicitEulerScheme implicitEvolver(map_, bcSet_);
-                FiniteDifferenceModel<ImplicitEulerScheme> 
-                   implicitModel(implicitEvolver, condition_->stoppingTimes());
-                implicitModel.rollback(rhs, from, to, allSteps, *condition_);
+                ImplicitEulerScheme implicitEvolver(
+                    map_, bcSet_, 1e-8, ImplicitEulerScheme::BiCGstab,
+                    implicitPreconditioner(schemeDesc_));
+                rollbackWith(implicitEvolver, rhs, from, to, allSteps, order);
+                preconditionerSetups_ += implicitEvolver.numberOfPreconditionerSetups();
             }
             break;
           case FdmSchemeDesc::ExplicitEulerType:
             {
                 ExplicitEulerScheme explicitEvolver(map_, bcSet_);
-                FiniteDifferenceModel<ExplicitEulerScheme> 
-                   explicitModel(explicitEvolver, condition_->stoppingTimes());
-                explicitModel.rollback(rhs, dampingTo, to, steps, *condition_);
+                rollbackWith(explicitEvolver, rhs, dampingTo, to, steps, order);
             }
             break;
           case FdmSchemeDesc::MethodOfLinesType:
             {
                 MethodOfLinesScheme methodOfLines(
                     schemeDesc_.theta, schemeDesc_.mu, map_, bcSet_);
-                FiniteDifferenceModel<MethodOfLinesScheme>
-                   molModel(methodOfLines, condition_->stoppingTimes());
-                molModel.rollback(rhs, dampingTo, to, steps, *condition_);
+                rollbackWith(methodOfLines, rhs, dampingTo, to, steps, order);
             }
             break;
           case FdmSchemeDesc::TrBDF2Type:
@@ -187,10 +284,7 @@ namespace QuantLib {
 
                 TrBDF2Scheme<CraigSneydScheme> trBDF2(
                     schemeDesc_.theta, map_, hsEvolver, bcSet_,schemeDesc_.mu);
-
-                FiniteDifferenceModel<TrBDF2Scheme<CraigSneydScheme> >
-                   trBDF2Model(trBDF2, condition_->stoppingTimes());
-                trBDF2Model.rollback(rhs, dampingTo, to, steps, *condition_);
+                rollbackWith(trBDF2, rhs, dampingTo, to, steps, order);
             }
             break;
           default:
@@ -38,11 +38,38 @@ namespace QuantLib {
                              ImplicitEulerType, ExplicitEulerType,
                              MethodOfLinesType, TrBDF2Type,
                              CrankNicolsonType };
+        enum FdmPreconditionerType { SplittingPreconditioner,
+                                     MultigridPreconditioner };
 
-        FdmSchemeDesc(FdmSchemeType type, Real theta, Real mu);
+        FdmSchemeDesc(FdmSchemeType type, Real theta, Real mu,
+                      Size threads = 1,
+                      FdmPreconditionerType preconditioner
+                          = SplittingPreconditioner,
+                      Real stepTolerance = Null<Real>());
 
         const FdmSchemeType type;
         const Real theta, mu;
+        //! number of threads used by the operators during the rollback
+        const Size threads;
+        /*! preconditioner of the iterative solvers used by the
+            implicit-Euler and Crank-Nicolson schemes; the multigrid
+            preconditioner needs the matrix decomposition of the
+            operator, see ImplicitEulerScheme.
+        */
+        const FdmPreconditionerType preconditioner;
+        /*! maximum local error of the time steps; if not null, the
+            rollback, including the damping steps, uses adaptive time
+            steps, see AdaptiveFiniteDifferenceModel, and the given
+            numbers of steps only set the initial step sizes.
+        */
+        const Real stepTolerance;
+
+        //! returns a copy of the description using the given threads
+        FdmSchemeDesc withThreads(Size threads) const;
+        //! returns a copy of the description using the given preconditioner
+        FdmSchemeDesc withPreconditioner(FdmPreconditionerType preconditioner) const;
+        //! returns a copy of the description using adaptive time steps
+        FdmSchemeDesc withAdaptiveSteps(Real stepTolerance) const;
 
         // some default scheme descriptions
         static FdmSchemeDesc Douglas(); //same as Crank-Nicolson in 1 dimension
@@ -71,11 +98,31 @@ namespace QuantLib {
                       Time from, Time to,
                       Size steps, Size dampingSteps);
 
+        //! \name step history of the last adaptive rollback
+        //@{
+        //! times of the accepted steps, including the damping steps
+        const std::vector<Time>& stepTimes() const { return stepTimes_; }
+        //! number of steps rejected because of their error
+        Size rejectedSteps() const { return rejectedSteps_; }
+        //! number of evolver steps, including those of rejected steps
+        //! and of error estimates
+        Size evolverSteps() const { return evolverSteps_; }
+        //@}
+
+        //! number of multigrid preconditioner setups in the last rollback
+        Size preconditionerSetups() const { return preconditionerSetups_; }
+
       protected:
+        template <class Evolver>
+        void rollbackWith(Evolver& evolver, array_type& a,
+                          Time from, Time to, Size steps, Size order);
+
         const ext::shared_ptr<FdmLinearOpComposite> map_;
         const FdmBoundaryConditionSet bcSet_;
         const ext::shared_ptr<FdmStepConditionComposite> condition_;
         const FdmSchemeDesc schemeDesc_;
+        std::vector<Time> stepTimes_;
+        Size rejectedSteps_ = 0, evolverSteps_ = 0, preconditionerSetups_ = 0;
     };
 }
 
@@ -71,6 +71,13 @@ namespace QuantLib {
     }
 
     Real FdmBlackScholesSolver::thetaAt(Real s) const {
+        calculate();
         return solver_->thetaAt(std::log(s));
     }
+
+    ext::shared_ptr<const Fdm1DimValueSurface>
+    FdmBlackScholesSolver::valueSurface() const {
+        calculate();
+        return solver_->valueSurface();
+    }
 }
@@ -34,6 +34,7 @@
 namespace QuantLib {
 
     class Fdm1DimSolver;
+    class Fdm1DimValueSurface;
     class FdmSnapshotCondition;
     class GeneralizedBlackScholesProcess;
 
@@ -52,6 +53,12 @@ namespace QuantLib {
         Real gammaAt(Real s) const;
         Real thetaAt(Real s) const;
 
+        /*! solved values on the log-spot grid; they can be queried
+            for many spots without re-solving and stay valid after
+            the market data change.
+        */
+        ext::shared_ptr<const Fdm1DimValueSurface> valueSurface() const;
+
       protected:
         void performCalculations() const override;
 
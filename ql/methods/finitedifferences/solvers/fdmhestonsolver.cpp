@@ -33,22 +33,23 @@ namespace QuantLib {
                                      const FdmSchemeDesc& schemeDesc,
                                      Handle<FdmQuantoHelper> quantoHelper,
                                      ext::shared_ptr<LocalVolTermStructure> leverageFct,
-                                     const Real mixingFactor)
+                                     const Real mixingFactor,
+                                     ext::shared_ptr<FdmLinearOpComposite> op)
     : process_(std::move(process)), solverDesc_(std::move(solverDesc)), schemeDesc_(schemeDesc),
       quantoHelper_(std::move(quantoHelper)), leverageFct_(std::move(leverageFct)),
-      mixingFactor_(mixingFactor) {
+      mixingFactor_(mixingFactor), op_(std::move(op)) {
 
         registerWith(process_);
         registerWith(quantoHelper_);
     }
 
     void FdmHestonSolver::performCalculations() const {
-        ext::shared_ptr<FdmLinearOpComposite> op(
+        ext::shared_ptr<FdmLinearOpComposite> op = (op_ != nullptr) ? op_ :
 			ext::make_shared<FdmHestonOp>(
                 solverDesc_.mesher, process_.currentLink(),
                 (!quantoHelper_.empty()) ? quantoHelper_.currentLink()
                              : ext::shared_ptr<FdmQuantoHelper>(),
-                leverageFct_, mixingFactor_));
+                leverageFct_, mixingFactor_);
 
         solver_ = ext::make_shared<Fdm2DimSolver>(solverDesc_, schemeDesc_, op);
     }
@@ -90,4 +91,10 @@ namespace QuantLib {
         calculate();
         return solver_->thetaAt(std::log(s), v);
     }
+
+    ext::shared_ptr<const Fdm2DimValueSurface>
+    FdmHestonSolver::valueSurface() const {
+        calculate();
+        return solver_->valueSurface();
+    }
 }
@@ -38,7 +38,13 @@ namespace QuantLib {
 
     class HestonProcess;
     class Fdm2DimSolver;
+    class Fdm2DimValueSurface;
 
+    //! Heston finite-differences solver
+    /*! If an operator is given, it is used for the rollback instead
+        of building a new FdmHestonOp; it must be defined on the mesher
+        of the solver description and consistent with the process.
+    */
     class FdmHestonSolver : public LazyObject {
       public:
         FdmHestonSolver(Handle<HestonProcess> process,
@@ -47,7 +53,9 @@ namespace QuantLib {
                         Handle<FdmQuantoHelper> quantoHelper = Handle<FdmQuantoHelper>(),
                         ext::shared_ptr<LocalVolTermStructure> leverageFct =
                             ext::shared_ptr<LocalVolTermStructure>(),
-                        Real mixingFactor = 1.0);
+                        Real mixingFactor = 1.0,
+                        ext::shared_ptr<FdmLinearOpComposite> op =
+                            ext::shared_ptr<FdmLinearOpComposite>());
 
         Real valueAt(Real s, Real v) const;
         Real thetaAt(Real s, Real v) const;
@@ -63,6 +71,12 @@ namespace QuantLib {
         Real meanVarianceDeltaAt(Real s, Real v) const;
         Real meanVarianceGammaAt(Real s, Real v) const;
 
+        /*! solved values on the (log-spot, variance) grid; they can be
+            queried for many spots and variances without re-solving and
+            stay valid after the market data change.
+        */
+        ext::shared_ptr<const Fdm2DimValueSurface> valueSurface() const;
+
       protected:
         void performCalculations() const override;
 
@@ -73,6 +87,7 @@ namespace QuantLib {
         const Handle<FdmQuantoHelper> quantoHelper_;
         const ext::shared_ptr<LocalVolTermStructure> leverageFct_;
         const Real mixingFactor_;
+        const ext::shared_ptr<FdmLinearOpComposite> op_;
 
         mutable ext::shared_ptr<Fdm2DimSolver> solver_;
     };
@@ -0,0 +1,126 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/math/interpolations/bicubicsplineinterpolation.hpp>
+#include <ql/math/interpolations/cubicinterpolation.hpp>
+#include <ql/methods/finitedifferences/solvers/fdmvaluesurface.hpp>
+#include <utility>
+
+namespace QuantLib {
+
+    Fdm1DimValueSurface::Fdm1DimValueSurface(std::vector<Real> x,
+                                             Array values,
+                                             Array thetaValues,
+                                             Time thetaTime)
+    : x_(std::move(x)), values_(std::move(values)),
+      thetaValues_(std::move(thetaValues)), thetaTime_(thetaTime) {
+
+        QL_REQUIRE(x_.size() == values_.size(),
+                   "grid and values have different sizes");
+
+        interpolation_ = ext::make_shared<MonotonicCubicNaturalSpline>(
+            x_.begin(), x_.end(), values_.begin());
+
+        if (!thetaValues_.empty()) {
+            QL_REQUIRE(x_.size() == thetaValues_.size(),
+                       "grid and theta values have different sizes");
+            QL_REQUIRE(thetaTime_ != Null<Time>() && thetaTime_ > 0.0,
+                       "positive theta time required");
+
+            thetaInterpolation_ = ext::make_shared<MonotonicCubicNaturalSpline>(
+                x_.begin(), x_.end(), thetaValues_.begin());
+        }
+    }
+
+    Real Fdm1DimValueSurface::valueAt(Real x) const {
+        return (*interpolation_)(x);
+    }
+
+    Real Fdm1DimValueSurface::thetaAt(Real x) const {
+        if (thetaInterpolation_ == nullptr)
+            return Null<Real>();
+
+        return ((*thetaInterpolation_)(x) - valueAt(x)) / thetaTime_;
+    }
+
+    Real Fdm1DimValueSurface::derivativeX(Real x) const {
+        return interpolation_->derivative(x);
+    }
+
+    Real Fdm1DimValueSurface::derivativeXX(Real x) const {
+        return interpolation_->secondDerivative(x);
+    }
+
+
+    Fdm2DimValueSurface::Fdm2DimValueSurface(std::vector<Real> x,
+                                             std::vector<Real> y,
+                                             Matrix values,
+                                             Matrix thetaValues,
+                                             Time thetaTime)
+    : x_(std::move(x)), y_(std::move(y)), values_(std::move(values)),
+      thetaValues_(std::move(thetaValues)), thetaTime_(thetaTime) {
+
+        QL_REQUIRE(values_.rows() == y_.size() && values_.columns() == x_.size(),
+                   "grid and values have different sizes");
+
+        interpolation_ = ext::make_shared<BicubicSpline>(
+            x_.begin(), x_.end(), y_.begin(), y_.end(), values_);
+
+        if (!thetaValues_.empty()) {
+            QL_REQUIRE(thetaValues_.rows() == y_.size()
+                       && thetaValues_.columns() == x_.size(),
+                       "grid and theta values have different sizes");
+            QL_REQUIRE(thetaTime_ != Null<Time>() && thetaTime_ > 0.0,
+                       "positive theta time required");
+
+            thetaInterpolation_ = ext::make_shared<BicubicSpline>(
+                x_.begin(), x_.end(), y_.begin(), y_.end(), thetaValues_);
+        }
+    }
+
+    Real Fdm2DimValueSurface::valueAt(Real x, Real y) const {
+        return (*interpolation_)(x, y);
+    }
+
+    Real Fdm2DimValueSurface::thetaAt(Real x, Real y) const {
+        if (thetaInterpolation_ == nullptr)
+            return Null<Real>();
+
+        return ((*thetaInterpolation_)(x, y) - valueAt(x, y)) / thetaTime_;
+    }
+
+    Real Fdm2DimValueSurface::derivativeX(Real x, Real y) const {
+        return interpolation_->derivativeX(x, y);
+    }
+
+    Real Fdm2DimValueSurface::derivativeY(Real x, Real y) const {
+        return interpolation_->derivativeY(x, y);
+    }
+
+    Real Fdm2DimValueSurface::derivativeXX(Real x, Real y) const {
+        return interpolation_->secondDerivativeX(x, y);
+    }
+
+    Real Fdm2DimValueSurface::derivativeYY(Real x, Real y) const {
+        return interpolation_->secondDerivativeY(x, y);
+    }
+
+    Real Fdm2DimValueSurface::derivativeXY(Real x, Real y) const {
+        return interpolation_->derivativeXY(x, y);
+    }
+
+}
@@ -0,0 +1,121 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file fdmvaluesurface.hpp
+    \brief solved finite-difference value grids
+*/
+
+#ifndef quantlib_fdm_value_surface_hpp
+#define quantlib_fdm_value_surface_hpp
+
+#include <ql/math/matrix.hpp>
+#include <ql/shared_ptr.hpp>
+#include <vector>
+
+namespace QuantLib {
+
+    class BicubicSpline;
+    class CubicInterpolation;
+
+    //! solved one-dimensional value grid
+    /*! Holds the values of a finite-difference solve on the grid
+        points and, optionally, the values one short time step later,
+        which give the theta.  The splines are built once, so that
+        values and derivatives can be queried at many points without
+        re-solving or re-interpolating.  The grid is detached from
+        the solver that produced it and is not updated when market
+        data change.
+
+        Coordinates are those of the mesher, e.g., the log-spot for
+        Black-Scholes problems.
+    */
+    class Fdm1DimValueSurface {
+      public:
+        /*! \param x           grid locations
+            \param values      values on the grid
+            \param thetaValues values at time thetaTime, or an empty
+                               array if the theta is not available
+            \param thetaTime   time of the theta values
+        */
+        Fdm1DimValueSurface(std::vector<Real> x,
+                            Array values,
+                            Array thetaValues = Array(),
+                            Time thetaTime = Null<Time>());
+
+        // the splines refer to the grid data
+        Fdm1DimValueSurface(const Fdm1DimValueSurface&) = delete;
+        Fdm1DimValueSurface& operator=(const Fdm1DimValueSurface&) = delete;
+
+        const std::vector<Real>& x() const { return x_; }
+        const Array& values() const { return values_; }
+
+        Real valueAt(Real x) const;
+        //! Null<Real>() if no theta values were given
+        Real thetaAt(Real x) const;
+
+        Real derivativeX(Real x) const;
+        Real derivativeXX(Real x) const;
+
+      private:
+        const std::vector<Real> x_;
+        const Array values_, thetaValues_;
+        const Time thetaTime_;
+        ext::shared_ptr<CubicInterpolation> interpolation_;
+        ext::shared_ptr<CubicInterpolation> thetaInterpolation_;
+    };
+
+    //! solved two-dimensional value grid
+    /*! Same as Fdm1DimValueSurface on a two-dimensional mesher, e.g.,
+        the log-spot and the variance for Heston problems.  Values are
+        stored with the second direction along the rows.
+    */
+    class Fdm2DimValueSurface {
+      public:
+        Fdm2DimValueSurface(std::vector<Real> x,
+                            std::vector<Real> y,
+                            Matrix values,
+                            Matrix thetaValues = Matrix(),
+                            Time thetaTime = Null<Time>());
+
+        // the splines refer to the grid data
+        Fdm2DimValueSurface(const Fdm2DimValueSurface&) = delete;
+        Fdm2DimValueSurface& operator=(const Fdm2DimValueSurface&) = delete;
+
+        const std::vector<Real>& x() const { return x_; }
+        const std::vector<Real>& y() const { return y_; }
+        const Matrix& values() const { return values_; }
+
+        Real valueAt(Real x, Real y) const;
+        //! Null<Real>() if no theta values were given
+        Real thetaAt(Real x, Real y) const;
+
+        Real derivativeX(Real x, Real y) const;
+        Real derivativeY(Real x, Real y) const;
+        Real derivativeXX(Real x, Real y) const;
+        Real derivativeYY(Real x, Real y) const;
+        Real derivativeXY(Real x, Real y) const;
+
+      private:
+        const std::vector<Real> x_, y_;
+        const Matrix values_, thetaValues_;
+        const Time thetaTime_;
+        ext::shared_ptr<BicubicSpline> interpolation_;
+        ext::shared_ptr<BicubicSpline> thetaInterpolation_;
+    };
+}
+
+#endif
@@ -133,4 +133,21 @@ namespace QuantLib {
                                     const FdmLinearOpIterator& iter, Time t) {
         return innerValue(iter, t);
     }
+
+    FdmBatchInnerValue::FdmBatchInnerValue(
+        std::vector<ext::shared_ptr<FdmInnerValueCalculator> > calculators,
+        Size batchDirection)
+    : calculators_(std::move(calculators)), batchDirection_(batchDirection) {}
+
+    Real FdmBatchInnerValue::innerValue(
+                                    const FdmLinearOpIterator& iter, Time t) {
+        return calculators_.at(iter.coordinates()[batchDirection_])
+            ->innerValue(iter, t);
+    }
+
+    Real FdmBatchInnerValue::avgInnerValue(
+                                    const FdmLinearOpIterator& iter, Time t) {
+        return calculators_.at(iter.coordinates()[batchDirection_])
+            ->avgInnerValue(iter, t);
+    }
 }
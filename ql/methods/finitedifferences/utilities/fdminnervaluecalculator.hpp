@@ -90,6 +90,25 @@ namespace QuantLib {
         const ext::shared_ptr<FdmMesher> mesher_;
     };
 
+    //! inner values of a batch of payoffs on a shared mesh
+    /*! The mesher has a dimension indexing the payoffs of the batch;
+        the inner value at a point is the one given by the calculator
+        of the corresponding payoff.
+    */
+    class FdmBatchInnerValue : public FdmInnerValueCalculator {
+      public:
+        FdmBatchInnerValue(
+            std::vector<ext::shared_ptr<FdmInnerValueCalculator> > calculators,
+            Size batchDirection);
+
+        Real innerValue(const FdmLinearOpIterator& iter, Time t) override;
+        Real avgInnerValue(const FdmLinearOpIterator& iter, Time t) override;
+
+      private:
+        const std::vector<ext::shared_ptr<FdmInnerValueCalculator> > calculators_;
+        const Size batchDirection_;
+    };
+
     class FdmZeroInnerValue : public FdmInnerValueCalculator {
       public:
         Real innerValue(const FdmLinearOpIterator&, Time) override { return 0.0; }
@@ -10,6 +10,8 @@
 #include <ql/methods/montecarlo/mctraits.hpp>
 #include <ql/methods/montecarlo/montecarlomodel.hpp>
 #include <ql/methods/montecarlo/multipath.hpp>
+#include <ql/methods/montecarlo/multipathbatch.hpp>
+#include <ql/methods/montecarlo/multipathbatchgenerator.hpp>
 #include <ql/methods/montecarlo/multipathgenerator.hpp>
 #include <ql/methods/montecarlo/nodedata.hpp>
 #include <ql/methods/montecarlo/parametricexercise.hpp>
@@ -32,8 +32,12 @@
 #include <ql/methods/montecarlo/earlyexercisepathpricer.hpp>
 #include <ql/methods/montecarlo/pathpricer.hpp>
 #include <ql/termstructures/yieldtermstructure.hpp>
+#include <ql/utilities/parallel.hpp>
+#include <iterator>
 #include <utility>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace QuantLib {
 
@@ -63,6 +67,40 @@ namespace QuantLib {
 
         Real exerciseProbability() const;
 
+        //! \name Calibration settings
+        //@{
+        /*! If \p storePaths is false, the full calibration paths are
+            not kept.  For each path, only the exercise value and the
+            regression state at each time are stored, i.e., the data
+            read by the regression and by post_processing; this
+            amounts to one Real and one state per path and time.
+            Calibration results don't change.
+        */
+        void storeCalibrationPaths(bool storePaths);
+        /*! The exercise values and regression states at each time are
+            calculated over the given number of threads, each of them
+            working on a contiguous block of paths.  The regression
+            data are then gathered in path order and fitted as in the
+            single-threaded case, so that results don't depend on the
+            number of threads.
+        */
+        void setCalibrationThreads(Size threads);
+        //@}
+
+        //! adds calibration paths drawn on several threads
+        /*! The i-th generator draws <tt>samples[i]</tt> paths, each
+            followed by its antithetic if required, on a separate
+            thread.  Paths are stored in generator order, i.e., as if
+            they had been passed to operator() one generator after the
+            other.  The generators should be built on the calling
+            thread beforehand.
+        */
+        template <class PathGenerator>
+        void addCalibrationPaths(
+            const std::vector<ext::shared_ptr<PathGenerator> >& generators,
+            const std::vector<Size>& samples,
+            bool antitheticVariate);
+
       protected:
         virtual void post_processing(const Size i,
                                      const std::vector<StateType> &state,
@@ -73,6 +111,8 @@ namespace QuantLib {
             pathPricer_;
 
         mutable QuantLib::IncrementalStatistics exerciseProbability_;
+        // paths might be priced concurrently after calibration
+        mutable std::mutex exerciseProbabilityMutex_;
 
         std::unique_ptr<Array[]> coeff_;
         std::unique_ptr<DiscountFactor[]> dF_;
@@ -81,6 +121,31 @@ namespace QuantLib {
         const   std::vector<std::function<Real(StateType)> > v_;
 
         const Size len_;
+
+        bool storePaths_ = true;
+        Size calibrationThreads_ = 1;
+        // when the full calibration paths are not stored, they are
+        // replaced by the exercise values and regression states by
+        // path, then by time (excluding the first)
+        mutable std::vector<Real> exercises_;
+        mutable std::vector<StateType> states_;
+
+      private:
+        void store(const PathType& path,
+                   std::vector<PathType>& paths,
+                   std::vector<Real>& exercises,
+                   std::vector<StateType>& states) const;
+        Size calibrationPaths() const;
+        StateType calibrationState(Size j, Size i) const;
+        Real calibrationExercise(Size j, Size i) const;
+        void rollBack(Size i, Array& prices, Array& exercise,
+                      std::vector<StateType>& p_state,
+                      std::vector<Real>& p_price,
+                      std::vector<Real>& p_exercise);
+        void rollBackInParallel(Size i, Array& prices, Array& exercise,
+                                std::vector<StateType>& p_state,
+                                std::vector<Real>& p_price,
+                                std::vector<Real>& p_exercise);
     };
 
     template <class PathType>
@@ -103,7 +168,7 @@ namespace QuantLib {
         (const PathType& path) const {
         if (calibrationPhase_) {
             // store paths for the calibration
-            paths_.push_back(path);
+            store(path, paths_, exercises_, states_);
             // result doesn't matter
             return 0.0;
         }
@@ -134,75 +199,257 @@ namespace QuantLib {
             }
         }
 
-        exerciseProbability_.add(exercised ? 1.0 : 0.0);
+        {
+            std::lock_guard<std::mutex> lock(exerciseProbabilityMutex_);
+            exerciseProbability_.add(exercised ? 1.0 : 0.0);
+        }
 
         return price*dF_[0];
     }
 
     template <class PathType> inline
     void LongstaffSchwartzPathPricer<PathType>::calibrate() {
-        const Size n = paths_.size();
+        const Size n = calibrationPaths();
         Array prices(n), exercise(n);
         std::vector<StateType> p_state(n);
         std::vector<Real> p_price(n), p_exercise(n);
 
         for (Size i=0; i<n; ++i) {
-            p_state[i] = pathPricer_->state(paths_[i],len_-1);
-            prices[i] = p_price[i] = (*pathPricer_)(paths_[i], len_-1);
+            p_state[i] = calibrationState(i, len_-1);
+            prices[i] = p_price[i] = calibrationExercise(i, len_-1);
             p_exercise[i] = prices[i];
         }
 
         post_processing(len_ - 1, p_state, p_price, p_exercise);
 
+        for (Size i=len_-2; i>0; --i) {
+            if (calibrationThreads_ > 1 && n > 1)
+                rollBackInParallel(i, prices, exercise,
+                                   p_state, p_price, p_exercise);
+            else
+                rollBack(i, prices, exercise, p_state, p_price, p_exercise);
+
+            post_processing(i, p_state, p_price, p_exercise);
+        }
+
+        // remove calibration paths and release memory
+        std::vector<PathType> empty;
+        paths_.swap(empty);
+        std::vector<Real>().swap(exercises_);
+        std::vector<StateType>().swap(states_);
+        // entering the calculation phase
+        calibrationPhase_ = false;
+    }
+
+    template <class PathType> inline
+    void LongstaffSchwartzPathPricer<PathType>::rollBack(
+                                    Size i, Array& prices, Array& exercise,
+                                    std::vector<StateType>& p_state,
+                                    std::vector<Real>& p_price,
+                                    std::vector<Real>& p_exercise) {
+        const Size n = prices.size();
         std::vector<Real>      y;
         std::vector<StateType> x;
-        for (Size i=len_-2; i>0; --i) {
-            y.clear();
-            x.clear();
 
-            //roll back step
-            for (Size j=0; j<n; ++j) {
-                exercise[j]=(*pathPricer_)(paths_[j], i);
-                if (exercise[j]>0.0) {
-                    x.push_back(pathPricer_->state(paths_[j], i));
-                    y.push_back(dF_[i]*prices[j]);
-                }
+        //roll back step
+        for (Size j=0; j<n; ++j) {
+            exercise[j]=calibrationExercise(j, i);
+            p_state[j] = calibrationState(j, i);
+            if (exercise[j]>0.0) {
+                x.push_back(p_state[j]);
+                y.push_back(dF_[i]*prices[j]);
             }
+        }
+
+        if (v_.size() <=  x.size()) {
+            coeff_[i-1] = GeneralLinearLeastSquares(x, y, v_).coefficients();
+        }
+        else {
+        // if number of itm paths is smaller then the number of
+        // calibration functions then early exercise if exerciseValue > 0
+            coeff_[i-1] = Array(v_.size(), 0.0);
+        }
 
-            if (v_.size() <=  x.size()) {
-                coeff_[i-1] = GeneralLinearLeastSquares(x, y, v_).coefficients();
+        for (Size j=0; j<n; ++j) {
+            prices[j]*=dF_[i];
+            if (exercise[j]>0.0) {
+                Real continuationValue = 0.0;
+                for (Size l=0; l<v_.size(); ++l) {
+                    continuationValue += coeff_[i-1][l] * v_[l](p_state[j]);
+                }
+                if (continuationValue < exercise[j]) {
+                    prices[j] = exercise[j];
+                }
             }
-            else {
-            // if number of itm paths is smaller then the number of
-            // calibration functions then early exercise if exerciseValue > 0
-                coeff_[i-1] = Array(v_.size(), 0.0);
+            p_price[j] = prices[j];
+            p_exercise[j] = exercise[j];
+        }
+    }
+
+    template <class PathType> inline
+    void LongstaffSchwartzPathPricer<PathType>::rollBackInParallel(
+                                    Size i, Array& prices, Array& exercise,
+                                    std::vector<StateType>& p_state,
+                                    std::vector<Real>& p_price,
+                                    std::vector<Real>& p_exercise) {
+        const Size n = prices.size(), m = v_.size();
+        const Size blockSize = detail::parallelBlockSize(n, calibrationThreads_);
+        const Size blocks = (n + blockSize - 1) / blockSize;
+
+        // regression data of each block of paths; they're gathered
+        // in path order, so that the fit is the same as with a
+        // single thread
+        std::vector<std::vector<StateType> > xs(blocks);
+        std::vector<std::vector<Real> > ys(blocks);
+
+        detail::runInParallel(blocks, [&](Size b) {
+            const Size to = std::min(n, (b+1)*blockSize);
+            for (Size j=b*blockSize; j<to; ++j) {
+                exercise[j] = calibrationExercise(j, i);
+                p_state[j] = calibrationState(j, i);
+                if (exercise[j] > 0.0) {
+                    xs[b].push_back(p_state[j]);
+                    ys[b].push_back(dF_[i]*prices[j]);
+                }
             }
+        });
+
+        std::vector<StateType> x;
+        std::vector<Real> y;
+        for (Size b=0; b<blocks; ++b) {
+            x.insert(x.end(), std::make_move_iterator(xs[b].begin()),
+                     std::make_move_iterator(xs[b].end()));
+            y.insert(y.end(), ys[b].begin(), ys[b].end());
+        }
+
+        if (m <= x.size()) {
+            coeff_[i-1] = GeneralLinearLeastSquares(x, y, v_).coefficients();
+        }
+        else {
+        // if number of itm paths is smaller then the number of
+        // calibration functions then early exercise if exerciseValue > 0
+            coeff_[i-1] = Array(m, 0.0);
+        }
 
-            for (Size j=0, k=0; j<n; ++j) {
+        const Array& coeff = coeff_[i-1];
+        detail::runInParallel(blocks, [&](Size b) {
+            const Size to = std::min(n, (b+1)*blockSize);
+            for (Size j=b*blockSize; j<to; ++j) {
                 prices[j]*=dF_[i];
                 if (exercise[j]>0.0) {
                     Real continuationValue = 0.0;
-                    for (Size l=0; l<v_.size(); ++l) {
-                        continuationValue += coeff_[i-1][l] * v_[l](x[k]);
+                    for (Size l=0; l<m; ++l) {
+                        continuationValue += coeff[l] * v_[l](p_state[j]);
                     }
                     if (continuationValue < exercise[j]) {
                         prices[j] = exercise[j];
                     }
-                    ++k;
                 }
-                p_state[j] = pathPricer_->state(paths_[j],i);
                 p_price[j] = prices[j];
                 p_exercise[j] = exercise[j];
             }
+        });
+    }
 
-            post_processing(i, p_state, p_price, p_exercise);
+    template <class PathType> inline
+    void LongstaffSchwartzPathPricer<PathType>::storeCalibrationPaths(
+                                                            bool storePaths) {
+        QL_REQUIRE(paths_.empty() && exercises_.empty(),
+                   "calibration paths already added");
+        storePaths_ = storePaths;
+    }
+
+    template <class PathType> inline
+    void LongstaffSchwartzPathPricer<PathType>::setCalibrationThreads(
+                                                                Size threads) {
+        QL_REQUIRE(threads > 0, "at least one thread required");
+        calibrationThreads_ = threads;
+    }
+
+    template <class PathType>
+    template <class PathGenerator>
+    inline void LongstaffSchwartzPathPricer<PathType>::addCalibrationPaths(
+            const std::vector<ext::shared_ptr<PathGenerator> >& generators,
+            const std::vector<Size>& samples,
+            bool antitheticVariate) {
+        QL_REQUIRE(calibrationPhase_, "path pricer already calibrated");
+        QL_REQUIRE(generators.size() == samples.size(),
+                   "the number of generators (" << generators.size()
+                   << ") differs from the number of sample counts ("
+                   << samples.size() << ")");
+        const Size blocks = generators.size();
+        if (blocks == 0)
+            return;
+
+        std::vector<std::vector<PathType> > paths(blocks);
+        std::vector<std::vector<Real> > exercises(blocks);
+        std::vector<std::vector<StateType> > states(blocks);
+        auto generate = [&](Size b, Size from, Size to) {
+            const PathGenerator& generator = *generators[b];
+            for (Size k=from; k<to; ++k) {
+                store(generator.next().value,
+                      paths[b], exercises[b], states[b]);
+                if (antitheticVariate)
+                    store(generator.antithetic().value,
+                          paths[b], exercises[b], states[b]);
+            }
+        };
+
+        // as in MonteCarloModel, the first path is drawn before
+        // starting the other threads so that any lazily-initialized
+        // state is set up on the calling thread.
+        const Size first = std::min<Size>(1, samples[0]);
+        generate(0, 0, first);
+        detail::runInParallel(blocks, [&](Size b) {
+            generate(b, b == 0 ? first : 0, samples[b]);
+        });
+
+        for (Size b=0; b<blocks; ++b) {
+            paths_.insert(paths_.end(),
+                          std::make_move_iterator(paths[b].begin()),
+                          std::make_move_iterator(paths[b].end()));
+            exercises_.insert(exercises_.end(),
+                              exercises[b].begin(), exercises[b].end());
+            states_.insert(states_.end(),
+                           std::make_move_iterator(states[b].begin()),
+                           std::make_move_iterator(states[b].end()));
         }
+    }
 
-        // remove calibration paths and release memory
-        std::vector<PathType> empty;
-        paths_.swap(empty);
-        // entering the calculation phase
-        calibrationPhase_ = false;
+    template <class PathType> inline
+    void LongstaffSchwartzPathPricer<PathType>::store(
+                                        const PathType& path,
+                                        std::vector<PathType>& paths,
+                                        std::vector<Real>& exercises,
+                                        std::vector<StateType>& states) const {
+        if (storePaths_) {
+            paths.push_back(path);
+        } else {
+            for (Size i=1; i<len_; ++i) {
+                exercises.push_back((*pathPricer_)(path, i));
+                states.push_back(pathPricer_->state(path, i));
+            }
+        }
+    }
+
+    template <class PathType> inline
+    Size LongstaffSchwartzPathPricer<PathType>::calibrationPaths() const {
+        return storePaths_ ? paths_.size() : exercises_.size()/(len_-1);
+    }
+
+    template <class PathType> inline
+    typename LongstaffSchwartzPathPricer<PathType>::StateType
+    LongstaffSchwartzPathPricer<PathType>::calibrationState(Size j,
+                                                            Size i) const {
+        return storePaths_ ? pathPricer_->state(paths_[j], i)
+                           : states_[j*(len_-1)+i-1];
+    }
+
+    template <class PathType> inline
+    Real LongstaffSchwartzPathPricer<PathType>::calibrationExercise(
+                                                        Size j, Size i) const {
+        return storePaths_ ? (*pathPricer_)(paths_[j], i)
+                           : exercises_[j*(len_-1)+i-1];
     }
 
     template <class PathType> inline
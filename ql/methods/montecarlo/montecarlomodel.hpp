@@ -27,8 +27,12 @@
 
 #include <ql/math/statistics/statistics.hpp>
 #include <ql/methods/montecarlo/mctraits.hpp>
+#include <ql/utilities/parallel.hpp>
 #include <ql/shared_ptr.hpp>
+#include <algorithm>
+#include <functional>
 #include <utility>
+#include <vector>
 
 namespace QuantLib {
 
@@ -46,6 +50,9 @@ namespace QuantLib {
         provide the additional control option, namely the option path
         pricer and the option value.
 
+        Samples can be drawn on several threads, see setThreads(),
+        or in batches of paths, see setBatchSampler().
+
         \ingroup mcarlo
     */
     template <template <class> class MC, class RNG, class S = Statistics>
@@ -58,6 +65,12 @@ namespace QuantLib {
         typedef typename path_generator_type::sample_type sample_type;
         typedef typename path_pricer_type::result_type result_type;
         typedef S stats_type;
+        typedef std::function<ext::shared_ptr<path_generator_type>(Size, Size)>
+            path_generator_factory;
+        typedef std::function<void(std::vector<result_type>&,
+                                   std::vector<Real>&)> batch_sampler;
+        typedef std::function<batch_sampler(Size, Size)>
+            batch_sampler_factory;
         // constructor
         MonteCarloModel(
             ext::shared_ptr<path_generator_type> pathGenerator,
@@ -76,7 +89,60 @@ namespace QuantLib {
         }
         void addSamples(Size samples);
         const stats_type& sampleAccumulator() const;
+        /*! Enables multi-threaded sampling.  Each call to addSamples()
+            splits the samples in contiguous blocks, one per thread.
+            The first block of the first call is drawn from the path
+            generator passed to the constructor; every other block is
+            drawn from a generator built as
+            <tt>factory(stream, firstSample)</tt>, where
+            <tt>stream</tt> is a number never used before by this
+            model and <tt>firstSample</tt> is the index of the first
+            sample in the block.  Factories can thus either return
+            independent pseudo-random streams or move a
+            low-discrepancy sequence ahead to the first sample.
+            Samples are added to the accumulator in block order, so
+            that results are reproducible for a given number of
+            threads.  The threads are started here and reused by all
+            calls to addSamples().
+
+            \warning the path pricers are shared among threads and
+                     must be safe to call concurrently.  A separate
+                     control-variate path generator is not supported.
+        */
+        void setThreads(Size threads, path_generator_factory factory);
+        Size threads() const { return threads_; }
+        /*! Enables batched sampling.  Instead of drawing a path at a
+            time from the path generator, the samples are taken from
+            the batches returned by <tt>sampler(values, weights)</tt>,
+            which must fill the vectors with the values of the next
+            batch of paths (already averaged with their antithetic
+            ones, if needed) and with their weights.  Samples left
+            over in the last batch are used by the next call to
+            addSamples(), so that the sequence of samples doesn't
+            depend on how they are requested; a sampler drawing its
+            paths from the same sequence as the path generator will
+            thus give the same results.
+
+            With more than one thread, the first block of the first
+            call to addSamples() is drawn from <tt>sampler</tt> and
+            every other block from a sampler built as
+            <tt>factory(stream, firstSample)</tt>, as for the path
+            generators in setThreads(); samples left over in the last
+            batch of a block are discarded.
+
+            \warning batched sampling is not available with control
+                     variate, and multi-threaded batched sampling
+                     requires a factory.
+        */
+        void setBatchSampler(
+            batch_sampler sampler,
+            batch_sampler_factory factory = batch_sampler_factory());
       private:
+        result_type nextSample(const path_generator_type& generator,
+                               const path_generator_type* cvGenerator,
+                               Real& weight) const;
+        void addSamplesInParallel(Size samples);
+        void addSamplesInBatches(Size samples);
         ext::shared_ptr<path_generator_type> pathGenerator_;
         ext::shared_ptr<path_pricer_type> pathPricer_;
         stats_type sampleAccumulator_;
@@ -85,43 +151,210 @@ namespace QuantLib {
         result_type cvOptionValue_;
         bool isControlVariate_;
         ext::shared_ptr<path_generator_type> cvPathGenerator_;
+        Size threads_ = 1;
+        ext::shared_ptr<detail::ThreadPool> threadPool_;
+        path_generator_factory pathGeneratorFactory_;
+        Size nextStream_ = 1;
+        batch_sampler batchSampler_;
+        batch_sampler_factory batchSamplerFactory_;
+        std::vector<result_type> batchValues_;
+        std::vector<Real> batchWeights_;
+        Size nextInBatch_ = 0;
     };
 
     // inline definitions
     template <template <class> class MC, class RNG, class S>
     inline void MonteCarloModel<MC,RNG,S>::addSamples(Size samples) {
+        if (threads_ > 1 && samples > 1) {
+            addSamplesInParallel(samples);
+            return;
+        }
+        if (batchSampler_) {
+            addSamplesInBatches(samples);
+            return;
+        }
         for(Size j = 1; j <= samples; j++) {
+            Real weight;
+            result_type price =
+                nextSample(*pathGenerator_, cvPathGenerator_.get(), weight);
+            sampleAccumulator_.add(price, weight);
+        }
+    }
+
+    template <template <class> class MC, class RNG, class S>
+    inline typename MonteCarloModel<MC,RNG,S>::result_type
+    MonteCarloModel<MC,RNG,S>::nextSample(
+                                  const path_generator_type& generator,
+                                  const path_generator_type* cvGenerator,
+                                  Real& weight) const {
+        const sample_type& path = generator.next();
+        result_type price = (*pathPricer_)(path.value);
 
-            const sample_type& path = pathGenerator_->next();
-            result_type price = (*pathPricer_)(path.value);
+        if (isControlVariate_) {
+            if (cvGenerator == nullptr) {
+                price += cvOptionValue_-(*cvPathPricer_)(path.value);
+            }
+            else {
+                const sample_type& cvPath = cvGenerator->next();
+                price += cvOptionValue_-(*cvPathPricer_)(cvPath.value);
+            }
+        }
 
+        weight = path.weight;
+        if (isAntitheticVariate_) {
+            const sample_type& atPath = generator.antithetic();
+            result_type price2 = (*pathPricer_)(atPath.value);
             if (isControlVariate_) {
-                if (!cvPathGenerator_) {
-                    price += cvOptionValue_-(*cvPathPricer_)(path.value);
-                }
+                if (cvGenerator == nullptr)
+                    price2 += cvOptionValue_-(*cvPathPricer_)(atPath.value);
                 else {
-                    const sample_type& cvPath = cvPathGenerator_->next();
-                    price += cvOptionValue_-(*cvPathPricer_)(cvPath.value);
+                    const sample_type& cvPath = cvGenerator->antithetic();
+                    price2 += cvOptionValue_-(*cvPathPricer_)(cvPath.value);
                 }
             }
+            return (price+price2)/2.0;
+        } else {
+            return price;
+        }
+    }
 
-            if (isAntitheticVariate_) {
-                const sample_type& atPath = pathGenerator_->antithetic();
-                result_type price2 = (*pathPricer_)(atPath.value);
-                if (isControlVariate_) {
-                    if (!cvPathGenerator_)
-                        price2 += cvOptionValue_-(*cvPathPricer_)(atPath.value);
-                    else {
-                        const sample_type& cvPath = cvPathGenerator_->antithetic();
-                        price2 += cvOptionValue_-(*cvPathPricer_)(cvPath.value);
-                    }
-                }
+    template <template <class> class MC, class RNG, class S>
+    inline void MonteCarloModel<MC,RNG,S>::setThreads(
+                                       Size threads,
+                                       path_generator_factory factory) {
+        QL_REQUIRE(threads > 0, "at least one thread required");
+        QL_REQUIRE(threads == 1 || !cvPathGenerator_,
+                   "multi-threaded sampling not available with a "
+                   "separate control-variate path generator");
+        QL_REQUIRE(threads == 1 || factory,
+                   "path-generator factory required "
+                   "for multi-threaded sampling");
+        QL_REQUIRE(threads == 1 || !batchSampler_ || batchSamplerFactory_,
+                   "batch-sampler factory required "
+                   "for multi-threaded batched sampling");
+        if (threads != threads_)
+            threadPool_ = threads > 1 ?
+                ext::make_shared<detail::ThreadPool>(threads) :
+                ext::shared_ptr<detail::ThreadPool>();
+        threads_ = threads;
+        pathGeneratorFactory_ = std::move(factory);
+    }
 
-                sampleAccumulator_.add((price+price2)/2.0, path.weight);
+    template <template <class> class MC, class RNG, class S>
+    inline void MonteCarloModel<MC,RNG,S>::setBatchSampler(
+                                      batch_sampler sampler,
+                                      batch_sampler_factory factory) {
+        QL_REQUIRE(!sampler || threads_ == 1 || factory,
+                   "batch-sampler factory required "
+                   "for multi-threaded batched sampling");
+        QL_REQUIRE(!sampler || !isControlVariate_,
+                   "batched sampling not available with control variate");
+        batchSampler_ = std::move(sampler);
+        batchSamplerFactory_ = std::move(factory);
+        batchValues_.clear();
+        batchWeights_.clear();
+        nextInBatch_ = 0;
+    }
+
+    template <template <class> class MC, class RNG, class S>
+    inline void MonteCarloModel<MC,RNG,S>::addSamplesInBatches(
+                                                             Size samples) {
+        while (samples > 0) {
+            if (nextInBatch_ == batchValues_.size()) {
+                batchSampler_(batchValues_, batchWeights_);
+                QL_REQUIRE(!batchValues_.empty()
+                           && batchWeights_.size() == batchValues_.size(),
+                           "empty or inconsistent batch of samples");
+                nextInBatch_ = 0;
+            }
+            const Size n =
+                std::min(samples, Size(batchValues_.size() - nextInBatch_));
+            for (Size j=nextInBatch_; j<nextInBatch_+n; ++j)
+                sampleAccumulator_.add(batchValues_[j], batchWeights_[j]);
+            nextInBatch_ += n;
+            samples -= n;
+        }
+    }
+
+    template <template <class> class MC, class RNG, class S>
+    inline void MonteCarloModel<MC,RNG,S>::addSamplesInParallel(
+                                                             Size samples) {
+        const Size blockSize = detail::parallelBlockSize(samples, threads_);
+        const Size blocks = (samples + blockSize - 1) / blockSize;
+
+        // the generators and samplers are created here on the calling
+        // thread, since their construction might register observers.
+        // The sampler passed to setBatchSampler() can only be used for
+        // the first block if no batch was drawn from it yet.
+        const bool batched = static_cast<bool>(batchSampler_);
+        const Size firstSample = sampleAccumulator_.samples();
+        std::vector<ext::shared_ptr<path_generator_type> > generators(
+                                                      batched ? 0 : blocks);
+        std::vector<batch_sampler> samplers(batched ? blocks : 0);
+        for (Size i=0; i<blocks; ++i) {
+            const Size first = firstSample + i*blockSize;
+            if (batched) {
+                if (i == 0 && nextStream_ == 1 && batchValues_.empty())
+                    samplers[i] = batchSampler_;
+                else
+                    samplers[i] = batchSamplerFactory_(nextStream_++, first);
             } else {
-                sampleAccumulator_.add(price, path.weight);
+                if (i == 0 && nextStream_ == 1)
+                    generators[i] = pathGenerator_;
+                else
+                    generators[i] =
+                        pathGeneratorFactory_(nextStream_++, first);
             }
         }
+
+        std::vector<std::vector<std::pair<result_type, Real> > >
+            results(blocks);
+
+        // draws samples until the block holds at least minSize of them;
+        // a batch might give more, which are kept up to maxSize.
+        auto simulateBlock = [&](Size i, Size minSize, Size maxSize) {
+            std::vector<std::pair<result_type, Real> >& block = results[i];
+            if (batched) {
+                std::vector<result_type> values;
+                std::vector<Real> weights;
+                while (block.size() < minSize) {
+                    samplers[i](values, weights);
+                    QL_REQUIRE(!values.empty()
+                               && weights.size() == values.size(),
+                               "empty or inconsistent batch of samples");
+                    for (Size j=0; j<values.size() && block.size()<maxSize;
+                         ++j)
+                        block.emplace_back(values[j], weights[j]);
+                }
+            } else {
+                const path_generator_type& generator = *generators[i];
+                while (block.size() < minSize) {
+                    Real weight;
+                    result_type price =
+                        nextSample(generator, nullptr, weight);
+                    block.emplace_back(price, weight);
+                }
+            }
+        };
+        auto blockEnd = [&](Size i) {
+            return std::min(blockSize, samples - i*blockSize);
+        };
+
+        // the first sample is drawn before starting the other threads,
+        // so that any state lazily initialized by the process or by
+        // the term structures it uses is set up on a single thread.
+        results[0].reserve(blockSize);
+        simulateBlock(0, 1, blockEnd(0));
+
+        threadPool_->run(blocks, [&](Size i) {
+            results[i].reserve(blockEnd(i));
+            simulateBlock(i, blockEnd(i), blockEnd(i));
+        });
+
+        for (const auto& block : results) {
+            for (const auto& sample : block)
+                sampleAccumulator_.add(sample.first, sample.second);
+        }
     }
 
     template <template <class> class MC, class RNG, class S>
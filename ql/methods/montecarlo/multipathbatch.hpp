@@ -0,0 +1,131 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file multipathbatch.hpp
+    \brief Batch of correlated multiple asset paths
+*/
+
+#ifndef quantlib_montecarlo_multi_path_batch_hpp
+#define quantlib_montecarlo_multi_path_batch_hpp
+
+#include <ql/methods/montecarlo/multipath.hpp>
+#include <utility>
+#include <vector>
+
+namespace QuantLib {
+
+    //! Batch of correlated multiple asset paths
+    /*! MultiPathBatch stores a number of multi-asset paths sharing
+        the same time grid in a single contiguous block.  The values
+        are laid out by time, then by asset, then by path, so that
+        slice(i,j) returns the values of the j-th asset at the i-th
+        time on all paths as a contiguous range, and the values of
+        all assets at the i-th time form a contiguous block starting
+        at slice(i,0).  This is the layout expected by the batch
+        evolution methods of stochastic processes and lets loops over
+        paths be vectorized.
+
+        \ingroup mcarlo
+    */
+    class MultiPathBatch {
+      public:
+        MultiPathBatch() = default;
+        MultiPathBatch(Size nPaths,
+                       Size nAsset,
+                       TimeGrid timeGrid);
+        //! \name inspectors
+        //@{
+        Size pathNumber() const { return paths_; }
+        Size assetNumber() const { return assets_; }
+        Size pathSize() const { return timeGrid_.size(); }
+        const TimeGrid& timeGrid() const { return timeGrid_; }
+        //@}
+        //! \name read/write access to components
+        //@{
+        //! value of the j-th asset at the i-th time on the p-th path
+        Real operator()(Size p, Size j, Size i) const;
+        Real& operator()(Size p, Size j, Size i);
+        //! values of the j-th asset at the i-th time on all paths
+        const Real* slice(Size i, Size j) const;
+        Real* slice(Size i, Size j);
+        //! weights of the paths
+        const std::vector<Real>& weights() const { return weights_; }
+        std::vector<Real>& weights() { return weights_; }
+        //@}
+        //! \name conversion
+        //@{
+        //! copies the p-th path into the given multi-path
+        void path(Size p, MultiPath& result) const;
+        MultiPath path(Size p) const;
+        //@}
+      private:
+        Size paths_ = 0, assets_ = 0;
+        TimeGrid timeGrid_;
+        Array values_;
+        std::vector<Real> weights_;
+    };
+
+
+    // inline definitions
+
+    inline MultiPathBatch::MultiPathBatch(Size nPaths,
+                                          Size nAsset,
+                                          TimeGrid timeGrid)
+    : paths_(nPaths), assets_(nAsset), timeGrid_(std::move(timeGrid)),
+      values_(nPaths*nAsset*timeGrid_.size()), weights_(nPaths, 1.0) {
+        QL_REQUIRE(nPaths > 0, "number of paths must be positive");
+        QL_REQUIRE(nAsset > 0, "number of asset must be positive");
+    }
+
+    inline Real MultiPathBatch::operator()(Size p, Size j, Size i) const {
+        return values_[(i*assets_+j)*paths_+p];
+    }
+
+    inline Real& MultiPathBatch::operator()(Size p, Size j, Size i) {
+        return values_[(i*assets_+j)*paths_+p];
+    }
+
+    inline const Real* MultiPathBatch::slice(Size i, Size j) const {
+        return values_.begin() + (i*assets_+j)*paths_;
+    }
+
+    inline Real* MultiPathBatch::slice(Size i, Size j) {
+        return values_.begin() + (i*assets_+j)*paths_;
+    }
+
+    inline void MultiPathBatch::path(Size p, MultiPath& result) const {
+        QL_REQUIRE(p < paths_, "path " << p << " out of range");
+        QL_REQUIRE(result.assetNumber() == assets_ &&
+                   result.pathSize() == timeGrid_.size(),
+                   "multi-path of wrong size given");
+        for (Size j=0; j<assets_; ++j) {
+            Path& path = result[j];
+            for (Size i=0; i<timeGrid_.size(); ++i)
+                path[i] = (*this)(p, j, i);
+        }
+    }
+
+    inline MultiPath MultiPathBatch::path(Size p) const {
+        MultiPath result(assets_, timeGrid_);
+        path(p, result);
+        return result;
+    }
+
+}
+
+
+#endif
@@ -0,0 +1,238 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file multipathbatchgenerator.hpp
+    \brief Generates batches of multi paths from a random-array generator
+*/
+
+#ifndef quantlib_multi_path_batch_generator_hpp
+#define quantlib_multi_path_batch_generator_hpp
+
+#include <ql/methods/montecarlo/brownianbridge.hpp>
+#include <ql/methods/montecarlo/multipathbatch.hpp>
+#include <ql/stochasticprocess.hpp>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace QuantLib {
+
+    //! Generates batches of multipaths from a random number generator.
+    /*! GSG is a sample generator which returns a random sequence,
+        with the same interface required by MultiPathGenerator.
+
+        The p-th path in a batch is built from the p-th sequence
+        drawn for it, so that a sequence of batches contains the same
+        paths, in the same order, as the sequence of samples returned
+        by a MultiPathGenerator built on the same generator.  Paths
+        are evolved a time step at a time across the whole batch by
+        means of StochasticProcess::evolveBatch.
+
+        If the Brownian bridge is used, the draws for each factor are
+        taken as the variates of a bridge over the time grid, so that
+        the ones at the start of each sequence determine the values
+        of the factors at maturity; the draws for the i-th point of
+        the bridge of the j-th factor are at index \f$ i n + j \f$ of
+        a sequence, \f$ n \f$ being the number of factors.  For a
+        single factor, the paths are the same as the ones returned by
+        a PathGenerator using the Brownian bridge.
+
+        \ingroup mcarlo
+
+        \test the generated paths are checked against the ones
+              returned by MultiPathGenerator, and against the ones
+              returned by PathGenerator when using the Brownian bridge
+    */
+    template <class GSG>
+    class MultiPathBatchGenerator {
+      public:
+        typedef MultiPathBatch batch_type;
+        MultiPathBatchGenerator(const ext::shared_ptr<StochasticProcess>&,
+                                const TimeGrid&,
+                                GSG generator,
+                                Size batchSize,
+                                bool brownianBridge = false);
+        //! returns a new batch of paths
+        const batch_type& next() const;
+        //! returns the antithetic paths of the last batch
+        const batch_type& antithetic() const;
+        Size batchSize() const { return next_.pathNumber(); }
+      private:
+        const batch_type& evolve(bool antithetic) const;
+        void transformDraws() const;
+        ext::shared_ptr<StochasticProcess> process_;
+        GSG generator_;
+        bool brownianBridge_;
+        BrownianBridge bridge_;
+        mutable batch_type next_;
+        // random draws of the last batch, by time step, then by
+        // factor, then by path
+        mutable Array draws_;
+        // negated draws for a single step
+        mutable Array antitheticDraws_;
+        // bridged Brownian motion of a factor, by time, then by path
+        mutable Array bridgePaths_;
+    };
+
+
+    // template definitions
+
+    template <class GSG>
+    MultiPathBatchGenerator<GSG>::MultiPathBatchGenerator(
+                          const ext::shared_ptr<StochasticProcess>& process,
+                          const TimeGrid& times,
+                          GSG generator,
+                          Size batchSize,
+                          bool brownianBridge)
+    : process_(process), generator_(std::move(generator)),
+      brownianBridge_(brownianBridge), bridge_(times),
+      next_(batchSize, process->size(), times),
+      draws_(batchSize*generator_.dimension()),
+      antitheticDraws_(batchSize*process->factors()) {
+
+        QL_REQUIRE(generator_.dimension() ==
+                   process->factors()*(times.size()-1),
+                   "dimension (" << generator_.dimension()
+                   << ") is not equal to ("
+                   << process->factors() << " * " << times.size()-1
+                   << ") the number of factors "
+                   << "times the number of time steps");
+        QL_REQUIRE(times.size() > 1,
+                   "no times given");
+        if (brownianBridge_)
+            bridgePaths_ = Array(batchSize*(times.size()-1));
+    }
+
+    template <class GSG>
+    inline const typename MultiPathBatchGenerator<GSG>::batch_type&
+    MultiPathBatchGenerator<GSG>::next() const {
+        const Size nPaths = next_.pathNumber();
+        const Size dimension = generator_.dimension();
+        std::vector<Real>& weights = next_.weights();
+        for (Size p=0; p<nPaths; ++p) {
+            typedef typename GSG::sample_type sequence_type;
+            const sequence_type& sequence = generator_.nextSequence();
+            for (Size k=0; k<dimension; ++k)
+                draws_[k*nPaths+p] = sequence.value[k];
+            weights[p] = sequence.weight;
+        }
+        if (brownianBridge_)
+            transformDraws();
+        return evolve(false);
+    }
+
+    template <class GSG>
+    void MultiPathBatchGenerator<GSG>::transformDraws() const {
+        // same as BrownianBridge::transform, applied to all the paths
+        // of the batch at once
+        const Size nPaths = next_.pathNumber();
+        const Size n = process_->factors();
+        const Size steps = bridge_.size();
+        const std::vector<Size>& bridgeIndex = bridge_.bridgeIndex();
+        const std::vector<Size>& leftIndex = bridge_.leftIndex();
+        const std::vector<Size>& rightIndex = bridge_.rightIndex();
+        const std::vector<Real>& leftWeight = bridge_.leftWeight();
+        const std::vector<Real>& rightWeight = bridge_.rightWeight();
+        const std::vector<Real>& stdDev = bridge_.stdDeviation();
+        const TimeGrid& timeGrid = next_.timeGrid();
+
+        for (Size j=0; j<n; ++j) {
+            const auto draws = [&](Size i) {
+                return draws_.begin() + (i*n+j)*nPaths;
+            };
+            const auto path = [&](Size i) {
+                return bridgePaths_.begin() + i*nPaths;
+            };
+
+            const Real* z = draws(0);
+            Real* w = path(steps-1);
+            for (Size p=0; p<nPaths; ++p)
+                w[p] = stdDev[0] * z[p];
+            for (Size i=1; i<steps; ++i) {
+                z = draws(i);
+                w = path(bridgeIndex[i]);
+                const Real* right = path(rightIndex[i]);
+                if (leftIndex[i] != 0) {
+                    const Real* left = path(leftIndex[i]-1);
+                    for (Size p=0; p<nPaths; ++p)
+                        w[p] = leftWeight[i] * left[p] +
+                               rightWeight[i] * right[p] +
+                               stdDev[i] * z[p];
+                } else {
+                    for (Size p=0; p<nPaths; ++p)
+                        w[p] = rightWeight[i] * right[p] +
+                               stdDev[i] * z[p];
+                }
+            }
+
+            // variations normalized to unit times; as in the bridge,
+            // the steps are taken from the times rather than from
+            // TimeGrid::dt, which can differ in the last bits
+            for (Size i=0; i<steps; ++i) {
+                Real* dw = draws(i);
+                const Real* current = path(i);
+                const Real sqrtdt = std::sqrt(timeGrid[i+1] - timeGrid[i]);
+                if (i == 0) {
+                    for (Size p=0; p<nPaths; ++p)
+                        dw[p] = current[p] / sqrtdt;
+                } else {
+                    const Real* previous = path(i-1);
+                    for (Size p=0; p<nPaths; ++p)
+                        dw[p] = (current[p] - previous[p]) / sqrtdt;
+                }
+            }
+        }
+    }
+
+    template <class GSG>
+    inline const typename MultiPathBatchGenerator<GSG>::batch_type&
+    MultiPathBatchGenerator<GSG>::antithetic() const {
+        return evolve(true);
+    }
+
+    template <class GSG>
+    const typename MultiPathBatchGenerator<GSG>::batch_type&
+    MultiPathBatchGenerator<GSG>::evolve(bool antithetic) const {
+
+        const Size nPaths = next_.pathNumber();
+        const Size m = process_->size();
+        const Size n = process_->factors();
+        const TimeGrid& timeGrid = next_.timeGrid();
+
+        Array asset = process_->initialValues();
+        for (Size j=0; j<m; ++j)
+            std::fill(next_.slice(0, j), next_.slice(0, j)+nPaths, asset[j]);
+
+        for (Size i=1; i<next_.pathSize(); ++i) {
+            const Time t = timeGrid[i-1];
+            const Time dt = timeGrid.dt(i-1);
+            const Real* draws = draws_.begin() + (i-1)*n*nPaths;
+            if (antithetic) {
+                std::transform(draws, draws+n*nPaths,
+                               antitheticDraws_.begin(), std::negate<>());
+                draws = antitheticDraws_.begin();
+            }
+            std::copy(next_.slice(i-1, 0), next_.slice(i-1, 0)+m*nPaths,
+                      next_.slice(i, 0));
+            process_->evolveBatch(t, nPaths, next_.slice(i, 0), dt, draws);
+        }
+        return next_;
+    }
+
+}
+
+#endif
@@ -28,6 +28,7 @@
 #include <ql/option.hpp>
 #include <ql/types.hpp>
 #include <functional>
+#include <vector>
 
 namespace QuantLib {
 
@@ -45,6 +46,23 @@ namespace QuantLib {
         virtual ValueType operator()(const PathType& path) const=0;
     };
 
+    //! base class for batch path pricers
+    /*! Returns the values of an option on each path of a batch,
+        such as a MultiPathBatch; the values vector is resized to
+        the number of paths in the batch.
+
+        \ingroup mcarlo
+    */
+    template<class BatchType, class ValueType=Real>
+    class BatchPathPricer {
+      public:
+        typedef ValueType result_type;
+
+        virtual ~BatchPathPricer() = default;
+        virtual void operator()(const BatchType& paths,
+                                std::vector<ValueType>& values) const=0;
+    };
+
 }
 
 
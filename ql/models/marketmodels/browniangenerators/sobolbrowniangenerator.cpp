@@ -204,12 +204,22 @@ namespace QuantLib {
                                                    unsigned long seed,
                                                    SobolRsg::DirectionIntegers integers)
     : SobolBrownianGeneratorBase(factors, steps, ordering),
+      seed_(seed), integers_(integers),
       generator_(SobolRsg(factors * steps, seed, integers), InverseCumulativeNormal()) {}
 
     const SobolRsg::sample_type& SobolBrownianGenerator::nextSequence() {
         return generator_.nextSequence();
     }
 
+    void SobolBrownianGenerator::skipTo(std::uint32_t n) {
+        // SobolRsg::skipTo(n) leaves the (n+1)-th sample to be drawn next
+        SobolRsg rsg(numberOfFactors() * numberOfSteps(), seed_, integers_);
+        if (n != 0)
+            rsg.skipTo(n);
+        generator_ = InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>(
+                                            rsg, InverseCumulativeNormal());
+    }
+
     SobolBrownianGeneratorFactory::SobolBrownianGeneratorFactory(
                                     SobolBrownianGenerator::Ordering ordering,
                                     unsigned long seed,
@@ -231,6 +241,7 @@ namespace QuantLib {
         SobolRsg::DirectionIntegers integers,
         unsigned long scrambleSeed)
     : SobolBrownianGeneratorBase(factors, steps, ordering),
+      seed_(seed), integers_(integers), scrambleSeed_(scrambleSeed),
       generator_(Burley2020SobolRsg(factors * steps, seed, integers, scrambleSeed),
                  InverseCumulativeNormal()) {}
 
@@ -238,6 +249,16 @@ namespace QuantLib {
         return generator_.nextSequence();
     }
 
+    void Burley2020SobolBrownianGenerator::skipTo(std::uint32_t n) {
+        // unlike SobolRsg, Burley2020SobolRsg::skipTo(n) draws n+1 samples
+        Burley2020SobolRsg rsg(numberOfFactors() * numberOfSteps(), seed_, integers_,
+                               scrambleSeed_);
+        if (n != 0)
+            rsg.skipTo(n - 1);
+        generator_ = InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>(
+                                            rsg, InverseCumulativeNormal());
+    }
+
     Burley2020SobolBrownianGeneratorFactory::Burley2020SobolBrownianGeneratorFactory(
         SobolBrownianGenerator::Ordering ordering,
         unsigned long seed,
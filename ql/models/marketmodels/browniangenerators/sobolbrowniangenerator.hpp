@@ -27,6 +27,7 @@
 #include <ql/math/randomnumbers/burley2020sobolrsg.hpp>
 #include <ql/methods/montecarlo/brownianbridge.hpp>
 #include <ql/math/distributions/normaldistribution.hpp>
+#include <cstdint>
 #include <vector>
 
 namespace QuantLib {
@@ -84,8 +85,19 @@ namespace QuantLib {
                                unsigned long seed = 0,
                                SobolRsg::DirectionIntegers directionIntegers = SobolRsg::Jaeckel);
 
+        //! moves the generator as if n paths had been drawn
+        /*! The next path is built from the same sample as the
+            (n+1)-th path drawn by a new generator; this allows to
+            split a simulation into contiguous blocks of paths, e.g.,
+            one for each thread, with the same results as a single
+            generator.
+        */
+        void skipTo(std::uint32_t n);
+
       private:
         const SobolRsg::sample_type& nextSequence() override;
+        unsigned long seed_;
+        SobolRsg::DirectionIntegers integers_;
         InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal> generator_;
     };
 
@@ -113,8 +125,17 @@ namespace QuantLib {
             SobolRsg::DirectionIntegers directionIntegers = SobolRsg::Jaeckel,
             unsigned long scrambleSeed = 43);
 
+        //! moves the generator as if n paths had been drawn
+        /*! \warning the scrambled sequence has no fast skip-ahead;
+                     the skipped samples are generated and discarded.
+        */
+        void skipTo(std::uint32_t n);
+
       private:
         const Burley2020SobolRsg::sample_type& nextSequence() override;
+        unsigned long seed_;
+        SobolRsg::DirectionIntegers integers_;
+        unsigned long scrambleSeed_;
         InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal> generator_;
     };
 
@@ -26,6 +26,8 @@ FOR A PARTICULAR PURPOSE.  See the license for more details.
 namespace QuantLib {
 
     void ObservableSettings::enableUpdates() {
+        QL_REQUIRE(transactionDepth_ == 0,
+                   "cannot enable updates during a notification transaction");
         updatesEnabled_  = true;
         updatesDeferred_ = false;
 
@@ -53,6 +55,121 @@ namespace QuantLib {
     }
 
 
+    void ObservableSettings::beginTransaction() {
+        if (transactionDepth_ == 0) {
+            QL_REQUIRE(updatesEnabled_,
+                       "cannot begin a notification transaction "
+                       "while updates are disabled");
+            updatesEnabled_  = false;
+            updatesDeferred_ = true;
+            transactionNotifications_ = transactionUpdates_ = 0;
+        }
+        ++transactionDepth_;
+    }
+
+
+    void ObservableSettings::commitTransaction() {
+        QL_REQUIRE(transactionDepth_ > 0,
+                   "no notification transaction to commit");
+        if (--transactionDepth_ > 0)
+            return;
+
+        bool successful = true;
+        std::string errMsg;
+
+        // updates stay deferred while dispatching, so that the
+        // notifications sent by the updated observers are collected
+        // as well.  The observers are visited in dependency order and
+        // only the ones notified so far are updated; thus, observers
+        // of a lazy object which doesn't forward the notification are
+        // left alone.  Notifications sent to observers which were
+        // already visited are dropped, while any other one is
+        // dispatched in a further round.
+        set_type visited;
+        while (!deferredObservers_.empty()) {
+            for (auto i = deferredObservers_.begin(); i != deferredObservers_.end();) {
+                if (visited.count(*i) != 0)
+                    i = deferredObservers_.erase(i);
+                else
+                    ++i;
+            }
+
+            std::vector<Observer*> postOrder;
+            for (auto* observer : deferredObservers_) {
+                if (visited.count(observer) == 0)
+                    sortDependents(observer, visited, postOrder);
+            }
+
+            // observers destroyed during the dispatch are removed
+            // from the deferred set when unregistering
+            for (auto i = postOrder.rbegin(); i != postOrder.rend(); ++i) {
+                if (deferredObservers_.erase(*i) == 0)
+                    continue;
+                try {
+                    ++transactionUpdates_;
+                    (*i)->update();
+                } catch (std::exception& e) {
+                    successful = false;
+                    errMsg = e.what();
+                } catch (...) {
+                    successful = false;
+                }
+            }
+        }
+
+        updatesEnabled_  = true;
+        updatesDeferred_ = false;
+
+        QL_ENSURE(successful,
+                  "could not notify one or more observers: " << errMsg);
+    }
+
+
+    void ObservableSettings::sortDependents(Observer* observer,
+                                            set_type& visited,
+                                            std::vector<Observer*>& postOrder) const {
+        // depth-first visit; the reversed post-order lists each
+        // observer after all the observers it depends upon.  An
+        // explicit stack is used, since chains of dependencies can
+        // be long enough to overflow the call stack.
+        struct Frame {
+            Observer* observer;
+            const Observable* observable;
+            Observable::set_type::const_iterator next;
+        };
+        std::vector<Frame> stack;
+
+        const auto visit = [&](Observer* o) {
+            visited.insert(o);
+            const auto* observable = dynamic_cast<const Observable*>(o);
+            stack.push_back({o, observable,
+                             observable != nullptr ?
+                                 observable->observers_.begin() :
+                                 Observable::set_type::const_iterator()});
+        };
+
+        visit(observer);
+        while (!stack.empty()) {
+            Frame& top = stack.back();
+            Observer* dependent = nullptr;
+            if (top.observable != nullptr) {
+                while (dependent == nullptr
+                       && top.next != top.observable->observers_.end()) {
+                    Observer* o = *(top.next++);
+                    if (o != nullptr && visited.count(o) == 0)
+                        dependent = o;
+                }
+            }
+            if (dependent != nullptr) {
+                visit(dependent);
+            } else {
+                postOrder.push_back(top.observer);
+                stack.pop_back();
+            }
+        }
+    }
+
+
     void Observable::notifyObservers() {
         if (!ObservableSettings::instance().updatesEnabled()) {
             // if updates are only deferred, flag this for later notification
@@ -61,7 +178,18 @@ namespace QuantLib {
         } else if (!observers_.empty()) {
             bool successful = true;
             std::string errMsg;
+            #ifdef QL_FLAT_OBSERVER_STORAGE
+            // observers might be added or removed by the updates; the
+            // vector is not compacted until the loop is over, and
+            // indexing keeps working if it is reallocated.
+            ++runningNotifications_;
+            for (Size i=0; i<observers_.size(); ++i) {
+                Observer* observer = observers_[i];
+                if (observer == nullptr)
+                    continue;
+            #else
             for (auto* observer : observers_) {
+            #endif
                 try {
                     observer->update();
                 } catch (std::exception& e) {
@@ -78,21 +206,49 @@ namespace QuantLib {
                     successful = false;
                 }
             }
+            #ifdef QL_FLAT_OBSERVER_STORAGE
+            if (--runningNotifications_ == 0 && 2 * removedObservers_ > observers_.size())
+                compact();
+            #endif
             QL_ENSURE(successful,
                   "could not notify one or more observers: " << errMsg);
         }
     }
 
+    #ifdef QL_FLAT_OBSERVER_STORAGE
+    void Observable::compact() {
+        Size j = 0;
+        for (Size i=0; i<observers_.size(); ++i) {
+            Observer* observer = observers_[i];
+            if (observer != nullptr) {
+                if (i != j) {
+                    observers_[j] = observer;
+                    observer->relocate(this, j);
+                }
+                ++j;
+            }
+        }
+        observers_.resize(j);
+        removedObservers_ = 0;
+    }
+    #endif
+
 }
 
 #else
 
 #include <boost/signals2/signal_type.hpp>
+#include <unordered_map>
 
 namespace QuantLib {
 
     namespace detail {
 
+        /* The connection of each observer is kept, so that it can be
+           disconnected directly instead of looking for its slot among
+           all the others while holding the lock of the signal.  The
+           connections are guarded by the mutex of the observable.
+        */
         class Signal {
           public:
             typedef boost::signals2::signal_type<
@@ -100,13 +256,18 @@ namespace QuantLib {
                 boost::signals2::keywords::mutex_type<std::recursive_mutex> >
                 ::type signal_type;
 
-            void connect(const signal_type::slot_type& slot) {
-                sig_.connect(slot);
+            void connect(const void* proxy,
+                         const signal_type::slot_type& slot) {
+                connections_[proxy] = sig_.connect(slot);
             }
 
-            template <class T>
-            void disconnect(const T& slot) {
-                sig_.disconnect(slot);
+            void disconnect(const void* proxy, bool disconnect) {
+                auto i = connections_.find(proxy);
+                if (i != connections_.end()) {
+                    if (disconnect)
+                        i->second.disconnect();
+                    connections_.erase(i);
+                }
             }
 
             void operator()() const {
@@ -114,6 +275,8 @@ namespace QuantLib {
             }
           private:
             signal_type sig_;
+            std::unordered_map<const void*,
+                               boost::signals2::connection> connections_;
         };
 
         template <class T>
@@ -126,64 +289,51 @@ namespace QuantLib {
             void operator()() const {
                 proxy_->update();
             }
-
-            bool operator==(const ProxyUpdater<T>& other) const {
-                return proxy_ == other.proxy_;
-            }
-
-            bool operator!=(const ProxyUpdater<T>& other) const {
-                return proxy_ != other.proxy_;
-            }
         };
 
     }
 
     void Observable::registerObserver(const ext::shared_ptr<Observer::Proxy>& observerProxy) {
-        {
-            std::lock_guard<std::recursive_mutex> lock(mutex_);
-            observers_.insert(observerProxy);
-        }
-
         detail::Signal::signal_type::slot_type slot {detail::ProxyUpdater<Observer::Proxy>(observerProxy)};
         #if defined(QL_USE_STD_SHARED_PTR)
-        sig_->connect(slot.track_foreign(observerProxy));
+        slot.track_foreign(observerProxy);
         #else
-        sig_->connect(slot.track(observerProxy));
+        slot.track(observerProxy);
         #endif
+
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        if (observers_.insert(observerProxy).second)
+            sig_->connect(observerProxy.get(), slot);
     }
 
     void Observable::unregisterObserver(const ext::shared_ptr<Observer::Proxy>& observerProxy,
                                         bool disconnect) {
         {
             std::lock_guard<std::recursive_mutex> lock(mutex_);
-            observers_.erase(observerProxy);
-        }
-
-        if (ObservableSettings::instance().updatesDeferred()) {
-            std::lock_guard<std::mutex> sLock(ObservableSettings::instance().mutex_);
-            if (ObservableSettings::instance().updatesDeferred())
-                ObservableSettings::instance().unregisterDeferredObserver(observerProxy);
+            if (observers_.erase(observerProxy) == 0)
+                return;
+            sig_->disconnect(observerProxy.get(), disconnect);
         }
 
-        if (disconnect) {
-            sig_->disconnect(detail::ProxyUpdater<Observer::Proxy>(observerProxy));
-        }
+        // a notification deferred before the observer was
+        // unregistered must not reach it any longer, even if it is
+        // being dispatched right now
+        ObservableSettings::instance().unregisterDeferredObserver(observerProxy);
     }
 
     void Observable::notifyObservers() {
-        if (ObservableSettings::instance().updatesEnabled()) {
+        // the mode is read once; notifications sent while updates
+        // are disabled (and not deferred) are dropped without locking
+        const int updatesType = ObservableSettings::instance().updatesType_;
+        if (updatesType == ObservableSettings::UpdatesEnabled) {
             sig_->operator()();
         }
-        else {
+        else if (updatesType == ObservableSettings::UpdatesDeferred) {
             bool updatesEnabled = false;
             {
-                std::lock_guard<std::mutex> sLock(ObservableSettings::instance().mutex_);
-                updatesEnabled = ObservableSettings::instance().updatesEnabled();
-
-                if (ObservableSettings::instance().updatesDeferred()) {
-                    std::lock_guard<std::recursive_mutex> lock(mutex_);
+                std::lock_guard<std::recursive_mutex> lock(mutex_);
+                updatesEnabled =
                     ObservableSettings::instance().registerDeferredObservers(observers_);
-                }
             }
 
             if (updatesEnabled)
@@ -33,7 +33,11 @@ FOR A PARTICULAR PURPOSE.  See the license for more details.
 #include <ql/patterns/singleton.hpp>
 #include <ql/shared_ptr.hpp>
 #include <ql/types.hpp>
+#include <algorithm>
+#include <memory>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #if !defined(QL_USE_STD_SHARED_PTR) && BOOST_VERSION < 107400
 
@@ -76,11 +80,26 @@ namespace QuantLib {
         */
         void notifyObservers();
       private:
+        #ifdef QL_FLAT_OBSERVER_STORAGE
+        /* Observers are stored in a vector; removed ones leave a
+           null slot behind, and the vector is compacted when more
+           than half of the slots are empty and no notification is
+           running.  Each observer records its slot, so that
+           unregistering doesn't need a lookup.
+        */
+        typedef std::vector<Observer*> set_type;
+        Size registerObserver(Observer*);
+        void unregisterObserver(Observer*, Size slot);
+        void compact();
+        set_type observers_;
+        Size removedObservers_ = 0, runningNotifications_ = 0;
+        #else
         typedef std::set<Observer*> set_type;
         typedef set_type::iterator iterator;
         std::pair<iterator, bool> registerObserver(Observer*);
         Size unregisterObserver(Observer*);
         set_type observers_;
+        #endif
     };
 
     //! global repository for run-time library settings
@@ -89,6 +108,8 @@ namespace QuantLib {
         friend class Observable;
       public:
         void disableUpdates(bool deferred=false) {
+            QL_REQUIRE(transactionDepth_ == 0,
+                       "cannot disable updates during a notification transaction");
             updatesEnabled_  = false;
             updatesDeferred_ = deferred;
         }
@@ -97,6 +118,39 @@ namespace QuantLib {
         bool updatesEnabled() const { return updatesEnabled_; }
         bool updatesDeferred() const { return updatesDeferred_; }
 
+        //! \name Notification transactions
+        //@{
+        /*! After this call, notifications are collected instead of
+            being sent until the matching commitTransaction() call.
+            Transactions can be nested; only the outermost commit
+            dispatches the collected notifications.
+        */
+        void beginTransaction();
+        /*! Dispatches the notifications collected since the outermost
+            beginTransaction() call. The observers notified during the
+            transaction, and the ones notified in turn by their
+            updates, are updated exactly once, each one after the
+            observers it depends upon.  As outside transactions, lazy
+            objects forward only the notifications they would forward
+            anyway.
+
+            Updates can't be disabled or enabled while a transaction
+            is open.
+        */
+        void commitTransaction();
+        bool inTransaction() const { return transactionDepth_ > 0; }
+        /*! returns the number of observer notifications requested
+            during the last transaction, i.e., the number of
+            update() calls that would have been made on the direct
+            observers of the notifying observables.
+        */
+        Size transactionNotifications() const { return transactionNotifications_; }
+        /*! returns the number of update() calls actually made when
+            the last transaction was committed.
+        */
+        Size transactionUpdates() const { return transactionUpdates_; }
+        //@}
+
       private:
         ObservableSettings() = default;
 
@@ -105,17 +159,28 @@ namespace QuantLib {
 
         void registerDeferredObservers(const Observable::set_type& observers);
         void unregisterDeferredObserver(Observer*);
+        void sortDependents(Observer* observer,
+                            set_type& visited,
+                            std::vector<Observer*>& postOrder) const;
 
         set_type deferredObservers_;
 
         bool updatesEnabled_ = true, updatesDeferred_ = false;
+        Size transactionDepth_ = 0;
+        Size transactionNotifications_ = 0, transactionUpdates_ = 0;
     };
 
     //! Object that gets notified when a given observable changes
     /*! \ingroup patterns */
     class Observer { // NOLINT(cppcoreguidelines-special-member-functions)
+        #ifdef QL_FLAT_OBSERVER_STORAGE
+        friend class Observable;
+      private:
+        typedef std::vector<ext::shared_ptr<Observable>> set_type;
+        #else
       private:
         typedef std::set<ext::shared_ptr<Observable>> set_type;
+        #endif
       public:
         typedef set_type::iterator iterator;
 
@@ -153,6 +218,20 @@ namespace QuantLib {
 
       private:
         set_type observables_;
+        #ifdef QL_FLAT_OBSERVER_STORAGE
+        // slots_[i] is the position of this observer in the
+        // observer list of observables_[i]
+        std::vector<Size> slots_;
+        /* most observers are registered with a handful of
+           observables, for which a linear search is cheapest; the
+           positions in observables_ are indexed only when there are
+           more of them (e.g., for a portfolio of instruments).
+        */
+        std::unique_ptr<std::unordered_map<const Observable*, Size>> positions_;
+        Size position(const Observable*) const;
+        void reindex();
+        void relocate(const Observable* observable, Size slot);
+        #endif
     };
 
 
@@ -160,7 +239,13 @@ namespace QuantLib {
 
     inline void ObservableSettings::registerDeferredObservers(const Observable::set_type& observers) {
         if (updatesDeferred()) {
-            deferredObservers_.insert(observers.begin(), observers.end());
+            for (auto* observer : observers) {
+                if (observer != nullptr) {
+                    deferredObservers_.insert(observer);
+                    if (inTransaction())
+                        ++transactionNotifications_;
+                }
+            }
         }
     }
 
@@ -189,6 +274,139 @@ namespace QuantLib {
         return *this;
     }
 
+    #ifdef QL_FLAT_OBSERVER_STORAGE
+
+    inline Size Observable::registerObserver(Observer* o) {
+        observers_.push_back(o);
+        return observers_.size() - 1;
+    }
+
+    inline void Observable::unregisterObserver(Observer* o, Size slot) {
+        if (ObservableSettings::instance().updatesDeferred())
+            ObservableSettings::instance().unregisterDeferredObserver(o);
+
+        observers_[slot] = nullptr;
+        ++removedObservers_;
+        if (runningNotifications_ == 0 && 2 * removedObservers_ > observers_.size())
+            compact();
+    }
+
+
+    inline Observer::Observer(const Observer& o)
+    : observables_(o.observables_) {
+        slots_.reserve(observables_.size());
+        for (const auto& observable : observables_)
+            slots_.push_back(observable->registerObserver(this));
+        reindex();
+    }
+
+    inline Observer& Observer::operator=(const Observer& o) {
+        if (&o == this)
+            return *this;
+        unregisterWithAll();
+        observables_ = o.observables_;
+        slots_.reserve(observables_.size());
+        for (const auto& observable : observables_)
+            slots_.push_back(observable->registerObserver(this));
+        reindex();
+        return *this;
+    }
+
+    inline Observer::~Observer() {
+        for (Size i=0; i<observables_.size(); ++i)
+            observables_[i]->unregisterObserver(this, slots_[i]);
+    }
+
+    inline std::pair<Observer::iterator, bool>
+    Observer::registerWith(const ext::shared_ptr<Observable>& h) {
+        if (h != nullptr) {
+            // the lookup is done on this side, since the observable
+            // might have thousands of observers
+            const Size i = position(h.get());
+            if (i != observables_.size())
+                return std::make_pair(observables_.begin() + i, false);
+            slots_.push_back(h->registerObserver(this));
+            observables_.push_back(h);
+            if (positions_ != nullptr)
+                positions_->emplace(h.get(), i);
+            else
+                reindex();
+            return std::make_pair(observables_.end() - 1, true);
+        }
+        return std::make_pair(observables_.end(), false);
+    }
+
+    inline void
+    Observer::registerWithObservables(const ext::shared_ptr<Observer> &o) {
+        if (o != nullptr) {
+            for (const auto& observable : o->observables_)
+                registerWith(observable);
+        }
+    }
+
+    inline
+    Size Observer::unregisterWith(const ext::shared_ptr<Observable>& h) {
+        if (h == nullptr)
+            return 0;
+        const Size i = position(h.get());
+        if (i == observables_.size())
+            return 0;
+        h->unregisterObserver(this, slots_[i]);
+        // the last observable takes the place of the removed one
+        const Size last = observables_.size() - 1;
+        if (positions_ != nullptr) {
+            positions_->erase(h.get());
+            if (i != last)
+                (*positions_)[observables_[last].get()] = i;
+        }
+        if (i != last) {
+            std::swap(observables_[i], observables_[last]);
+            slots_[i] = slots_[last];
+        }
+        observables_.pop_back();
+        slots_.pop_back();
+        return 1;
+    }
+
+    inline void Observer::unregisterWithAll() {
+        for (Size i=0; i<observables_.size(); ++i)
+            observables_[i]->unregisterObserver(this, slots_[i]);
+        observables_.clear();
+        slots_.clear();
+        positions_.reset();
+    }
+
+    inline Size Observer::position(const Observable* observable) const {
+        if (positions_ != nullptr) {
+            auto i = positions_->find(observable);
+            return i != positions_->end() ? i->second : observables_.size();
+        }
+        for (Size i=0; i<observables_.size(); ++i) {
+            if (observables_[i].get() == observable)
+                return i;
+        }
+        return observables_.size();
+    }
+
+    inline void Observer::reindex() {
+        if (observables_.size() <= 16) {
+            positions_.reset();
+            return;
+        }
+        positions_ = std::make_unique<std::unordered_map<const Observable*, Size>>();
+        positions_->reserve(observables_.size());
+        for (Size i=0; i<observables_.size(); ++i)
+            positions_->emplace(observables_[i].get(), i);
+    }
+
+    inline void Observer::relocate(const Observable* observable, Size slot) {
+        const Size i = position(observable);
+        if (i != observables_.size())
+            slots_[i] = slot;
+    }
+
+    #else
+
     inline std::pair<Observable::iterator, bool>
     Observable::registerObserver(Observer* o) {
         return observers_.insert(o);
@@ -252,6 +470,8 @@ namespace QuantLib {
         observables_.clear();
     }
 
+    #endif
+
     inline void Observer::deepUpdate() {
         update();
     }
@@ -263,7 +483,9 @@ namespace QuantLib {
 #ifndef QL_USE_STD_SHARED_PTR
 #include <boost/smart_ptr/owner_less.hpp>
 #endif
+#include <array>
 #include <atomic>
+#include <cstdint>
 #include <mutex>
 #include <set>
 #include <thread>
@@ -324,23 +546,22 @@ namespace QuantLib {
 
             void update() const {
                 std::lock_guard<std::recursive_mutex> lock(mutex_);
-                if (active_) {
-                    // c++17 is required if used with std::shared_ptr<T>
-                    const ext::weak_ptr<Observer> o
-                        = observer_->weak_from_this();
-
-                    //check for empty weak reference
-                    //https://stackoverflow.com/questions/45507041/how-to-check-if-weak-ptr-is-empty-non-assigned
-                    const ext::weak_ptr<Observer> empty;
-                    if (o.owner_before(empty) || empty.owner_before(o)) {
-                        const ext::shared_ptr<Observer> obs(o.lock());
-                        if (obs)
-                            obs->update();
-                    }
-                    else {
-                        observer_->update();
-                    }
-                }
+                if (active_)
+                    updateObserver();
+            }
+
+            /* the check is made under the lock, so that the observer
+               can't be unregistered between the check and the update
+            */
+            template <class Check>
+            void updateIf(const Check& check) const {
+                std::lock_guard<std::recursive_mutex> lock(mutex_);
+                if (check() && active_)
+                    updateObserver();
+            }
+
+            std::unique_lock<std::recursive_mutex> lock() const {
+                return std::unique_lock<std::recursive_mutex>(mutex_);
             }
 
             void deactivate() {
@@ -349,6 +570,24 @@ namespace QuantLib {
             }
 
         private:
+            void updateObserver() const {
+                // c++17 is required if used with std::shared_ptr<T>
+                const ext::weak_ptr<Observer> o
+                    = observer_->weak_from_this();
+
+                //check for empty weak reference
+                //https://stackoverflow.com/questions/45507041/how-to-check-if-weak-ptr-is-empty-non-assigned
+                const ext::weak_ptr<Observer> empty;
+                if (o.owner_before(empty) || empty.owner_before(o)) {
+                    const ext::shared_ptr<Observer> obs(o.lock());
+                    if (obs)
+                        obs->update();
+                }
+                else {
+                    observer_->update();
+                }
+            }
+
             bool active_;
             mutable std::recursive_mutex mutex_;
             Observer* const observer_;
@@ -399,14 +638,25 @@ namespace QuantLib {
         friend class Observable;
 
       public:
-        void disableUpdates(bool deferred=false) {
-            std::lock_guard<std::mutex> lock(mutex_);
-            updatesType_ = (deferred) ? UpdatesDeferred : UpdatesDisabled;
-        }
+        void disableUpdates(bool deferred=false);
         void enableUpdates();
 
         bool updatesEnabled()  {return (updatesType_ & UpdatesEnabled) != 0; }
         bool updatesDeferred() {return (updatesType_ & UpdatesDeferred) != 0; }
+
+        //! \name Notification transactions
+        //@{
+        /*! \note In the thread-safe implementation, committing a
+                  transaction only deduplicates the direct observers
+                  of the notifying observables, as enableUpdates()
+                  does after disableUpdates(true).
+        */
+        void beginTransaction();
+        void commitTransaction();
+        bool inTransaction() const { return transactionDepth_ > 0; }
+        Size transactionNotifications() const { return transactionNotifications_; }
+        Size transactionUpdates() const { return transactionUpdates_; }
+        //@}
       private:
         ObservableSettings() : updatesType_(UpdatesEnabled) {}
 
@@ -420,44 +670,175 @@ namespace QuantLib {
             set_type;
 #endif
 
-        void registerDeferredObservers(const Observable::set_type& observers);
+        /* Deferred observers are spread over a few shards, each
+           with its own lock, so that threads notifying or
+           unregistering different observers while updates are
+           deferred don't serialize on a single mutex.  Changes of
+           the update mode lock all the shards.  When updates are
+           enabled again, the deferred observers are moved to the
+           dispatching set, from which unregistered observers are
+           still removed until they are updated.
+        */
+        struct DeferredShard {
+            set_type observers, dispatching;
+            std::mutex mutex;
+        };
+        static constexpr Size nShards = 16;
+
+        static Size shardIndex(const Observer::Proxy* proxy) {
+            const auto p = reinterpret_cast<std::uintptr_t>(proxy);
+            return (p >> 4) % nShards;
+        }
+        DeferredShard& shard(const Observer::Proxy* proxy) {
+            return deferredShards_[shardIndex(proxy)];
+        }
+
+        bool registerDeferredObservers(const Observable::set_type& observers);
         void unregisterDeferredObserver(const ext::shared_ptr<Observer::Proxy>& proxy);
+        void setUpdatesType(int type);
+        void sendDeferredUpdates();
 
-        set_type deferredObservers_;
+        std::array<DeferredShard, nShards> deferredShards_;
         mutable std::mutex mutex_;
 
         enum UpdateType { UpdatesDisabled = 0, UpdatesEnabled = 1, UpdatesDeferred = 2} ;
         std::atomic<int> updatesType_;
+
+        std::atomic<Size> transactionDepth_{0};
+        std::atomic<Size> transactionNotifications_{0};
+        Size transactionUpdates_ = 0;
     };
 
 
     // inline definitions
 
-    inline void ObservableSettings::registerDeferredObservers(const Observable::set_type& observers) {
-        deferredObservers_.insert(observers.begin(), observers.end());
+    inline void ObservableSettings::disableUpdates(bool deferred) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        QL_REQUIRE(transactionDepth_ == 0,
+                   "cannot disable updates during a notification transaction");
+        setUpdatesType(deferred ? UpdatesDeferred : UpdatesDisabled);
+    }
+
+    inline void ObservableSettings::setUpdatesType(int type) {
+        // the caller holds mutex_; shards are always locked in order
+        for (auto& s : deferredShards_)
+            s.mutex.lock();
+        updatesType_ = type;
+        for (auto& s : deferredShards_)
+            s.mutex.unlock();
+    }
+
+    inline bool ObservableSettings::registerDeferredObservers(
+        const Observable::set_type& observers) {
+        // returns true if updates were enabled in the meantime, in
+        // which case none of the observers is deferred and the caller
+        // must notify them directly.  The shards involved are locked
+        // together, in the same order as in setUpdatesType, so that
+        // the mode can't change while the observers are inserted.
+        static_assert(nShards <= 32, "too many shards for the lock mask");
+        std::uint32_t involved = 0;
+        for (const auto& proxy : observers)
+            involved |= std::uint32_t(1) << shardIndex(proxy.get());
+
+        std::array<std::unique_lock<std::mutex>, nShards> locks;
+        for (Size i=0; i<nShards; ++i) {
+            if ((involved & (std::uint32_t(1) << i)) != 0)
+                locks[i] = std::unique_lock<std::mutex>(deferredShards_[i].mutex);
+        }
+
+        if (updatesEnabled())
+            return true;
+        if (updatesDeferred()) {
+            for (const auto& proxy : observers)
+                shard(proxy.get()).observers.insert(proxy);
+            if (transactionDepth_ > 0)
+                transactionNotifications_ += observers.size();
+        }
+        return false;
+    }
+
+    inline void ObservableSettings::beginTransaction() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (transactionDepth_ == 0) {
+            QL_REQUIRE(updatesType_ == UpdatesEnabled,
+                       "cannot begin a notification transaction "
+                       "while updates are disabled");
+            transactionNotifications_ = 0;
+            transactionUpdates_ = 0;
+            setUpdatesType(UpdatesDeferred);
+        }
+        ++transactionDepth_;
+    }
+
+    inline void ObservableSettings::commitTransaction() {
+        // updates are enabled under the same lock, so that a new
+        // transaction can't begin before the deferred ones are sent
+        std::lock_guard<std::mutex> lock(mutex_);
+        QL_REQUIRE(transactionDepth_ > 0,
+                   "no notification transaction to commit");
+        if (--transactionDepth_ > 0)
+            return;
+        transactionUpdates_ = 0;
+        for (auto& s : deferredShards_) {
+            std::lock_guard<std::mutex> sLock(s.mutex);
+            transactionUpdates_ += s.observers.size();
+        }
+        sendDeferredUpdates();
     }
 
     inline void ObservableSettings::unregisterDeferredObserver(
         const ext::shared_ptr<Observer::Proxy>& o) {
-        deferredObservers_.erase(o);
+        // the lock of the proxy waits for a running deferred update
+        const auto proxyLock = o->lock();
+        DeferredShard& s = shard(o.get());
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.observers.erase(o);
+        s.dispatching.erase(o);
     }
 
     inline void ObservableSettings::enableUpdates() {
         std::lock_guard<std::mutex> lock(mutex_);
+        QL_REQUIRE(transactionDepth_ == 0,
+                   "cannot enable updates during a notification transaction");
+        sendDeferredUpdates();
+    }
 
-        // if there are outstanding deferred updates, do the notification
-        updatesType_ = UpdatesEnabled;
+    inline void ObservableSettings::sendDeferredUpdates() {
+        // the caller holds mutex_
 
-        if (deferredObservers_.size()) {
-            bool successful = true;
-            std::string errMsg;
+        // collect the outstanding deferred updates while switching
+        // the mode, so that no notification can be lost in between
+        for (auto& s : deferredShards_)
+            s.mutex.lock();
+        updatesType_ = UpdatesEnabled;
+        for (auto& s : deferredShards_)
+            s.dispatching.swap(s.observers);
+        for (auto& s : deferredShards_)
+            s.mutex.unlock();
 
-            for (auto i=deferredObservers_.begin();
-                i!=deferredObservers_.end(); ++i) {
+        // if there are outstanding deferred updates, do the notification
+        bool successful = true;
+        std::string errMsg;
+
+        for (auto& s : deferredShards_) {
+            for (;;) {
+                ext::shared_ptr<Observer::Proxy> proxy;
+                {
+                    std::lock_guard<std::mutex> sLock(s.mutex);
+                    if (s.dispatching.empty())
+                        break;
+                    proxy = s.dispatching.begin()->lock();
+                    if (!proxy) {
+                        s.dispatching.erase(s.dispatching.begin());
+                        continue;
+                    }
+                }
                 try {
-                    const ext::shared_ptr<Observer::Proxy> proxy = i->lock();
-                    if (proxy)
-                        proxy->update();
+                    // skipped if the observer was unregistered since
+                    proxy->updateIf([&]() {
+                        std::lock_guard<std::mutex> sLock(s.mutex);
+                        return s.dispatching.erase(proxy) != 0;
+                    });
                 } catch (std::exception& e) {
                     successful = false;
                     errMsg = e.what();
@@ -465,12 +846,10 @@ namespace QuantLib {
                     successful = false;
                 }
             }
+        }
 
-            deferredObservers_.clear();
-
-            QL_ENSURE(successful,
+        QL_ENSURE(successful,
                   "could not notify one or more observers: " << errMsg);
-        }
     }
 
 
@@ -538,8 +917,11 @@ namespace QuantLib {
         }
 
         if (h) {
-            h->registerObserver(proxy_);
-            return observables_.insert(h);
+            // connecting the proxy again would notify it twice
+            std::pair<iterator, bool> res = observables_.insert(h);
+            if (res.second)
+                h->registerObserver(proxy_);
+            return res;
         }
         return std::make_pair(observables_.end(), false);
     }
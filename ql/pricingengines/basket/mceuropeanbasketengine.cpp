@@ -44,5 +44,22 @@ namespace QuantLib {
         return (*payoff_)(finalPrice) * discount_;
     }
 
+    void EuropeanMultiPathPricer::operator()(const MultiPathBatch& paths,
+                                             std::vector<Real>& values) const {
+        Size n = paths.pathSize();
+        QL_REQUIRE(n>0, "the path cannot be empty");
+
+        Size numAssets = paths.assetNumber();
+        Size numPaths = paths.pathNumber();
+        values.resize(numPaths);
+
+        Array finalPrice(numAssets, 0.0);
+        for (Size p = 0; p < numPaths; p++) {
+            for (Size j = 0; j < numAssets; j++)
+                finalPrice[j] = paths.slice(n-1, j)[p];
+            values[p] = (*payoff_)(finalPrice) * discount_;
+        }
+    }
+
 }
 
@@ -27,6 +27,7 @@
 
 #include <ql/exercise.hpp>
 #include <ql/instruments/basketoption.hpp>
+#include <ql/methods/montecarlo/multipathbatchgenerator.hpp>
 #include <ql/pricingengines/mcsimulation.hpp>
 #include <ql/processes/blackscholesprocess.hpp>
 #include <ql/processes/stochasticprocessarray.hpp>
@@ -34,11 +35,22 @@
 
 namespace QuantLib {
 
+    class EuropeanMultiPathPricer;
+
     //! Pricing engine for European basket options using Monte Carlo simulation
-    /*! \ingroup basketengines
+    /*! If a batch size is given, the paths are generated and priced
+        in batches by means of MultiPathBatchGenerator; the results
+        are the same as when they are generated one at a time, also
+        when the simulation runs on more than one thread.  The
+        Brownian bridge is only available for batched simulations.
+
+        \ingroup basketengines
 
         \test the correctness of the returned value is tested by
               reproducing results available in literature.
+
+        \test batched simulations are checked against the
+              path-at-a-time ones.
     */
     template <class RNG = PseudoRandom, class S = Statistics>
     class MCEuropeanBasketEngine  : public BasketOption::engine,
@@ -50,6 +62,8 @@ namespace QuantLib {
             path_pricer_type;
         typedef typename McSimulation<MultiVariate,RNG,S>::stats_type
             stats_type;
+        typedef typename McSimulation<MultiVariate,RNG,S>::batch_sampler
+            batch_sampler;
         // constructor
         MCEuropeanBasketEngine(ext::shared_ptr<StochasticProcessArray>,
                                Size timeSteps,
@@ -59,7 +73,9 @@ namespace QuantLib {
                                Size requiredSamples,
                                Real requiredTolerance,
                                Size maxSamples,
-                               BigNatural seed);
+                               BigNatural seed,
+                               Size threads = 1,
+                               Size batchSize = Null<Size>());
         void calculate() const override {
             McSimulation<MultiVariate,RNG,S>::calculate(requiredTolerance_,
                                                         requiredSamples_,
@@ -74,6 +90,10 @@ namespace QuantLib {
         // McSimulation implementation
         TimeGrid timeGrid() const override;
         ext::shared_ptr<path_generator_type> pathGenerator() const override {
+            return streamPathGenerator(0, 0);
+        }
+        ext::shared_ptr<path_generator_type>
+        streamPathGenerator(Size stream, Size firstSample) const override {
 
             ext::shared_ptr<BasketPayoff> payoff =
                 ext::dynamic_pointer_cast<BasketPayoff>(
@@ -84,13 +104,17 @@ namespace QuantLib {
 
             TimeGrid grid = timeGrid();
             typename RNG::rsg_type gen =
-                RNG::make_sequence_generator(numAssets*(grid.size()-1),seed_);
+                detail::make_stream_sequence_generator<RNG>(
+                    numAssets*(grid.size()-1), seed_, stream, firstSample);
 
             return ext::shared_ptr<path_generator_type>(
                          new path_generator_type(processes_,
                                                  grid, gen, brownianBridge_));
         }
         ext::shared_ptr<path_pricer_type> pathPricer() const override;
+        batch_sampler
+        streamBatchSampler(Size stream, Size firstSample) const override;
+        ext::shared_ptr<EuropeanMultiPathPricer> europeanPathPricer() const;
         // data members
         ext::shared_ptr<StochasticProcessArray> processes_;
         Size timeSteps_, timeStepsPerYear_;
@@ -99,6 +123,7 @@ namespace QuantLib {
         Real requiredTolerance_;
         bool brownianBridge_;
         BigNatural seed_;
+        Size batchSize_;
     };
 
 
@@ -116,6 +141,8 @@ namespace QuantLib {
         MakeMCEuropeanBasketEngine& withAbsoluteTolerance(Real tolerance);
         MakeMCEuropeanBasketEngine& withMaxSamples(Size samples);
         MakeMCEuropeanBasketEngine& withSeed(BigNatural seed);
+        MakeMCEuropeanBasketEngine& withThreads(Size threads);
+        MakeMCEuropeanBasketEngine& withBatchSize(Size batchSize);
         // conversion to pricing engine
         operator ext::shared_ptr<PricingEngine>() const;
       private:
@@ -124,13 +151,19 @@ namespace QuantLib {
         Size steps_, stepsPerYear_, samples_, maxSamples_;
         Real tolerance_;
         BigNatural seed_ = 0;
+        Size threads_ = 1;
+        Size batchSize_;
     };
 
 
-    class EuropeanMultiPathPricer : public PathPricer<MultiPath> {
+    class EuropeanMultiPathPricer : public PathPricer<MultiPath>,
+                                    public BatchPathPricer<MultiPathBatch> {
       public:
+        typedef Real result_type;
         EuropeanMultiPathPricer(ext::shared_ptr<BasketPayoff> payoff, DiscountFactor discount);
         Real operator()(const MultiPath& multiPath) const override;
+        void operator()(const MultiPathBatch& paths,
+                        std::vector<Real>& values) const override;
 
       private:
         ext::shared_ptr<BasketPayoff> payoff_;
@@ -150,11 +183,14 @@ namespace QuantLib {
         Size requiredSamples,
         Real requiredTolerance,
         Size maxSamples,
-        BigNatural seed)
-    : McSimulation<MultiVariate, RNG, S>(antitheticVariate, false),
+        BigNatural seed,
+        Size threads,
+        Size batchSize)
+    : McSimulation<MultiVariate, RNG, S>(antitheticVariate, false, threads),
       processes_(std::move(processes)), timeSteps_(timeSteps), timeStepsPerYear_(timeStepsPerYear),
       requiredSamples_(requiredSamples), maxSamples_(maxSamples),
-      requiredTolerance_(requiredTolerance), brownianBridge_(brownianBridge), seed_(seed) {
+      requiredTolerance_(requiredTolerance), brownianBridge_(brownianBridge), seed_(seed),
+      batchSize_(batchSize) {
         QL_REQUIRE(timeSteps != Null<Size>() ||
                    timeStepsPerYear != Null<Size>(),
                    "no time steps provided");
@@ -167,6 +203,9 @@ namespace QuantLib {
         QL_REQUIRE(timeStepsPerYear != 0,
                    "timeStepsPerYear must be positive, " << timeStepsPerYear <<
                    " not allowed");
+        QL_REQUIRE(batchSize != 0,
+                   "batchSize must be positive, " << batchSize <<
+                   " not allowed");
         registerWith(processes_);
     }
 
@@ -189,6 +228,44 @@ namespace QuantLib {
     inline
     ext::shared_ptr<typename MCEuropeanBasketEngine<RNG,S>::path_pricer_type>
     MCEuropeanBasketEngine<RNG,S>::pathPricer() const {
+        return europeanPathPricer();
+    }
+
+    template <class RNG, class S>
+    inline typename MCEuropeanBasketEngine<RNG,S>::batch_sampler
+    MCEuropeanBasketEngine<RNG,S>::streamBatchSampler(
+                                       Size stream, Size firstSample) const {
+        if (batchSize_ == Null<Size>())
+            return batch_sampler();
+
+        // the paths are drawn from the same sequence as the ones
+        // returned by streamPathGenerator()
+        typedef typename RNG::rsg_type rsg_type;
+        TimeGrid grid = timeGrid();
+        rsg_type gen = detail::make_stream_sequence_generator<RNG>(
+            processes_->size()*(grid.size()-1), seed_, stream, firstSample);
+        auto generator = ext::make_shared<MultiPathBatchGenerator<rsg_type> >(
+            processes_, grid, gen, batchSize_, brownianBridge_);
+        ext::shared_ptr<EuropeanMultiPathPricer> pricer = europeanPathPricer();
+        const bool antithetic = this->antitheticVariate_;
+
+        return [generator, pricer, antithetic](std::vector<Real>& values,
+                                               std::vector<Real>& weights) {
+            const MultiPathBatch& paths = generator->next();
+            (*pricer)(paths, values);
+            weights = paths.weights();
+            if (antithetic) {
+                std::vector<Real> antitheticValues;
+                (*pricer)(generator->antithetic(), antitheticValues);
+                for (Size p=0; p<values.size(); ++p)
+                    values[p] = (values[p] + antitheticValues[p])/2.0;
+            }
+        };
+    }
+
+    template <class RNG, class S>
+    inline ext::shared_ptr<EuropeanMultiPathPricer>
+    MCEuropeanBasketEngine<RNG,S>::europeanPathPricer() const {
 
         ext::shared_ptr<BasketPayoff> payoff =
             ext::dynamic_pointer_cast<BasketPayoff>(arguments_.payoff);
@@ -199,11 +276,9 @@ namespace QuantLib {
                                                       processes_->process(0));
         QL_REQUIRE(process, "Black-Scholes process required");
 
-        return ext::shared_ptr<
-                    typename MCEuropeanBasketEngine<RNG,S>::path_pricer_type>(
-            new EuropeanMultiPathPricer(payoff,
-                                        process->riskFreeRate()->discount(
-                                           arguments_.exercise->lastDate())));
+        return ext::make_shared<EuropeanMultiPathPricer>(
+            payoff,
+            process->riskFreeRate()->discount(arguments_.exercise->lastDate()));
     }
 
 
@@ -211,7 +286,8 @@ namespace QuantLib {
     inline MakeMCEuropeanBasketEngine<RNG, S>::MakeMCEuropeanBasketEngine(
         ext::shared_ptr<StochasticProcessArray> process)
     : process_(std::move(process)), steps_(Null<Size>()), stepsPerYear_(Null<Size>()),
-      samples_(Null<Size>()), maxSamples_(Null<Size>()), tolerance_(Null<Real>()) {}
+      samples_(Null<Size>()), maxSamples_(Null<Size>()), tolerance_(Null<Real>()),
+      batchSize_(Null<Size>()) {}
 
     template <class RNG, class S>
     inline MakeMCEuropeanBasketEngine<RNG,S>&
@@ -276,6 +352,20 @@ namespace QuantLib {
         return *this;
     }
 
+    template <class RNG, class S>
+    inline MakeMCEuropeanBasketEngine<RNG,S>&
+    MakeMCEuropeanBasketEngine<RNG,S>::withThreads(Size threads) {
+        threads_ = threads;
+        return *this;
+    }
+
+    template <class RNG, class S>
+    inline MakeMCEuropeanBasketEngine<RNG,S>&
+    MakeMCEuropeanBasketEngine<RNG,S>::withBatchSize(Size batchSize) {
+        batchSize_ = batchSize;
+        return *this;
+    }
+
     template <class RNG, class S>
     inline
     MakeMCEuropeanBasketEngine<RNG,S>::operator
@@ -292,7 +382,9 @@ namespace QuantLib {
                                           antithetic_,
                                           samples_, tolerance_,
                                           maxSamples_,
-                                          seed_));
+                                          seed_,
+                                          threads_,
+                                          batchSize_));
     }
 
 }
@@ -66,4 +66,21 @@ namespace QuantLib {
         }
     }
 
+    std::vector<std::pair<Date, Real> >
+    DiscountingBondEngine::npvGradient(const Bond& bond) const {
+        QL_REQUIRE(!discountCurve_.empty(),
+                   "discounting term structure handle is empty");
+
+        const Date valuationDate = (*discountCurve_)->referenceDate();
+        const bool includeRefDateFlows = includeSettlementDateFlows_ ? // NOLINT(readability-implicit-bool-conversion)
+                                             *includeSettlementDateFlows_ :
+                                             Settings::instance().includeReferenceDateEvents();
+
+        return CashFlows::npvGradient(bond.cashflows(),
+                                      **discountCurve_,
+                                      includeRefDateFlows,
+                                      valuationDate,
+                                      valuationDate);
+    }
+
 }
@@ -29,6 +29,8 @@
 #include <ql/termstructures/yieldtermstructure.hpp>
 #include <ql/handle.hpp>
 #include <ql/optional.hpp>
+#include <utility>
+#include <vector>
 
 namespace QuantLib {
 
@@ -42,6 +44,11 @@ namespace QuantLib {
             Handle<YieldTermStructure> discountCurve = Handle<YieldTermStructure>(),
             const ext::optional<bool>& includeSettlementDateFlows = ext::nullopt);
         void calculate() const override;
+        //! gradient of the NPV of the bond wrt the discount factors
+        /*! The NPV is the one returned by calculate(); see
+            CashFlows::npvGradient for the returned derivatives.
+        */
+        std::vector<std::pair<Date, Real> > npvGradient(const Bond& bond) const;
         Handle<YieldTermStructure> discountCurve() const {
             return discountCurve_;
         }
@@ -68,7 +68,13 @@ namespace QuantLib {
           calibration and pricing; note however that this has no effect
           for low discrepancy RNGs usually, it is therefore recommended
           to use pseudo random generators for the calibration phase always
-          (and possibly quasi monte carlo in the subsequent pricing). */
+          (and possibly quasi monte carlo in the subsequent pricing).
+          The given number of threads is used in both the calibration
+          and the pricing phase; see
+          LongstaffSchwartzPathPricer::setCalibrationThreads() for the
+          effect on the calibration.  If \p storeCalibrationPaths is
+          false, only the exercise values and regression states
+          are kept for each calibration path. */
         MCLongstaffSchwartzEngine(ext::shared_ptr<StochasticProcess> process,
                                   Size timeSteps,
                                   Size timeStepsPerYear,
@@ -82,7 +88,9 @@ namespace QuantLib {
                                   Size nCalibrationSamples = Null<Size>(),
                                   ext::optional<bool> brownianBridgeCalibration = ext::nullopt,
                                   ext::optional<bool> antitheticVariateCalibration = ext::nullopt,
-                                  BigNatural seedCalibration = Null<Size>());
+                                  BigNatural seedCalibration = Null<Size>(),
+                                  Size threads = 1,
+                                  bool storeCalibrationPaths = true);
 
         void calculate() const override;
 
@@ -93,6 +101,10 @@ namespace QuantLib {
         TimeGrid timeGrid() const override;
         ext::shared_ptr<path_pricer_type> pathPricer() const override;
         ext::shared_ptr<path_generator_type> pathGenerator() const override;
+        ext::shared_ptr<path_generator_type>
+        streamPathGenerator(Size stream, Size firstSample) const override;
+        ext::shared_ptr<path_generator_type_calibration>
+        calibrationPathGenerator(Size stream, Size firstSample) const;
 
         ext::shared_ptr<StochasticProcess> process_;
         const Size timeSteps_;
@@ -106,6 +118,7 @@ namespace QuantLib {
         const bool brownianBridgeCalibration_;
         const bool antitheticVariateCalibration_;
         const BigNatural seedCalibration_;
+        const bool storeCalibrationPaths_;
 
         mutable ext::shared_ptr<LongstaffSchwartzPathPricer<path_type> >
             pathPricer_;
@@ -133,8 +146,10 @@ namespace QuantLib {
                                   Size nCalibrationSamples,
                                   ext::optional<bool> brownianBridgeCalibration,
                                   ext::optional<bool> antitheticVariateCalibration,
-                                  BigNatural seedCalibration)
-    : McSimulation<MC, RNG, S>(antitheticVariate, controlVariate), process_(std::move(process)),
+                                  BigNatural seedCalibration,
+                                  Size threads,
+                                  bool storeCalibrationPaths)
+    : McSimulation<MC, RNG, S>(antitheticVariate, controlVariate, threads), process_(std::move(process)),
       timeSteps_(timeSteps), timeStepsPerYear_(timeStepsPerYear), brownianBridge_(brownianBridge),
       requiredSamples_(requiredSamples), requiredTolerance_(requiredTolerance),
       maxSamples_(maxSamples), seed_(seed),
@@ -146,7 +161,8 @@ namespace QuantLib {
           // NOLINTNEXTLINE(readability-implicit-bool-conversion)
           antitheticVariateCalibration ? *antitheticVariateCalibration : antitheticVariate),
       seedCalibration_(seedCalibration != Null<Real>() ? seedCalibration :
-                                                         (seed == 0 ? 0 : seed + 1768237423L)) {
+                                                         (seed == 0 ? 0 : seed + 1768237423L)),
+      storeCalibrationPaths_(storeCalibrationPaths) {
         QL_REQUIRE(timeSteps != Null<Size>() ||
                    timeStepsPerYear != Null<Size>(),
                    "no time steps provided");
@@ -179,22 +195,36 @@ namespace QuantLib {
                                           RNG_Calibration>::calculate() const {
         // calibration
         pathPricer_ = this->lsmPathPricer();
-        Size dimensions = process_->factors();
-        TimeGrid grid = this->timeGrid();
-        typename RNG_Calibration::rsg_type generator =
-            RNG_Calibration::make_sequence_generator(
-                dimensions * (grid.size() - 1), seedCalibration_);
-        ext::shared_ptr<path_generator_type_calibration>
-            pathGeneratorCalibration =
-                ext::make_shared<path_generator_type_calibration>(
-                    process_, grid, generator, brownianBridgeCalibration_);
-        mcModelCalibration_ =
-            ext::shared_ptr<MonteCarloModel<MC, RNG_Calibration, S> >(
-                new MonteCarloModel<MC, RNG_Calibration, S>(
-                    pathGeneratorCalibration, pathPricer_, stats_type(),
-                    this->antitheticVariateCalibration_));
+        pathPricer_->storeCalibrationPaths(storeCalibrationPaths_);
+        if (this->threads_ > 1) {
+            // one block of calibration paths per thread, drawn from
+            // separate streams
+            const Size blockSize =
+                detail::parallelBlockSize(nCalibrationSamples_,
+                                          this->threads_);
+            std::vector<ext::shared_ptr<path_generator_type_calibration> >
+                generators;
+            std::vector<Size> samples;
+            for (Size first=0; first<nCalibrationSamples_;
+                 first+=blockSize) {
+                generators.push_back(
+                    calibrationPathGenerator(generators.size(), first));
+                samples.push_back(
+                    std::min(blockSize, nCalibrationSamples_-first));
+            }
+            mcModelCalibration_.reset();
+            pathPricer_->setCalibrationThreads(this->threads_);
+            pathPricer_->addCalibrationPaths(
+                generators, samples, antitheticVariateCalibration_);
+        } else {
+            mcModelCalibration_ =
+                ext::shared_ptr<MonteCarloModel<MC, RNG_Calibration, S> >(
+                    new MonteCarloModel<MC, RNG_Calibration, S>(
+                        calibrationPathGenerator(0, 0), pathPricer_,
+                        stats_type(), this->antitheticVariateCalibration_));
 
-        mcModelCalibration_->addSamples(nCalibrationSamples_);
+            mcModelCalibration_->addSamples(nCalibrationSamples_);
+        }
         pathPricer_->calibrate();
         // pricing
         McSimulation<MC,RNG,S>::calculate(requiredTolerance_,
@@ -245,16 +275,44 @@ namespace QuantLib {
         GenericEngine, MC, RNG, S, RNG_Calibration>::path_generator_type>
     MCLongstaffSchwartzEngine<GenericEngine, MC, RNG, S,
                               RNG_Calibration>::pathGenerator() const {
+        return streamPathGenerator(0, 0);
+    }
+
+    template <class GenericEngine, template <class> class MC, class RNG,
+              class S, class RNG_Calibration>
+    inline ext::shared_ptr<typename MCLongstaffSchwartzEngine<
+        GenericEngine, MC, RNG, S, RNG_Calibration>::path_generator_type>
+    MCLongstaffSchwartzEngine<GenericEngine, MC, RNG, S, RNG_Calibration>::
+    streamPathGenerator(Size stream, Size firstSample) const {
 
         Size dimensions = process_->factors();
         TimeGrid grid = this->timeGrid();
         typename RNG::rsg_type generator =
-            RNG::make_sequence_generator(dimensions*(grid.size()-1),seed_);
+            detail::make_stream_sequence_generator<RNG>(
+                dimensions*(grid.size()-1), seed_, stream, firstSample);
         return ext::shared_ptr<path_generator_type>(
                    new path_generator_type(process_,
                                            grid, generator, brownianBridge_));
     }
 
+    template <class GenericEngine, template <class> class MC, class RNG,
+              class S, class RNG_Calibration>
+    inline ext::shared_ptr<typename MCLongstaffSchwartzEngine<
+        GenericEngine, MC, RNG, S,
+        RNG_Calibration>::path_generator_type_calibration>
+    MCLongstaffSchwartzEngine<GenericEngine, MC, RNG, S, RNG_Calibration>::
+    calibrationPathGenerator(Size stream, Size firstSample) const {
+
+        Size dimensions = process_->factors();
+        TimeGrid grid = this->timeGrid();
+        typename RNG_Calibration::rsg_type generator =
+            detail::make_stream_sequence_generator<RNG_Calibration>(
+                dimensions*(grid.size()-1), seedCalibration_,
+                stream, firstSample);
+        return ext::make_shared<path_generator_type_calibration>(
+                   process_, grid, generator, brownianBridgeCalibration_);
+    }
+
 }
 
 
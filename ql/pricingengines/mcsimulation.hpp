@@ -37,6 +37,13 @@ namespace QuantLib {
         Carlo engine.
 
         See McVanillaEngine as an example.
+
+        Engines can spread the simulation over several threads by
+        passing their number to the constructor and overriding
+        streamPathGenerator(); see MonteCarloModel::setThreads() for
+        details.  They can also simulate batches of paths at a time
+        by overriding streamBatchSampler(); see
+        MonteCarloModel::setBatchSampler().
     */
 
     template <template <class> class MC, class RNG, class S = Statistics>
@@ -49,6 +56,8 @@ namespace QuantLib {
         typedef typename MonteCarloModel<MC,RNG,S>::stats_type
             stats_type;
         typedef typename MonteCarloModel<MC,RNG,S>::result_type result_type;
+        typedef typename MonteCarloModel<MC,RNG,S>::batch_sampler
+            batch_sampler;
 
         virtual ~McSimulation() = default;
         //! add samples until the required absolute tolerance is reached
@@ -67,12 +76,32 @@ namespace QuantLib {
                        Size maxSamples) const;
       protected:
         McSimulation(bool antitheticVariate,
-                     bool controlVariate)
+                     bool controlVariate,
+                     Size threads = 1)
         : antitheticVariate_(antitheticVariate),
-          controlVariate_(controlVariate) {}
+          controlVariate_(controlVariate), threads_(threads) {
+            QL_REQUIRE(threads > 0, "at least one thread required");
+        }
         virtual ext::shared_ptr<path_pricer_type> pathPricer() const = 0;
         virtual ext::shared_ptr<path_generator_type> pathGenerator()
                                                                    const = 0;
+        /*! path generator for the given stream of a multi-threaded
+            simulation, starting at the given sample; it must be
+            overridden by engines supporting more than one thread.
+        */
+        virtual ext::shared_ptr<path_generator_type>
+        streamPathGenerator(Size /*stream*/, Size /*firstSample*/) const {
+            QL_FAIL("engine does not support multi-threaded simulation");
+        }
+        /*! sampler of batches of paths for the given stream,
+            starting at the given sample, with the same conventions
+            as streamPathGenerator(); if not empty, it is used instead
+            of the path generator and path pricer.
+        */
+        virtual batch_sampler
+        streamBatchSampler(Size /*stream*/, Size /*firstSample*/) const {
+            return batch_sampler();
+        }
         virtual TimeGrid timeGrid() const = 0;
         virtual ext::shared_ptr<path_pricer_type> controlPathPricer() const {
             return ext::shared_ptr<path_pricer_type>();
@@ -97,6 +126,7 @@ namespace QuantLib {
         
         mutable ext::shared_ptr<MonteCarloModel<MC,RNG,S> > mcModel_;
         bool antitheticVariate_, controlVariate_;
+        Size threads_;
     };
 
 
@@ -195,6 +225,21 @@ namespace QuantLib {
                            this->antitheticVariate_));
         }
 
+        if (threads_ > 1) {
+            this->mcModel_->setThreads(
+                threads_, [this](Size stream, Size firstSample) {
+                    return this->streamPathGenerator(stream, firstSample);
+                });
+        }
+
+        batch_sampler sampler = this->streamBatchSampler(0, 0);
+        if (sampler) {
+            this->mcModel_->setBatchSampler(
+                std::move(sampler), [this](Size stream, Size firstSample) {
+                    return this->streamBatchSampler(stream, firstSample);
+                });
+        }
+
         if (requiredTolerance != Null<Real>()) {
             if (maxSamples != Null<Size>())
                 this->value(requiredTolerance, maxSamples);
@@ -37,6 +37,30 @@ namespace QuantLib {
         registerWith(discountCurve_);
     }
 
+    Date DiscountingSwapEngine::settlementDate(const Date& refDate) const {
+        if (settlementDate_==Date())
+            return refDate;
+        QL_REQUIRE(settlementDate_>=refDate,
+                   "settlement date (" << settlementDate_ << ") before "
+                   "discount curve reference date (" << refDate << ")");
+        return settlementDate_;
+    }
+
+    Date DiscountingSwapEngine::npvDate(const Date& refDate) const {
+        if (npvDate_==Date())
+            return refDate;
+        QL_REQUIRE(npvDate_>=refDate,
+                   "npv date (" << npvDate_  << ") before "
+                   "discount curve reference date (" << refDate << ")");
+        return npvDate_;
+    }
+
+    bool DiscountingSwapEngine::includeRefDateFlows() const {
+        return includeSettlementDateFlows_ ? // NOLINT(readability-implicit-bool-conversion)
+            *includeSettlementDateFlows_ :
+            Settings::instance().includeReferenceDateEvents();
+    }
+
     void DiscountingSwapEngine::calculate() const {
         QL_REQUIRE(!discountCurve_.empty(),
                    "discounting term structure handle is empty");
@@ -46,23 +70,8 @@ namespace QuantLib {
 
         Date refDate = discountCurve_->referenceDate();
 
-        Date settlementDate = settlementDate_;
-        if (settlementDate_==Date()) {
-            settlementDate = refDate;
-        } else {
-            QL_REQUIRE(settlementDate>=refDate,
-                       "settlement date (" << settlementDate << ") before "
-                       "discount curve reference date (" << refDate << ")");
-        }
-
-        results_.valuationDate = npvDate_;
-        if (npvDate_==Date()) {
-            results_.valuationDate = refDate;
-        } else {
-            QL_REQUIRE(npvDate_>=refDate,
-                       "npv date (" << npvDate_  << ") before "
-                       "discount curve reference date (" << refDate << ")");
-        }
+        Date settlementDate = this->settlementDate(refDate);
+        results_.valuationDate = npvDate(refDate);
         results_.npvDateDiscount = discountCurve_->discount(results_.valuationDate);
 
         Size n = arguments_.legs.size();
@@ -71,9 +80,7 @@ namespace QuantLib {
         results_.startDiscounts.resize(n);
         results_.endDiscounts.resize(n);
 
-        bool includeRefDateFlows = includeSettlementDateFlows_ ? // NOLINT(readability-implicit-bool-conversion)
-                                       *includeSettlementDateFlows_ :
-                                       Settings::instance().includeReferenceDateEvents();
+        bool includeRefDateFlows = this->includeRefDateFlows();
 
         for (Size i=0; i<n; ++i) {
             try {
@@ -111,4 +118,32 @@ namespace QuantLib {
         }
     }
 
+    std::vector<std::pair<Date, Real> >
+    DiscountingSwapEngine::npvGradient(const Swap& swap) const {
+        QL_REQUIRE(!discountCurve_.empty(),
+                   "discounting term structure handle is empty");
+
+        const Date refDate = discountCurve_->referenceDate();
+        const Date settlementDate = this->settlementDate(refDate);
+        const Date valuationDate = npvDate(refDate);
+        const bool includeRefDateFlows = this->includeRefDateFlows();
+
+        std::vector<std::pair<Date, Real> > gradient;
+        for (Size i=0; i<swap.legs().size(); ++i) {
+            const Real sign = swap.payer(i) ? -1.0 : 1.0;
+            try {
+                for (const auto& g :
+                         CashFlows::npvGradient(swap.legs()[i],
+                                                **discountCurve_,
+                                                includeRefDateFlows,
+                                                settlementDate,
+                                                valuationDate))
+                    gradient.emplace_back(g.first, sign * g.second);
+            } catch (std::exception &e) {
+                QL_FAIL(io::ordinal(i+1) << " leg: " << e.what());
+            }
+        }
+        return gradient;
+    }
+
 }
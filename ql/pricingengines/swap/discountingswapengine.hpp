@@ -29,6 +29,8 @@
 #include <ql/termstructures/yieldtermstructure.hpp>
 #include <ql/handle.hpp>
 #include <ql/optional.hpp>
+#include <utility>
+#include <vector>
 
 namespace QuantLib {
 
@@ -44,10 +46,18 @@ namespace QuantLib {
             Date settlementDate = Date(),
             Date npvDate = Date());
         void calculate() const override;
+        //! gradient of the NPV of the swap wrt the discount factors
+        /*! The NPV is the one returned by calculate(); see
+            CashFlows::npvGradient for the returned derivatives.
+        */
+        std::vector<std::pair<Date, Real> > npvGradient(const Swap& swap) const;
         Handle<YieldTermStructure> discountCurve() const {
             return discountCurve_;
         }
       private:
+        Date settlementDate(const Date& refDate) const;
+        Date npvDate(const Date& refDate) const;
+        bool includeRefDateFlows() const;
         Handle<YieldTermStructure> discountCurve_;
         ext::optional<bool> includeSettlementDateFlows_;
         Date settlementDate_, npvDate_;
@@ -0,0 +1,236 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/exercise.hpp>
+#include <ql/math/comparison.hpp>
+#include <ql/math/integrals/discreteintegrals.hpp>
+#include <ql/methods/finitedifferences/meshers/fdmblackscholesmesher.hpp>
+#include <ql/methods/finitedifferences/meshers/fdmmeshercomposite.hpp>
+#include <ql/methods/finitedifferences/operators/fdmblackscholesfwdop.hpp>
+#include <ql/methods/finitedifferences/schemes/craigsneydscheme.hpp>
+#include <ql/methods/finitedifferences/schemes/cranknicolsonscheme.hpp>
+#include <ql/methods/finitedifferences/schemes/douglasscheme.hpp>
+#include <ql/methods/finitedifferences/schemes/expliciteulerscheme.hpp>
+#include <ql/methods/finitedifferences/schemes/hundsdorferscheme.hpp>
+#include <ql/methods/finitedifferences/schemes/impliciteulerscheme.hpp>
+#include <ql/methods/finitedifferences/schemes/modifiedcraigsneydscheme.hpp>
+#include <ql/methods/finitedifferences/utilities/fdmmesherintegral.hpp>
+#include <ql/pricingengines/vanilla/fdblackscholesfokkerplanckengine.hpp>
+#include <ql/processes/blackscholesprocess.hpp>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace QuantLib {
+
+    namespace {
+
+        template <class Scheme>
+        void evolve(Scheme& scheme, Array& p, Time from, Time to, Size steps) {
+            const Time dt = (to - from)/steps;
+            scheme.setStep(dt);
+            for (Size i=1; i <= steps; ++i)
+                scheme.step(p, (i < steps) ? from + i*dt : to);
+        }
+
+        // the schemes step from t-dt to t, which moves the forward
+        // equation forward in time
+        void evolve(const FdmSchemeDesc& desc,
+                    const ext::shared_ptr<FdmLinearOpComposite>& op,
+                    Array& p, Time from, Time to, Size steps) {
+            if (steps == 0)
+                return;
+
+            switch (desc.type) {
+              case FdmSchemeDesc::HundsdorferType:
+                {
+                    HundsdorferScheme scheme(desc.theta, desc.mu, op);
+                    evolve(scheme, p, from, to, steps);
+                }
+                break;
+              case FdmSchemeDesc::DouglasType:
+                {
+                    DouglasScheme scheme(desc.theta, op);
+                    evolve(scheme, p, from, to, steps);
+                }
+                break;
+              case FdmSchemeDesc::CrankNicolsonType:
+                {
+                    CrankNicolsonScheme scheme(desc.theta, op);
+                    evolve(scheme, p, from, to, steps);
+                }
+                break;
+              case FdmSchemeDesc::CraigSneydType:
+                {
+                    CraigSneydScheme scheme(desc.theta, desc.mu, op);
+                    evolve(scheme, p, from, to, steps);
+                }
+                break;
+              case FdmSchemeDesc::ModifiedCraigSneydType:
+                {
+                    ModifiedCraigSneydScheme scheme(desc.theta, desc.mu, op);
+                    evolve(scheme, p, from, to, steps);
+                }
+                break;
+              case FdmSchemeDesc::ImplicitEulerType:
+                {
+                    ImplicitEulerScheme scheme(op);
+                    evolve(scheme, p, from, to, steps);
+                }
+                break;
+              case FdmSchemeDesc::ExplicitEulerType:
+                {
+                    ExplicitEulerScheme scheme(op);
+                    evolve(scheme, p, from, to, steps);
+                }
+                break;
+              default:
+                QL_FAIL("scheme is not supported by the Fokker-Planck engine");
+            }
+        }
+
+    }
+
+    FdBlackScholesFokkerPlanckEngine::FdBlackScholesFokkerPlanckEngine(
+        ext::shared_ptr<GeneralizedBlackScholesProcess> process,
+        std::vector<Date> expiries,
+        Size tGrid,
+        Size xGrid,
+        Size dampingSteps,
+        const FdmSchemeDesc& schemeDesc,
+        bool localVol,
+        Real illegalLocalVolOverwrite)
+    : process_(std::move(process)), expiries_(std::move(expiries)),
+      tGrid_(tGrid), xGrid_(xGrid), dampingSteps_(dampingSteps),
+      schemeDesc_(schemeDesc), localVol_(localVol),
+      illegalLocalVolOverwrite_(illegalLocalVolOverwrite) {
+        QL_REQUIRE(tGrid_ > 0, "at least one time step required");
+        QL_REQUIRE(xGrid_ > 3, "at least four grid points required");
+        registerWith(process_);
+    }
+
+    void FdBlackScholesFokkerPlanckEngine::update() {
+        densities_.clear();
+        VanillaOption::engine::update();
+    }
+
+    void FdBlackScholesFokkerPlanckEngine::calculate() const {
+        QL_REQUIRE(arguments_.exercise->type() == Exercise::European,
+                   "not an European option");
+
+        const Date expiry = arguments_.exercise->lastDate();
+        const Time maturity = process_->time(expiry);
+        QL_REQUIRE(maturity > 0.0, "expired option given");
+
+        if (!localVol_) {
+            const ext::shared_ptr<StrikedTypePayoff> payoff =
+                ext::dynamic_pointer_cast<StrikedTypePayoff>(arguments_.payoff);
+            QL_REQUIRE(payoff == nullptr
+                       || close_enough(
+                           process_->blackVolatility()->blackVariance(
+                               maturity, payoff->strike(), true),
+                           process_->blackVolatility()->blackVariance(
+                               maturity, process_->x0(), true)),
+                       "the Fokker-Planck engine requires local volatility "
+                       "or a volatility independent of the strike");
+        }
+
+        if (densities_.find(expiry) == densities_.end()) {
+            std::vector<Date> expiries(expiries_);
+            expiries.push_back(expiry);
+            for (const auto& density : densities_)
+                expiries.push_back(density.first);
+
+            propagateDensity(expiries);
+        }
+
+        const Array& p = densities_.find(expiry)->second;
+        const Array x = mesher_->locations(0);
+
+        Array f(x.size());
+        for (Size i=0; i < x.size(); ++i)
+            f[i] = (*arguments_.payoff)(std::exp(x[i]))*p[i];
+
+        results_.value = process_->riskFreeRate()->discount(expiry)
+            * FdmMesherIntegral(mesher_, DiscreteSimpsonIntegral()).integrate(f);
+    }
+
+    void FdBlackScholesFokkerPlanckEngine::propagateDensity(
+                                    const std::vector<Date>& expiries) const {
+        std::vector<Date> dates;
+        for (const auto& d : expiries) {
+            if (process_->time(d) > 0.0)
+                dates.push_back(d);
+        }
+        std::sort(dates.begin(), dates.end());
+        dates.erase(std::unique(dates.begin(), dates.end()), dates.end());
+
+        const Real spot = process_->x0();
+        const Time maturity = process_->time(dates.back());
+
+        // 1. Mesher
+        mesher_ = ext::make_shared<FdmMesherComposite>(
+            ext::make_shared<FdmBlackScholesMesher>(
+                xGrid_, process_, maturity, spot,
+                Null<Real>(), Null<Real>(), 0.0001, 1.5,
+                std::pair<Real, Real>(spot, 0.1)));
+
+        // 2. Initial density, a Dirac delta at the spot
+        const Array x = mesher_->locations(0);
+        const Real x0 = std::log(spot);
+        QL_REQUIRE(x0 > x[1] && x0 < x[x.size()-2], "insufficient mesher");
+
+        const Size upper = std::upper_bound(x.begin(), x.end(), x0) - x.begin();
+        const Size lower = upper - 1;
+
+        Array p(x.size(), 0.0);
+        p[lower] = (x[upper] - x0)/(x[upper] - x[lower])
+            / (0.5*(x[lower+1] - x[lower-1]));
+        p[upper] = (x0 - x[lower])/(x[upper] - x[lower])
+            / (0.5*(x[upper+1] - x[upper-1]));
+
+        // 3. Operator
+        const ext::shared_ptr<FdmLinearOpComposite> op =
+            ext::make_shared<FdmBlackScholesFwdOp>(
+                mesher_, process_, spot, localVol_, illegalLocalVolOverwrite_);
+
+        // 4. Forward propagation, the first steps are damped with
+        //    implicit Euler steps to smooth out the Dirac delta
+        densities_.clear();
+
+        const Time dt = maturity/tGrid_;
+        Size dampingSteps = dampingSteps_;
+        Time t = 0.0;
+        for (const auto& d : dates) {
+            const Time expiry = process_->time(d);
+            const Size steps = std::max<Size>(
+                1, Size(std::lround((expiry - t)/dt)));
+            const Time h = (expiry - t)/steps;
+
+            const Size implicitSteps = std::min(dampingSteps, steps);
+            const Time dampingTo = t + implicitSteps*h;
+            evolve(FdmSchemeDesc::ImplicitEuler(), op,
+                   p, t, dampingTo, implicitSteps);
+            evolve(schemeDesc_, op, p, dampingTo, expiry, steps - implicitSteps);
+            dampingSteps -= implicitSteps;
+
+            densities_[d] = p;
+            t = expiry;
+        }
+    }
+
+}
@@ -0,0 +1,86 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file fdblackscholesfokkerplanckengine.hpp
+    \brief Fokker-Planck forward engine for European options
+*/
+
+#ifndef quantlib_fd_black_scholes_fokker_planck_engine_hpp
+#define quantlib_fd_black_scholes_fokker_planck_engine_hpp
+
+#include <ql/instruments/vanillaoption.hpp>
+#include <ql/methods/finitedifferences/solvers/fdmbackwardsolver.hpp>
+#include <map>
+
+namespace QuantLib {
+
+    class FdmMesherComposite;
+    class GeneralizedBlackScholesProcess;
+
+    //! Fokker-Planck forward engine for European options
+    /*! The risk-neutral density of the log-spot is propagated forward
+        in time from the spot by solving the Fokker-Planck equation
+        of the process; the price of a European payoff is then the
+        discounted integral of the payoff against the density at its
+        expiry.  The densities at all the given expiries are computed
+        in a single forward propagation and kept until the engine is
+        notified of a change, so that any number of payoffs, e.g. a
+        whole volatility surface, are priced with one solve.  Options
+        expiring on other dates trigger a new propagation that
+        includes their expiry.
+
+        Only the value of the option is calculated.  Without local
+        volatility, the volatility at the spot is used, so that the
+        volatility must not depend on the strike.
+
+        \ingroup vanillaengines
+
+        \test the correctness of the returned value is tested by
+              comparison with Black pricing.
+    */
+    class FdBlackScholesFokkerPlanckEngine : public VanillaOption::engine {
+      public:
+        explicit FdBlackScholesFokkerPlanckEngine(
+            ext::shared_ptr<GeneralizedBlackScholesProcess> process,
+            std::vector<Date> expiries = std::vector<Date>(),
+            Size tGrid = 100,
+            Size xGrid = 400,
+            Size dampingSteps = 2,
+            const FdmSchemeDesc& schemeDesc = FdmSchemeDesc::Douglas(),
+            bool localVol = false,
+            Real illegalLocalVolOverwrite = -Null<Real>());
+
+        void calculate() const override;
+        void update() override;
+
+      private:
+        void propagateDensity(const std::vector<Date>& expiries) const;
+
+        const ext::shared_ptr<GeneralizedBlackScholesProcess> process_;
+        const std::vector<Date> expiries_;
+        const Size tGrid_, xGrid_, dampingSteps_;
+        const FdmSchemeDesc schemeDesc_;
+        const bool localVol_;
+        const Real illegalLocalVolOverwrite_;
+
+        mutable ext::shared_ptr<FdmMesherComposite> mesher_;
+        mutable std::map<Date, Array> densities_;
+    };
+
+}
+
+#endif
@@ -20,10 +20,15 @@
 */
 
 #include <ql/exercise.hpp>
+#include <ql/math/comparison.hpp>
+#include <ql/methods/finitedifferences/meshers/concentrating1dmesher.hpp>
 #include <ql/methods/finitedifferences/meshers/fdmblackscholesmesher.hpp>
 #include <ql/methods/finitedifferences/utilities/escroweddividendadjustment.hpp>
 #include <ql/methods/finitedifferences/meshers/fdmmeshercomposite.hpp>
+#include <ql/methods/finitedifferences/meshers/predefined1dmesher.hpp>
+#include <ql/methods/finitedifferences/operators/fdmblackscholesop.hpp>
 #include <ql/methods/finitedifferences/operators/fdmlinearoplayout.hpp>
+#include <ql/methods/finitedifferences/solvers/fdm1dimbatchsolver.hpp>
 #include <ql/methods/finitedifferences/solvers/fdmblackscholessolver.hpp>
 #include <ql/methods/finitedifferences/stepconditions/fdmstepconditioncomposite.hpp>
 #include <ql/methods/finitedifferences/utilities/fdminnervaluecalculator.hpp>
@@ -31,6 +36,7 @@
 #include <ql/methods/finitedifferences/utilities/fdmquantohelper.hpp>
 #include <ql/pricingengines/vanilla/fdblackscholesvanillaengine.hpp>
 #include <ql/processes/blackscholesprocess.hpp>
+#include <algorithm>
 
 namespace QuantLib {
 
@@ -108,6 +114,40 @@ namespace QuantLib {
 
     void FdBlackScholesVanillaEngine::calculate() const {
 
+        if (!strikes_.empty()) {
+            const ext::shared_ptr<PlainVanillaPayoff> payoff =
+                ext::dynamic_pointer_cast<PlainVanillaPayoff>(arguments_.payoff);
+            QL_REQUIRE(payoff, "non plain vanilla payoff given");
+
+            const auto cachedResults = [&]() -> const VanillaOption::results* {
+                for (const auto& cachedArgs2result : cachedArgs2results_) {
+                    const ext::shared_ptr<PlainVanillaPayoff> p =
+                        ext::dynamic_pointer_cast<PlainVanillaPayoff>(
+                            cachedArgs2result.first.payoff);
+
+                    if (cachedArgs2result.first.exercise->type()
+                            == arguments_.exercise->type()
+                        && cachedArgs2result.first.exercise->dates()
+                            == arguments_.exercise->dates()
+                        && p->strike() == payoff->strike()
+                        && p->optionType() == payoff->optionType())
+                        return &cachedArgs2result.second;
+                }
+                return nullptr;
+            };
+
+            const VanillaOption::results* results = cachedResults();
+            if (results == nullptr) {
+                // the batch always contains the option
+                // passed to the engine
+                calculateBatch();
+                results = cachedResults();
+                QL_REQUIRE(results != nullptr, "option not found in the batch");
+            }
+            results_ = *results;
+            return;
+        }
+
         // 0. Cash dividend model
         const Date exerciseDate = arguments_.exercise->lastDate();
         const Time maturity = process_->time(exerciseDate);
@@ -210,6 +250,163 @@ namespace QuantLib {
         results_.theta = solver->thetaAt(spot);
     }
 
+    void FdBlackScholesVanillaEngine::calculateBatch() const {
+        const ext::shared_ptr<PlainVanillaPayoff> payoff =
+            ext::dynamic_pointer_cast<PlainVanillaPayoff>(arguments_.payoff);
+        const ext::shared_ptr<Exercise> exercise = arguments_.exercise;
+
+        QL_REQUIRE(exercise->type() == Exercise::European
+                   || exercise->type() == Exercise::American,
+                   "multiple strikes caching supports only "
+                   "European and American exercises");
+        QL_REQUIRE(cashDividendModel_ == Spot,
+                   "multiple strikes caching supports only "
+                   "the spot cash dividend model");
+        QL_REQUIRE(quantoHelper_ == nullptr,
+                   "multiple strikes caching is not supported "
+                   "for quanto options");
+
+        // 0. Batch of strikes and exercise dates
+        std::vector<Real> strikes(strikes_);
+        strikes.push_back(payoff->strike());
+        std::sort(strikes.begin(), strikes.end());
+        strikes.erase(std::unique(strikes.begin(), strikes.end()),
+                      strikes.end());
+
+        const Date earliestDate = exercise->dates().front();
+        std::vector<Date> dates(1, exercise->lastDate());
+        for (const auto& d : exerciseDates_) {
+            // American exercises of the batch share the earliest date
+            if (exercise->type() == Exercise::European || d >= earliestDate)
+                dates.push_back(d);
+        }
+        std::sort(dates.begin(), dates.end());
+        dates.erase(std::unique(dates.begin(), dates.end()), dates.end());
+
+        std::vector<ext::shared_ptr<Exercise> > exercises;
+        for (const auto& d : dates) {
+            if (exercise->type() == Exercise::European)
+                exercises.push_back(ext::make_shared<EuropeanExercise>(d));
+            else
+                exercises.push_back(
+                    ext::make_shared<AmericanExercise>(earliestDate, d));
+        }
+
+        const Date referenceDate = process_->riskFreeRate()->referenceDate();
+        const Time maturity = process_->time(dates.back());
+
+        if (!localVol_) {
+            // the operator uses the volatility at the strike of the option
+            for (const auto& d : dates) {
+                const Time t = process_->time(d);
+                const Real v = process_->blackVolatility()
+                    ->blackVariance(t, payoff->strike(), true);
+                for (Real strike : strikes)
+                    QL_REQUIRE(close_enough(v, process_->blackVolatility()
+                                   ->blackVariance(t, strike, true)),
+                               "multiple strikes caching requires local "
+                               "volatility or a volatility independent "
+                               "of the strike");
+            }
+        }
+
+        // 1. Mesher; it spans the ranges required by the lowest and
+        // highest strikes and is concentrated around all strikes
+        const auto range = [&](Real strike) {
+            const FdmBlackScholesMesher m(
+                xGrid_, process_, maturity, strike,
+                Null<Real>(), Null<Real>(), 0.0001, 1.5,
+                std::pair<Real, Real>(strike, 0.1), dividends_);
+            return std::make_pair(m.locations().front(), m.locations().back());
+        };
+        const std::pair<Real, Real> low = range(strikes.front());
+        const std::pair<Real, Real> high = range(strikes.back());
+
+        std::vector<std::tuple<Real, Real, bool> > cPoints;
+        for (Real strike : strikes)
+            cPoints.emplace_back(std::log(strike), 0.1, false);
+
+        const ext::shared_ptr<Fdm1dMesher> equityMesher =
+            ext::make_shared<Concentrating1dMesher>(
+                std::min(low.first, high.first),
+                std::max(low.second, high.second), xGrid_, cPoints);
+
+        std::vector<Real> lines(strikes.size()*dates.size());
+        for (Size i=0; i < lines.size(); ++i)
+            lines[i] = Real(i);
+
+        const ext::shared_ptr<FdmMesher> mesher =
+            ext::make_shared<FdmMesherComposite>(
+                equityMesher, ext::make_shared<Predefined1dMesher>(lines));
+
+        // 2. Calculator
+        std::vector<ext::shared_ptr<FdmInnerValueCalculator> > calculators;
+        std::vector<Time> maturities;
+        for (const auto& d : dates) {
+            for (Real strike : strikes) {
+                calculators.push_back(ext::make_shared<FdmLogInnerValue>(
+                    ext::make_shared<PlainVanillaPayoff>(
+                        payoff->optionType(), strike), mesher, 0));
+                maturities.push_back(process_->time(d));
+            }
+        }
+        const ext::shared_ptr<FdmInnerValueCalculator> calculator =
+            ext::make_shared<FdmBatchInnerValue>(calculators, 1);
+
+        // 3. Step conditions
+        const ext::shared_ptr<FdmStepConditionComposite> conditions =
+            FdmStepConditionComposite::vanillaComposite(
+                dividends_, exercises.back(), mesher, calculator,
+                referenceDate, process_->riskFreeRate()->dayCounter());
+
+        // 4. Boundary conditions
+        const FdmBoundaryConditionSet boundaries;
+
+        // 5. Solver
+        const FdmSolverDesc solverDesc = {
+            mesher, boundaries, conditions, calculator,
+            maturity, tGrid_, dampingSteps_ };
+
+        const ext::shared_ptr<FdmLinearOpComposite> op =
+            ext::make_shared<FdmBlackScholesOp>(
+                mesher, process_, payoff->strike(),
+                localVol_, illegalLocalVolOverwrite_);
+
+        const Fdm1DimBatchSolver solver(solverDesc, maturities, schemeDesc_, op);
+
+        const Real spot = process_->x0();
+        const Real x = std::log(spot);
+
+        cachedArgs2results_.resize(maturities.size());
+        for (Size i=0; i < maturities.size(); ++i) {
+            VanillaOption::arguments& args = cachedArgs2results_[i].first;
+            args.exercise = exercises[i / strikes.size()];
+            args.payoff = ext::make_shared<PlainVanillaPayoff>(
+                payoff->optionType(), strikes[i % strikes.size()]);
+
+            const Real dX = solver.derivativeX(i, x);
+
+            VanillaOption::results& results = cachedArgs2results_[i].second;
+            results.value = solver.interpolateAt(i, x);
+            results.delta = dX/spot;
+            results.gamma = (solver.derivativeXX(i, x) - dX)/(spot*spot);
+            results.theta = solver.thetaAt(i, x);
+        }
+    }
+
+    void FdBlackScholesVanillaEngine::update() {
+        cachedArgs2results_.clear();
+        VanillaOption::engine::update();
+    }
+
+    void FdBlackScholesVanillaEngine::enableMultipleStrikesCaching(
+                                    const std::vector<Real>& strikes,
+                                    const std::vector<Date>& exerciseDates) {
+        strikes_ = strikes;
+        exerciseDates_ = exerciseDates;
+        cachedArgs2results_.clear();
+    }
+
     MakeFdBlackScholesVanillaEngine::MakeFdBlackScholesVanillaEngine(
         ext::shared_ptr<GeneralizedBlackScholesProcess> process)
     : process_(std::move(process)),
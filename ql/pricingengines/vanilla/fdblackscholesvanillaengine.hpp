@@ -92,7 +92,24 @@ namespace QuantLib {
 
         void calculate() const override;
 
+        // multiple strikes caching engine
+        void update() override;
+        /*! Prices all the given strikes and exercise dates together
+            with the option passed to the engine, with the same option
+            and exercise type, in a single rollback on a shared mesh.
+            The results are cached and returned for any later option
+            of the batch until the engine is notified of a change.
+            Only European and American exercises and the spot cash
+            dividend model are supported; without local volatility,
+            the volatility must not depend on the strike.
+        */
+        void enableMultipleStrikesCaching(
+            const std::vector<Real>& strikes,
+            const std::vector<Date>& exerciseDates = std::vector<Date>());
+
       private:
+        void calculateBatch() const;
+
         ext::shared_ptr<GeneralizedBlackScholesProcess> process_;
         DividendSchedule dividends_;
         Size tGrid_, xGrid_, dampingSteps_;
@@ -101,6 +118,12 @@ namespace QuantLib {
         Real illegalLocalVolOverwrite_;
         ext::shared_ptr<FdmQuantoHelper> quantoHelper_;
         CashDividendModel cashDividendModel_;
+
+        std::vector<Real> strikes_;
+        std::vector<Date> exerciseDates_;
+        mutable std::vector<std::pair<VanillaOption::arguments,
+                                      VanillaOption::results> >
+                                                   cachedArgs2results_;
     };
 
 
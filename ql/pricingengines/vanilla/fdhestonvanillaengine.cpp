@@ -24,16 +24,35 @@
 #include <ql/methods/finitedifferences/meshers/fdmblackscholesmultistrikemesher.hpp>
 #include <ql/methods/finitedifferences/meshers/fdmhestonvariancemesher.hpp>
 #include <ql/methods/finitedifferences/meshers/fdmmeshercomposite.hpp>
+#include <ql/methods/finitedifferences/operators/fdmhestonop.hpp>
 #include <ql/methods/finitedifferences/operators/fdmlinearoplayout.hpp>
 #include <ql/methods/finitedifferences/solvers/fdmhestonsolver.hpp>
 #include <ql/methods/finitedifferences/stepconditions/fdmstepconditioncomposite.hpp>
 #include <ql/methods/finitedifferences/utilities/fdminnervaluecalculator.hpp>
 #include <ql/pricingengines/vanilla/fdhestonvanillaengine.hpp>
 #include <ql/processes/batesprocess.hpp>
+#include <algorithm>
 #include <utility>
 
 namespace QuantLib {
 
+    namespace {
+
+        // the data the mesher and the operator are built from, besides
+        // the variance mesher and the linked curves, which are checked
+        // by identity and by counting their notifications; the
+        // operator takes the model parameters when it's built.
+        std::vector<Real> mesherKey(const HestonProcess& process,
+                                    Time maturity, Real strike) {
+            return {
+                Real(process.riskFreeRate()->referenceDate().serialNumber()),
+                maturity, strike, process.s0()->value(), process.kappa(),
+                process.theta(), process.sigma(), process.rho()
+            };
+        }
+
+    }
+
     FdHestonVanillaEngine::FdHestonVanillaEngine(const ext::shared_ptr<HestonModel>& model,
                                                  Size tGrid,
                                                  Size xGrid,
@@ -47,7 +66,9 @@ namespace QuantLib {
                          VanillaOption::results>(model),
       tGrid_(tGrid), xGrid_(xGrid), vGrid_(vGrid), dampingSteps_(dampingSteps),
       schemeDesc_(schemeDesc), leverageFct_(std::move(leverageFct)),
-      quantoHelper_(ext::shared_ptr<FdmQuantoHelper>()), mixingFactor_(mixingFactor) {}
+      quantoHelper_(ext::shared_ptr<FdmQuantoHelper>()), mixingFactor_(mixingFactor) {
+        registerWith(leverageFct_);
+    }
 
     FdHestonVanillaEngine::FdHestonVanillaEngine(const ext::shared_ptr<HestonModel>& model,
                                                  DividendSchedule dividends,
@@ -64,7 +85,9 @@ namespace QuantLib {
       dividends_(std::move(dividends)),
       tGrid_(tGrid), xGrid_(xGrid), vGrid_(vGrid), dampingSteps_(dampingSteps),
       schemeDesc_(schemeDesc), leverageFct_(std::move(leverageFct)),
-      quantoHelper_(ext::shared_ptr<FdmQuantoHelper>()), mixingFactor_(mixingFactor) {}
+      quantoHelper_(ext::shared_ptr<FdmQuantoHelper>()), mixingFactor_(mixingFactor) {
+        registerWith(leverageFct_);
+    }
 
     FdHestonVanillaEngine::FdHestonVanillaEngine(const ext::shared_ptr<HestonModel>& model,
                                                  ext::shared_ptr<FdmQuantoHelper> quantoHelper,
@@ -80,7 +103,10 @@ namespace QuantLib {
                          VanillaOption::results>(model),
       tGrid_(tGrid), xGrid_(xGrid), vGrid_(vGrid), dampingSteps_(dampingSteps),
       schemeDesc_(schemeDesc), leverageFct_(std::move(leverageFct)),
-      quantoHelper_(std::move(quantoHelper)), mixingFactor_(mixingFactor) {}
+      quantoHelper_(std::move(quantoHelper)), mixingFactor_(mixingFactor) {
+        registerWith(quantoHelper_);
+        registerWith(leverageFct_);
+    }
 
     FdHestonVanillaEngine::FdHestonVanillaEngine(const ext::shared_ptr<HestonModel>& model,
                                                  DividendSchedule dividends,
@@ -98,7 +124,10 @@ namespace QuantLib {
       dividends_(std::move(dividends)),
       tGrid_(tGrid), xGrid_(xGrid), vGrid_(vGrid), dampingSteps_(dampingSteps),
       schemeDesc_(schemeDesc), leverageFct_(std::move(leverageFct)),
-      quantoHelper_(std::move(quantoHelper)), mixingFactor_(mixingFactor) {}
+      quantoHelper_(std::move(quantoHelper)), mixingFactor_(mixingFactor) {
+        registerWith(quantoHelper_);
+        registerWith(leverageFct_);
+    }
 
     FdmSolverDesc FdHestonVanillaEngine::getSolverDesc(Real) const {
 
@@ -106,48 +135,89 @@ namespace QuantLib {
         const ext::shared_ptr<HestonProcess> process = model_->process();
         const Time maturity = process->time(arguments_.exercise->lastDate());
 
-        // 1.1 The variance mesher
-        const Size tGridMin = 5;
-        const Size tGridAvgSteps = std::max(tGridMin, tGrid_/50);
-        const ext::shared_ptr<FdmHestonLocalVolatilityVarianceMesher> vMesher
-            = ext::make_shared<FdmHestonLocalVolatilityVarianceMesher>(
-                  vGrid_, process, leverageFct_, maturity, tGridAvgSteps, 0.0001, mixingFactor_);
-
-        const Volatility avgVolaEstimate = vMesher->volaEstimate();
-
-        // 1.2 The equity mesher
         const ext::shared_ptr<StrikedTypePayoff> payoff =
             ext::dynamic_pointer_cast<StrikedTypePayoff>(arguments_.payoff);
 
-        ext::shared_ptr<Fdm1dMesher> equityMesher;
-        if (strikes_.empty()) {
-            equityMesher = ext::shared_ptr<Fdm1dMesher>(
-                new FdmBlackScholesMesher(
-                    xGrid_,
-                    FdmBlackScholesMesher::processHelper(
-                        process->s0(), process->dividendYield(),
-                        process->riskFreeRate(), avgVolaEstimate),
-                    maturity, payoff->strike(),
-                    Null<Real>(), Null<Real>(), 0.0001, 2.0,
-                    std::pair<Real, Real>(payoff->strike(), 0.1),
-                    dividends_,
-                    quantoHelper_));
+        // 1.1 The variance mesher, which only depends on the maturity
+        //     and on the parameters of the variance process (and, if
+        //     given, on the leverage function; see update())
+        const std::vector<Real> varianceParams = {
+            process->v0(), process->kappa(), process->theta(), process->sigma()
+        };
+        if (varianceParams != varianceMesherParams_) {
+            varianceMeshers_.clear();
+            varianceMesherParams_ = varianceParams;
+        }
+        const auto cached = std::find_if(
+            varianceMeshers_.begin(), varianceMeshers_.end(),
+            [maturity](const auto& m) { return m.first == maturity; });
+        if (cached != varianceMeshers_.end()) {
+            varianceMeshers_.splice(varianceMeshers_.begin(),
+                                    varianceMeshers_, cached);
+        } else {
+            const Size tGridMin = 5;
+            const Size tGridAvgSteps = std::max(tGridMin, tGrid_/50);
+            varianceMeshers_.emplace_front(
+                maturity,
+                ext::make_shared<FdmHestonLocalVolatilityVarianceMesher>(
+                    vGrid_, process, leverageFct_, maturity, tGridAvgSteps,
+                    0.0001, mixingFactor_));
+            if (varianceMeshers_.size() > maxVarianceMeshers)
+                varianceMeshers_.pop_back();
         }
-        else {
-            QL_REQUIRE(dividends_.empty(),
-                       "multiple strikes engine does not work with discrete dividends");
-            equityMesher = ext::shared_ptr<Fdm1dMesher>(
-                new FdmBlackScholesMultiStrikeMesher(
-                    xGrid_,
-                    FdmBlackScholesMesher::processHelper(
-                      process->s0(), process->dividendYield(),
-                      process->riskFreeRate(), avgVolaEstimate),
-                    maturity, strikes_, 0.0001, 1.5,
-                    std::pair<Real, Real>(payoff->strike(), 0.075)));
+        const ext::shared_ptr<FdmHestonLocalVolatilityVarianceMesher> vMesher
+            = varianceMeshers_.front().second;
+
+        std::vector<Real> key = mesherKey(*process, maturity, payoff->strike());
+        if (mesher_ == nullptr || key != mesherKey_
+            || vMesher != mesherVarianceMesher_
+            || process->riskFreeRate().currentLink() != mesherRiskFreeRate_
+            || process->dividendYield().currentLink() != mesherDividendYield_
+            || mesherCurveUpdates_.updates() != 0) {
+
+            const Volatility avgVolaEstimate = vMesher->volaEstimate();
+
+            // 1.2 The equity mesher
+            ext::shared_ptr<Fdm1dMesher> equityMesher;
+            if (strikes_.empty()) {
+                equityMesher = ext::shared_ptr<Fdm1dMesher>(
+                    new FdmBlackScholesMesher(
+                        xGrid_,
+                        FdmBlackScholesMesher::processHelper(
+                            process->s0(), process->dividendYield(),
+                            process->riskFreeRate(), avgVolaEstimate),
+                        maturity, payoff->strike(),
+                        Null<Real>(), Null<Real>(), 0.0001, 2.0,
+                        std::pair<Real, Real>(payoff->strike(), 0.1),
+                        dividends_,
+                        quantoHelper_));
+            }
+            else {
+                QL_REQUIRE(dividends_.empty(),
+                           "multiple strikes engine does not work with discrete dividends");
+                equityMesher = ext::shared_ptr<Fdm1dMesher>(
+                    new FdmBlackScholesMultiStrikeMesher(
+                        xGrid_,
+                        FdmBlackScholesMesher::processHelper(
+                          process->s0(), process->dividendYield(),
+                          process->riskFreeRate(), avgVolaEstimate),
+                        maturity, strikes_, 0.0001, 1.5,
+                        std::pair<Real, Real>(payoff->strike(), 0.075)));
+            }
+
+            mesher_ = ext::make_shared<FdmMesherComposite>(equityMesher, vMesher);
+            mesherKey_ = std::move(key);
+            mesherVarianceMesher_ = vMesher;
+            mesherRiskFreeRate_ = process->riskFreeRate().currentLink();
+            mesherDividendYield_ = process->dividendYield().currentLink();
+            mesherCurveUpdates_.unregisterWithAll();
+            mesherCurveUpdates_.registerWith(mesherRiskFreeRate_);
+            mesherCurveUpdates_.registerWith(mesherDividendYield_);
+            mesherCurveUpdates_.reset();
+            op_.reset();
         }
 
-        const ext::shared_ptr<FdmMesher> mesher(
-            new FdmMesherComposite(equityMesher, vMesher));
+        const ext::shared_ptr<FdmMesher> mesher = mesher_;
 
         // 2. Calculator
         const ext::shared_ptr<FdmInnerValueCalculator> calculator(
@@ -196,11 +266,22 @@ namespace QuantLib {
 
         const ext::shared_ptr<HestonProcess> process = model_->process();
 
+        const FdmSolverDesc solverDesc = getSolverDesc(1.5);
+
+        if (op_ == nullptr) {
+            op_ = ext::make_shared<FdmHestonOp>(
+                solverDesc.mesher, process, quantoHelper_,
+                leverageFct_, mixingFactor_);
+            ++cacheMisses_;
+        }
+        else
+            ++cacheHits_;
+
         ext::shared_ptr<FdmHestonSolver> solver(new FdmHestonSolver(
                     Handle<HestonProcess>(process),
-                    getSolverDesc(1.5), schemeDesc_,
+                    solverDesc, schemeDesc_,
                     Handle<FdmQuantoHelper>(quantoHelper_), leverageFct_,
-                    mixingFactor_));
+                    mixingFactor_, op_));
 
         const Real v0   = process->v0();
         const Real spot = process->s0()->value();
@@ -230,6 +311,14 @@ namespace QuantLib {
 
     void FdHestonVanillaEngine::update() {
         cachedArgs2results_.clear();
+        // the meshers and the operator are checked against the data
+        // they were built from; the quanto helper and the leverage
+        // function are not, and their changes clear them.
+        if (quantoHelper_ != nullptr || leverageFct_ != nullptr) {
+            varianceMeshers_.clear();
+            mesher_.reset();
+            op_.reset();
+        }
         GenericModelEngine<HestonModel,
                            VanillaOption::arguments,
                            VanillaOption::results>::update();
@@ -239,6 +328,8 @@ namespace QuantLib {
                                         const std::vector<Real>& strikes) {
         strikes_ = strikes;
         cachedArgs2results_.clear();
+        mesher_.reset();
+        op_.reset();
     }
 
 
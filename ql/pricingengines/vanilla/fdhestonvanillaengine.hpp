@@ -32,9 +32,13 @@
 #include <ql/methods/finitedifferences/solvers/fdmsolverdesc.hpp>
 #include <ql/methods/finitedifferences/solvers/fdmbackwardsolver.hpp>
 #include <ql/termstructures/volatility/equityfx/localvoltermstructure.hpp>
+#include <list>
 
 namespace QuantLib {
 
+    class FdmHestonLocalVolatilityVarianceMesher;
+    class FdmLinearOpComposite;
+    class FdmMesher;
     class FdmQuantoHelper;
 
     //! Finite-differences Heston vanilla option engine
@@ -99,7 +103,33 @@ namespace QuantLib {
         // helper method for Heston like engines
         FdmSolverDesc getSolverDesc(Real equityScaleFactor) const;
 
+        /*! The mesher and the operator of the last calculation are
+            reused by the next one if they would be built from the
+            same data, i.e., the same maturity, strike, spot and model
+            parameters and the same curves, not notified since, e.g.
+            for options of different type or exercise; variance
+            meshers are reused for the last few maturities priced
+            with the same variance parameters, e.g., when only the
+            correlation, the spot or the curves change.
+            Notifications don't clear the caches, unless a quanto
+            helper or a leverage function is used.  The counters tell
+            how many calculations reused or rebuilt the operator.
+        */
+        Size cacheHits() const { return cacheHits_; }
+        Size cacheMisses() const { return cacheMisses_; }
+
       private:
+        // counts the notifications of the curves the mesher was built on
+        class UpdateCounter : public Observer {
+          public:
+            void update() override { ++updates_; }
+            Size updates() const { return updates_; }
+            void reset() { updates_ = 0; }
+          private:
+            Size updates_ = 0;
+        };
+        static constexpr Size maxVarianceMeshers = 16;
+
         DividendSchedule dividends_;
         const Size tGrid_, xGrid_, vGrid_, dampingSteps_;
         const FdmSchemeDesc schemeDesc_;
@@ -111,6 +141,22 @@ namespace QuantLib {
         mutable std::vector<std::pair<VanillaOption::arguments,
                                       VanillaOption::results> >
                                                             cachedArgs2results_;
+
+        // mesher and operator caching
+        mutable std::vector<Real> varianceMesherParams_;
+        // most recently used first
+        mutable std::list<std::pair<Time,
+                          ext::shared_ptr<FdmHestonLocalVolatilityVarianceMesher> > >
+                                                            varianceMeshers_;
+        mutable std::vector<Real> mesherKey_;
+        mutable ext::shared_ptr<FdmHestonLocalVolatilityVarianceMesher>
+                                                            mesherVarianceMesher_;
+        mutable ext::shared_ptr<YieldTermStructure> mesherRiskFreeRate_,
+                                                    mesherDividendYield_;
+        mutable UpdateCounter mesherCurveUpdates_;
+        mutable ext::shared_ptr<FdmMesher> mesher_;
+        mutable ext::shared_ptr<FdmLinearOpComposite> op_;
+        mutable Size cacheHits_ = 0, cacheMisses_ = 0;
     };
 
     class MakeFdHestonVanillaEngine {
@@ -0,0 +1,110 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/math/richardsonextrapolation.hpp>
+#include <ql/pricingengines/vanilla/fdrichardsonvanillaengine.hpp>
+#include <ql/utilities/parallel.hpp>
+#include <cmath>
+
+namespace QuantLib {
+
+    FdRichardsonVanillaEngine::FdRichardsonVanillaEngine(
+        const engine_factory& factory,
+        Size tGrid,
+        Size xGrid,
+        Real order,
+        bool parallel)
+    : order_(order), parallel_(parallel) {
+        QL_REQUIRE(order_ == Null<Real>() || order_ > 0.0,
+                   "positive order of convergence required");
+        #ifndef QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN
+        QL_REQUIRE(!parallel_,
+                   "concurrent calculations require "
+                   "the thread-safe observer pattern");
+        #endif
+
+        scales_ = (order_ == Null<Real>()) ?
+            std::vector<Real>{1.0, 2.0, 4.0} : std::vector<Real>{1.0, 2.0};
+
+        for (Real scale : scales_) {
+            const Size t = Size(std::lround(tGrid/scale));
+            const Size x = Size(std::lround(xGrid/scale));
+            QL_REQUIRE(t > 0 && x > 0,
+                       "grid too coarse for Richardson extrapolation");
+
+            engines_.push_back(factory(t, x));
+            QL_REQUIRE(engines_.back(), "null engine given by the factory");
+            registerWith(engines_.back());
+        }
+    }
+
+    void FdRichardsonVanillaEngine::calculate() const {
+        std::vector<VanillaOption::results> results(engines_.size());
+
+        const auto solve = [&](Size i) {
+            const ext::shared_ptr<PricingEngine>& engine = engines_[i];
+            engine->reset();
+
+            auto* arguments =
+                dynamic_cast<VanillaOption::arguments*>(engine->getArguments());
+            QL_REQUIRE(arguments != nullptr, "wrong engine type");
+            *arguments = arguments_;
+            arguments->validate();
+
+            engine->calculate();
+
+            const auto* r =
+                dynamic_cast<const VanillaOption::results*>(engine->getResults());
+            QL_REQUIRE(r != nullptr, "wrong engine type");
+            results[i] = *r;
+        };
+
+        // the coarsest level sets up lazily initialized market data
+        const Size coarsest = engines_.size()-1;
+        solve(coarsest);
+
+        if (parallel_)
+            detail::runInParallel(coarsest, solve);
+        else
+            for (Size i=0; i < coarsest; ++i)
+                solve(i);
+
+        const auto extrapolate = [&](Real VanillaOption::results::* x) -> Real {
+            for (const auto& r : results)
+                if (r.*x == Null<Real>())
+                    return Null<Real>();
+
+            const auto f = [&](Real h) {
+                for (Size i=0; i < scales_.size(); ++i)
+                    if (scales_[i] == h)
+                        return results[i].*x;
+                QL_FAIL("unexpected grid scale " << h);
+            };
+
+            if (order_ == Null<Real>())
+                return RichardsonExtrapolation(f, 4.0)(4.0, 2.0);
+            else
+                return RichardsonExtrapolation(f, 2.0, order_)(2.0);
+        };
+
+        results_.value = extrapolate(&VanillaOption::results::value);
+        results_.delta = extrapolate(&VanillaOption::results::delta);
+        results_.gamma = extrapolate(&VanillaOption::results::gamma);
+        results_.theta = extrapolate(&VanillaOption::results::theta);
+    }
+
+}
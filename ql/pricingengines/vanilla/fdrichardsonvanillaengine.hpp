@@ -0,0 +1,87 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file fdrichardsonvanillaengine.hpp
+    \brief Richardson extrapolation of finite-difference vanilla engines
+*/
+
+#ifndef quantlib_fd_richardson_vanilla_engine_hpp
+#define quantlib_fd_richardson_vanilla_engine_hpp
+
+#include <ql/instruments/vanillaoption.hpp>
+#include <ql/functional.hpp>
+
+namespace QuantLib {
+
+    //! Richardson extrapolation of finite-difference vanilla engines
+    /*! The option is priced by engines built by the given factory on
+        the given grid and on coarser grids with half (and, when the
+        order of convergence is unknown, a quarter) of the time steps
+        and grid points; value and greeks are then extrapolated to a
+        vanishing grid size.  A few coarse solves thus give the
+        accuracy of a much finer one.
+
+        The coarsest level is calculated first, so that lazily
+        initialized market data are set up only once; the other
+        levels can then be calculated concurrently.
+
+        \warning Concurrent calculations require the library to be
+                 compiled with the thread-safe observer pattern, and
+                 the market data used by the engines to be safe for
+                 concurrent reads.  Global settings, such as the
+                 evaluation date, must not be changed during the
+                 calculation.
+
+        \ingroup vanillaengines
+
+        \test the extrapolated value is tested against Black pricing.
+
+        \test concurrent calculations are checked against sequential
+              ones.
+    */
+    class FdRichardsonVanillaEngine : public VanillaOption::engine {
+      public:
+        typedef std::function<ext::shared_ptr<PricingEngine>(Size tGrid,
+                                                             Size xGrid)>
+            engine_factory;
+
+        /*! \param factory builds an engine for the given grid sizes
+            \param tGrid   time steps of the finest level
+            \param xGrid   grid points of the finest level
+            \param order   order of convergence of the engines, or
+                           Null<Real>() if it has to be estimated
+            \param parallel whether the levels are calculated
+                           concurrently
+        */
+        FdRichardsonVanillaEngine(const engine_factory& factory,
+                                  Size tGrid,
+                                  Size xGrid,
+                                  Real order = 2.0,
+                                  bool parallel = false);
+
+        void calculate() const override;
+
+      private:
+        const Real order_;
+        const bool parallel_;
+        std::vector<Real> scales_;
+        std::vector<ext::shared_ptr<PricingEngine> > engines_;
+    };
+
+}
+
+#endif
@@ -66,7 +66,9 @@ namespace QuantLib {
                          LsmBasisSystem::PolynomialType polynomialType,
                          Size nCalibrationSamples = Null<Size>(),
                          const ext::optional<bool>& antitheticVariateCalibration = ext::nullopt,
-                         BigNatural seedCalibration = Null<Size>());
+                         BigNatural seedCalibration = Null<Size>(),
+                         Size threads = 1,
+                         bool storeCalibrationPaths = true);
 
         void calculate() const override;
 
@@ -122,6 +124,8 @@ namespace QuantLib {
         MakeMCAmericanEngine& withCalibrationSamples(Size calibrationSamples);
         MakeMCAmericanEngine& withAntitheticVariateCalibration(bool b = true);
         MakeMCAmericanEngine& withSeedCalibration(BigNatural seed);
+        MakeMCAmericanEngine& withThreads(Size threads);
+        MakeMCAmericanEngine& withStoredCalibrationPaths(bool b = true);
 
         // conversion to pricing engine
         operator ext::shared_ptr<PricingEngine>() const;
@@ -136,6 +140,8 @@ namespace QuantLib {
         LsmBasisSystem::PolynomialType polynomialType_ = LsmBasisSystem::Monomial;
         ext::optional<bool> antitheticCalibration_;
         BigNatural seedCalibration_;
+        Size threads_ = 1;
+        bool storeCalibrationPaths_ = true;
     };
 
     template <class RNG, class S, class RNG_Calibration>
@@ -153,7 +159,9 @@ namespace QuantLib {
         LsmBasisSystem::PolynomialType polynomialType,
         Size nCalibrationSamples,
         const ext::optional<bool>& antitheticVariateCalibration,
-        BigNatural seedCalibration)
+        BigNatural seedCalibration,
+        Size threads,
+        bool storeCalibrationPaths)
     : MCLongstaffSchwartzEngine<VanillaOption::engine, SingleVariate, RNG, S, RNG_Calibration>(
           process,
           timeSteps,
@@ -168,7 +176,9 @@ namespace QuantLib {
           nCalibrationSamples,
           false,
           antitheticVariateCalibration,
-          seedCalibration),
+          seedCalibration,
+          threads,
+          storeCalibrationPaths),
       polynomialOrder_(polynomialOrder), polynomialType_(polynomialType) {}
 
     template <class RNG, class S, class RNG_Calibration>
@@ -375,6 +385,21 @@ namespace QuantLib {
         return *this;
     }
 
+    template <class RNG, class S, class RNG_Calibration>
+    inline MakeMCAmericanEngine<RNG, S, RNG_Calibration> &
+    MakeMCAmericanEngine<RNG, S, RNG_Calibration>::withThreads(Size threads) {
+        threads_ = threads;
+        return *this;
+    }
+
+    template <class RNG, class S, class RNG_Calibration>
+    inline MakeMCAmericanEngine<RNG, S, RNG_Calibration> &
+    MakeMCAmericanEngine<RNG, S, RNG_Calibration>::withStoredCalibrationPaths(
+                                                                     bool b) {
+        storeCalibrationPaths_ = b;
+        return *this;
+    }
+
     template <class RNG, class S, class RNG_Calibration>
     inline MakeMCAmericanEngine<RNG, S, RNG_Calibration>::
     operator ext::shared_ptr<PricingEngine>() const {
@@ -395,7 +420,9 @@ namespace QuantLib {
                                      polynomialType_,
                                      calibrationSamples_,
                                      antitheticCalibration_,
-                                     seedCalibration_));
+                                     seedCalibration_,
+                                     threads_,
+                                     storeCalibrationPaths_));
     }
 
 }
@@ -66,15 +66,21 @@ namespace QuantLib {
                         Size requiredSamples,
                         Real requiredTolerance,
                         Size maxSamples,
-                        BigNatural seed);
+                        BigNatural seed,
+                        Size threads = 1);
         // McSimulation implementation
         TimeGrid timeGrid() const override;
         ext::shared_ptr<path_generator_type> pathGenerator() const override {
+            return streamPathGenerator(0, 0);
+        }
+        ext::shared_ptr<path_generator_type>
+        streamPathGenerator(Size stream, Size firstSample) const override {
 
             Size dimensions = process_->factors();
             TimeGrid grid = this->timeGrid();
             typename RNG::rsg_type generator =
-                RNG::make_sequence_generator(dimensions*(grid.size()-1),seed_);
+                detail::make_stream_sequence_generator<RNG>(
+                    dimensions*(grid.size()-1), seed_, stream, firstSample);
             return ext::shared_ptr<path_generator_type>(
                    new path_generator_type(process_, grid,
                                            generator, brownianBridge_));
@@ -103,8 +109,9 @@ namespace QuantLib {
         Size requiredSamples,
         Real requiredTolerance,
         Size maxSamples,
-        BigNatural seed)
-    : McSimulation<MC, RNG, S>(antitheticVariate, controlVariate), process_(std::move(process)),
+        BigNatural seed,
+        Size threads)
+    : McSimulation<MC, RNG, S>(antitheticVariate, controlVariate, threads), process_(std::move(process)),
       timeSteps_(timeSteps), timeStepsPerYear_(timeStepsPerYear), requiredSamples_(requiredSamples),
       maxSamples_(maxSamples), requiredTolerance_(requiredTolerance),
       brownianBridge_(brownianBridge), seed_(seed) {
@@ -62,6 +62,12 @@ namespace QuantLib {
         return retVal;
     }
 
+    void BatesProcess::evolveBatch(Time t0, Size paths, Real* x,
+                                   Time dt, const Real* dw) const {
+        // jumps are drawn path by path; skip the Heston batch schemes
+        StochasticProcess::evolveBatch(t0, paths, x, dt, dw);
+    }
+
     Size BatesProcess::factors() const {
         return HestonProcess::factors() + 2;
     }
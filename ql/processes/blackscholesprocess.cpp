@@ -146,6 +146,27 @@ namespace QuantLib {
                                  stdDeviation(t0, x0, dt) * dw);
     }
 
+    void GeneralizedBlackScholesProcess::evolveBatch(Time t0, Size paths,
+                                                     Real* x, Time dt,
+                                                     const Real* dw) const {
+        localVolatility(); // trigger update
+        if (isStrikeIndependent_ && !forceDiscretization_) {
+            // drift and variance don't depend on the state
+            Real var = variance(t0, 0.0, dt);
+            Real drift = (riskFreeRate_->forwardRate(t0, t0 + dt, Continuous,
+                                                     NoFrequency, true).rate() -
+                          dividendYield_->forwardRate(t0, t0 + dt, Continuous,
+                                                      NoFrequency, true).rate()) *
+                             dt -
+                         0.5 * var;
+            Real stdDev = std::sqrt(var);
+            for (Size p=0; p<paths; ++p)
+                x[p] *= std::exp(stdDev * dw[p] + drift);
+        } else {
+            StochasticProcess1D::evolveBatch(t0, paths, x, dt, dw);
+        }
+    }
+
     Time GeneralizedBlackScholesProcess::time(const Date& d) const {
         return riskFreeRate_->dayCounter().yearFraction(
                                            riskFreeRate_->referenceDate(), d);
@@ -83,6 +83,11 @@ namespace QuantLib {
         Real stdDeviation(Time t0, Real x0, Time dt) const override;
         Real variance(Time t0, Real x0, Time dt) const override;
         Real evolve(Time t0, Real x0, Time dt, Real dw) const override;
+        void evolveBatch(Time t0,
+                         Size paths,
+                         Real* x,
+                         Time dt,
+                         const Real* dw) const override;
         //@}
         Time time(const Date&) const override;
         //! \name Observer interface
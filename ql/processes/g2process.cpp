@@ -95,6 +95,27 @@ namespace QuantLib {
         return result;
     }
 
+    void G2Process::evolveBatch(Time t0, Size paths, Real* x,
+                                Time dt, const Real* dw) const {
+        // neither the decay factors nor the standard deviation
+        // depend on the state, so they're computed once per step.
+        Real* x1 = x;
+        Real* y1 = x + paths;
+        const Real* dw0 = dw;
+        const Real* dw1 = dw + paths;
+        const Real xLevel = xProcess_->level(), yLevel = yProcess_->level();
+        const Real xDecay = std::exp(-xProcess_->speed()*dt);
+        const Real yDecay = std::exp(-yProcess_->speed()*dt);
+        const Matrix s = stdDeviation(t0, initialValues(), dt);
+        const Real s00 = s[0][0], s10 = s[1][0], s11 = s[1][1];
+        for (Size p=0; p<paths; ++p) {
+            const Real ex = xLevel + (x1[p] - xLevel) * xDecay;
+            const Real ey = yLevel + (y1[p] - yLevel) * yDecay;
+            x1[p] = ex + dw0[p]*s00;
+            y1[p] = ey + (dw0[p]*s10 + dw1[p]*s11);
+        }
+    }
+
     Real G2Process::x0() const {
         return x0_;
     }
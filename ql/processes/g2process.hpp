@@ -43,6 +43,8 @@ namespace QuantLib {
         Array expectation(Time t0, const Array& x0, Time dt) const override;
         Matrix stdDeviation(Time t0, const Array& x0, Time dt) const override;
         Matrix covariance(Time t0, const Array& x0, Time dt) const override;
+        void evolveBatch(Time t0, Size paths, Real* x,
+                         Time dt, const Real* dw) const override;
         //@}
         Real x0() const;
         Real y0() const;
@@ -396,50 +396,19 @@ namespace QuantLib {
     Array HestonProcess::evolve(Time t0, const Array& x0,
                                 Time dt, const Array& dw) const {
         Array retVal(2);
-        Real vol, vol2, mu, nu, dy;
+        Real vol, mu, dy;
 
         const Real sdt = std::sqrt(dt);
         const Real sqrhov = std::sqrt(1.0 - rho_*rho_);
 
         switch (discretization_) {
-          // For the definition of PartialTruncation, FullTruncation
-          // and Reflection  see Lord, R., R. Koekkoek and D. van Dijk (2006),
-          // "A Comparison of biased simulation schemes for
-          //  stochastic volatility models",
-          // Working Paper, Tinbergen Institute
           case PartialTruncation:
-            vol = (x0[1] > 0.0) ? std::sqrt(x0[1]) : Real(0.0);
-            vol2 = sigma_ * vol;
-            mu =    riskFreeRate_->forwardRate(t0, t0+dt, Continuous).rate()
-                  - dividendYield_->forwardRate(t0, t0+dt, Continuous).rate()
-                    - 0.5 * vol * vol;
-            nu = kappa_*(theta_ - x0[1]);
-
-            retVal[0] = x0[0] * std::exp(mu*dt+vol*dw[0]*sdt);
-            retVal[1] = x0[1] + nu*dt + vol2*sdt*(rho_*dw[0] + sqrhov*dw[1]);
-            break;
           case FullTruncation:
-            vol = (x0[1] > 0.0) ? std::sqrt(x0[1]) : Real(0.0);
-            vol2 = sigma_ * vol;
-            mu =    riskFreeRate_->forwardRate(t0, t0+dt, Continuous).rate()
-                  - dividendYield_->forwardRate(t0, t0+dt, Continuous).rate()
-                    - 0.5 * vol * vol;
-            nu = kappa_*(theta_ - vol*vol);
-
-            retVal[0] = x0[0] * std::exp(mu*dt+vol*dw[0]*sdt);
-            retVal[1] = x0[1] + nu*dt + vol2*sdt*(rho_*dw[0] + sqrhov*dw[1]);
-            break;
           case Reflection:
-            vol = std::sqrt(std::fabs(x0[1]));
-            vol2 = sigma_ * vol;
-            mu =    riskFreeRate_->forwardRate(t0, t0+dt, Continuous).rate()
-                  - dividendYield_->forwardRate(t0, t0+dt, Continuous).rate()
-                    - 0.5 * vol*vol;
-            nu = kappa_*(theta_ - vol*vol);
-
-            retVal[0] = x0[0]*std::exp(mu*dt+vol*dw[0]*sdt);
-            retVal[1] = vol*vol
-                        +nu*dt + vol2*sdt*(rho_*dw[0] + sqrhov*dw[1]);
+          case QuadraticExponential:
+          case QuadraticExponentialMartingale:
+            retVal = x0;
+            evolveStates(t0, 1, retVal.begin(), dt, dw.begin());
             break;
           case NonCentralChiSquareVariance:
             // use Alan Lewis trick to decorrelate the equity and the variance
@@ -458,62 +427,6 @@ namespace QuantLib {
 
             retVal[0] = x0[0]*std::exp(dy + rho_/sigma_*(retVal[1]-x0[1]));
             break;
-          case QuadraticExponential:
-          case QuadraticExponentialMartingale:
-          {
-            // for details of the quadratic exponential discretization scheme
-            // see Leif Andersen,
-            // Efficient Simulation of the Heston Stochastic Volatility Model
-            const Real ex = std::exp(-kappa_*dt);
-
-            const Real m  =  theta_+(x0[1]-theta_)*ex;
-            const Real s2 =  x0[1]*sigma_*sigma_*ex/kappa_*(1-ex)
-                           + theta_*sigma_*sigma_/(2*kappa_)*(1-ex)*(1-ex);
-            const Real psi = s2/(m*m);
-
-            const Real g1 =  0.5;
-            const Real g2 =  0.5;
-                  Real k0 = -rho_*kappa_*theta_*dt/sigma_;
-            const Real k1 =  g1*dt*(kappa_*rho_/sigma_-0.5)-rho_/sigma_;
-            const Real k2 =  g2*dt*(kappa_*rho_/sigma_-0.5)+rho_/sigma_;
-            const Real k3 =  g1*dt*(1-rho_*rho_);
-            const Real k4 =  g2*dt*(1-rho_*rho_);
-            const Real A  =  k2+0.5*k4;
-
-            if (psi < 1.5) {
-                const Real b2 = 2/psi-1+std::sqrt(2/psi*(2/psi-1));
-                const Real b  = std::sqrt(b2);
-                const Real a  = m/(1+b2);
-
-                if (discretization_ == QuadraticExponentialMartingale) {
-                    // martingale correction
-                    QL_REQUIRE(A < 1/(2*a), "illegal value");
-                    k0 = -A*b2*a/(1-2*A*a)+0.5*std::log(1-2*A*a)
-                         -(k1+0.5*k3)*x0[1];
-                }
-                retVal[1] = a*(b+dw[1])*(b+dw[1]);
-            }
-            else {
-                const Real p = (psi-1)/(psi+1);
-                const Real beta = (1-p)/m;
-
-                const Real u = CumulativeNormalDistribution()(dw[1]);
-
-                if (discretization_ == QuadraticExponentialMartingale) {
-                    // martingale correction
-                    QL_REQUIRE(A < beta, "illegal value");
-                    k0 = -std::log(p+beta*(1-p)/(beta-A))-(k1+0.5*k3)*x0[1];
-                }
-                retVal[1] = ((u <= p) ? Real(0.0) : std::log((1-p)/(1-u))/beta);
-            }
-
-            mu =   riskFreeRate_->forwardRate(t0, t0+dt, Continuous).rate()
-                 - dividendYield_->forwardRate(t0, t0+dt, Continuous).rate();
-
-            retVal[0] = x0[0]*std::exp(mu*dt + k0 + k1*x0[1] + k2*retVal[1]
-                                       +std::sqrt(k3*x0[1]+k4*retVal[1])*dw[0]);
-          }
-          break;
           case BroadieKayaExactSchemeLobatto:
           case BroadieKayaExactSchemeLaguerre:
           case BroadieKayaExactSchemeTrapezoidal:
@@ -549,6 +462,139 @@ namespace QuantLib {
         return retVal;
     }
 
+    void HestonProcess::evolveBatch(Time t0, Size paths, Real* x,
+                                    Time dt, const Real* dw) const {
+        switch (discretization_) {
+          case PartialTruncation:
+          case FullTruncation:
+          case Reflection:
+          case QuadraticExponential:
+          case QuadraticExponentialMartingale:
+            evolveStates(t0, paths, x, dt, dw);
+            break;
+          default:
+            StochasticProcess::evolveBatch(t0, paths, x, dt, dw);
+        }
+    }
+
+    void HestonProcess::evolveStates(Time t0, Size paths, Real* x,
+                                     Time dt, const Real* dw) const {
+        Real* s = x;
+        Real* v = x + paths;
+        const Real* dw0 = dw;
+        const Real* dw1 = dw + paths;
+
+        const Real sdt = std::sqrt(dt);
+        const Real sqrhov = std::sqrt(1.0 - rho_*rho_);
+        const Rate r = riskFreeRate_->forwardRate(t0, t0+dt, Continuous).rate()
+                     - dividendYield_->forwardRate(t0, t0+dt, Continuous).rate();
+
+        switch (discretization_) {
+          // For the definition of PartialTruncation, FullTruncation
+          // and Reflection  see Lord, R., R. Koekkoek and D. van Dijk (2006),
+          // "A Comparison of biased simulation schemes for
+          //  stochastic volatility models",
+          // Working Paper, Tinbergen Institute
+          case PartialTruncation:
+            for (Size p=0; p<paths; ++p) {
+                const Real vol = (v[p] > 0.0) ? std::sqrt(v[p]) : Real(0.0);
+                const Real vol2 = sigma_ * vol;
+                const Real mu = r - 0.5 * vol * vol;
+                const Real nu = kappa_*(theta_ - v[p]);
+
+                s[p] = s[p] * std::exp(mu*dt+vol*dw0[p]*sdt);
+                v[p] = v[p] + nu*dt + vol2*sdt*(rho_*dw0[p] + sqrhov*dw1[p]);
+            }
+            break;
+          case FullTruncation:
+            for (Size p=0; p<paths; ++p) {
+                const Real vol = (v[p] > 0.0) ? std::sqrt(v[p]) : Real(0.0);
+                const Real vol2 = sigma_ * vol;
+                const Real mu = r - 0.5 * vol * vol;
+                const Real nu = kappa_*(theta_ - vol*vol);
+
+                s[p] = s[p] * std::exp(mu*dt+vol*dw0[p]*sdt);
+                v[p] = v[p] + nu*dt + vol2*sdt*(rho_*dw0[p] + sqrhov*dw1[p]);
+            }
+            break;
+          case Reflection:
+            for (Size p=0; p<paths; ++p) {
+                const Real vol = std::sqrt(std::fabs(v[p]));
+                const Real vol2 = sigma_ * vol;
+                const Real mu = r - 0.5 * vol*vol;
+                const Real nu = kappa_*(theta_ - vol*vol);
+
+                s[p] = s[p]*std::exp(mu*dt+vol*dw0[p]*sdt);
+                v[p] = vol*vol
+                       +nu*dt + vol2*sdt*(rho_*dw0[p] + sqrhov*dw1[p]);
+            }
+            break;
+          case QuadraticExponential:
+          case QuadraticExponentialMartingale:
+          {
+            // for details of the quadratic exponential discretization scheme
+            // see Leif Andersen,
+            // Efficient Simulation of the Heston Stochastic Volatility Model
+            const Real ex = std::exp(-kappa_*dt);
+
+            const Real g1 =  0.5;
+            const Real g2 =  0.5;
+            const Real k1 =  g1*dt*(kappa_*rho_/sigma_-0.5)-rho_/sigma_;
+            const Real k2 =  g2*dt*(kappa_*rho_/sigma_-0.5)+rho_/sigma_;
+            const Real k3 =  g1*dt*(1-rho_*rho_);
+            const Real k4 =  g2*dt*(1-rho_*rho_);
+            const Real A  =  k2+0.5*k4;
+
+            const CumulativeNormalDistribution N;
+
+            for (Size p=0; p<paths; ++p) {
+                const Real v0 = v[p];
+                const Real m  =  theta_+(v0-theta_)*ex;
+                const Real s2 =  v0*sigma_*sigma_*ex/kappa_*(1-ex)
+                               + theta_*sigma_*sigma_/(2*kappa_)*(1-ex)*(1-ex);
+                const Real psi = s2/(m*m);
+
+                Real k0 = -rho_*kappa_*theta_*dt/sigma_;
+                Real v1;
+
+                if (psi < 1.5) {
+                    const Real b2 = 2/psi-1+std::sqrt(2/psi*(2/psi-1));
+                    const Real b  = std::sqrt(b2);
+                    const Real a  = m/(1+b2);
+
+                    if (discretization_ == QuadraticExponentialMartingale) {
+                        // martingale correction
+                        QL_REQUIRE(A < 1/(2*a), "illegal value");
+                        k0 = -A*b2*a/(1-2*A*a)+0.5*std::log(1-2*A*a)
+                             -(k1+0.5*k3)*v0;
+                    }
+                    v1 = a*(b+dw1[p])*(b+dw1[p]);
+                }
+                else {
+                    const Real q = (psi-1)/(psi+1);
+                    const Real beta = (1-q)/m;
+
+                    const Real u = N(dw1[p]);
+
+                    if (discretization_ == QuadraticExponentialMartingale) {
+                        // martingale correction
+                        QL_REQUIRE(A < beta, "illegal value");
+                        k0 = -std::log(q+beta*(1-q)/(beta-A))-(k1+0.5*k3)*v0;
+                    }
+                    v1 = ((u <= q) ? Real(0.0) : std::log((1-q)/(1-u))/beta);
+                }
+
+                s[p] = s[p]*std::exp(r*dt + k0 + k1*v0 + k2*v1
+                                     +std::sqrt(k3*v0+k4*v1)*dw0[p]);
+                v[p] = v1;
+            }
+          }
+          break;
+          default:
+            QL_FAIL("discretization schema not supported for batches");
+        }
+    }
+
     const Handle<Quote>& HestonProcess::s0() const {
         return s0_;
     }
@@ -73,6 +73,12 @@ namespace QuantLib {
         Matrix diffusion(Time t, const Array& x) const override;
         Array apply(const Array& x0, const Array& dx) const override;
         Array evolve(Time t0, const Array& x0, Time dt, const Array& dw) const override;
+        /*! the truncation, reflection and quadratic-exponential
+            schemes evolve the whole batch in a single loop per
+            step; the exact schemes evolve one path at a time.
+        */
+        void evolveBatch(Time t0, Size paths, Real* x,
+                         Time dt, const Real* dw) const override;
 
         Real v0()    const { return v0_; }
         Real rho()   const { return rho_; }
@@ -92,6 +98,8 @@ namespace QuantLib {
 
       private:
         Real varianceDistribution(Real v, Real dw, Time dt) const;
+        void evolveStates(Time t0, Size paths, Real* x,
+                          Time dt, const Real* dw) const;
 
         Handle<YieldTermStructure> riskFreeRate_, dividendYield_;
         Handle<Quote> s0_;
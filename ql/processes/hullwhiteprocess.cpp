@@ -62,6 +62,20 @@ namespace QuantLib {
         return process_->variance(t0, x0, dt);
     }
 
+    void HullWhiteProcess::evolveBatch(Time t0, Size paths, Real* x,
+                                       Time dt, const Real* dw) const {
+        // the exact transition only depends on x through the
+        // Ornstein-Uhlenbeck expectation; everything else is
+        // computed once for the whole batch.
+        const Real level = process_->level();
+        const Real decay = std::exp(-process_->speed()*dt);
+        const Real a1 = alpha(t0 + dt);
+        const Real a0 = alpha(t0)*std::exp(-a_*dt);
+        const Real sd = stdDeviation(t0, x0(), dt);
+        for (Size p=0; p<paths; ++p)
+            x[p] = (level + (x[p] - level) * decay + a1 - a0) + sd*dw[p];
+    }
+
     Real HullWhiteProcess::alpha(Time t) const {
         Real alfa = a_ > QL_EPSILON ?
                     Real((sigma_/a_)*(1 - std::exp(-a_*t))) :
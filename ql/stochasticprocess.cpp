@@ -56,6 +56,21 @@ namespace QuantLib {
         return apply(expectation(t0,x0,dt), stdDeviation(t0,x0,dt)*dw);
     }
 
+    void StochasticProcess::evolveBatch(Time t0, Size paths, Real* x,
+                                        Time dt, const Real* dw) const {
+        const Size n = size(), m = factors();
+        Array x0(n), dw0(m);
+        for (Size p=0; p<paths; ++p) {
+            for (Size i=0; i<n; ++i)
+                x0[i] = x[i*paths+p];
+            for (Size j=0; j<m; ++j)
+                dw0[j] = dw[j*paths+p];
+            const Array x1 = evolve(t0, x0, dt, dw0);
+            for (Size i=0; i<n; ++i)
+                x[i*paths+p] = x1[i];
+        }
+    }
+
     Array StochasticProcess::apply(const Array& x0,
                                    const Array& dx) const {
         return x0 + dx;
@@ -92,6 +107,12 @@ namespace QuantLib {
         return apply(expectation(t0,x0,dt), stdDeviation(t0,x0,dt)*dw);
     }
 
+    void StochasticProcess1D::evolveBatch(Time t0, Size paths, Real* x,
+                                          Time dt, const Real* dw) const {
+        for (Size p=0; p<paths; ++p)
+            x[p] = evolve(t0, x[p], dt, dw[p]);
+    }
+
     Real StochasticProcess1D::apply(Real x0, Real dx) const {
         return x0 + dx;
     }
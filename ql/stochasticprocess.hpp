@@ -124,6 +124,20 @@ namespace QuantLib {
                              const Array& x0,
                              Time dt,
                              const Array& dw) const;
+        /*! evolves in place the states of a batch of paths over a
+            time interval \f$ \Delta t \f$.  The i-th component of
+            the state on the p-th path is stored in
+            <tt>x[i*paths+p]</tt>, and the j-th random variate for
+            the p-th path in <tt>dw[j*paths+p]</tt>; this is the
+            layout of MultiPathBatch.  By default, it calls evolve()
+            on each path; derived classes can override it to share
+            calculations across paths and avoid allocations.
+        */
+        virtual void evolveBatch(Time t0,
+                                 Size paths,
+                                 Real* x,
+                                 Time dt,
+                                 const Real* dw) const;
         /*! applies a change to the asset value. By default, it
             returns \f$ \mathrm{x} + \Delta \mathrm{x} \f$.
         */
@@ -217,6 +231,14 @@ namespace QuantLib {
             standard deviation.
         */
         virtual Real evolve(Time t0, Real x0, Time dt, Real dw) const;
+        /*! evolves in place the values of a batch of paths; by
+            default, it calls evolve() on each value.
+        */
+        void evolveBatch(Time t0,
+                         Size paths,
+                         Real* x,
+                         Time dt,
+                         const Real* dw) const override;
         /*! applies a change to the asset value. By default, it
             returns \f$ x + \Delta x \f$.
         */
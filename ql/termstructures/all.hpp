@@ -9,6 +9,7 @@
 #include <ql/termstructures/interpolatedcurve.hpp>
 #include <ql/termstructures/iterativebootstrap.hpp>
 #include <ql/termstructures/localbootstrap.hpp>
+#include <ql/termstructures/newtonbootstrap.hpp>
 #include <ql/termstructures/voltermstructure.hpp>
 #include <ql/termstructures/yieldtermstructure.hpp>
 
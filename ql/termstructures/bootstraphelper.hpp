@@ -34,6 +34,7 @@
 #include <ql/settings.hpp>
 #include <ql/time/date.hpp>
 #include <utility>
+#include <vector>
 
 namespace QuantLib {
 
@@ -70,6 +71,16 @@ namespace QuantLib {
         const Handle<Quote>& quote() const { return quote_; }
         virtual Real impliedQuote() const = 0;
         Real quoteError() const { return quote_->value() - impliedQuote(); }
+        //! analytic gradient of the implied quote
+        /*! If available, sets the dates at which the implied quote
+            depends on the term structure being bootstrapped and its
+            derivatives with respect to the term-structure values at
+            those dates (e.g., the discount factors for yield curves)
+            and returns true; otherwise, returns false.  Dates can be
+            repeated, in which case the derivatives add up.
+        */
+        virtual bool impliedQuoteGradient(std::vector<Date>& dates,
+                                          std::vector<Real>& gradient) const;
         //! sets the term structure to be used for pricing
         /*! \warning Being a pointer and not a shared_ptr, the term
                      structure is not guaranteed to remain allocated
@@ -163,6 +174,12 @@ namespace QuantLib {
         termStructure_ = t;
     }
 
+    template <class TS>
+    bool BootstrapHelper<TS>::impliedQuoteGradient(std::vector<Date>&,
+                                                   std::vector<Real>&) const {
+        return false;
+    }
+
     template <class TS>
     Date BootstrapHelper<TS>::earliestDate() const {
         return earliestDate_;
@@ -64,6 +64,8 @@ template <class Curve> class GlobalBootstrap {
                     Real accuracy = Null<Real>());
     void setup(Curve *ts);
     void calculate() const;
+    //! discards the current solution, which is otherwise used as a guess
+    void reset() { validCurve_ = initialized_ = false; }
 
   private:
     void initialize() const;
@@ -29,6 +29,7 @@
 
 #include <ql/termstructures/bootstraphelper.hpp>
 #include <ql/termstructures/bootstraperror.hpp>
+#include <ql/math/comparison.hpp>
 #include <ql/math/interpolations/linearinterpolation.hpp>
 #include <ql/math/solvers1d/finitedifferencenewtonsafe.hpp>
 #include <ql/math/solvers1d/brent.hpp>
@@ -74,6 +75,17 @@ namespace detail {
 }
 
     //! Universal piecewise-term-structure boostrapper.
+    /*! When the curve is bootstrapped again and neither the
+        interpolation nor the helpers require the convergence loop,
+        the error of each helper is first checked against the one
+        left by the previous bootstrap; pillars whose helpers give
+        the same error, i.e., whose quotes and dependencies did not
+        change, keep their previous value and are not solved again.
+        This makes re-bootstrapping after a single quote bump restart
+        from the first affected pillar.  For moving curves, this
+        holds as long as the pillars don't move, i.e., until the
+        evaluation date changes.
+    */
     template <class Curve>
     class IterativeBootstrap {
         typedef typename Curve::traits_type Traits;
@@ -103,8 +115,12 @@ namespace detail {
                            Size maxEvaluations = MAX_FUNCTION_EVALUATIONS);
         void setup(Curve* ts);
         void calculate() const;
+        //! discards the current solution, which is otherwise used as a guess
+        void reset() { validCurve_ = initialized_ = false; }
+        //! number of pillar solves avoided by incremental bootstraps
+        Size skippedSolves() const { return skippedSolves_; }
       private:
-        void initialize() const;
+        bool initialize() const;
         Real accuracy_;
         Real minValue_, maxValue_;
         Size maxAttempts_;
@@ -118,7 +134,8 @@ namespace detail {
         FiniteDifferenceNewtonSafe solver_;
         mutable bool initialized_ = false, validCurve_ = false, loopRequired_;
         mutable Size firstAliveHelper_ = 0, alive_ = 0;
-        mutable std::vector<Real> previousData_;
+        mutable std::vector<Real> previousData_, residuals_;
+        mutable Size skippedSolves_ = 0;
         mutable std::vector<ext::shared_ptr<BootstrapError<Curve> > > errors_;
     };
 
@@ -156,8 +173,10 @@ namespace detail {
         // but valid later when bootstrapping is actually required
     }
 
+    // returns true if the pillars changed, in which case no previous
+    // residual can be reused
     template <class Curve>
-    void IterativeBootstrap<Curve>::initialize() const {
+    bool IterativeBootstrap<Curve>::initialize() const {
         // ensure helpers are sorted
         std::sort(ts_->instruments_.begin(), ts_->instruments_.end(),
                   detail::BootstrapHelperSorter());
@@ -178,6 +197,8 @@ namespace detail {
         // calculate dates and times, create errors_
         std::vector<Date>& dates = ts_->dates_;
         std::vector<Time>& times = ts_->times_;
+        const std::vector<Date> previousDates = dates;
+        const std::vector<Time> previousTimes = times;
         dates.resize(alive_+1);
         times.resize(alive_+1);
         errors_.resize(alive_+1);
@@ -226,7 +247,12 @@ namespace detail {
             previousData_.resize(alive_+1);
             validCurve_ = false;
         }
+        const bool pillarsChanged =
+            !initialized_ || dates != previousDates || times != previousTimes;
+        if (pillarsChanged)
+            residuals_ = std::vector<Real>(alive_+1, Null<Real>());
         initialized_ = true;
+        return pillarsChanged;
     }
 
     template <class Curve>
@@ -237,8 +263,9 @@ namespace detail {
         // with evaluation date change.
         // anyway it makes little sense to use date relative helpers with a
         // non-moving curve if the evaluation date changes
+        bool reinitialized = false;
         if (!initialized_ || ts_->moving_)
-            initialize();
+            reinitialized = initialize();
 
         // setup helpers
         for (Size j=firstAliveHelper_; j<n_; ++j) {
@@ -264,6 +291,10 @@ namespace detail {
         // there might be a valid curve state to use as guess
         bool validData = validCurve_;
 
+        // pillars are solved independently of later ones, so those
+        // whose helpers are unaffected by the changes can be skipped
+        const bool incremental = validCurve_ && !reinitialized && !loopRequired_;
+
         for (Size iteration=0; ; ++iteration) {
             previousData_ = ts_->data_;
 
@@ -274,6 +305,12 @@ namespace detail {
 
             for (Size i=1; i<=alive_; ++i) { // pillar loop
 
+                if (incremental && attempts[i] == 1
+                    && close_enough((*errors_[i])(data[i]), residuals_[i])) {
+                    ++skippedSolves_;
+                    continue;
+                }
+
                 // shorter aliases for readability and to avoid duplication
                 Real& min = minValues[i];
                 Real& max = maxValues[i];
@@ -361,6 +398,9 @@ namespace detail {
                                 ": " << e.what());
                     }
                 }
+
+                if (!loopRequired_)
+                    residuals_[i] = errors_[i]->helper()->quoteError();
             }
 
             if (!loopRequired_)
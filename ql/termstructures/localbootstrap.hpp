@@ -91,6 +91,8 @@ namespace QuantLib {
                        Real accuracy = Null<Real>());
         void setup(Curve* ts);
         void calculate() const;
+        //! no-op; the previous solution is never used as a guess
+        void reset() {}
 
       private:
         mutable bool validCurve_ = false;
@@ -0,0 +1,333 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file newtonbootstrap.hpp
+    \brief Newton bootstrap of all the pillars at once
+*/
+
+#ifndef quantlib_newton_bootstrap_hpp
+#define quantlib_newton_bootstrap_hpp
+
+#include <ql/math/interpolations/linearinterpolation.hpp>
+#include <ql/math/matrixutilities/qrdecomposition.hpp>
+#include <ql/termstructures/bootstraphelper.hpp>
+#include <ql/utilities/dataformatters.hpp>
+#include <algorithm>
+#include <map>
+
+namespace QuantLib {
+
+    //! Newton bootstrap of all the pillars at once
+    /*! The curve data at all pillars are solved for together with a
+        damped Newton method.  The Jacobian is assembled from the
+        analytic gradients of the implied quotes with respect to the
+        discount factors, as given by
+        BootstrapHelper::impliedQuoteGradient, and from the
+        sensitivities of the discount factors to the curve data,
+        which only require the interpolation to be evaluated; the
+        helpers are therefore priced once per iteration.  Deposit,
+        FRA, futures, swap and OIS helpers provide such gradients;
+        the rows of other helpers are obtained by repricing them with
+        bumped curve data.
+
+        The bootstrap stops when all quote errors, or all the changes
+        in the curve data, are below the accuracy.
+
+        \warning This class works with yield curves, since the
+                 gradients are taken with respect to discount factors.
+    */
+    template <class Curve>
+    class NewtonBootstrap {
+        typedef typename Curve::traits_type Traits;
+        typedef typename Curve::interpolator_type Interpolator;
+      public:
+        /*! \param accuracy  Accuracy for the stopping criterion. If it is
+                             set to \c Null<Real>(), its value is taken
+                             from the term structure's accuracy.
+        */
+        explicit NewtonBootstrap(Real accuracy = Null<Real>());
+        void setup(Curve* ts);
+        void calculate() const;
+        //! discards the current solution, which is otherwise used as a guess
+        void reset() { validCurve_ = initialized_ = false; }
+      private:
+        void initialize() const;
+        Array errors() const;
+        Matrix jacobian() const;
+        Real accuracy_;
+        Curve* ts_ = nullptr;
+        Size n_ = 0;
+        mutable bool initialized_ = false, validCurve_ = false;
+        mutable Size firstAliveHelper_ = 0, alive_ = 0;
+    };
+
+
+    // template definitions
+
+    template <class Curve>
+    NewtonBootstrap<Curve>::NewtonBootstrap(Real accuracy)
+    : accuracy_(accuracy) {}
+
+    template <class Curve>
+    void NewtonBootstrap<Curve>::setup(Curve* ts) {
+        ts_ = ts;
+        n_ = ts_->instruments_.size();
+        QL_REQUIRE(n_ > 0, "no bootstrap helpers given");
+        for (Size j=0; j<n_; ++j)
+            ts_->registerWithObservables(ts_->instruments_[j]);
+
+        // do not initialize yet: instruments could be invalid here
+        // but valid later when bootstrapping is actually required
+    }
+
+    template <class Curve>
+    void NewtonBootstrap<Curve>::initialize() const {
+        // ensure helpers are sorted
+        std::sort(ts_->instruments_.begin(), ts_->instruments_.end(),
+                  detail::BootstrapHelperSorter());
+        // skip expired helpers
+        Date firstDate = Traits::initialDate(ts_);
+        QL_REQUIRE(ts_->instruments_[n_-1]->pillarDate()>firstDate,
+                   "all instruments expired");
+        firstAliveHelper_ = 0;
+        while (ts_->instruments_[firstAliveHelper_]->pillarDate() <= firstDate)
+            ++firstAliveHelper_;
+        alive_ = n_-firstAliveHelper_;
+        QL_REQUIRE(alive_+1 >= Interpolator::requiredPoints,
+                   "not enough alive instruments: " << alive_ <<
+                   " provided, " << Interpolator::requiredPoints-1 <<
+                   " required");
+
+        // calculate dates and times
+        std::vector<Date>& dates = ts_->dates_;
+        std::vector<Time>& times = ts_->times_;
+        dates.resize(alive_+1);
+        times.resize(alive_+1);
+        dates[0] = firstDate;
+        times[0] = ts_->timeFromReference(dates[0]);
+
+        Date maxDate = firstDate;
+        for (Size i=1, j=firstAliveHelper_; j<n_; ++i, ++j) {
+            const ext::shared_ptr<typename Traits::helper>& helper =
+                                                        ts_->instruments_[j];
+            dates[i] = helper->pillarDate();
+            times[i] = ts_->timeFromReference(dates[i]);
+            // check for duplicated pillars
+            QL_REQUIRE(dates[i-1]!=dates[i],
+                       "more than one instrument with pillar " << dates[i]);
+            maxDate = std::max(maxDate, helper->latestRelevantDate());
+        }
+        ts_->maxDate_ = maxDate;
+
+        // set initial guess only if the current curve cannot be used as guess
+        if (!validCurve_ || ts_->data_.size()!=alive_+1) {
+            ts_->data_ = std::vector<Real>(alive_+1, Traits::initialValue(ts_));
+            validCurve_ = false;
+        }
+        initialized_ = true;
+    }
+
+    template <class Curve>
+    Array NewtonBootstrap<Curve>::errors() const {
+        Array result(alive_);
+        for (Size j=0; j<alive_; ++j)
+            result[j] = ts_->instruments_[firstAliveHelper_+j]->quoteError();
+        return result;
+    }
+
+    template <class Curve>
+    Matrix NewtonBootstrap<Curve>::jacobian() const {
+        // analytic gradients of the implied quotes with respect to
+        // the discount factors at the dates they depend on
+        std::vector<std::vector<Date> > dates(alive_);
+        std::vector<std::vector<Real> > gradients(alive_);
+        std::vector<Size> numericalRows;
+        std::map<Date, Size> dateIndex;
+        for (Size j=0; j<alive_; ++j) {
+            if (ts_->instruments_[firstAliveHelper_+j]->impliedQuoteGradient(
+                    dates[j], gradients[j])) {
+                for (const auto& d : dates[j])
+                    dateIndex.emplace(d, 0);
+            } else {
+                dates[j].clear();
+                gradients[j].clear();
+                numericalRows.push_back(j);
+            }
+        }
+        Size k = 0;
+        for (auto& d : dateIndex)
+            d.second = k++;
+
+        // sensitivities of the discount factors (and of the implied
+        // quotes without analytic gradient) to the curve data; only
+        // the interpolation is evaluated for the former
+        std::vector<Real>& data = ts_->data_;
+        Matrix discountSensitivities(dateIndex.size(), alive_);
+        Matrix result(alive_, alive_, 0.0);
+        std::vector<Real> up(std::max(dateIndex.size(), numericalRows.size()));
+        for (Size i=1; i<=alive_; ++i) {
+            const Real x = data[i];
+            const Real h = 1e-6 * std::max(std::fabs(x), Real(1.0));
+
+            Traits::updateGuess(data, x+h, i);
+            ts_->interpolation_.update();
+            for (const auto& d : dateIndex)
+                up[d.second] = ts_->discount(d.first, true);
+            for (Size l=0; l<numericalRows.size(); ++l)
+                result[numericalRows[l]][i-1] =
+                    ts_->instruments_[firstAliveHelper_+numericalRows[l]]
+                        ->impliedQuote();
+
+            Traits::updateGuess(data, x-h, i);
+            ts_->interpolation_.update();
+            for (const auto& d : dateIndex)
+                discountSensitivities[d.second][i-1] =
+                    (up[d.second] - ts_->discount(d.first, true)) / (2.0*h);
+            for (Size l=0; l<numericalRows.size(); ++l) {
+                Real& r = result[numericalRows[l]][i-1];
+                r = (r - ts_->instruments_[firstAliveHelper_+numericalRows[l]]
+                             ->impliedQuote()) / (2.0*h);
+            }
+
+            Traits::updateGuess(data, x, i);
+        }
+        ts_->interpolation_.update();
+
+        // chain rule for the helpers with analytic gradient
+        for (Size j=0; j<alive_; ++j) {
+            for (Size l=0; l<dates[j].size(); ++l) {
+                const Size row = dateIndex[dates[j][l]];
+                const Real g = gradients[j][l];
+                for (Size i=0; i<alive_; ++i)
+                    result[j][i] += g * discountSensitivities[row][i];
+            }
+        }
+        return result;
+    }
+
+    template <class Curve>
+    void NewtonBootstrap<Curve>::calculate() const {
+
+        // we might have to call initialize even if the curve is initialized
+        // and not moving, just because helpers might be date relative and change
+        // with evaluation date change.
+        // anyway it makes little sense to use date relative helpers with a
+        // non-moving curve if the evaluation date changes
+        if (!initialized_ || ts_->moving_)
+            initialize();
+
+        // setup helpers
+        for (Size j=firstAliveHelper_; j<n_; ++j) {
+            const ext::shared_ptr<typename Traits::helper>& helper =
+                                                        ts_->instruments_[j];
+            // check for valid quote
+            QL_REQUIRE(helper->quote()->isValid(),
+                       io::ordinal(j + 1) << " instrument (maturity: " <<
+                       helper->maturityDate() << ", pillar: " <<
+                       helper->pillarDate() << ") has an invalid quote");
+            // don't try this at home!
+            // This call creates helpers, and removes "const".
+            // There is a significant interaction with observability.
+            helper->setTermStructure(const_cast<Curve*>(ts_));
+        }
+
+        std::vector<Real>& data = ts_->data_;
+        const Real accuracy = accuracy_ != Null<Real>() ? accuracy_ : ts_->accuracy_;
+
+        if (!validCurve_) {
+            // pillar-by-pillar guess, extending the interpolation
+            // a point at a time as the guesses might need it
+            const std::vector<Time>& times = ts_->times_;
+            for (Size i=1; i<=alive_; ++i) {
+                try {
+                    ts_->interpolation_ = ts_->interpolator_.interpolate(
+                        times.begin(), times.begin()+i+1, data.begin());
+                } catch (...) {
+                    ts_->interpolation_ = Linear().interpolate(
+                        times.begin(), times.begin()+i+1, data.begin());
+                }
+                ts_->interpolation_.update();
+                Traits::updateGuess(data, Traits::guess(i, ts_, false, 0), i);
+            }
+            ts_->interpolation_ = ts_->interpolator_.interpolate(
+                times.begin(), times.end(), data.begin());
+        }
+        ts_->interpolation_.update();
+
+        const auto maxNorm = [](const Array& a) {
+            Real result = 0.0;
+            for (Real x : a)
+                result = std::max(result, std::fabs(x));
+            return result;
+        };
+
+        Array error = errors();
+        Real errorNorm = maxNorm(error);
+
+        const Size maxIterations = Traits::maxIterations();
+        for (Size iteration=0; errorNorm > accuracy; ++iteration) {
+            QL_REQUIRE(iteration < maxIterations,
+                       "Newton bootstrap: convergence not reached after "
+                       << iteration << " iterations; largest quote error "
+                       << errorNorm << ", required accuracy " << accuracy);
+
+            // the quote errors are quote - impliedQuote
+            const Array step = qrSolve(jacobian(), error);
+            const std::vector<Real> previousData = data;
+
+            // the quote errors might not decrease any more because
+            // of round-off, but the curve data have converged
+            if (maxNorm(step) <= accuracy) {
+                for (Size i=1; i<=alive_; ++i)
+                    Traits::updateGuess(data, previousData[i] + step[i-1], i);
+                ts_->interpolation_.update();
+                break;
+            }
+
+            // damp the step until the quote errors decrease
+            Real lambda = 1.0;
+            Array trialError;
+            Real trialNorm = QL_MAX_REAL;
+            for (Size attempt=0; ; ++attempt) {
+                for (Size i=1; i<=alive_; ++i)
+                    Traits::updateGuess(data, previousData[i] + lambda*step[i-1], i);
+                ts_->interpolation_.update();
+
+                try {
+                    trialError = errors();
+                    trialNorm = maxNorm(trialError);
+                } catch (std::exception&) {
+                    trialNorm = QL_MAX_REAL;
+                }
+                if (trialNorm < errorNorm || attempt == 20)
+                    break;
+                lambda /= 2.0;
+            }
+            QL_REQUIRE(trialNorm < errorNorm,
+                       "Newton bootstrap: " << io::ordinal(iteration + 1)
+                       << " iteration failed to reduce the largest quote "
+                       "error " << errorNorm);
+
+            error = trialError;
+            errorNorm = trialNorm;
+        }
+        validCurve_ = true;
+    }
+
+}
+
+#endif
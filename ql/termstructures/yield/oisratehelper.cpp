@@ -21,6 +21,8 @@
 #include <ql/instruments/makeois.hpp>
 #include <ql/instruments/simplifynotificationgraph.hpp>
 #include <ql/cashflows/couponpricer.hpp>
+#include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/cashflows/overnightindexedcouponpricer.hpp>
 #include <ql/pricingengines/swap/discountingswapengine.hpp>
 #include <ql/termstructures/yield/oisratehelper.hpp>
 #include <ql/utilities/null_deleter.hpp>
@@ -28,6 +30,90 @@
 
 namespace QuantLib {
 
+    namespace {
+
+        // The fair rate of the swap is F/A, where F is the NPV of the
+        // overnight leg and A is the fixed-leg annuity, both
+        // undiscounted from the NPV date.  The overnight coupons
+        // depend on the forwarding curve through their compound
+        // factors.
+        bool fairRateGradient(const OvernightIndexedSwap& swap,
+                              const YieldTermStructure& forwardingCurve,
+                              const YieldTermStructure& discountCurve,
+                              bool exogenousDiscount,
+                              std::vector<Date>& dates,
+                              std::vector<Real>& gradient) {
+            dates.clear();
+            gradient.clear();
+            const Date refDate = discountCurve.referenceDate();
+
+            Real annuity = 0.0;
+            std::vector<Date> annuityDates;
+            std::vector<Real> annuityGradient;
+            for (const auto& cf : swap.fixedLeg()) {
+                if (cf->hasOccurred(refDate))
+                    continue;
+                auto coupon = ext::dynamic_pointer_cast<FixedRateCoupon>(cf);
+                if (coupon == nullptr)
+                    return false;
+                Real weight = coupon->nominal() * coupon->accrualPeriod();
+                annuity += weight * discountCurve.discount(coupon->date());
+                annuityDates.push_back(coupon->date());
+                annuityGradient.push_back(weight);
+            }
+            QL_REQUIRE(annuity != 0.0, "null fixed-leg annuity");
+
+            std::vector<std::pair<Date, Real> > forwardGradient;
+            Real floating = 0.0;
+            for (const auto& cf : swap.overnightLeg()) {
+                if (cf->hasOccurred(refDate))
+                    continue;
+                auto coupon = ext::dynamic_pointer_cast<OvernightIndexedCoupon>(cf);
+                if (coupon == nullptr)
+                    return false;
+                auto pricer = ext::dynamic_pointer_cast<
+                    CompoundingOvernightIndexedCouponPricer>(coupon->pricer());
+                if (pricer == nullptr)
+                    return false;
+
+                const Real amount = coupon->amount();
+                const DiscountFactor discount =
+                    discountCurve.discount(coupon->date());
+                if (coupon->gearing() != 0.0) {
+                    // amount = N*(gearing*(C-1) + spread*T), C being
+                    // the compound factor
+                    const Real compoundFactor =
+                        1.0 + (coupon->rate() - coupon->spread()) *
+                        coupon->accrualPeriod() / coupon->gearing();
+                    pricer->initialize(*coupon);
+                    pricer->addCompoundFactorGradient(
+                        forwardingCurve, compoundFactor,
+                        coupon->nominal() * coupon->gearing() * discount / annuity,
+                        forwardGradient);
+                }
+                floating += amount * discount;
+                if (!exogenousDiscount) {
+                    dates.push_back(coupon->date());
+                    gradient.push_back(amount / annuity);
+                }
+            }
+            for (const auto& g : forwardGradient) {
+                dates.push_back(g.first);
+                gradient.push_back(g.second);
+            }
+
+            if (!exogenousDiscount) {
+                Real rate = floating / annuity;
+                for (Size i=0; i<annuityDates.size(); ++i) {
+                    dates.push_back(annuityDates[i]);
+                    gradient.push_back(-rate * annuityGradient[i] / annuity);
+                }
+            }
+            return true;
+        }
+
+    }
+
     OISRateHelper::OISRateHelper(Natural settlementDays,
                                  const Period& tenor, // swap maturity
                                  const Handle<Quote>& fixedRate,
@@ -162,6 +248,14 @@ namespace QuantLib {
         return swap_->fairRate();
     }
 
+    bool OISRateHelper::impliedQuoteGradient(std::vector<Date>& dates,
+                                             std::vector<Real>& gradient) const {
+        QL_REQUIRE(termStructure_ != nullptr, "term structure not set");
+        return fairRateGradient(*swap_, *termStructure_,
+                                **discountRelinkableHandle_,
+                                !discountHandle_.empty(), dates, gradient);
+    }
+
     void OISRateHelper::accept(AcyclicVisitor& v) {
         auto* v1 = dynamic_cast<Visitor<OISRateHelper>*>(&v);
         if (v1 != nullptr)
@@ -281,6 +375,14 @@ namespace QuantLib {
         return swap_->fairRate();
     }
 
+    bool DatedOISRateHelper::impliedQuoteGradient(std::vector<Date>& dates,
+                                                  std::vector<Real>& gradient) const {
+        QL_REQUIRE(termStructure_ != nullptr, "term structure not set");
+        return fairRateGradient(*swap_, *termStructure_,
+                                **discountRelinkableHandle_,
+                                !discountHandle_.empty(), dates, gradient);
+    }
+
     void DatedOISRateHelper::accept(AcyclicVisitor& v) {
         auto* v1 = dynamic_cast<Visitor<DatedOISRateHelper>*>(&v);
         if (v1 != nullptr)
@@ -62,6 +62,8 @@ namespace QuantLib {
         //! \name RateHelper interface
         //@{
         Real impliedQuote() const override;
+        bool impliedQuoteGradient(std::vector<Date>& dates,
+                                  std::vector<Real>& gradient) const override;
         void setTermStructure(YieldTermStructure*) override;
         //@}
         //! \name inspectors
@@ -153,6 +155,8 @@ namespace QuantLib {
         //! \name RateHelper interface
         //@{
         Real impliedQuote() const override;
+        bool impliedQuoteGradient(std::vector<Date>& dates,
+                                  std::vector<Real>& gradient) const override;
         void setTermStructure(YieldTermStructure*) override;
         //@}
         //! \name Visitability
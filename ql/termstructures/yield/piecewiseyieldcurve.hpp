@@ -35,6 +35,7 @@
 namespace QuantLib {
 
     class MultiCurveSensitivities;
+    template <class> class PillarSensitivities;
 
     //! Piecewise yield term structure
     /*! This term structure is bootstrapped on a number of interest
@@ -165,6 +166,17 @@ namespace QuantLib {
         const std::vector<Real>& data() const;
         std::vector<std::pair<Date, Real> > nodes() const;
         //@}
+        //! \name Inspectors
+        //@{
+        const bootstrap_type& bootstrap() const { return bootstrap_; }
+        //@}
+        //! \name Calculations
+        //@{
+        /*! discards the current solution, so that the next bootstrap
+            does not depend on the previous ones
+        */
+        void reset();
+        //@}
         //! \name Observer interface
         //@{
         void update() override;
@@ -185,6 +197,7 @@ namespace QuantLib {
         // it would increase the complexity---which is high enough
         // already.
         friend class MultiCurveSensitivities;
+        friend class PillarSensitivities<this_curve>;
         friend class Bootstrap<this_curve>;
         friend class BootstrapError<this_curve> ;
         friend class PenaltyFunction<this_curve>;
@@ -239,6 +252,12 @@ namespace QuantLib {
 
     }
 
+    template <class C, class I, template <class> class B>
+    inline void PiecewiseYieldCurve<C,I,B>::reset() {
+        bootstrap_.reset();
+        update();
+    }
+
     template <class C, class I, template <class> class B>
     inline
     DiscountFactor PiecewiseYieldCurve<C,I,B>::discountImpl(Time t) const {
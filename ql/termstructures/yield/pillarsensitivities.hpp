@@ -0,0 +1,318 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file pillarsensitivities.hpp
+    \brief adjoint sensitivities to the quotes of a bootstrapped curve
+*/
+
+#ifndef quantlib_pillar_sensitivities_hpp
+#define quantlib_pillar_sensitivities_hpp
+
+#include <ql/math/matrix.hpp>
+#include <ql/patterns/lazyobject.hpp>
+#include <ql/termstructures/yield/piecewiseyieldcurve.hpp>
+#include <algorithm>
+#include <map>
+#include <utility>
+
+namespace QuantLib {
+
+    //! sensitivities of prices to the quotes of a bootstrapped curve
+    /*! Given the gradient of a price with respect to the discount
+        factors of a piecewise yield curve, e.g., as returned by
+        CashFlows::npvGradient for each leg of an instrument priced
+        by DiscountingSwapEngine or DiscountingBondEngine, this class
+        returns its derivatives with respect to the quotes of the
+        helpers the curve was bootstrapped on.
+
+        By the implicit-function theorem, the sensitivities of the
+        curve data to the quotes are the inverse of the Jacobian \f$ J
+        \f$ of the implied quotes with respect to the curve data; the
+        quote sensitivities of a price with gradient \f$ g \f$ with
+        respect to the curve data are therefore \f$ J^{-T} g \f$.  The
+        Jacobian is built and inverted once for each curve state,
+        using the analytic gradients returned by
+        BootstrapHelper::impliedQuoteGradient where available; no
+        bootstrap is run.
+
+        The sensitivities of the discount factors to the curve data
+        are obtained by bumping the data of a private copy of the
+        curve, which is never seen by other objects, and are cached
+        for each date.  Once the dates of a price are cached, its
+        quote sensitivities only cost a matrix-vector product.
+
+        \warning The curve must have one pillar for each alive helper,
+                 as with the iterative, local and Newton bootstraps.
+    */
+    template <class Curve>
+    class PillarSensitivities : public LazyObject {
+        typedef typename Curve::traits_type Traits;
+        typedef typename Curve::base_curve base_curve;
+      public:
+        typedef ext::shared_ptr<typename Traits::helper> helper_ptr;
+
+        explicit PillarSensitivities(ext::shared_ptr<Curve> curve);
+
+        //! alive helpers, in the order of the sensitivities
+        const std::vector<helper_ptr>& helpers() const;
+        //! derivatives of a price with respect to the helper quotes
+        /*! \param gradient derivatives of the price with respect to
+                            the discount factors at the given dates
+        */
+        std::vector<Real> sensitivities(
+                    const std::vector<std::pair<Date, Real> >& gradient) const;
+
+      private:
+        // copy of the curve, without jumps, whose data can be bumped
+        class BumpableCurve : public base_curve {
+          public:
+            BumpableCurve(const Date& referenceDate,
+                          const DayCounter& dayCounter,
+                          const typename Curve::interpolator_type& interpolator,
+                          std::vector<Date> dates,
+                          std::vector<Time> times,
+                          std::vector<Real> data,
+                          const Date& maxDate)
+            : base_curve(referenceDate, dayCounter, {}, {}, interpolator) {
+                this->dates_ = std::move(dates);
+                this->times_ = std::move(times);
+                this->data_ = std::move(data);
+                this->maxDate_ = maxDate;
+                this->setupInterpolation();
+                this->interpolation_.update();
+            }
+            Size pillars() const { return this->data_.size() - 1; }
+            Real value(Size i) const { return this->data_[i]; }
+            void setValue(Size i, Real x) {
+                Traits::updateGuess(this->data_, x, i);
+                this->interpolation_.update();
+            }
+        };
+
+        // restores the value of a bumped pillar on exit
+        class BumpGuard {
+          public:
+            BumpGuard(BumpableCurve& curve, Size i)
+            : curve_(curve), i_(i), value_(curve.value(i)) {}
+            ~BumpGuard() { curve_.setValue(i_, value_); }
+            BumpGuard(const BumpGuard&) = delete;
+            BumpGuard& operator=(const BumpGuard&) = delete;
+          private:
+            BumpableCurve& curve_;
+            Size i_;
+            Real value_;
+        };
+
+        void performCalculations() const override;
+        //! derivatives of the discounts at the dates wrt the curve data
+        Matrix discountSensitivities(const std::vector<Date>& dates,
+                                     const std::vector<helper_ptr>&
+                                                  numericalHelpers = {},
+                                     Matrix* numericalRows = nullptr) const;
+        ext::shared_ptr<Curve> curve_;
+        mutable std::vector<helper_ptr> helpers_;
+        mutable Matrix inverseJacobian_;
+        mutable ext::shared_ptr<BumpableCurve> bumpableCurve_;
+        mutable std::map<Date, std::vector<Real> > cachedSensitivities_;
+    };
+
+
+    // template definitions
+
+    template <class Curve>
+    PillarSensitivities<Curve>::PillarSensitivities(ext::shared_ptr<Curve> curve)
+    : curve_(std::move(curve)) {
+        QL_REQUIRE(curve_ != nullptr, "null curve given");
+        registerWith(curve_);
+    }
+
+    template <class Curve>
+    const std::vector<typename PillarSensitivities<Curve>::helper_ptr>&
+    PillarSensitivities<Curve>::helpers() const {
+        calculate();
+        return helpers_;
+    }
+
+    template <class Curve>
+    std::vector<Real> PillarSensitivities<Curve>::sensitivities(
+                   const std::vector<std::pair<Date, Real> >& gradient) const {
+        calculate();
+
+        // discount sensitivities at the dates not seen yet
+        std::vector<Date> newDates;
+        for (const auto& g : gradient) {
+            if (cachedSensitivities_.count(g.first) == 0)
+                newDates.push_back(g.first);
+        }
+        std::sort(newDates.begin(), newDates.end());
+        newDates.erase(std::unique(newDates.begin(), newDates.end()),
+                       newDates.end());
+        const Size n = helpers_.size();
+        if (!newDates.empty()) {
+            const Matrix s = discountSensitivities(newDates);
+            for (Size k=0; k<newDates.size(); ++k)
+                cachedSensitivities_[newDates[k]] =
+                    std::vector<Real>(s.row_begin(k), s.row_end(k));
+        }
+
+        // sensitivities to the curve data...
+        Array dataGradient(n, 0.0);
+        for (const auto& g : gradient) {
+            const std::vector<Real>& s = cachedSensitivities_[g.first];
+            for (Size i=0; i<n; ++i)
+                dataGradient[i] += g.second * s[i];
+        }
+
+        // ...and to the quotes
+        std::vector<Real> result(n, 0.0);
+        for (Size j=0; j<n; ++j)
+            for (Size i=0; i<n; ++i)
+                result[j] += inverseJacobian_[i][j] * dataGradient[i];
+        return result;
+    }
+
+    template <class Curve>
+    Matrix PillarSensitivities<Curve>::discountSensitivities(
+                              const std::vector<Date>& dates,
+                              const std::vector<helper_ptr>& numericalHelpers,
+                              Matrix* numericalRows) const {
+        BumpableCurve& curve = *bumpableCurve_;
+        const Size n = curve.pillars();
+
+        Matrix result(dates.size(), n);
+        if (numericalRows != nullptr)
+            *numericalRows = Matrix(numericalHelpers.size(), n);
+        std::vector<Real> up(std::max(dates.size(), numericalHelpers.size()));
+        for (Size i=1; i<=n; ++i) {
+            BumpGuard guard(curve, i);
+            const Real x = curve.value(i);
+            const Real h = 1e-6 * std::max(std::fabs(x), Real(1.0));
+
+            curve.setValue(i, x+h);
+            for (Size k=0; k<dates.size(); ++k)
+                result[k][i-1] = curve.discount(dates[k], true);
+            for (Size l=0; l<numericalHelpers.size(); ++l)
+                (*numericalRows)[l][i-1] = numericalHelpers[l]->impliedQuote();
+
+            curve.setValue(i, x-h);
+            for (Size k=0; k<dates.size(); ++k) {
+                Real& r = result[k][i-1];
+                r = (r - curve.discount(dates[k], true)) / (2.0*h);
+            }
+            for (Size l=0; l<numericalHelpers.size(); ++l) {
+                Real& r = (*numericalRows)[l][i-1];
+                r = (r - numericalHelpers[l]->impliedQuote()) / (2.0*h);
+            }
+        }
+
+        // jumps multiply the discounts by factors independent of the data
+        if (!curve_->jumpDates().empty()) {
+            for (Size k=0; k<dates.size(); ++k) {
+                const Real jumps = curve_->discount(dates[k], true) /
+                                   curve.discount(dates[k], true);
+                std::transform(result.row_begin(k), result.row_end(k),
+                               result.row_begin(k),
+                               [jumps](Real x) { return x * jumps; });
+            }
+        }
+        return result;
+    }
+
+    template <class Curve>
+    void PillarSensitivities<Curve>::performCalculations() const {
+        // bootstrap the curve if needed; the helpers are sorted and
+        // linked to it afterwards
+        const Size n = curve_->data().size() - 1;
+        const std::vector<helper_ptr>& instruments = curve_->instruments_;
+        QL_REQUIRE(n <= instruments.size(),
+                   "the curve has more pillars than helpers");
+        helpers_.assign(instruments.end() - n, instruments.end());
+
+        bumpableCurve_ = ext::make_shared<BumpableCurve>(
+            curve_->referenceDate(), curve_->dayCounter(),
+            curve_->interpolator_,
+            curve_->dates_, curve_->times_, curve_->data_, curve_->maxDate_);
+        cachedSensitivities_.clear();
+
+        // analytic gradients of the implied quotes with respect to
+        // the discount factors at the dates they depend on
+        std::vector<std::vector<Date> > dates(n);
+        std::vector<std::vector<Real> > gradients(n);
+        std::vector<Size> numericalIndices;
+        std::vector<helper_ptr> numericalHelpers;
+        std::map<Date, Size> dateIndex;
+        for (Size j=0; j<n; ++j) {
+            if (helpers_[j]->impliedQuoteGradient(dates[j], gradients[j])) {
+                for (const auto& d : dates[j])
+                    dateIndex.emplace(d, 0);
+            } else {
+                dates[j].clear();
+                gradients[j].clear();
+                numericalIndices.push_back(j);
+                numericalHelpers.push_back(helpers_[j]);
+            }
+        }
+        std::vector<Date> allDates;
+        allDates.reserve(dateIndex.size());
+        for (auto& d : dateIndex) {
+            d.second = allDates.size();
+            allDates.push_back(d.first);
+        }
+
+        // the helpers without analytic gradient are repriced on the
+        // bumped copy, and linked back to the curve afterwards
+        QL_REQUIRE(numericalHelpers.empty() || curve_->jumpDates().empty(),
+                   "helpers without analytic gradient are not supported "
+                   "on curves with jumps");
+        struct RelinkGuard {
+            const std::vector<helper_ptr>& helpers;
+            Curve* curve;
+            ~RelinkGuard() {
+                for (const auto& h : helpers)
+                    h->setTermStructure(curve);
+            }
+        } relink = { numericalHelpers, curve_.get() };
+        for (const auto& h : numericalHelpers)
+            h->setTermStructure(bumpableCurve_.get());
+
+        Matrix numericalRows;
+        const Matrix s =
+            discountSensitivities(allDates, numericalHelpers, &numericalRows);
+        for (Size k=0; k<allDates.size(); ++k)
+            cachedSensitivities_[allDates[k]] =
+                std::vector<Real>(s.row_begin(k), s.row_end(k));
+
+        // Jacobian of the implied quotes with respect to the curve data
+        Matrix jacobian(n, n, 0.0);
+        for (Size j=0; j<n; ++j) {
+            for (Size l=0; l<dates[j].size(); ++l) {
+                const Size row = dateIndex[dates[j][l]];
+                const Real g = gradients[j][l];
+                for (Size i=0; i<n; ++i)
+                    jacobian[j][i] += g * s[row][i];
+            }
+        }
+        for (Size l=0; l<numericalIndices.size(); ++l)
+            std::copy(numericalRows.row_begin(l), numericalRows.row_end(l),
+                      jacobian.row_begin(numericalIndices[l]));
+
+        inverseJacobian_ = inverse(jacobian);
+    }
+
+}
+
+#endif
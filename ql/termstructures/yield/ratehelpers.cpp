@@ -23,6 +23,7 @@
  FOR A PARTICULAR PURPOSE.  See the license for more details.
 */
 
+#include <ql/cashflows/fixedratecoupon.hpp>
 #include <ql/cashflows/iborcoupon.hpp>
 #include <ql/currency.hpp>
 #include <ql/indexes/swapindex.hpp>
@@ -64,6 +65,38 @@ namespace QuantLib {
                                            earliestDate, maturityDate);
         }
 
+        // adds the gradient of weight*(P(d1)/P(d2)-1)/t with respect
+        // to the discount factors P(d1) and P(d2)
+        void AddForwardGradient(const YieldTermStructure& ts,
+                                const Date& d1,
+                                const Date& d2,
+                                Time t,
+                                Real weight,
+                                std::vector<Date>& dates,
+                                std::vector<Real>& gradient) {
+            DiscountFactor disc1 = ts.discount(d1);
+            DiscountFactor disc2 = ts.discount(d2);
+            dates.push_back(d1);
+            gradient.push_back(weight / (t * disc2));
+            dates.push_back(d2);
+            gradient.push_back(-weight * disc1 / (t * disc2 * disc2));
+        }
+
+        bool AddIborFixingGradient(const YieldTermStructure& ts,
+                                   const IborIndex& index,
+                                   const Date& fixingDate,
+                                   std::vector<Date>& dates,
+                                   std::vector<Real>& gradient) {
+            // past fixings are not forecast
+            if (fixingDate < Settings::instance().evaluationDate())
+                return false;
+            Date d1 = index.valueDate(fixingDate);
+            Date d2 = index.maturityDate(d1);
+            Time t = index.dayCounter().yearFraction(d1, d2);
+            AddForwardGradient(ts, d1, d2, t, 1.0, dates, gradient);
+            return true;
+        }
+
     } // namespace
 
     FuturesRateHelper::FuturesRateHelper(const Handle<Quote>& price,
@@ -192,6 +225,16 @@ namespace QuantLib {
         return 100.0 * (1.0 - futureRate);
     }
 
+    bool FuturesRateHelper::impliedQuoteGradient(std::vector<Date>& dates,
+                                                 std::vector<Real>& gradient) const {
+        QL_REQUIRE(termStructure_ != nullptr, "term structure not set");
+        dates.clear();
+        gradient.clear();
+        AddForwardGradient(*termStructure_, earliestDate_, maturityDate_,
+                           yearFraction_, -100.0, dates, gradient);
+        return true;
+    }
+
     Real FuturesRateHelper::convexityAdjustment() const {
         return convAdj_.empty() ? 0.0 : convAdj_->value();
     }
@@ -247,6 +290,15 @@ namespace QuantLib {
         return iborIndex_->fixing(fixingDate_, true);
     }
 
+    bool DepositRateHelper::impliedQuoteGradient(std::vector<Date>& dates,
+                                                 std::vector<Real>& gradient) const {
+        QL_REQUIRE(termStructure_ != nullptr, "term structure not set");
+        dates.clear();
+        gradient.clear();
+        return AddIborFixingGradient(*termStructure_, *iborIndex_, fixingDate_,
+                                     dates, gradient);
+    }
+
     void DepositRateHelper::setTermStructure(YieldTermStructure* t) {
         // do not set the relinkable handle as an observer -
         // force recalculation when needed---the index is not lazy
@@ -432,6 +484,20 @@ namespace QuantLib {
                    spanningTime_;
     }
 
+    bool FraRateHelper::impliedQuoteGradient(std::vector<Date>& dates,
+                                             std::vector<Real>& gradient) const {
+        QL_REQUIRE(termStructure_ != nullptr, "term structure not set");
+        dates.clear();
+        gradient.clear();
+        if (useIndexedCoupon_)
+            return AddIborFixingGradient(*termStructure_, *iborIndex_, fixingDate_,
+                                         dates, gradient);
+
+        AddForwardGradient(*termStructure_, earliestDate_, maturityDate_,
+                           spanningTime_, 1.0, dates, gradient);
+        return true;
+    }
+
     void FraRateHelper::setTermStructure(YieldTermStructure* t) {
         // do not set the relinkable handle as an observer -
         // force recalculation when needed---the index is not lazy
@@ -687,6 +753,77 @@ namespace QuantLib {
         return result;
     }
 
+    bool SwapRateHelper::impliedQuoteGradient(std::vector<Date>& dates,
+                                              std::vector<Real>& gradient) const {
+        QL_REQUIRE(termStructure_ != nullptr, "term structure not set");
+        dates.clear();
+        gradient.clear();
+
+        // The implied quote is (F + s*B)/A, where F and B are the
+        // floating-leg NPV and BPS and A is the fixed-leg BPS, all
+        // undiscounted from the NPV date and taken in absolute value.
+        const YieldTermStructure& discountCurve = **discountRelinkableHandle_;
+        const bool exogenousDiscount = !discountHandle_.empty();
+        const Date refDate = discountCurve.referenceDate();
+
+        Real annuity = 0.0;
+        std::vector<Date> annuityDates;
+        std::vector<Real> annuityGradient;
+        for (const auto& cf : swap_->fixedLeg()) {
+            if (cf->hasOccurred(refDate))
+                continue;
+            auto coupon = ext::dynamic_pointer_cast<FixedRateCoupon>(cf);
+            if (coupon == nullptr)
+                return false;
+            Real weight = coupon->nominal() * coupon->accrualPeriod();
+            annuity += weight * discountCurve.discount(coupon->date());
+            annuityDates.push_back(coupon->date());
+            annuityGradient.push_back(weight);
+        }
+        QL_REQUIRE(annuity != 0.0, "null fixed-leg annuity");
+
+        Spread spread = spread_.empty() ? 0.0 : spread_->value();
+        Real floating = 0.0;
+        for (const auto& cf : swap_->floatingLeg()) {
+            if (cf->hasOccurred(refDate))
+                continue;
+            auto coupon = ext::dynamic_pointer_cast<IborCoupon>(cf);
+            if (coupon == nullptr || coupon->isInArrears())
+                return false;
+            Real weight = coupon->nominal() * coupon->accrualPeriod();
+            DiscountFactor discount = discountCurve.discount(coupon->date());
+            Rate fixing;
+            if (coupon->hasFixed()) {
+                fixing = coupon->indexFixing();
+            } else {
+                const Date& d1 = coupon->fixingValueDate();
+                const Date& d2 = coupon->fixingEndDate();
+                Time t = coupon->spanningTime();
+                fixing = (termStructure_->discount(d1) /
+                          termStructure_->discount(d2) - 1.0) / t;
+                AddForwardGradient(*termStructure_, d1, d2, t,
+                                   weight * coupon->gearing() * discount / annuity,
+                                   dates, gradient);
+            }
+            Real amount =
+                weight * (coupon->gearing() * fixing + coupon->spread() + spread);
+            floating += amount * discount;
+            if (!exogenousDiscount) {
+                dates.push_back(coupon->date());
+                gradient.push_back(amount / annuity);
+            }
+        }
+
+        if (!exogenousDiscount) {
+            Real rate = floating / annuity;
+            for (Size i=0; i<annuityDates.size(); ++i) {
+                dates.push_back(annuityDates[i]);
+                gradient.push_back(-rate * annuityGradient[i] / annuity);
+            }
+        }
+        return true;
+    }
+
     void SwapRateHelper::accept(AcyclicVisitor& v) {
         auto* v1 = dynamic_cast<Visitor<SwapRateHelper>*>(&v);
         if (v1 != nullptr)
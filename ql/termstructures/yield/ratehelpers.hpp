@@ -93,6 +93,8 @@ namespace QuantLib {
         //! \name RateHelper interface
         //@{
         Real impliedQuote() const override;
+        bool impliedQuoteGradient(std::vector<Date>& dates,
+                                  std::vector<Real>& gradient) const override;
         //@}
         //! \name FuturesRateHelper inspectors
         //@{
@@ -132,6 +134,8 @@ namespace QuantLib {
         //! \name RateHelper interface
         //@{
         Real impliedQuote() const override;
+        bool impliedQuoteGradient(std::vector<Date>& dates,
+                                  std::vector<Real>& gradient) const override;
         void setTermStructure(YieldTermStructure*) override;
         //@}
         //! \name Visitability
@@ -234,6 +238,8 @@ namespace QuantLib {
         //! \name RateHelper interface
         //@{
         Real impliedQuote() const override;
+        bool impliedQuoteGradient(std::vector<Date>& dates,
+                                  std::vector<Real>& gradient) const override;
         void setTermStructure(YieldTermStructure*) override;
         //@}
         //! \name Visitability
@@ -316,6 +322,8 @@ namespace QuantLib {
         //! \name RateHelper interface
         //@{
         Real impliedQuote() const override;
+        bool impliedQuoteGradient(std::vector<Date>& dates,
+                                  std::vector<Real>& gradient) const override;
         void setTermStructure(YieldTermStructure*) override;
         //@}
         //! \name SwapRateHelper inspectors
@@ -96,6 +96,14 @@
 #    define QL_FASTER_LAZY_OBJECTS
 #endif
 
+/* Define this if you want observers and observables to be stored in
+   vectors instead of sets.  This reduces the allocations needed for
+   building large portfolios and speeds up notifications.  It has no
+   effect on the thread-safe observer pattern. */
+#ifndef QL_FLAT_OBSERVER_STORAGE
+//#    define QL_FLAT_OBSERVER_STORAGE
+#endif
+
 /* Define this to use std::any instead of boost::any. */
 #ifndef QL_USE_STD_ANY
 //#    define QL_USE_STD_ANY
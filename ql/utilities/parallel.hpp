@@ -0,0 +1,219 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file parallel.hpp
+    \brief helpers for running tasks on several threads
+*/
+
+#ifndef quantlib_parallel_hpp
+#define quantlib_parallel_hpp
+
+#include <ql/types.hpp>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace QuantLib {
+
+    namespace detail {
+
+        //! calls <tt>f(i)</tt> for each i in [0, tasks), one task per thread
+        /*! The first task runs on the calling thread; the function
+            returns when all tasks are done.  If any task throws, the
+            exception thrown by the task with the lowest index is
+            rethrown after all threads are joined.  If a thread cannot
+            be started, the ones already running are joined before the
+            resulting exception is propagated.
+
+            Tasks should be few and coarse-grained, since a thread is
+            started for each of them; code calling this repeatedly
+            should use a ThreadPool instead.
+        */
+        template <class F>
+        void runInParallel(Size tasks, const F& f) {
+            if (tasks == 0)
+                return;
+            if (tasks == 1) {
+                f(Size(0));
+                return;
+            }
+
+            std::vector<std::exception_ptr> errors(tasks);
+            auto run = [&](Size i) {
+                try {
+                    f(i);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            };
+
+            {
+                // joins the started threads even if starting another
+                // one throws, since destroying a joinable thread would
+                // terminate the program
+                struct JoinGuard {
+                    std::vector<std::thread>& threads;
+                    ~JoinGuard() {
+                        for (auto& thread : threads) {
+                            if (thread.joinable())
+                                thread.join();
+                        }
+                    }
+                };
+                std::vector<std::thread> workers;
+                JoinGuard guard{workers};
+                workers.reserve(tasks-1);
+                for (Size i=1; i<tasks; ++i)
+                    workers.emplace_back(run, i);
+                run(0);
+            }
+
+            for (const auto& error : errors) {
+                if (error)
+                    std::rethrow_exception(error);
+            }
+        }
+
+        //! threads started once and reused by successive batches of tasks
+        /*! run(tasks, f) has the same semantics as runInParallel(),
+            but the tasks are shared between the calling thread and
+            <tt>threads-1</tt> workers started by the constructor and
+            joined by the destructor.
+
+            Batches are run one at a time; a task must not call run()
+            on the pool that runs it.
+        */
+        class ThreadPool {
+          public:
+            explicit ThreadPool(Size threads) {
+                try {
+                    for (Size i=1; i<threads; ++i)
+                        workers_.emplace_back([this]() { work(); });
+                } catch (...) {
+                    stop();
+                    throw;
+                }
+            }
+            ~ThreadPool() { stop(); }
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            //! number of threads running the tasks, including the caller
+            Size size() const { return workers_.size() + 1; }
+
+            template <class F>
+            void run(Size tasks, const F& f) {
+                if (tasks == 0)
+                    return;
+
+                std::lock_guard<std::mutex> batch(batchMutex_);
+                const std::function<void(Size)> task =
+                    [&f](Size i) { f(i); };
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    task_ = &task;
+                    tasks_ = pending_ = tasks;
+                    next_ = 0;
+                    errors_.assign(tasks, nullptr);
+                    ++batch_;
+                }
+                wakeUp_.notify_all();
+
+                execute();
+
+                std::vector<std::exception_ptr> errors;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    done_.wait(lock, [this]() { return pending_ == 0; });
+                    task_ = nullptr;
+                    errors.swap(errors_);
+                }
+                for (const auto& error : errors) {
+                    if (error)
+                        std::rethrow_exception(error);
+                }
+            }
+
+          private:
+            // runs tasks of the current batch until none is left
+            void execute() {
+                for (;;) {
+                    Size i;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        if (task_ == nullptr || next_ == tasks_)
+                            return;
+                        i = next_++;
+                    }
+                    try {
+                        (*task_)(i);
+                    } catch (...) {
+                        errors_[i] = std::current_exception();
+                    }
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (--pending_ == 0)
+                        done_.notify_all();
+                }
+            }
+            void work() {
+                Size seen = 0;
+                for (;;) {
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        wakeUp_.wait(lock, [&]() {
+                            return stopped_ || batch_ != seen;
+                        });
+                        if (stopped_)
+                            return;
+                        seen = batch_;
+                    }
+                    execute();
+                }
+            }
+            void stop() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stopped_ = true;
+                }
+                wakeUp_.notify_all();
+                for (auto& worker : workers_)
+                    worker.join();
+            }
+
+            std::vector<std::thread> workers_;
+            std::mutex batchMutex_, mutex_;
+            std::condition_variable wakeUp_, done_;
+            const std::function<void(Size)>* task_ = nullptr;
+            Size tasks_ = 0, next_ = 0, pending_ = 0, batch_ = 0;
+            std::vector<std::exception_ptr> errors_;
+            bool stopped_ = false;
+        };
+
+        //! size of the contiguous blocks splitting n items among threads
+        inline Size parallelBlockSize(Size n, Size threads) {
+            return threads > 1 ? (n + threads - 1) / threads : n;
+        }
+
+    }
+
+}
+
+
+#endif
@@ -803,6 +803,72 @@ BOOST_AUTO_TEST_CASE(testEscrowedVsSpotAmericanOption) {
    }
 }
 
+BOOST_AUTO_TEST_CASE(testFdMultipleStrikesCaching) {
+    BOOST_TEST_MESSAGE("Testing batch pricing of American options "
+                       "with dividends on a shared grid...");
+
+    const auto dc = Actual365Fixed();
+    const auto today = Date(27, February, 2021);
+    Settings::instance().evaluationDate() = today;
+
+    const auto spot = ext::make_shared<SimpleQuote>(100.0);
+    const auto process = ext::make_shared<BlackScholesMertonProcess>(
+        Handle<Quote>(spot),
+        Handle<YieldTermStructure>(flatRate(0.04, dc)),
+        Handle<YieldTermStructure>(flatRate(0.01, dc)),
+        Handle<BlackVolTermStructure>(flatVol(0.25, dc)));
+
+    const auto dividends = DividendVector(
+        {today + Period(4, Months), today + Period(10, Months)}, {2.0, 2.0});
+
+    const std::vector<Real> strikes = {80.0, 90.0, 100.0, 110.0, 120.0};
+    const std::vector<Date> exerciseDates = {
+        today + Period(6, Months), today + Period(1, Years)};
+
+    // the grids differ, so they must be fine enough for the
+    // discretization errors to be below the tolerance
+    const auto batchEngine = ext::make_shared<FdBlackScholesVanillaEngine>(
+        process, dividends, 300, 1200, 2);
+    batchEngine->enableMultipleStrikesCaching(strikes, exerciseDates);
+
+    const auto engine = ext::make_shared<FdBlackScholesVanillaEngine>(
+        process, dividends, 300, 1200, 2);
+
+    const Real tol = 1e-4;
+    for (Real s : {100.0, 90.0}) {
+        spot->setValue(s);
+        for (const auto& exerciseDate : exerciseDates) {
+            for (Real strike : strikes) {
+                VanillaOption option(
+                    ext::make_shared<PlainVanillaPayoff>(Option::Put, strike),
+                    ext::make_shared<AmericanExercise>(today, exerciseDate));
+
+                option.setPricingEngine(batchEngine);
+                const Real batchNpv = option.NPV();
+                const Real batchDelta = option.delta();
+
+                option.setPricingEngine(engine);
+                const Real npv = option.NPV();
+                const Real delta = option.delta();
+
+                if (std::fabs(batchNpv - npv) > tol
+                    || std::fabs(batchDelta - delta) > tol) {
+                    BOOST_ERROR("failed to reproduce American put price "
+                                "with multiple strikes caching"
+                                << "\n    spot:            " << s
+                                << "\n    strike:          " << strike
+                                << "\n    exercise date:   " << exerciseDate
+                                << "\n    batch npv:       " << batchNpv
+                                << "\n    npv:             " << npv
+                                << "\n    batch delta:     " << batchDelta
+                                << "\n    delta:           " << delta
+                                << "\n    tolerance:       " << tol);
+                }
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testTodayIsDividendDate) {
     BOOST_TEST_MESSAGE("Testing escrowed vs spot dividend model on dividend dates for American options...");
 
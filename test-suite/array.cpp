@@ -20,7 +20,9 @@
 #include "toplevelfixture.hpp"
 #include "utilities.hpp"
 #include <ql/math/array.hpp>
+#include <ql/math/matrix.hpp>
 #include <ql/utilities/dataformatters.hpp>
+#include <cstdint>
 
 using namespace QuantLib;
 using namespace boost::unit_test_framework;
@@ -327,6 +329,126 @@ BOOST_AUTO_TEST_CASE(testArrayOperators) {
     QL_CHECK_CLOSE_ARRAY(real_rvalue_quotient, scalar_quotient_2);
 }
 
+BOOST_AUTO_TEST_CASE(testLazyExpressions) {
+    BOOST_TEST_MESSAGE("Testing lazy array and matrix expressions...");
+
+    const Array x = {1.1, 2.2, 3.3};
+    const Array y = {0.5, -1.5, 2.5};
+    const Array z = {4.0, 5.0, 6.0};
+
+    // evaluated lazily and eagerly, results must agree exactly
+    const Array eager = 2.0*x + y*3.0 - z/x + (-y) - 1.5;
+    const Array fused = 2.0*lazy(x) + lazy(y)*3.0 - z/lazy(x) + (-lazy(y)) - 1.5;
+    if (fused != eager)
+        BOOST_FAIL("lazy expression differs from eager evaluation:"
+                   << "\n    eager: " << eager
+                   << "\n    lazy:  " << fused);
+
+    // mixing with rvalue arrays
+    const Array mixed = lazy(x) + Array(3, 1.0);
+    const Array shifted = x + 1.0;
+    QL_CHECK_CLOSE_ARRAY(mixed, shifted);
+
+    // assignment reuses the storage and allows aliasing
+    Array w = x;
+    const Array::const_iterator storage = w.begin();
+    w = lazy(w)*0.5 + y;
+    BOOST_CHECK(storage == w.begin());
+    const Array scaled = x*0.5 + y;
+    QL_CHECK_CLOSE_ARRAY(w, scaled);
+
+    // assignment to an array of a different size
+    Array v;
+    v = lazy(x) - y;
+    BOOST_CHECK(v.size() == x.size());
+    const Array difference = x - y;
+    QL_CHECK_CLOSE_ARRAY(v, difference);
+
+    BOOST_CHECK_THROW(Array(lazy(x) + Array(2)), Error);
+
+    Matrix m(2, 3), n(2, 3);
+    for (Size i=0; i<2; ++i) {
+        for (Size j=0; j<3; ++j) {
+            m[i][j] = 1.0 + i + 0.5*j;
+            n[i][j] = 2.0 - 0.25*i*j;
+        }
+    }
+    const Matrix p = lazy(m)*n - 0.5*lazy(n) + 1.0;
+    BOOST_CHECK(p.rows() == 2 && p.columns() == 3);
+    for (Size i=0; i<2; ++i) {
+        for (Size j=0; j<3; ++j) {
+            const Real expected = m[i][j]*n[i][j] - 0.5*n[i][j] + 1.0;
+            if (p[i][j] != expected)
+                BOOST_FAIL("lazy matrix expression failed at (" << i << ", "
+                           << j << "):"
+                           << "\n    calculated: " << p[i][j]
+                           << "\n    expected:   " << expected);
+        }
+    }
+
+    BOOST_CHECK_THROW(Matrix(lazy(m) + Matrix(3, 2, 0.0)), Error);
+}
+
+BOOST_AUTO_TEST_CASE(testArrayKernels) {
+    BOOST_TEST_MESSAGE("Testing array storage alignment and kernels...");
+
+    for (Size n=1; n<70; ++n) {
+        Array a(n), b(n);
+        for (Size i=0; i<n; ++i) {
+            a[i] = std::sin(0.3*i) + 1.5;
+            b[i] = std::cos(0.7*i) + 2.5;
+        }
+
+        if (reinterpret_cast<std::uintptr_t>(a.begin()) % 64 != 0)
+            BOOST_FAIL("array storage of size " << n
+                       << " is not aligned on 64 bytes");
+
+        // the default dot product sums sequentially
+        Real dot = 0.0;
+        for (Size i=0; i<n; ++i)
+            dot += a[i]*b[i];
+        if (DotProduct(a, b) != dot)
+            BOOST_FAIL("dot product differs from sequential sum"
+                       << "\n    size:       " << n
+                       << "\n    calculated: " << DotProduct(a, b)
+                       << "\n    expected:   " << dot);
+        QL_CHECK_CLOSE(VectorizedDotProduct(a, b), dot, 1e-10);
+        QL_CHECK_CLOSE(Norm2(a), std::sqrt(DotProduct(a, a)), 1e-10);
+        QL_CHECK_CLOSE(VectorizedNorm2(a), Norm2(a), 1e-10);
+
+        // element-wise kernels must give exact results
+        Array sum = a, difference = a, product = a, quotient = a, scaled = a;
+        sum += b;
+        difference -= b;
+        product *= b;
+        quotient /= b;
+        scaled *= 0.7;
+        for (Size i=0; i<n; ++i) {
+            if (sum[i] != a[i] + b[i]
+                || difference[i] != a[i] - b[i]
+                || product[i] != a[i] * b[i]
+                || quotient[i] != a[i] / b[i]
+                || scaled[i] != a[i] * 0.7)
+                BOOST_FAIL("element-wise kernel failed"
+                           << "\n    size:  " << n
+                           << "\n    index: " << i);
+        }
+
+        // the same array on both sides
+        Array doubled = a;
+        doubled += doubled;
+        for (Size i=0; i<n; ++i)
+            if (doubled[i] != 2.0*a[i])
+                BOOST_FAIL("self-addition failed"
+                           << "\n    size:  " << n
+                           << "\n    index: " << i);
+    }
+
+    BOOST_TEST_MESSAGE("    kernels use the "
+                       << detail::arrayKernelsInstructionSet()
+                       << " instruction set");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
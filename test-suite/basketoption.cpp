@@ -912,6 +912,162 @@ BOOST_AUTO_TEST_CASE(testOddSamples) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testBatchedMonteCarlo) {
+
+    BOOST_TEST_MESSAGE("Testing batched Monte Carlo basket engine...");
+
+    DayCounter dc = Actual360();
+    Date today = Date::todaysDate();
+
+    Handle<YieldTermStructure> rTS(flatRate(today, 0.05, dc));
+    Handle<YieldTermStructure> qTS(flatRate(today, 0.02, dc));
+    Handle<BlackVolTermStructure> volTS1(flatVol(today, 0.30, dc));
+    Handle<BlackVolTermStructure> volTS2(flatVol(today, 0.20, dc));
+
+    ext::shared_ptr<GeneralizedBlackScholesProcess> p1(
+        new BlackScholesMertonProcess(
+            Handle<Quote>(ext::make_shared<SimpleQuote>(100.0)),
+            qTS, rTS, volTS1));
+    ext::shared_ptr<GeneralizedBlackScholesProcess> p2(
+        new BlackScholesMertonProcess(
+            Handle<Quote>(ext::make_shared<SimpleQuote>(95.0)),
+            qTS, rTS, volTS2));
+
+    const Real rho = 0.5;
+    Matrix correlation(2, 2, rho);
+    correlation[0][0] = correlation[1][1] = 1.0;
+    ext::shared_ptr<StochasticProcessArray> process(
+        new StochasticProcessArray({p1, p2}, correlation));
+
+    Date exDate = today + 360;
+    BasketOption basketOption(
+        ext::make_shared<MaxBasketPayoff>(
+            ext::make_shared<PlainVanillaPayoff>(Option::Call, 100.0)),
+        ext::make_shared<EuropeanExercise>(exDate));
+
+    // the samples don't fill a whole number of batches
+    const Size samples = 1001, batchSize = 64;
+
+    basketOption.setPricingEngine(
+        MakeMCEuropeanBasketEngine<PseudoRandom>(process)
+        .withSteps(10)
+        .withAntitheticVariate()
+        .withSamples(samples)
+        .withSeed(42));
+    const Real expected = basketOption.NPV();
+    const Real expectedError = basketOption.errorEstimate();
+
+    basketOption.setPricingEngine(
+        MakeMCEuropeanBasketEngine<PseudoRandom>(process)
+        .withSteps(10)
+        .withAntitheticVariate()
+        .withSamples(samples)
+        .withSeed(42)
+        .withBatchSize(batchSize));
+    Real calculated = basketOption.NPV();
+    Real calculatedError = basketOption.errorEstimate();
+
+    if (calculated != expected || calculatedError != expectedError)
+        BOOST_FAIL("batched simulation differs from path-at-a-time one:"
+                   << std::setprecision(16)
+                   << "\n    batched:          " << calculated
+                   << " +/- " << calculatedError
+                   << "\n    path at a time:   " << expected
+                   << " +/- " << expectedError);
+
+    // the samples are added in several rounds when a tolerance is given
+    basketOption.setPricingEngine(
+        MakeMCEuropeanBasketEngine<PseudoRandom>(process)
+        .withSteps(10)
+        .withAntitheticVariate()
+        .withAbsoluteTolerance(0.05)
+        .withSeed(42));
+    const Real expectedWithTolerance = basketOption.NPV();
+
+    basketOption.setPricingEngine(
+        MakeMCEuropeanBasketEngine<PseudoRandom>(process)
+        .withSteps(10)
+        .withAntitheticVariate()
+        .withAbsoluteTolerance(0.05)
+        .withSeed(42)
+        .withBatchSize(batchSize));
+    calculated = basketOption.NPV();
+
+    if (calculated != expectedWithTolerance)
+        BOOST_FAIL("batched simulation with tolerance differs from "
+                   "path-at-a-time one:" << std::setprecision(16)
+                   << "\n    batched:          " << calculated
+                   << "\n    path at a time:   " << expectedWithTolerance);
+
+    // the Brownian bridge is available for batched simulations
+    basketOption.setPricingEngine(
+        ext::make_shared<StulzEngine>(p1, p2, rho));
+    const Real analytic = basketOption.NPV();
+
+    basketOption.setPricingEngine(
+        MakeMCEuropeanBasketEngine<LowDiscrepancy>(process)
+        .withSteps(10)
+        .withBrownianBridge()
+        .withSamples(32767)
+        .withBatchSize(batchSize));
+    calculated = basketOption.NPV();
+
+    const Real tolerance = 0.01;
+    if (relativeError(calculated, analytic, analytic) > tolerance)
+        BOOST_FAIL("batched simulation with Brownian bridge failed:"
+                   << "\n    calculated:  " << calculated
+                   << "\n    analytic:    " << analytic
+                   << "\n    tolerance:   " << tolerance);
+
+    // batches can be drawn on several threads; low-discrepancy
+    // sequences skip ahead to the first sample of each block, so
+    // that the samples don't depend on the number of threads
+    const Size threads = 4;
+    basketOption.setPricingEngine(
+        MakeMCEuropeanBasketEngine<LowDiscrepancy>(process)
+        .withSteps(10)
+        .withBrownianBridge()
+        .withSamples(32767)
+        .withBatchSize(batchSize)
+        .withThreads(threads));
+    Real multiThreaded = basketOption.NPV();
+
+    if (std::fabs(multiThreaded - calculated) > 1.0e-12)
+        BOOST_FAIL("multi-threaded batched simulation differs from "
+                   "single-threaded one:"
+                   << std::setprecision(16)
+                   << "\n    multi-threaded:   " << multiThreaded
+                   << "\n    single-threaded:  " << calculated);
+
+    // pseudo-random batches on several threads use the same streams
+    // as paths generated one at a time
+    basketOption.setPricingEngine(
+        MakeMCEuropeanBasketEngine<PseudoRandom>(process)
+        .withSteps(10)
+        .withAntitheticVariate()
+        .withSamples(samples)
+        .withSeed(42)
+        .withThreads(threads));
+    const Real expectedMultiThreaded = basketOption.NPV();
+
+    basketOption.setPricingEngine(
+        MakeMCEuropeanBasketEngine<PseudoRandom>(process)
+        .withSteps(10)
+        .withAntitheticVariate()
+        .withSamples(samples)
+        .withSeed(42)
+        .withBatchSize(batchSize)
+        .withThreads(threads));
+    multiThreaded = basketOption.NPV();
+
+    if (multiThreaded != expectedMultiThreaded)
+        BOOST_FAIL("multi-threaded batched simulation differs from "
+                   "path-at-a-time one:"
+                   << std::setprecision(16)
+                   << "\n    batched:          " << multiThreaded
+                   << "\n    path at a time:   " << expectedMultiThreaded);
+}
+
 BOOST_AUTO_TEST_CASE(testLocalVolatilitySpreadOption) {
 
     BOOST_TEST_MESSAGE("Testing 2D local-volatility spread-option pricing...");
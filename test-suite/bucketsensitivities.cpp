@@ -0,0 +1,139 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include "utilities.hpp"
+#include <ql/experimental/risk/bucketsensitivities.hpp>
+#include <ql/indexes/ibor/euribor.hpp>
+#include <ql/instruments/makevanillaswap.hpp>
+#include <ql/pricingengines/swap/discountingswapengine.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/yield/piecewiseyieldcurve.hpp>
+#include <ql/termstructures/yield/ratehelpers.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual360.hpp>
+#include <ql/time/daycounters/thirty360.hpp>
+#include <iomanip>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(BucketSensitivitiesExperimentalTest)
+
+namespace bucket_sensitivities_test {
+
+    // a Euribor curve bootstrapped over deposits and swaps, and a
+    // few swaps priced on it; each call builds new objects
+    BucketSensitivities::Scenario euriborScenario() {
+        const Calendar calendar = TARGET();
+        const Natural settlementDays = 2;
+        const Date settlement = calendar.advance(
+            Settings::instance().evaluationDate(), settlementDays, Days);
+
+        BucketSensitivities::Scenario scenario;
+        std::vector<ext::shared_ptr<RateHelper> > helpers;
+
+        const Integer depositMonths[] = { 1, 3, 6, 9 };
+        const Rate depositRates[] = { 0.0355, 0.0362, 0.0368, 0.0372 };
+        for (Size i=0; i<LENGTH(depositMonths); ++i) {
+            auto quote = ext::make_shared<SimpleQuote>(depositRates[i]);
+            scenario.quotes.push_back(quote);
+            helpers.push_back(ext::make_shared<DepositRateHelper>(
+                Handle<Quote>(quote), depositMonths[i]*Months,
+                settlementDays, calendar, ModifiedFollowing, true,
+                Actual360()));
+        }
+
+        const Integer swapYears[] = { 1, 2, 3, 5, 7, 10, 15 };
+        const Rate swapRates[] = { 0.0375, 0.0385, 0.0392, 0.0405,
+                                   0.0415, 0.0425, 0.0435 };
+        auto euribor6m = ext::make_shared<Euribor6M>();
+        for (Size i=0; i<LENGTH(swapYears); ++i) {
+            auto quote = ext::make_shared<SimpleQuote>(swapRates[i]);
+            scenario.quotes.push_back(quote);
+            helpers.push_back(ext::make_shared<SwapRateHelper>(
+                Handle<Quote>(quote), swapYears[i]*Years, calendar,
+                Annual, Unadjusted, Thirty360(Thirty360::BondBasis),
+                euribor6m));
+        }
+
+        auto curve =
+            ext::make_shared<PiecewiseYieldCurve<Discount, LogLinear> >(
+                settlement, helpers, Actual360());
+        RelinkableHandle<YieldTermStructure> curveHandle;
+        curveHandle.linkTo(curve);
+        auto forecastIndex = ext::make_shared<Euribor6M>(curveHandle);
+        auto engine = ext::make_shared<DiscountingSwapEngine>(curveHandle);
+
+        scenario.reset = [curve]() { curve->reset(); };
+        for (Integer years : {2, 5, 7, 12}) {
+            ext::shared_ptr<VanillaSwap> swap =
+                MakeVanillaSwap(years*Years, forecastIndex, 0.03)
+                .withNominal(100.0)
+                .withFixedLegDayCount(Thirty360(Thirty360::BondBasis))
+                .withFixedLegTenor(1*Years)
+                .withFixedLegConvention(Unadjusted)
+                .withFixedLegTerminationDateConvention(Unadjusted)
+                .withPricingEngine(engine);
+            scenario.instruments.push_back(swap);
+        }
+        return scenario;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testParallelBucketSensitivities) {
+    BOOST_TEST_MESSAGE(
+        "Testing bucketed curve sensitivities on several threads...");
+
+    using namespace bucket_sensitivities_test;
+
+    Settings::instance().evaluationDate() = Date(15, March, 2024);
+
+    // curves are bootstrapped from scratch for each scenario, so
+    // the results must be exactly the same for any number of threads
+    const BucketSensitivities sequential(euriborScenario);
+    for (Size threads : {2, 3, 5}) {
+        const BucketSensitivities parallel(euriborScenario, 0.0001, true,
+                                           threads);
+
+        BOOST_REQUIRE(parallel.delta().rows() == sequential.delta().rows()
+                      && parallel.delta().columns() == sequential.delta().columns());
+        for (Size i=0; i<sequential.delta().rows(); ++i) {
+            if (parallel.npv()[i] != sequential.npv()[i])
+                BOOST_ERROR("different base NPVs for the " << io::ordinal(i+1)
+                            << " instrument with " << threads << " threads");
+            for (Size j=0; j<sequential.delta().columns(); ++j) {
+                if (parallel.delta()[i][j] != sequential.delta()[i][j] ||
+                    parallel.gamma()[i][j] != sequential.gamma()[i][j])
+                    BOOST_ERROR("failed to reproduce sequential sensitivities"
+                                << "\n    threads:    " << threads
+                                << "\n    instrument: " << i
+                                << "\n    quote:      " << j
+                                << std::setprecision(17)
+                                << "\n    calculated: " << parallel.delta()[i][j]
+                                << "\n    expected:   " << sequential.delta()[i][j]);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
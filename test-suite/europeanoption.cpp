@@ -30,7 +30,9 @@
 #include <ql/pricingengines/vanilla/analyticeuropeanengine.hpp>
 #include <ql/pricingengines/vanilla/analyticdividendeuropeanengine.hpp>
 #include <ql/pricingengines/vanilla/binomialengine.hpp>
+#include <ql/pricingengines/vanilla/fdblackscholesfokkerplanckengine.hpp>
 #include <ql/pricingengines/vanilla/fdblackscholesvanillaengine.hpp>
+#include <ql/pricingengines/vanilla/fdrichardsonvanillaengine.hpp>
 #include <ql/experimental/variancegamma/fftvanillaengine.hpp>
 #include <ql/pricingengines/vanilla/mceuropeanengine.hpp>
 #include <ql/pricingengines/vanilla/integralengine.hpp>
@@ -1292,6 +1294,105 @@ BOOST_AUTO_TEST_CASE(testQmcEngines) {
     testEngineConsistency(engine,steps,samples,relativeTol);
 }
 
+BOOST_AUTO_TEST_CASE(testMultiThreadedMcEngines) {
+
+    BOOST_TEST_MESSAGE("Testing multi-threaded Monte Carlo European engines...");
+
+    DayCounter dc = Actual360();
+    Date today = Date::todaysDate();
+    Settings::instance().evaluationDate() = today;
+
+    ext::shared_ptr<SimpleQuote> spot(new SimpleQuote(100.0));
+    ext::shared_ptr<YieldTermStructure> qTS = flatRate(today, 0.02, dc);
+    ext::shared_ptr<YieldTermStructure> rTS = flatRate(today, 0.05, dc);
+    ext::shared_ptr<BlackVolTermStructure> volTS = flatVol(today, 0.25, dc);
+    ext::shared_ptr<GeneralizedBlackScholesProcess> process =
+        makeProcess(spot, qTS, rTS, volTS);
+
+    ext::shared_ptr<StrikedTypePayoff> payoff(
+                                 new PlainVanillaPayoff(Option::Call, 105.0));
+    ext::shared_ptr<Exercise> exercise(
+                              new EuropeanExercise(today + Period(1, Years)));
+    EuropeanOption option(payoff, exercise);
+
+    option.setPricingEngine(
+        ext::make_shared<AnalyticEuropeanEngine>(process));
+    Real expected = option.NPV();
+
+    const Size samples = 20000;
+    const Size threads = 4;
+
+    // pseudo-random: results are reproducible for a given number of threads
+    option.setPricingEngine(MakeMCEuropeanEngine<PseudoRandom>(process)
+                            .withSteps(10)
+                            .withSamples(samples)
+                            .withSeed(42)
+                            .withThreads(threads));
+    Real calculated = option.NPV();
+    Real error = option.errorEstimate();
+
+    if (std::fabs(calculated-expected) > 3.0*error)
+        BOOST_ERROR("failed to reproduce analytic price "
+                    "with multi-threaded pseudo-random engine"
+                    << "\n    threads:    " << threads
+                    << "\n    calculated: " << calculated << " +/- " << error
+                    << "\n    expected:   " << expected);
+
+    option.setPricingEngine(MakeMCEuropeanEngine<PseudoRandom>(process)
+                            .withSteps(10)
+                            .withSamples(samples)
+                            .withSeed(42)
+                            .withThreads(threads));
+    Real repeated = option.NPV();
+
+    if (repeated != calculated)
+        BOOST_ERROR("failed to reproduce multi-threaded pseudo-random result"
+                    << std::setprecision(16)
+                    << "\n    first run:  " << calculated
+                    << "\n    second run: " << repeated);
+
+    // low-discrepancy: every thread moves the sequence ahead to its
+    // first sample, so that the single-threaded result is reproduced
+    option.setPricingEngine(MakeMCEuropeanEngine<LowDiscrepancy>(process)
+                            .withSteps(10)
+                            .withBrownianBridge()
+                            .withSamples(4095));
+    Real sequential = option.NPV();
+
+    option.setPricingEngine(MakeMCEuropeanEngine<LowDiscrepancy>(process)
+                            .withSteps(10)
+                            .withBrownianBridge()
+                            .withSamples(4095)
+                            .withThreads(threads));
+    Real parallel = option.NPV();
+
+    if (parallel != sequential)
+        BOOST_ERROR("failed to reproduce single-threaded low-discrepancy "
+                    "result with " << threads << " threads"
+                    << std::setprecision(16)
+                    << "\n    single thread: " << sequential
+                    << "\n    " << threads << " threads:     " << parallel);
+
+    // with a tolerance, the samples are added in several calls,
+    // which reuse the same threads
+    const Real tolerance = 0.05;
+    option.setPricingEngine(MakeMCEuropeanEngine<PseudoRandom>(process)
+                            .withSteps(10)
+                            .withAbsoluteTolerance(tolerance)
+                            .withSeed(42)
+                            .withThreads(threads));
+    calculated = option.NPV();
+    error = option.errorEstimate();
+
+    if (error > tolerance || std::fabs(calculated-expected) > 3.0*error)
+        BOOST_ERROR("failed to reproduce analytic price "
+                    "with multi-threaded engine and tolerance"
+                    << "\n    threads:    " << threads
+                    << "\n    calculated: " << calculated << " +/- " << error
+                    << "\n    expected:   " << expected
+                    << "\n    tolerance:  " << tolerance);
+}
+
 BOOST_AUTO_TEST_CASE(testLocalVolatility) {
     BOOST_TEST_MESSAGE("Testing finite-differences with local volatility...");
 
@@ -1696,6 +1797,200 @@ BOOST_AUTO_TEST_CASE(testDouglasVsCrankNicolson) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testFokkerPlanckEngine) {
+    BOOST_TEST_MESSAGE("Testing Fokker-Planck forward engine "
+                       "for a book of European options...");
+
+    const DayCounter dc = Actual365Fixed();
+    const Date today = Date(5, October, 2018);
+
+    Settings::instance().evaluationDate() = today;
+
+    const Handle<Quote> spot(ext::make_shared<SimpleQuote>(100.0));
+    const Handle<YieldTermStructure> qTS(flatRate(today, 0.02, dc));
+    const Handle<YieldTermStructure> rTS(flatRate(today, 0.05, dc));
+    const Handle<BlackVolTermStructure> volTS(flatVol(today, 0.25, dc));
+
+    const ext::shared_ptr<BlackScholesMertonProcess> process =
+        ext::make_shared<BlackScholesMertonProcess>(
+            spot, qTS, rTS, volTS);
+
+    const std::vector<Date> expiries = {
+        today + Period(3, Months), today + Period(6, Months),
+        today + Period(1, Years), today + Period(2, Years) };
+
+    const ext::shared_ptr<PricingEngine> analyticEngine =
+        ext::make_shared<AnalyticEuropeanEngine>(process);
+
+    const Real tol = 0.01;
+    for (bool localVol : {false, true}) {
+        const ext::shared_ptr<PricingEngine> fokkerPlanckEngine =
+            ext::make_shared<FdBlackScholesFokkerPlanckEngine>(
+                process, expiries, 100, 400, 2,
+                FdmSchemeDesc::Douglas(), localVol);
+
+        for (const auto& expiry : expiries) {
+            for (Real strike = 60.0; strike < 141.0; strike += 10.0) {
+                for (Option::Type type : {Option::Call, Option::Put}) {
+                    VanillaOption option(
+                        ext::make_shared<PlainVanillaPayoff>(type, strike),
+                        ext::make_shared<EuropeanExercise>(expiry));
+
+                    option.setPricingEngine(analyticEngine);
+                    const Real expected = option.NPV();
+
+                    option.setPricingEngine(fokkerPlanckEngine);
+                    const Real calculated = option.NPV();
+
+                    const Real diff = std::fabs(calculated - expected);
+                    if (diff > tol) {
+                        BOOST_ERROR("failed to reproduce European option "
+                                    "values with the Fokker-Planck engine"
+                                    << "\n    type:       " << type
+                                    << "\n    strike:     " << strike
+                                    << "\n    expiry:     " << expiry
+                                    << "\n    local vol:  " << localVol
+                                    << "\n    calculated: " << calculated
+                                    << "\n    expected:   " << expected
+                                    << "\n    difference: " << diff
+                                    << "\n    tolerance:  " << tol);
+                    }
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testRichardsonFdEngine) {
+    BOOST_TEST_MESSAGE("Testing Richardson extrapolation "
+                       "of finite-difference engines...");
+
+    const DayCounter dc = Actual365Fixed();
+    const Date today = Date(5, October, 2018);
+
+    Settings::instance().evaluationDate() = today;
+
+    const Handle<Quote> spot(ext::make_shared<SimpleQuote>(100.0));
+    const Handle<YieldTermStructure> qTS(flatRate(today, 0.02, dc));
+    const Handle<YieldTermStructure> rTS(flatRate(today, 0.05, dc));
+    const Handle<BlackVolTermStructure> volTS(flatVol(today, 0.25, dc));
+
+    const ext::shared_ptr<BlackScholesMertonProcess> process =
+        ext::make_shared<BlackScholesMertonProcess>(
+            spot, qTS, rTS, volTS);
+
+    VanillaOption option(
+        ext::make_shared<PlainVanillaPayoff>(Option::Put, 105.0),
+        ext::make_shared<EuropeanExercise>(today + Period(1, Years)));
+
+    option.setPricingEngine(
+        ext::make_shared<AnalyticEuropeanEngine>(process));
+    const Real expectedNPV = option.NPV();
+    const Real expectedDelta = option.delta();
+    const Real expectedGamma = option.gamma();
+
+    const FdRichardsonVanillaEngine::engine_factory factory =
+        [process](Size tGrid, Size xGrid) {
+            return ext::make_shared<FdBlackScholesVanillaEngine>(
+                process, tGrid, xGrid, 2);
+        };
+
+    #ifdef QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN
+    const bool parallel = true;
+    #else
+    const bool parallel = false;
+    #endif
+
+    const Real tol = 2e-3;
+    for (Real order : {2.0, Real(Null<Real>())}) {
+        option.setPricingEngine(
+            ext::make_shared<FdRichardsonVanillaEngine>(
+                factory, 100, 200, order, parallel));
+
+        const Real npvDiff = std::fabs(option.NPV() - expectedNPV);
+        const Real deltaDiff = std::fabs(option.delta() - expectedDelta);
+        const Real gammaDiff = std::fabs(option.gamma() - expectedGamma);
+
+        if (npvDiff > tol || deltaDiff > tol || gammaDiff > tol) {
+            BOOST_ERROR("failed to reproduce European option values "
+                        "with the Richardson extrapolated engine"
+                        << "\n    order:            " << order
+                        << "\n    calculated value: " << option.NPV()
+                        << "\n    expected value:   " << expectedNPV
+                        << "\n    calculated delta: " << option.delta()
+                        << "\n    expected delta:   " << expectedDelta
+                        << "\n    calculated gamma: " << option.gamma()
+                        << "\n    expected gamma:   " << expectedGamma
+                        << "\n    tolerance:        " << tol);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testRichardsonFdEngineInParallel) {
+    BOOST_TEST_MESSAGE("Testing concurrent Richardson extrapolation "
+                       "of finite-difference engines...");
+
+    const DayCounter dc = Actual365Fixed();
+    const Date today = Date(5, October, 2018);
+
+    Settings::instance().evaluationDate() = today;
+
+    // each engine gets its own market data, so that the concurrent
+    // levels don't notify each other
+    const FdRichardsonVanillaEngine::engine_factory factory =
+        [today, dc](Size tGrid, Size xGrid) {
+            const ext::shared_ptr<BlackScholesMertonProcess> process =
+                ext::make_shared<BlackScholesMertonProcess>(
+                    Handle<Quote>(ext::make_shared<SimpleQuote>(100.0)),
+                    Handle<YieldTermStructure>(flatRate(today, 0.02, dc)),
+                    Handle<YieldTermStructure>(flatRate(today, 0.05, dc)),
+                    Handle<BlackVolTermStructure>(flatVol(today, 0.25, dc)));
+            return ext::make_shared<FdBlackScholesVanillaEngine>(
+                process, tGrid, xGrid, 2);
+        };
+
+    #ifndef QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN
+    BOOST_CHECK_THROW(
+        FdRichardsonVanillaEngine(factory, 100, 200, 2.0, true), Error);
+    #else
+    VanillaOption option(
+        ext::make_shared<PlainVanillaPayoff>(Option::Put, 105.0),
+        ext::make_shared<AmericanExercise>(today, today + Period(1, Years)));
+
+    for (Real order : {2.0, Real(Null<Real>())}) {
+        option.setPricingEngine(
+            ext::make_shared<FdRichardsonVanillaEngine>(
+                factory, 100, 200, order, false));
+        const Real expectedNPV = option.NPV();
+        const Real expectedDelta = option.delta();
+        const Real expectedGamma = option.gamma();
+        const Real expectedTheta = option.theta();
+
+        option.setPricingEngine(
+            ext::make_shared<FdRichardsonVanillaEngine>(
+                factory, 100, 200, order, true));
+
+        if (option.NPV() != expectedNPV
+            || option.delta() != expectedDelta
+            || option.gamma() != expectedGamma
+            || option.theta() != expectedTheta) {
+            BOOST_ERROR("concurrent Richardson extrapolation differs "
+                        "from sequential one"
+                        << std::setprecision(16)
+                        << "\n    order:            " << order
+                        << "\n    calculated value: " << option.NPV()
+                        << "\n    expected value:   " << expectedNPV
+                        << "\n    calculated delta: " << option.delta()
+                        << "\n    expected delta:   " << expectedDelta
+                        << "\n    calculated gamma: " << option.gamma()
+                        << "\n    expected gamma:   " << expectedGamma
+                        << "\n    calculated theta: " << option.theta()
+                        << "\n    expected theta:   " << expectedTheta);
+        }
+    }
+    #endif
+}
+
 BOOST_AUTO_TEST_CASE(testFFTEngines) {
 
     BOOST_TEST_MESSAGE("Testing FFT European engines "
@@ -25,6 +25,8 @@
 #include <ql/instruments/vanillaoption.hpp>
 #include <ql/math/functional.hpp>
 #include <ql/methods/finitedifferences/meshers/fdmhestonvariancemesher.hpp>
+#include <ql/methods/finitedifferences/solvers/fdmhestonsolver.hpp>
+#include <ql/methods/finitedifferences/solvers/fdmvaluesurface.hpp>
 #include <ql/models/equity/hestonmodel.hpp>
 #include <ql/pricingengines/barrier/analyticbarrierengine.hpp>
 #include <ql/pricingengines/barrier/fdblackscholesbarrierengine.hpp>
@@ -1052,6 +1054,208 @@ BOOST_AUTO_TEST_CASE(testAmericanCallPutParity) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testOperatorCaching) {
+    BOOST_TEST_MESSAGE("Testing mesher and operator caching "
+                       "of the FDM Heston engine...");
+
+    const DayCounter dc = Actual365Fixed();
+    const Date today = Date(5, October, 2018);
+    Settings::instance().evaluationDate() = today;
+
+    const auto spot = ext::make_shared<SimpleQuote>(100.0);
+    const auto rate = ext::make_shared<SimpleQuote>(0.05);
+    const auto model = ext::make_shared<HestonModel>(
+        ext::make_shared<HestonProcess>(
+            Handle<YieldTermStructure>(flatRate(rate, dc)),
+            Handle<YieldTermStructure>(flatRate(0.02, dc)),
+            Handle<Quote>(spot), 0.04, 1.0, 0.04, 0.5, -0.7));
+
+    const auto engine = ext::make_shared<FdHestonVanillaEngine>(
+        model, 20, 50, 20, 0);
+
+    const Date maturityDate = today + Period(1, Years);
+    const ext::shared_ptr<Exercise> europeanExercise =
+        ext::make_shared<EuropeanExercise>(maturityDate);
+    const ext::shared_ptr<Exercise> americanExercise =
+        ext::make_shared<AmericanExercise>(today, maturityDate);
+
+    struct OptionSpec {
+        Option::Type type;
+        Real strike;
+        ext::shared_ptr<Exercise> exercise;
+        Size expectedHits, expectedMisses;
+    };
+    const OptionSpec specs[] = {
+        { Option::Call, 100.0, europeanExercise, 0, 1 },
+        { Option::Put,  100.0, europeanExercise, 1, 1 },
+        { Option::Put,  100.0, americanExercise, 2, 1 },
+        { Option::Put,  110.0, americanExercise, 2, 2 },
+        { Option::Call, 110.0, europeanExercise, 3, 2 }
+    };
+
+    const Real tol = 1e-12;
+    for (Real s : {100.0, 105.0}) {
+        spot->setValue(s);
+        const Size hits = engine->cacheHits(), misses = engine->cacheMisses();
+
+        for (const auto& spec : specs) {
+            VanillaOption option(
+                ext::make_shared<PlainVanillaPayoff>(spec.type, spec.strike),
+                spec.exercise);
+
+            option.setPricingEngine(engine);
+            const Real cached = option.NPV();
+
+            if (engine->cacheHits() - hits != spec.expectedHits
+                || engine->cacheMisses() - misses != spec.expectedMisses) {
+                BOOST_ERROR("unexpected operator cache statistics"
+                            << "\n    spot:            " << s
+                            << "\n    strike:          " << spec.strike
+                            << "\n    hits:            "
+                            << engine->cacheHits() - hits
+                            << "\n    expected hits:   " << spec.expectedHits
+                            << "\n    misses:          "
+                            << engine->cacheMisses() - misses
+                            << "\n    expected misses: " << spec.expectedMisses);
+            }
+
+            option.setPricingEngine(
+                ext::make_shared<FdHestonVanillaEngine>(model, 20, 50, 20, 0));
+            const Real expected = option.NPV();
+
+            if (std::fabs(cached - expected) > tol) {
+                BOOST_ERROR("failed to reproduce option value "
+                            "with a cached operator"
+                            << "\n    spot:       " << s
+                            << "\n    strike:     " << spec.strike
+                            << "\n    cached:     " << cached
+                            << "\n    expected:   " << expected
+                            << "\n    tolerance:  " << tol);
+            }
+        }
+    }
+
+    // notifications that don't change the data the operator is built
+    // from, e.g., calibrations evaluating the same parameters again,
+    // keep it...
+    VanillaOption option(
+        ext::make_shared<PlainVanillaPayoff>(Option::Put, 100.0),
+        europeanExercise);
+    option.setPricingEngine(engine);
+    option.NPV();
+
+    Size hits = engine->cacheHits(), misses = engine->cacheMisses();
+    model->setParams(model->params());
+    option.NPV();
+    if (engine->cacheHits() != hits + 1 || engine->cacheMisses() != misses)
+        BOOST_ERROR("operator not reused after a notification "
+                    "with unchanged model parameters");
+
+    // ...while a change in the parameters rebuilds it
+    Array params = model->params();
+    params[3] = -0.5;
+    model->setParams(params);
+
+    hits = engine->cacheHits();
+    misses = engine->cacheMisses();
+    const Real cached = option.NPV();
+    if (engine->cacheHits() != hits || engine->cacheMisses() != misses + 1)
+        BOOST_ERROR("operator not rebuilt after a change in the correlation");
+
+    option.setPricingEngine(
+        ext::make_shared<FdHestonVanillaEngine>(model, 20, 50, 20, 0));
+    const Real expected = option.NPV();
+    if (std::fabs(cached - expected) > tol)
+        BOOST_ERROR("failed to reproduce option value "
+                    "after a change in the correlation"
+                    << "\n    cached:     " << cached
+                    << "\n    expected:   " << expected
+                    << "\n    tolerance:  " << tol);
+
+    // changes in the curves rebuild it as well
+    option.setPricingEngine(engine);
+    option.NPV();
+    rate->setValue(0.06);
+
+    hits = engine->cacheHits();
+    misses = engine->cacheMisses();
+    const Real cachedAfterRateChange = option.NPV();
+    if (engine->cacheHits() != hits || engine->cacheMisses() != misses + 1)
+        BOOST_ERROR("operator not rebuilt after a change in the interest rate");
+
+    option.setPricingEngine(
+        ext::make_shared<FdHestonVanillaEngine>(model, 20, 50, 20, 0));
+    const Real expectedAfterRateChange = option.NPV();
+    if (std::fabs(cachedAfterRateChange - expectedAfterRateChange) > tol)
+        BOOST_ERROR("failed to reproduce option value "
+                    "after a change in the interest rate"
+                    << "\n    cached:     " << cachedAfterRateChange
+                    << "\n    expected:   " << expectedAfterRateChange
+                    << "\n    tolerance:  " << tol);
+}
+
+BOOST_AUTO_TEST_CASE(testValueSurface) {
+    BOOST_TEST_MESSAGE("Testing spot ladders from a solved "
+                       "Heston value surface...");
+
+    const DayCounter dc = Actual365Fixed();
+    const Date today = Date(5, October, 2018);
+    Settings::instance().evaluationDate() = today;
+
+    const Real v0 = 0.04;
+    const auto spot = ext::make_shared<SimpleQuote>(100.0);
+    const auto process = ext::make_shared<HestonProcess>(
+        Handle<YieldTermStructure>(flatRate(0.05, dc)),
+        Handle<YieldTermStructure>(flatRate(0.02, dc)),
+        Handle<Quote>(spot), v0, 1.0, 0.04, 0.5, -0.7);
+    const auto model = ext::make_shared<HestonModel>(process);
+
+    const auto fdEngine =
+        ext::make_shared<FdHestonVanillaEngine>(model, 100, 100, 50, 0);
+
+    VanillaOption option(
+        ext::make_shared<PlainVanillaPayoff>(Option::Put, 100.0),
+        ext::make_shared<EuropeanExercise>(today + Period(1, Years)));
+    option.setupArguments(fdEngine->getArguments());
+
+    const FdmHestonSolver solver(
+        Handle<HestonProcess>(process), fdEngine->getSolverDesc(1.0));
+
+    const ext::shared_ptr<const Fdm2DimValueSurface> surface =
+        solver.valueSurface();
+
+    const Real s0 = spot->value();
+    if (std::fabs(surface->valueAt(std::log(s0), v0)
+                  - solver.valueAt(s0, v0)) > 1e-12
+        || std::fabs(surface->derivativeX(std::log(s0), v0)/s0
+                     - solver.deltaAt(s0, v0)) > 1e-12
+        || std::fabs(surface->thetaAt(std::log(s0), v0)
+                     - solver.thetaAt(s0, v0)) > 1e-12) {
+        BOOST_ERROR("value surface differs from the solver");
+    }
+
+    // the surface is detached from the solver and answers spot
+    // scenarios without re-solving
+    option.setPricingEngine(ext::make_shared<AnalyticHestonEngine>(model));
+
+    const Real tol = 0.05;
+    for (Real s = 90.0; s < 110.1; s += 5.0) {
+        spot->setValue(s);
+
+        const Real calculated = surface->valueAt(std::log(s), v0);
+        const Real expected = option.NPV();
+
+        if (std::fabs(calculated - expected) > tol) {
+            BOOST_ERROR("failed to reproduce option value "
+                        "from the value surface"
+                        << "\n    spot:       " << s
+                        << "\n    calculated: " << calculated
+                        << "\n    expected:   " << expected
+                        << "\n    tolerance:  " << tol);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
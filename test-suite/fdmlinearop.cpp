@@ -27,7 +27,9 @@
 #include <ql/math/interpolations/bilinearinterpolation.hpp>
 #include <ql/math/interpolations/cubicinterpolation.hpp>
 #include <ql/math/matrixutilities/bicgstab.hpp>
+#include <ql/math/matrixutilities/csrmatrix.hpp>
 #include <ql/math/matrixutilities/gmres.hpp>
+#include <ql/math/matrixutilities/sparseamgpreconditioner.hpp>
 #include <ql/math/matrixutilities/sparseilupreconditioner.hpp>
 #include <ql/math/randomnumbers/rngtraits.hpp>
 #include <ql/methods/finitedifferences/finitedifferencemodel.hpp>
@@ -38,11 +40,13 @@
 #include <ql/methods/finitedifferences/meshers/uniform1dmesher.hpp>
 #include <ql/methods/finitedifferences/meshers/uniformgridmesher.hpp>
 #include <ql/methods/finitedifferences/operators/fdmblackscholesop.hpp>
+#include <ql/methods/finitedifferences/operators/fdmhestonfwdop.hpp>
 #include <ql/methods/finitedifferences/operators/fdmhestonhullwhiteop.hpp>
 #include <ql/methods/finitedifferences/operators/fdmhestonop.hpp>
 #include <ql/methods/finitedifferences/operators/fdmlinearop.hpp>
 #include <ql/methods/finitedifferences/operators/fdmlinearopcomposite.hpp>
 #include <ql/methods/finitedifferences/operators/fdmlinearoplayout.hpp>
+#include <ql/methods/finitedifferences/operators/fdmoperatorthreads.hpp>
 #include <ql/methods/finitedifferences/operators/firstderivativeop.hpp>
 #include <ql/methods/finitedifferences/operators/numericaldifferentiation.hpp>
 #include <ql/methods/finitedifferences/operators/secondderivativeop.hpp>
@@ -50,6 +54,7 @@
 #include <ql/methods/finitedifferences/schemes/craigsneydscheme.hpp>
 #include <ql/methods/finitedifferences/schemes/douglasscheme.hpp>
 #include <ql/methods/finitedifferences/schemes/hundsdorferscheme.hpp>
+#include <ql/methods/finitedifferences/schemes/impliciteulerscheme.hpp>
 #include <ql/methods/finitedifferences/solvers/fdm3dimsolver.hpp>
 #include <ql/methods/finitedifferences/solvers/fdmbackwardsolver.hpp>
 #include <ql/methods/finitedifferences/solvers/fdmhestonsolver.hpp>
@@ -72,8 +77,10 @@
 #include <ql/time/daycounters/actual365fixed.hpp>
 #include <boost/numeric/ublas/operation.hpp>
 #include <boost/numeric/ublas/vector.hpp>
+#include <chrono>
 #include <functional>
 #include <numeric>
+#include <thread>
 #include <utility>
 
 using namespace QuantLib;
@@ -833,6 +840,217 @@ BOOST_AUTO_TEST_CASE(testTripleBandMapSolve) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testInPlaceOperators) {
+
+    BOOST_TEST_MESSAGE("Testing in-place application and solution of operators...");
+
+    const std::vector<Size> dim = {50, 20};
+
+    ext::shared_ptr<FdmLinearOpLayout> layout(new FdmLinearOpLayout(dim));
+
+    std::vector<std::pair<Real, Real> > boundaries = {{3.8, 4.905274778}, {0.0, 1.0}};
+
+    ext::shared_ptr<FdmMesher> mesher(
+        new UniformGridMesher(layout, boundaries));
+
+    Handle<Quote> s0(ext::shared_ptr<Quote>(new SimpleQuote(100.0)));
+    Handle<YieldTermStructure> rTS(flatRate(0.05, Actual365Fixed()));
+    Handle<YieldTermStructure> qTS(flatRate(0.02, Actual365Fixed()));
+
+    ext::shared_ptr<HestonProcess> hestonProcess(
+        new HestonProcess(rTS, qTS, s0, 0.04, 2.5, 0.04, 0.66, -0.8));
+
+    FdmHestonOp hestonOp(mesher, hestonProcess);
+    hestonOp.setTime(0.5, 0.6);
+
+    Array u(layout->size());
+    for (Size i=0; i < layout->size(); ++i)
+        u[i] = std::sin(0.1*i)+std::cos(0.35*i);
+
+    // results must be identical to the ones of the allocating versions
+    Array out;
+    hestonOp.apply_into(u, out);
+    if (out != hestonOp.apply(u))
+        BOOST_FAIL("in-place apply differs from apply");
+
+    hestonOp.apply_mixed_into(u, out);
+    if (out != hestonOp.apply_mixed(u))
+        BOOST_FAIL("in-place apply_mixed differs from apply_mixed");
+
+    for (Size direction=0; direction < dim.size(); ++direction) {
+        hestonOp.apply_direction_into(direction, u, out);
+        if (out != hestonOp.apply_direction(direction, u))
+            BOOST_FAIL("in-place apply_direction differs from apply_direction"
+                       "\n    direction: " << direction);
+
+        hestonOp.solve_splitting_into(direction, u, -0.01, out);
+        const Array expected = hestonOp.solve_splitting(direction, u, -0.01);
+        if (out != expected)
+            BOOST_FAIL("in-place solve_splitting differs from solve_splitting"
+                       "\n    direction: " << direction);
+
+        // the solution can overwrite the right-hand side
+        Array v = u;
+        hestonOp.solve_splitting_into(direction, v, -0.01, v);
+        if (v != expected)
+            BOOST_FAIL("solve_splitting fails when overwriting its input"
+                       "\n    direction: " << direction);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testMultiThreadedOperators) {
+
+    BOOST_TEST_MESSAGE("Testing multi-threaded application and solution of operators...");
+
+    const Date today = Date(28, March, 2004);
+    Settings::instance().evaluationDate() = today;
+
+    Date exerciseDate(28, March, 2012);
+    const Time maturity = Actual365Fixed().yearFraction(today, exerciseDate);
+
+    // large enough to be split among threads
+    const std::vector<Size> dim = {41, 21, 21};
+
+    ext::shared_ptr<HybridHestonHullWhiteProcess> jointProcess
+                                            = createHestonHullWhite(maturity);
+    FdmSolverDesc desc = createSolverDesc(dim, jointProcess);
+    ext::shared_ptr<FdmMesher> mesher = desc.mesher;
+
+    ext::shared_ptr<HullWhiteForwardProcess> hwFwdProcess
+                                            = jointProcess->hullWhiteProcess();
+
+    ext::shared_ptr<HullWhiteProcess> hwProcess(
+        new HullWhiteProcess(jointProcess->hestonProcess()->riskFreeRate(),
+                             hwFwdProcess->a(), hwFwdProcess->sigma()));
+
+    ext::shared_ptr<FdmLinearOpComposite> linearOp(
+        new FdmHestonHullWhiteOp(mesher,
+                                 jointProcess->hestonProcess(),
+                                 hwProcess,
+                                 jointProcess->eta()));
+    linearOp->setTime(0.5, 0.6);
+
+    Array u(mesher->layout()->size());
+    for (Size i=0; i < u.size(); ++i)
+        u[i] = std::sin(0.1*i)+std::cos(0.35*i);
+
+    // results must be identical to the single-threaded ones
+    for (Size direction=0; direction < dim.size(); ++direction) {
+        Array applied, solved;
+        {
+            const FdmOperatorThreads threads(1);
+            applied = linearOp->apply_direction(direction, u);
+            solved = linearOp->solve_splitting(direction, u, -0.01);
+        }
+        const FdmOperatorThreads threads(3);
+        if (linearOp->apply_direction(direction, u) != applied)
+            BOOST_FAIL("multi-threaded apply_direction differs "
+                       "from single-threaded one"
+                       "\n    direction: " << direction);
+        if (linearOp->solve_splitting(direction, u, -0.01) != solved)
+            BOOST_FAIL("multi-threaded solve_splitting differs "
+                       "from single-threaded one"
+                       "\n    direction: " << direction);
+
+        // the solution along each line must invert the operator
+        Array v = solved;
+        linearOp->apply_direction_into(direction, solved, v);
+        v = solved - 0.01*v;
+        for (Size i=0; i < u.size(); ++i) {
+            if (std::fabs(u[i] - v[i]) > 1e-8)
+                BOOST_FAIL("solve and apply are not consistent"
+                           "\n    direction:  " << direction <<
+                           "\n    expected:   " << u[i] <<
+                           "\n    calculated: " << v[i]);
+        }
+    }
+
+    Array mixed;
+    {
+        const FdmOperatorThreads threads(1);
+        mixed = linearOp->apply_mixed(u);
+    }
+    {
+        const FdmOperatorThreads threads(3);
+        if (linearOp->apply_mixed(u) != mixed)
+            BOOST_FAIL("multi-threaded apply_mixed differs "
+                       "from single-threaded one");
+    }
+
+    const Real x = std::log(100.0);
+    const Real v0 = jointProcess->hestonProcess()->v0();
+    const FdmSchemeDesc schemeDesc = FdmSchemeDesc::Hundsdorfer();
+
+    const Real singleThreaded =
+        Fdm3DimSolver(desc, schemeDesc, linearOp).interpolateAt(x, v0, 0.0);
+    const Real multiThreaded =
+        Fdm3DimSolver(desc, schemeDesc.withThreads(3), linearOp)
+        .interpolateAt(x, v0, 0.0);
+
+    if (multiThreaded != singleThreaded)
+        BOOST_FAIL("multi-threaded rollback differs from single-threaded one"
+                   << std::setprecision(16)
+                   << "\n    single-threaded: " << singleThreaded
+                   << "\n    multi-threaded:  " << multiThreaded);
+}
+
+BOOST_AUTO_TEST_CASE(testMultiThreadedOperatorsSpeedUp, *precondition(if_speed(Slow))) {
+
+    BOOST_TEST_MESSAGE("Testing speed-up of multi-threaded operators "
+                       "on a 200x100x50 Heston/Hull-White grid...");
+
+    const Date today = Date(28, March, 2004);
+    Settings::instance().evaluationDate() = today;
+
+    Date exerciseDate(28, March, 2012);
+    const Time maturity = Actual365Fixed().yearFraction(today, exerciseDate);
+
+    const std::vector<Size> dim = {200, 100, 50};
+
+    ext::shared_ptr<HybridHestonHullWhiteProcess> jointProcess
+                                            = createHestonHullWhite(maturity);
+    const FdmSolverDesc grid = createSolverDesc(dim, jointProcess);
+    const FdmSolverDesc desc = { grid.mesher, grid.bcSet, grid.condition,
+                                 grid.calculator, grid.maturity, 10, 0 };
+
+    ext::shared_ptr<HullWhiteForwardProcess> hwFwdProcess
+                                            = jointProcess->hullWhiteProcess();
+    ext::shared_ptr<FdmLinearOpComposite> linearOp(
+        new FdmHestonHullWhiteOp(desc.mesher,
+                                 jointProcess->hestonProcess(),
+                                 ext::make_shared<HullWhiteProcess>(
+                                     jointProcess->hestonProcess()->riskFreeRate(),
+                                     hwFwdProcess->a(), hwFwdProcess->sigma()),
+                                 jointProcess->eta()));
+
+    const Real x = std::log(100.0);
+    const Real v0 = jointProcess->hestonProcess()->v0();
+    const FdmSchemeDesc schemeDesc = FdmSchemeDesc::Hundsdorfer();
+
+    const Size threads =
+        std::max<Size>(std::thread::hardware_concurrency(), 1);
+    Real value[2], elapsed[2];
+    for (Size i=0; i<2; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        value[i] = Fdm3DimSolver(desc, schemeDesc.withThreads(i == 0 ? 1 : threads),
+                                 linearOp).interpolateAt(x, v0, 0.0);
+        elapsed[i] = std::chrono::duration<Real>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
+    // the speed-up depends on the machine and is only reported
+    BOOST_TEST_MESSAGE("    threads:         " << threads
+                       << "\n    single-threaded: " << elapsed[0] << " s"
+                       << "\n    multi-threaded:  " << elapsed[1] << " s"
+                       << "\n    speed-up:        " << elapsed[0]/elapsed[1]);
+
+    if (value[1] != value[0])
+        BOOST_FAIL("multi-threaded rollback differs from single-threaded one"
+                   << std::setprecision(16)
+                   << "\n    single-threaded: " << value[0]
+                   << "\n    multi-threaded:  " << value[1]);
+}
+
 BOOST_AUTO_TEST_CASE(testFdmHestonBarrier) {
 
     BOOST_TEST_MESSAGE("Testing FDM with barrier option in Heston model...");
@@ -1289,6 +1507,263 @@ BOOST_AUTO_TEST_CASE(testGMRES) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testCsrMatrix) {
+    BOOST_TEST_MESSAGE("Testing compressed-sparse-row matrices...");
+
+    const std::vector<Size> dim = {50, 20};
+
+    ext::shared_ptr<FdmLinearOpLayout> layout(new FdmLinearOpLayout(dim));
+
+    std::vector<std::pair<Real, Real> > boundaries = {{3.8, 4.905274778}, {0.0, 1.0}};
+
+    ext::shared_ptr<FdmMesher> mesher(
+        new UniformGridMesher(layout, boundaries));
+
+    Handle<Quote> s0(ext::shared_ptr<Quote>(new SimpleQuote(100.0)));
+    Handle<YieldTermStructure> rTS(flatRate(0.05, Actual365Fixed()));
+    Handle<YieldTermStructure> qTS(flatRate(0.02, Actual365Fixed()));
+
+    ext::shared_ptr<HestonProcess> hestonProcess(
+        new HestonProcess(rTS, qTS, s0, 0.04, 2.5, 0.04, 0.66, -0.8));
+
+    FdmHestonOp hestonOp(mesher, hestonProcess);
+    hestonOp.setTime(0.5, 0.6);
+
+    Array u(layout->size());
+    for (Size i=0; i < layout->size(); ++i)
+        u[i] = std::sin(0.1*i)+std::cos(0.35*i);
+
+    // the assembled matrices must match the ublas ones and the operator
+    const auto checkAssembly = [](const FdmLinearOpComposite& op,
+                                  const std::string& name) {
+        const SparseMatrix expected = op.toMatrix();
+        const CsrMatrix m = op.toCsrMatrix();
+        if (m.rows() != expected.size1() || m.columns() != expected.size2())
+            BOOST_FAIL("wrong size of compressed-sparse-row matrix for " << name);
+
+        for (auto i1 = expected.begin1(); i1 != expected.end1(); ++i1) {
+            for (auto i2 = i1.begin(); i2 != i1.end(); ++i2) {
+                if (std::fabs(m(i2.index1(), i2.index2()) - *i2) > 1e-12)
+                    BOOST_FAIL("compressed-sparse-row matrix for " << name
+                               << " differs from ublas matrix at ("
+                               << i2.index1() << ", " << i2.index2() << ")"
+                               "\n    expected:   " << *i2 <<
+                               "\n    calculated: " << m(i2.index1(), i2.index2()));
+            }
+        }
+    };
+
+    checkAssembly(hestonOp, "Heston operator");
+
+    ext::shared_ptr<GeneralizedBlackScholesProcess> bsProcess(
+        new GeneralizedBlackScholesProcess(
+            s0, qTS, rTS, Handle<BlackVolTermStructure>(flatVol(0.2, Actual365Fixed()))));
+    FdmBlackScholesOp bsOp(mesher, bsProcess, 100.0);
+    bsOp.setTime(0.5, 0.6);
+    checkAssembly(bsOp, "Black-Scholes operator");
+
+    std::vector<std::pair<Real, Real> > fwdBoundaries = {{3.8, 4.905274778}, {0.01, 1.0}};
+    FdmHestonFwdOp hestonFwdOp(
+        ext::make_shared<UniformGridMesher>(layout, fwdBoundaries), hestonProcess);
+    hestonFwdOp.setTime(0.5, 0.6);
+    checkAssembly(hestonFwdOp, "Heston forward operator");
+
+    const CsrMatrix m = hestonOp.toCsrMatrix();
+
+    // the terms are summed in a single pass, as by chained additions
+    const std::vector<CsrMatrix> terms = hestonOp.toCsrMatrixDecomp();
+    const CsrMatrix chained = terms[0] + terms[1] + terms[2];
+    if (m.rowOffsets() != chained.rowOffsets()
+        || m.columnIndices() != chained.columnIndices()
+        || m.values() != chained.values())
+        BOOST_FAIL("single-pass sum of the operator terms differs "
+                   "from chained additions");
+
+    const Array applied = hestonOp.apply(u);
+    const Array product = prod(m, u);
+    for (Size i=0; i < u.size(); ++i) {
+        if (std::fabs(applied[i] - product[i]) > 1e-10*std::fabs(applied[i]) + 1e-10)
+            BOOST_FAIL("matrix-vector product differs from operator"
+                       "\n    expected:   " << applied[i] <<
+                       "\n    calculated: " << product[i]);
+    }
+
+    Array multiThreaded;
+    m.multiply(u, multiThreaded, 3);
+    if (multiThreaded != product)
+        BOOST_FAIL("multi-threaded matrix-vector product differs "
+                   "from single-threaded one");
+
+    // iterative solvers and preconditioner working directly on it
+    const Size n=41, k=21;
+    const CsrMatrix a(createTestMatrix(n, k, 1.0));
+
+    const SparseILUPreconditioner ilu(a, 4);
+    const std::function<Array(const Array&)> precond
+        = [&](const Array& _x) { return ilu.apply(_x); };
+
+    Array b(n*k);
+    MersenneTwisterUniformRng rng(1234);
+    for (Real& i : b) {
+        i = rng.next().value;
+    }
+
+    const Real tol = 1e-10;
+    const Array x = BiCGstab(a, n*k, tol, precond).solve(b).x;
+    const Array y = GMRES(a, n*k, tol, precond).solve(b, b).x;
+
+    const Real errorBiCGstab =
+        std::sqrt(DotProduct(b-prod(a, x), b-prod(a, x))/DotProduct(b,b));
+    const Real errorGMRES =
+        std::sqrt(DotProduct(b-prod(a, y), b-prod(a, y))/DotProduct(b,b));
+
+    if (errorBiCGstab > tol || errorGMRES > tol) {
+        BOOST_FAIL("Error calculating the inverse of a compressed-sparse-row matrix" <<
+                "\n tolerance:      " << tol <<
+                "\n BiCGstab error: " << errorBiCGstab <<
+                "\n GMRES error:    " << errorGMRES);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testMultigridPreconditioner) {
+    BOOST_TEST_MESSAGE("Testing algebraic multigrid preconditioner...");
+
+    // preconditioned solvers on a plain sparse matrix
+    const Size n=41, k=21;
+    const CsrMatrix a(createTestMatrix(n, k, 1.0));
+
+    const SparseAMGPreconditioner amg(a);
+    if (amg.levels() < 2)
+        BOOST_FAIL("no coarse level built by multigrid preconditioner");
+
+    Array b(n*k);
+    MersenneTwisterUniformRng rng(1234);
+    for (Real& i : b) {
+        i = rng.next().value;
+    }
+
+    const Real tol = 1e-10;
+    const std::function<Array(const Array&)> precond
+        = [&](const Array& _x) { return amg.apply(_x); };
+    const Array x = BiCGstab(a, n*k, tol, precond).solve(b).x;
+    const Real error =
+        std::sqrt(DotProduct(b-prod(a, x), b-prod(a, x))/DotProduct(b,b));
+    if (error > tol)
+        BOOST_FAIL("Error calculating the inverse using the multigrid "
+                   "preconditioner" <<
+                   "\n tolerance: " << tol <<
+                   "\n error:     " << error);
+
+    // implicit-Euler steps for the Heston operator
+    Handle<Quote> s0(ext::shared_ptr<Quote>(new SimpleQuote(100.0)));
+    Handle<YieldTermStructure> rTS(flatRate(0.05, Actual365Fixed()));
+    Handle<YieldTermStructure> qTS(flatRate(0.02, Actual365Fixed()));
+
+    ext::shared_ptr<HestonProcess> hestonProcess(
+        new HestonProcess(rTS, qTS, s0, 0.04, 2.5, 0.04, 0.66, -0.8));
+
+    const ext::shared_ptr<Fdm1dMesher> xMesher(
+        new Concentrating1dMesher(std::log(100.0)-2.5, std::log(100.0)+2.5, 100,
+                                  std::pair<Real, Real>(std::log(100.0), 0.1)));
+    const ext::shared_ptr<Fdm1dMesher> vMesher(
+        new FdmHestonVarianceMesher(50, hestonProcess, 1.0));
+    const ext::shared_ptr<FdmMesher> mesher(
+        new FdmMesherComposite(xMesher, vMesher));
+    const ext::shared_ptr<FdmLinearOpLayout> layout = mesher->layout();
+
+    ext::shared_ptr<FdmLinearOpComposite> hestonOp(
+        new FdmHestonOp(mesher, hestonProcess));
+
+    Array payoff(layout->size());
+    for (const auto& iter : *layout)
+        payoff[iter.index()] = std::max(
+            std::exp(mesher->location(iter, 0)) - 100.0, 0.0);
+
+    ImplicitEulerScheme splitting(hestonOp);
+    ImplicitEulerScheme multigrid(hestonOp, ImplicitEulerScheme::bc_set(), 1e-8,
+                                  ImplicitEulerScheme::BiCGstab,
+                                  ImplicitEulerScheme::Multigrid);
+
+    const Time dt = 0.1;
+    splitting.setStep(dt);
+    multigrid.setStep(dt);
+
+    Array expected = payoff, calculated = payoff;
+    for (Time t = 1.0; t > 0.05; t -= dt) {
+        splitting.step(expected, t);
+        multigrid.step(calculated, t);
+    }
+
+    for (Size i=0; i < expected.size(); ++i) {
+        if (std::fabs(expected[i] - calculated[i]) > 1e-5)
+            BOOST_FAIL("multigrid-preconditioned implicit-Euler scheme "
+                       "differs from splitting-preconditioned one at " << i <<
+                       "\n    expected:   " << expected[i] <<
+                       "\n    calculated: " << calculated[i]);
+    }
+
+    if (multigrid.numberOfIterations() >= splitting.numberOfIterations())
+        BOOST_FAIL("multigrid preconditioner does not reduce "
+                   "the number of iterations" <<
+                   "\n    splitting: " << splitting.numberOfIterations() <<
+                   "\n    multigrid: " << multigrid.numberOfIterations());
+
+    // the operator doesn't depend on time, so the preconditioner
+    // is only set up again when the step changes
+    if (multigrid.numberOfPreconditionerSetups() != 1)
+        BOOST_FAIL("multigrid preconditioner set up more than once "
+                   "for a constant system matrix" <<
+                   "\n    setups: " << multigrid.numberOfPreconditionerSetups());
+
+    multigrid.setStep(0.5*dt);
+    multigrid.step(calculated, 0.5*dt);
+    if (multigrid.numberOfPreconditionerSetups() != 2)
+        BOOST_FAIL("multigrid preconditioner not set up again "
+                   "after a change of step" <<
+                   "\n    setups: " << multigrid.numberOfPreconditionerSetups());
+
+    // the solver counts the setups of the schemes it copies
+    const FdmSchemeDesc schemeDesc = FdmSchemeDesc::ImplicitEuler()
+        .withPreconditioner(FdmSchemeDesc::MultigridPreconditioner);
+    const ext::shared_ptr<FdmStepConditionComposite> noConditions(
+        new FdmStepConditionComposite(std::list<std::vector<Time> >(),
+                                      FdmStepConditionComposite::Conditions()));
+    const Size steps = 10;
+
+    FdmBackwardSolver solver(hestonOp, FdmBoundaryConditionSet(),
+                             noConditions, schemeDesc);
+    Array rolledBack = payoff;
+    solver.rollback(rolledBack, 1.0, 0.0, steps, 0);
+    if (solver.preconditionerSetups() != 1)
+        BOOST_FAIL("multigrid preconditioner set up more than once "
+                   "during a rollback with a constant operator" <<
+                   "\n    setups: " << solver.preconditionerSetups());
+
+    // an operator depending on time needs a setup at each step
+    const Date today = Settings::instance().evaluationDate();
+    std::vector<Date> dates;
+    std::vector<Rate> rates;
+    for (Size i=0; i <= 5; ++i) {
+        dates.push_back(today + Period(i, Years));
+        rates.push_back(0.03 + 0.005*i);
+    }
+    const Handle<YieldTermStructure> zeroTS(
+        ext::make_shared<ZeroCurve>(dates, rates, Actual365Fixed()));
+    ext::shared_ptr<FdmLinearOpComposite> timeDependentOp(
+        new FdmHestonOp(mesher, ext::make_shared<HestonProcess>(
+            zeroTS, qTS, s0, 0.04, 2.5, 0.04, 0.66, -0.8)));
+
+    FdmBackwardSolver timeDependentSolver(
+        timeDependentOp, FdmBoundaryConditionSet(), noConditions, schemeDesc);
+    rolledBack = payoff;
+    timeDependentSolver.rollback(rolledBack, 1.0, 0.0, steps, 0);
+    if (timeDependentSolver.preconditionerSetups() != steps)
+        BOOST_FAIL("multigrid preconditioner not set up at each step "
+                   "for an operator depending on time" <<
+                   "\n    setups: " << timeDependentSolver.preconditionerSetups()
+                   << "\n    steps:  " << steps);
+}
+
 BOOST_AUTO_TEST_CASE(testCrankNicolsonWithDamping) {
 
     BOOST_TEST_MESSAGE("Testing Crank-Nicolson with initial implicit damping steps "
@@ -1377,6 +1852,118 @@ BOOST_AUTO_TEST_CASE(testCrankNicolsonWithDamping) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testAdaptiveTimeSteps) {
+
+    BOOST_TEST_MESSAGE("Testing adaptive time steps for an American option...");
+
+    DayCounter dc = Actual360();
+    Date today = Date::todaysDate();
+
+    ext::shared_ptr<SimpleQuote> spot(new SimpleQuote(100.0));
+    ext::shared_ptr<YieldTermStructure> qTS = flatRate(today, 0.0, dc);
+    ext::shared_ptr<YieldTermStructure> rTS = flatRate(today, 0.06, dc);
+    ext::shared_ptr<BlackVolTermStructure> volTS = flatVol(today, 0.3, dc);
+
+    ext::shared_ptr<BlackScholesMertonProcess> process(new
+        BlackScholesMertonProcess(Handle<Quote>(spot),
+                                  Handle<YieldTermStructure>(qTS),
+                                  Handle<YieldTermStructure>(rTS),
+                                  Handle<BlackVolTermStructure>(volTS)));
+
+    ext::shared_ptr<StrikedTypePayoff> payoff(
+                                 new PlainVanillaPayoff(Option::Put, 100.0));
+
+    const Time maturity = 1.0;
+    const std::vector<Size> dim(1, 200);
+
+    ext::shared_ptr<FdmLinearOpLayout> layout(new FdmLinearOpLayout(dim));
+    const ext::shared_ptr<Fdm1dMesher> equityMesher(
+        new FdmBlackScholesMesher(
+                dim[0], process, maturity, payoff->strike(),
+                Null<Real>(), Null<Real>(), 0.0001, 1.5,
+                std::pair<Real, Real>(payoff->strike(), 0.1)));
+
+    const ext::shared_ptr<FdmMesher> mesher(
+        new FdmMesherComposite(equityMesher));
+
+    ext::shared_ptr<FdmBlackScholesOp> map(
+                     new FdmBlackScholesOp(mesher, process, payoff->strike()));
+
+    ext::shared_ptr<FdmInnerValueCalculator> calculator(
+                                  new FdmLogInnerValue(payoff, mesher, 0));
+
+    // the stopping times don't change the American condition, but
+    // the steps must end on them
+    const std::vector<Time> stoppingTimes = {0.3, 0.6};
+    ext::shared_ptr<FdmStepConditionComposite> conditions(
+        new FdmStepConditionComposite(
+            std::list<std::vector<Time> >(1, stoppingTimes),
+            FdmStepConditionComposite::Conditions(1,
+                ext::make_shared<FdmAmericanStepCondition>(
+                    mesher, calculator))));
+
+    Array payoffValues(layout->size()), x(layout->size());
+    for (const auto& iter : *layout) {
+        payoffValues[iter.index()] = calculator->avgInnerValue(iter, maturity);
+        x[iter.index()] = mesher->location(iter, 0);
+    }
+
+    const auto price = [&](const Array& values) {
+        MonotonicCubicNaturalSpline spline(x.begin(), x.end(), values.begin());
+        return spline(std::log(spot->value()));
+    };
+
+    Array expected = payoffValues;
+    FdmBackwardSolver(map, FdmBoundaryConditionSet(), conditions,
+                      FdmSchemeDesc::Douglas())
+        .rollback(expected, maturity, 0.0, 2000, 0);
+    const Real expectedPV = price(expected);
+
+    const Size steps = 25, dampingSteps = 2;
+    Real previousError = Null<Real>();
+    for (Real tolerance : {0.1, 0.01}) {
+        Array adaptive = payoffValues;
+        FdmBackwardSolver solver(map, FdmBoundaryConditionSet(), conditions,
+                                 FdmSchemeDesc::Douglas()
+                                     .withAdaptiveSteps(tolerance));
+        solver.rollback(adaptive, maturity, 0.0, steps, dampingSteps);
+        const Real error = std::fabs(price(adaptive) - expectedPV);
+
+        const std::vector<Time>& stepTimes = solver.stepTimes();
+        if (stepTimes.size() < 2
+            || stepTimes.front() != maturity || stepTimes.back() != 0.0)
+            BOOST_FAIL("adaptive steps do not span the rollback period");
+
+        for (Size i=1; i < stepTimes.size(); ++i) {
+            if (stepTimes[i] >= stepTimes[i-1])
+                BOOST_FAIL("adaptive step times are not decreasing");
+        }
+        for (Time t : stoppingTimes) {
+            if (std::find(stepTimes.begin(), stepTimes.end(), t) == stepTimes.end())
+                BOOST_FAIL("adaptive steps miss the stopping time " << t);
+        }
+
+        // each trial step costs one evolver step, except for the few
+        // ones estimated by step doubling, which cost three
+        const Size trialSteps = stepTimes.size() - 1 + solver.rejectedSteps();
+        if (solver.evolverSteps() < trialSteps
+            || (tolerance < 0.1 && solver.evolverSteps() > 1.5*trialSteps))
+            BOOST_FAIL("unexpected number of evolver steps" <<
+                       "\n tolerance:        " << tolerance <<
+                       "\n adaptive steps:   " << stepTimes.size() - 1 <<
+                       "\n rejected steps:   " << solver.rejectedSteps() <<
+                       "\n evolver steps:    " << solver.evolverSteps());
+
+        if (previousError != Null<Real>() && error > 0.5*previousError)
+            BOOST_FAIL("adaptive error does not decrease with the tolerance" <<
+                       "\n expected:         " << expectedPV <<
+                       "\n tolerance:        " << tolerance <<
+                       "\n error:            " << error <<
+                       "\n previous error:   " << previousError);
+        previousError = error;
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testSpareMatrixReference) {
     BOOST_TEST_MESSAGE("Testing SparseMatrixReference type...");
 
@@ -48,6 +48,7 @@
 #include <ql/utilities/dataformatters.hpp>
 #include <ql/utilities/null.hpp>
 #include <cmath>
+#include <limits>
 #include <utility>
 #include <tuple>
 
@@ -2376,6 +2377,64 @@ BOOST_AUTO_TEST_CASE(testBackwardFlatOnSinglePoint) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testHintedLocate) {
+    BOOST_TEST_MESSAGE("Testing interpolation lookups in different orders...");
+
+    const Size n = 41;
+    std::vector<Real> uniform(n), nonUniform(n), y(n);
+    for (Size i=0; i<n; ++i) {
+        uniform[i] = 0.25*i;
+        nonUniform[i] = 0.01*i*i;
+        y[i] = std::sin(0.3*i);
+    }
+
+    for (const auto& x : {uniform, nonUniform}) {
+        const Interpolation f = LinearInterpolation(x.begin(), x.end(), y.begin());
+
+        // increasing points including the nodes, then decreasing
+        // ones, then points in scattered order
+        std::vector<Real> points(x.begin(), x.end());
+        const Real xMin = x.front() - 0.5, xMax = x.back() + 0.5;
+        for (Size k=0; k<=1000; ++k)
+            points.push_back(xMin + (xMax - xMin) * k / 1000.0);
+        std::sort(points.begin(), points.end());
+        points.insert(points.end(), points.rbegin(), points.rend());
+        for (Size k=0; k<1000; ++k)
+            points.push_back(xMin + (xMax - xMin) * ((k * 7919) % 1000) / 1000.0);
+
+        std::vector<Real> calculated(points.size());
+        f.values(points.begin(), points.end(), calculated.begin(), true);
+
+        for (Size k=0; k<points.size(); ++k) {
+            const Real z = points[k];
+            const Size i = std::min<Size>(
+                std::max<Integer>(
+                    std::upper_bound(x.begin(), x.end()-1, z) - x.begin() - 1, 0),
+                n-2);
+            const Real expected =
+                y[i] + (z - x[i]) * (y[i+1] - y[i]) / (x[i+1] - x[i]);
+            if (!close_enough(calculated[k], expected)) {
+                BOOST_FAIL("failed to reproduce linear interpolation"
+                           << std::setprecision(12)
+                           << "\n    x:          " << z
+                           << "\n    calculated: " << calculated[k]
+                           << "\n    expected:   " << expected);
+            }
+        }
+
+        // NaN and points far outside the range take the slow path
+        if (!std::isnan(f(std::numeric_limits<Real>::quiet_NaN(), true)))
+            BOOST_FAIL("NaN not propagated by the interpolation");
+        for (Real z : {-1.0e30, 1.0e30}) {
+            const Size i = z < 0.0 ? 0 : n-2;
+            const Real expected =
+                y[i] + (z - x[i]) * (y[i+1] - y[i]) / (x[i+1] - x[i]);
+            if (!close_enough(f(z, true), expected))
+                BOOST_FAIL("failed to extrapolate at " << z);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testChebyshevInterpolation) {
     BOOST_TEST_MESSAGE("Testing Chebyshev interpolation...");
 
@@ -32,6 +32,7 @@
 #include <ql/math/randomnumbers/randomizedlds.hpp>
 #include <ql/math/randomnumbers/randomsequencegenerator.hpp>
 #include <ql/math/randomnumbers/sobolrsg.hpp>
+#include <ql/math/randomnumbers/sobolbrownianbridgersg.hpp>
 #include <ql/utilities/dataformatters.hpp>
 #include <ql/math/randomnumbers/latticerules.hpp>
 #include <ql/math/randomnumbers/latticersg.hpp>
@@ -1068,6 +1069,45 @@ BOOST_AUTO_TEST_CASE(testSobolSkipping) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testSobolBrownianBridgeSkipping) {
+
+    BOOST_TEST_MESSAGE("Testing Sobol Brownian-bridge sequence skipping...");
+
+    const Size factors = 3, steps = 8;
+    const std::uint32_t skip[] = { 0, 1, 42, 1000 };
+
+    for (std::uint32_t k : skip) {
+        SobolBrownianBridgeRsg rsg1(factors, steps);
+        Burley2020SobolBrownianBridgeRsg brsg1(factors, steps);
+        for (Size l = 0; l < k; l++) {
+            rsg1.nextSequence();
+            brsg1.nextSequence();
+        }
+
+        SobolBrownianBridgeRsg rsg2(factors, steps);
+        rsg2.skipTo(k);
+        Burley2020SobolBrownianBridgeRsg brsg2(factors, steps);
+        brsg2.skipTo(k);
+
+        for (Size m = 0; m < 10; m++) {
+            const std::vector<Real>& s1 = rsg1.nextSequence().value;
+            const std::vector<Real>& s2 = rsg2.nextSequence().value;
+            const std::vector<Real>& b1 = brsg1.nextSequence().value;
+            const std::vector<Real>& b2 = brsg2.nextSequence().value;
+            for (Size n = 0; n < s1.size(); n++) {
+                if (s1[n] != s2[n])
+                    BOOST_ERROR("Mismatch after skipping:"
+                                << "\n  skipped:  " << k << "\n  at index: " << n
+                                << "\n  expected: " << s1[n] << "\n  found:    " << s2[n]);
+                if (b1[n] != b2[n])
+                    BOOST_ERROR("Mismatch after skipping scrambled sequence:"
+                                << "\n  skipped:  " << k << "\n  at index: " << n
+                                << "\n  expected: " << b1[n] << "\n  found:    " << b2[n]);
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testHighDimensionalIntegrals, *precondition(if_speed(Slow))) {
     BOOST_TEST_MESSAGE("Testing high-dimensional integrals...");
 
@@ -222,6 +222,202 @@ BOOST_AUTO_TEST_CASE(testAmericanOption, *precondition(if_speed(Fast))) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testMultiThreadedAmericanOption, *precondition(if_speed(Fast))) {
+    BOOST_TEST_MESSAGE("Testing multi-threaded Monte-Carlo pricing of American options...");
+
+    const Date today(15, May, 1998);
+    Settings::instance().evaluationDate() = today;
+    const DayCounter dayCounter = Actual365Fixed();
+
+    ext::shared_ptr<Exercise> americanExercise(
+        new AmericanExercise(today, today + Period(1, Years)));
+    ext::shared_ptr<StrikedTypePayoff> payoff(
+        new PlainVanillaPayoff(Option::Put, 40.0));
+    VanillaOption americanOption(payoff, americanExercise);
+
+    ext::shared_ptr<GeneralizedBlackScholesProcess> stochasticProcess(
+        new GeneralizedBlackScholesProcess(
+            Handle<Quote>(ext::make_shared<SimpleQuote>(36.0)),
+            Handle<YieldTermStructure>(
+                ext::make_shared<FlatForward>(today, 0.0, dayCounter)),
+            Handle<YieldTermStructure>(
+                ext::make_shared<FlatForward>(today, 0.06, dayCounter)),
+            Handle<BlackVolTermStructure>(
+                ext::make_shared<BlackConstantVol>(today, NullCalendar(),
+                                                   0.20, dayCounter))));
+
+    americanOption.setPricingEngine(ext::shared_ptr<PricingEngine>(
+        new FdBlackScholesVanillaEngine(stochasticProcess, 401, 200)));
+    const Real expected = americanOption.NPV();
+
+    Real calculated[2];
+    for (Real& npv : calculated) {
+        americanOption.setPricingEngine(
+            MakeMCAmericanEngine<PseudoRandom>(stochasticProcess)
+            .withSteps(50)
+            .withAntitheticVariate()
+            .withSamples(20000)
+            .withSeed(42)
+            .withPolynomialOrder(3)
+            .withThreads(4));
+        npv = americanOption.NPV();
+    }
+    const Real errorEstimate = americanOption.errorEstimate();
+
+    if (std::fabs(calculated[0] - expected) > 3.0*errorEstimate) {
+        BOOST_ERROR("Failed to reproduce american option price with 4 threads"
+                    << "\n    expected:   " << expected
+                    << "\n    calculated: " << calculated[0]
+                    << " +/- " << errorEstimate);
+    }
+
+    if (calculated[0] != calculated[1]) {
+        BOOST_ERROR("Failed to reproduce multi-threaded american option price"
+                    << std::setprecision(16)
+                    << "\n    first run:  " << calculated[0]
+                    << "\n    second run: " << calculated[1]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testCalibrationWithoutStoredPaths) {
+    BOOST_TEST_MESSAGE("Testing Longstaff-Schwartz calibration without storing paths...");
+
+    const Date today(15, May, 1998);
+    Settings::instance().evaluationDate() = today;
+    const DayCounter dayCounter = Actual365Fixed();
+
+    ext::shared_ptr<Exercise> americanExercise(
+        new AmericanExercise(today, today + Period(1, Years)));
+    ext::shared_ptr<StrikedTypePayoff> payoff(
+        new PlainVanillaPayoff(Option::Put, 40.0));
+    VanillaOption americanOption(payoff, americanExercise);
+
+    ext::shared_ptr<GeneralizedBlackScholesProcess> stochasticProcess(
+        new GeneralizedBlackScholesProcess(
+            Handle<Quote>(ext::make_shared<SimpleQuote>(36.0)),
+            Handle<YieldTermStructure>(
+                ext::make_shared<FlatForward>(today, 0.0, dayCounter)),
+            Handle<YieldTermStructure>(
+                ext::make_shared<FlatForward>(today, 0.06, dayCounter)),
+            Handle<BlackVolTermStructure>(
+                ext::make_shared<BlackConstantVol>(today, NullCalendar(),
+                                                   0.20, dayCounter))));
+
+    // the same data are regressed whether paths are stored or not
+    for (Size threads : {1, 3}) {
+        Real calculated[2];
+        for (Size i=0; i<2; ++i) {
+            americanOption.setPricingEngine(
+                MakeMCAmericanEngine<PseudoRandom>(stochasticProcess)
+                .withSteps(25)
+                .withAntitheticVariate()
+                .withSamples(5000)
+                .withCalibrationSamples(4000)
+                .withSeed(42)
+                .withPolynomialOrder(3)
+                .withThreads(threads)
+                .withStoredCalibrationPaths(i == 0));
+            calculated[i] = americanOption.NPV();
+        }
+
+        if (calculated[0] != calculated[1]) {
+            BOOST_ERROR("Failed to reproduce american option price "
+                        "without stored calibration paths"
+                        << std::setprecision(16)
+                        << "\n    threads:          " << threads
+                        << "\n    stored paths:     " << calculated[0]
+                        << "\n    regression data:  " << calculated[1]);
+        }
+    }
+}
+
+class RecordingPathPricer : public LongstaffSchwartzPathPricer<Path> {
+  public:
+    using LongstaffSchwartzPathPricer<Path>::LongstaffSchwartzPathPricer;
+    std::vector<std::vector<Real> > states;
+  protected:
+    void post_processing(const Size,
+                         const std::vector<Real>& state,
+                         const std::vector<Real>&,
+                         const std::vector<Real>&) override {
+        states.push_back(state);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(testCalibrationThreads) {
+    BOOST_TEST_MESSAGE("Testing Longstaff-Schwartz calibration "
+                       "on several threads...");
+
+    const Date today(15, May, 1998);
+    Settings::instance().evaluationDate() = today;
+    const DayCounter dayCounter = Actual365Fixed();
+
+    const ext::shared_ptr<YieldTermStructure> riskFreeRate =
+        ext::make_shared<FlatForward>(today, 0.06, dayCounter);
+    ext::shared_ptr<GeneralizedBlackScholesProcess> stochasticProcess(
+        new GeneralizedBlackScholesProcess(
+            Handle<Quote>(ext::make_shared<SimpleQuote>(36.0)),
+            Handle<YieldTermStructure>(
+                ext::make_shared<FlatForward>(today, 0.0, dayCounter)),
+            Handle<YieldTermStructure>(riskFreeRate),
+            Handle<BlackVolTermStructure>(
+                ext::make_shared<BlackConstantVol>(today, NullCalendar(),
+                                                   0.20, dayCounter))));
+    const ext::shared_ptr<Payoff> payoff =
+        ext::make_shared<PlainVanillaPayoff>(Option::Put, 40.0);
+
+    const Size steps = 25;
+    const TimeGrid grid(1.0, steps);
+    const PathGenerator<PseudoRandom::rsg_type> generator(
+        stochasticProcess, grid,
+        PseudoRandom::make_sequence_generator(steps, 42), false);
+
+    std::vector<Path> calibrationPaths, pricingPaths;
+    for (Size j=0; j<2000; ++j)
+        calibrationPaths.push_back(generator.next().value);
+    for (Size j=0; j<200; ++j)
+        pricingPaths.push_back(generator.next().value);
+
+    // the regression data, and therefore the exercise strategy and
+    // the states passed to post_processing, don't depend on the
+    // number of threads or on the calibration paths being stored
+    std::vector<Real> expectedPrices;
+    std::vector<std::vector<Real> > expectedStates;
+    for (Size threads : {1, 3}) {
+        for (bool storePaths : {true, false}) {
+            RecordingPathPricer pricer(
+                grid,
+                ext::make_shared<AmericanPathPricer>(
+                    payoff, 3, LsmBasisSystem::Monomial),
+                riskFreeRate);
+            pricer.storeCalibrationPaths(storePaths);
+            pricer.setCalibrationThreads(threads);
+            for (const auto& path : calibrationPaths)
+                pricer(path);
+            pricer.calibrate();
+
+            std::vector<Real> prices;
+            for (const auto& path : pricingPaths)
+                prices.push_back(pricer(path));
+
+            if (expectedPrices.empty()) {
+                expectedPrices = prices;
+                expectedStates = pricer.states;
+                continue;
+            }
+
+            if (prices != expectedPrices)
+                BOOST_ERROR("Failed to reproduce path prices"
+                            << "\n    threads:      " << threads
+                            << "\n    stored paths: " << storePaths);
+            if (pricer.states != expectedStates)
+                BOOST_ERROR("Failed to reproduce post-processed states"
+                            << "\n    threads:      " << threads
+                            << "\n    stored paths: " << storePaths);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testAmericanMaxOption) {
 
     // reference values taken from
@@ -17,10 +17,14 @@
  FOR A PARTICULAR PURPOSE.  See the license for more details.
 */
 
+#include "preconditions.hpp"
 #include "toplevelfixture.hpp"
 #include "utilities.hpp"
 #include <ql/indexes/ibor/euribor.hpp>
+#include <ql/instruments/compositeinstrument.hpp>
+#include <ql/instruments/makevanillaswap.hpp>
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <ql/patterns/lazyobject.hpp>
 #include <ql/patterns/observable.hpp>
 #include <ql/quotes/simplequote.hpp>
 #include <ql/termstructures/volatility/capfloor/capfloortermvolsurface.hpp>
@@ -180,6 +184,168 @@ BOOST_AUTO_TEST_CASE(testObservableSettings) {
    }
 }
 
+#ifndef QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN
+
+class ForwardingNode : public Observable, public Observer {
+  public:
+    explicit ForwardingNode(std::vector<const ForwardingNode*>& log) : log_(log) {}
+    void update() override {
+        ++counter_;
+        log_.push_back(this);
+        notifyObservers();
+    }
+    Size counter() const { return counter_; }
+
+  private:
+    std::vector<const ForwardingNode*>& log_;
+    Size counter_ = 0;
+};
+
+BOOST_AUTO_TEST_CASE(testNotificationTransaction) {
+
+    BOOST_TEST_MESSAGE("Testing notification transactions...");
+
+    RestoreUpdates guard;
+
+    // q1 -> a -> b -> c, with q2 -> b and q2 -> c
+    std::vector<const ForwardingNode*> log;
+    auto q1 = ext::make_shared<SimpleQuote>(1.0);
+    auto q2 = ext::make_shared<SimpleQuote>(2.0);
+    auto a = ext::make_shared<ForwardingNode>(log);
+    auto b = ext::make_shared<ForwardingNode>(log);
+    auto c = ext::make_shared<ForwardingNode>(log);
+    a->registerWith(q1);
+    b->registerWith(a);
+    b->registerWith(q2);
+    c->registerWith(b);
+    c->registerWith(q2);
+
+    ObservableSettings& settings = ObservableSettings::instance();
+    settings.beginTransaction();
+    settings.beginTransaction();
+    for (Size i=0; i<10; ++i) {
+        q1->setValue(Real(i));
+        q2->setValue(Real(i));
+    }
+    settings.commitTransaction();
+
+    if (!settings.inTransaction() || !log.empty())
+        BOOST_FAIL("notifications sent before the outermost commit");
+
+    settings.commitTransaction();
+
+    if (settings.inTransaction() || !settings.updatesEnabled())
+        BOOST_FAIL("updates not enabled after commit");
+    if (a->counter() != 1 || b->counter() != 1 || c->counter() != 1)
+        BOOST_FAIL("observers not updated exactly once:"
+                   << "\n    a: " << a->counter()
+                   << "\n    b: " << b->counter()
+                   << "\n    c: " << c->counter());
+    if (log.size() != 3 || log[0] != a.get() || log[1] != b.get() || log[2] != c.get())
+        BOOST_FAIL("observers not updated in dependency order");
+
+    if (settings.transactionNotifications() != 30)
+        BOOST_FAIL("unexpected number of collected notifications: "
+                   << settings.transactionNotifications() << " instead of 30");
+    if (settings.transactionUpdates() != 3)
+        BOOST_FAIL("unexpected number of dispatched updates: "
+                   << settings.transactionUpdates() << " instead of 3");
+
+    // outside transactions, notifications are forwarded as usual
+    q2->setValue(0.5);
+    if (b->counter() != 2 || c->counter() != 3)
+        BOOST_FAIL("notifications not forwarded after the transaction");
+}
+
+class LazyNode : public LazyObject {
+  public:
+    LazyNode() { forwardFirstNotificationOnly(); }
+    void evaluate() const { calculate(); }
+
+  private:
+    void performCalculations() const override {}
+};
+
+BOOST_AUTO_TEST_CASE(testNotificationTransactionThroughLazyObjects) {
+
+    BOOST_TEST_MESSAGE("Testing notification transactions "
+                       "through lazy objects...");
+
+    RestoreUpdates guard;
+
+    // q -> lazy -> c
+    std::vector<const ForwardingNode*> log;
+    auto q = ext::make_shared<SimpleQuote>(1.0);
+    auto lazy = ext::make_shared<LazyNode>();
+    auto c = ext::make_shared<ForwardingNode>(log);
+    lazy->registerWith(q);
+    c->registerWith(lazy);
+
+    ObservableSettings& settings = ObservableSettings::instance();
+
+    // a lazy object which was not calculated doesn't forward
+    settings.beginTransaction();
+    q->setValue(2.0);
+    settings.commitTransaction();
+    if (c->counter() != 0)
+        BOOST_FAIL("notification forwarded by a lazy object "
+                   "which was not calculated");
+
+    // once calculated, it forwards the first notification only
+    lazy->evaluate();
+    settings.beginTransaction();
+    q->setValue(3.0);
+    settings.commitTransaction();
+    q->setValue(4.0);
+    if (c->counter() != 1)
+        BOOST_FAIL("lazy object forwarded " << c->counter()
+                   << " notifications instead of 1");
+
+    // the update mode can't be changed during a transaction
+    settings.beginTransaction();
+    BOOST_CHECK_THROW(settings.disableUpdates(true), Error);
+    BOOST_CHECK_THROW(settings.enableUpdates(), Error);
+    settings.commitTransaction();
+}
+
+BOOST_AUTO_TEST_CASE(testLongNotificationTransaction) {
+
+    BOOST_TEST_MESSAGE("Testing notification transactions "
+                       "along long chains of observers...");
+
+    RestoreUpdates guard;
+
+    // the chain is deeper than a recursive visit could go
+    const Size n = 200000;
+    std::vector<const ForwardingNode*> log;
+    auto q = ext::make_shared<SimpleQuote>(1.0);
+    std::vector<ext::shared_ptr<ForwardingNode> > chain;
+    for (Size i=0; i<n; ++i) {
+        chain.push_back(ext::make_shared<ForwardingNode>(log));
+        if (i == 0)
+            chain.back()->registerWith(q);
+        else
+            chain.back()->registerWith(chain[i-1]);
+    }
+
+    ObservableSettings& settings = ObservableSettings::instance();
+    settings.beginTransaction();
+    q->setValue(2.0);
+    settings.commitTransaction();
+
+    if (log.size() != n || log.front() != chain.front().get()
+        || log.back() != chain.back().get())
+        BOOST_FAIL("observers not updated once in dependency order: "
+                   << log.size() << " updates instead of " << n);
+
+    // each node owns the previous one through its registration, so
+    // the chain is released from its end to avoid nested destructions
+    while (!chain.empty())
+        chain.pop_back();
+}
+
+#endif
+
 
 #ifdef QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN
 
@@ -263,6 +429,150 @@ BOOST_AUTO_TEST_CASE(testMultiThreadingGlobalSettings) {
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(testMultiThreadedRegistrationAndNotification) {
+    BOOST_TEST_MESSAGE("Testing concurrent registration and notification "
+                       "of observers...");
+
+    RestoreUpdates guard;
+
+    const Size nObservers = 50;
+    const Size nNotifications = 20;
+
+    for (Size nThreads = 1; nThreads <= 64; nThreads *= 2) {
+        const ext::shared_ptr<SimpleQuote> shared(new SimpleQuote(0.0));
+        std::vector<std::vector<ext::shared_ptr<MTUpdateCounter> > >
+            observers(nThreads);
+
+        // every thread registers its own observers with a private
+        // and a shared quote, then notifies through the former
+        std::vector<std::thread> threads;
+        for (Size t=0; t < nThreads; ++t) {
+            threads.emplace_back([&, t]() {
+                const ext::shared_ptr<SimpleQuote> local(new SimpleQuote(0.0));
+                for (Size i=0; i < nObservers; ++i) {
+                    const ext::shared_ptr<MTUpdateCounter> observer(new MTUpdateCounter);
+                    observer->registerWith(local);
+                    observer->registerWith(shared);
+                    observers[t].push_back(observer);
+                }
+                for (Size j=0; j < nNotifications; ++j)
+                    local->setValue(Real(j+1));
+                for (const auto& observer : observers[t])
+                    observer->unregisterWith(local);
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        for (Size t=0; t < nThreads; ++t)
+            for (const auto& observer : observers[t])
+                if (observer->counter() != int(nNotifications))
+                    BOOST_FAIL("wrong number of notifications with "
+                               << nThreads << " threads: "
+                               << observer->counter() << " instead of "
+                               << nNotifications);
+
+        // deferred notifications of the shared quote are sent once
+        ObservableSettings::instance().disableUpdates(true);
+        threads.clear();
+        for (Size t=0; t < nThreads; ++t) {
+            threads.emplace_back([&, t]() {
+                for (Size j=0; j < nNotifications; ++j)
+                    shared->setValue(Real(t*nNotifications+j));
+                // half of the observers go away before the notification
+                for (Size i=0; i < nObservers/2; ++i)
+                    observers[t][i]->unregisterWith(shared);
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        ObservableSettings::instance().enableUpdates();
+
+        for (Size t=0; t < nThreads; ++t)
+            for (Size i=0; i < nObservers; ++i) {
+                const int expected = int(nNotifications) + (i < nObservers/2 ? 0 : 1);
+                if (observers[t][i]->counter() != expected)
+                    BOOST_FAIL("wrong number of deferred notifications with "
+                               << nThreads << " threads: "
+                               << observers[t][i]->counter() << " instead of "
+                               << expected);
+            }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testUnregistrationDuringDeferredNotification) {
+    BOOST_TEST_MESSAGE("Testing unregistration of observers while "
+                       "deferred notifications are sent...");
+
+    RestoreUpdates guard;
+
+    // each observer unregisters the other one when updated; since
+    // both are notified by the same deferred notification, the
+    // second one must not be updated any longer
+    class Unregistering : public Observer {
+      public:
+        explicit Unregistering(ext::shared_ptr<Observable> observable)
+        : observable_(std::move(observable)) {}
+        void update() override {
+            ++counter_;
+            if (other_ != nullptr)
+                other_->unregisterWith(observable_);
+        }
+        Unregistering* other_ = nullptr;
+        Size counter_ = 0;
+      private:
+        ext::shared_ptr<Observable> observable_;
+    };
+
+    const ext::shared_ptr<SimpleQuote> quote(new SimpleQuote(0.0));
+    const ext::shared_ptr<Unregistering> first(new Unregistering(quote));
+    const ext::shared_ptr<Unregistering> second(new Unregistering(quote));
+    first->other_ = second.get();
+    second->other_ = first.get();
+    first->registerWith(quote);
+    second->registerWith(quote);
+
+    ObservableSettings::instance().disableUpdates(true);
+    quote->setValue(1.0);
+    ObservableSettings::instance().enableUpdates();
+
+    if (first->counter_ + second->counter_ != 1)
+        BOOST_FAIL("unregistered observer notified: "
+                   << first->counter_ << " and " << second->counter_
+                   << " updates instead of 1 in total");
+}
+
+BOOST_AUTO_TEST_CASE(testConcurrentDuplicateRegistration) {
+    BOOST_TEST_MESSAGE("Testing concurrent duplicate registrations "
+                       "of an observer...");
+
+    const Size nThreads = 8;
+    const Size nRegistrations = 1000;
+
+    const ext::shared_ptr<SimpleQuote> quote(new SimpleQuote(0.0));
+    const ext::shared_ptr<MTUpdateCounter> observer(new MTUpdateCounter);
+
+    std::vector<std::thread> threads;
+    for (Size t=0; t < nThreads; ++t) {
+        threads.emplace_back([&]() {
+            for (Size i=0; i < nRegistrations; ++i)
+                observer->registerWith(quote);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    quote->setValue(1.0);
+    if (observer->counter() != 1)
+        BOOST_FAIL("observer updated " << observer->counter()
+                   << " times instead of once");
+
+    observer->unregisterWith(quote);
+    quote->setValue(2.0);
+    if (observer->counter() != 1)
+        BOOST_FAIL("unregistered observer notified");
+}
 #endif
 
 BOOST_AUTO_TEST_CASE(testDeepUpdate) {
@@ -318,6 +628,164 @@ BOOST_AUTO_TEST_CASE(testEmptyObserverList) {
     dummyObserver->unregisterWith(ext::make_shared<SimpleQuote>(10.0));
 }
 
+BOOST_AUTO_TEST_CASE(testManyObservers) {
+    BOOST_TEST_MESSAGE("Testing registration and notification of many observers...");
+
+    const Size nObservers = 10000;
+
+    const ext::shared_ptr<Observable> observable = ext::make_shared<Observable>();
+    std::vector<ext::shared_ptr<UpdateCounter> > observers(nObservers);
+    for (auto& observer : observers) {
+        observer = ext::make_shared<UpdateCounter>();
+        observer->registerWith(observable);
+    }
+
+    // registering again has no effect
+    for (auto& observer : observers) {
+        if (observer->registerWith(observable).second)
+            BOOST_FAIL("observer registered twice");
+    }
+
+    observable->notifyObservers();
+
+    // remove two observers out of three, either explicitly or by
+    // destroying them
+    for (Size i=0; i<nObservers; ++i) {
+        if (i % 3 == 1)
+            observers[i]->unregisterWith(observable);
+        else if (i % 3 == 2)
+            observers[i].reset();
+    }
+
+    observable->notifyObservers();
+
+    for (Size i=0; i<nObservers; ++i) {
+        Size expected = 0;
+        switch (i % 3) {
+          case 0:
+            expected = 2;
+            break;
+          case 1:
+            expected = 1;
+            break;
+          default:
+            continue;
+        }
+        if (observers[i]->counter() != expected)
+            BOOST_FAIL("observer " << i << " updated " << observers[i]->counter()
+                       << " times instead of " << expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testRegisteringTwice) {
+    BOOST_TEST_MESSAGE("Testing that registering twice with an observable "
+                       "has no effect...");
+
+    const ext::shared_ptr<SimpleQuote> quote = ext::make_shared<SimpleQuote>(0.0);
+    const ext::shared_ptr<UpdateCounter> other = ext::make_shared<UpdateCounter>();
+    other->registerWith(quote);
+
+    const ext::shared_ptr<UpdateCounter> observer = ext::make_shared<UpdateCounter>();
+    if (!observer->registerWith(quote).second)
+        BOOST_FAIL("first registration rejected");
+    if (observer->registerWith(quote).second)
+        BOOST_FAIL("observer registered twice");
+    observer->registerWithObservables(other);
+
+    quote->setValue(1.0);
+    if (observer->counter() != 1)
+        BOOST_FAIL("observer updated " << observer->counter()
+                   << " times instead of once");
+
+    // a single unregistration is enough
+    if (observer->unregisterWith(quote) != 1)
+        BOOST_FAIL("registered observable not found");
+    if (observer->unregisterWith(quote) != 0)
+        BOOST_FAIL("observable unregistered twice");
+
+    quote->setValue(2.0);
+    if (observer->counter() != 1)
+        BOOST_FAIL("unregistered observer notified");
+}
+
+BOOST_AUTO_TEST_CASE(testManyObservables) {
+    BOOST_TEST_MESSAGE("Testing registration of an observer "
+                       "with many observables...");
+
+    const Size nQuotes = 1000;
+
+    std::vector<ext::shared_ptr<SimpleQuote> > quotes(nQuotes);
+    const ext::shared_ptr<UpdateCounter> observer = ext::make_shared<UpdateCounter>();
+    for (auto& quote : quotes) {
+        quote = ext::make_shared<SimpleQuote>(0.0);
+        if (!observer->registerWith(quote).second)
+            BOOST_FAIL("first registration rejected");
+    }
+
+    // observers coming and going move the others around
+    {
+        std::vector<ext::shared_ptr<UpdateCounter> > others(3);
+        for (auto& other : others) {
+            other = ext::make_shared<UpdateCounter>();
+            for (const auto& quote : quotes)
+                other->registerWith(quote);
+        }
+    }
+
+    for (const auto& quote : quotes) {
+        if (observer->registerWith(quote).second)
+            BOOST_FAIL("observer registered twice");
+    }
+
+    for (Size i=1; i<nQuotes; i+=2) {
+        if (observer->unregisterWith(quotes[i]) != 1)
+            BOOST_FAIL("registered observable not found");
+        if (observer->unregisterWith(quotes[i]) != 0)
+            BOOST_FAIL("observable unregistered twice");
+    }
+
+    const ext::shared_ptr<UpdateCounter> copy =
+        ext::make_shared<UpdateCounter>(*observer);
+
+    for (const auto& quote : quotes)
+        quote->setValue(1.0);
+
+    if (observer->counter() != nQuotes/2)
+        BOOST_FAIL("observer updated " << observer->counter()
+                   << " times instead of " << nQuotes/2);
+    if (copy->counter() != nQuotes/2)
+        BOOST_FAIL("copied observer updated " << copy->counter()
+                   << " times instead of " << nQuotes/2);
+}
+
+BOOST_AUTO_TEST_CASE(testSwapPortfolio, *precondition(if_speed(Slow))) {
+    BOOST_TEST_MESSAGE("Testing registration of a large swap portfolio...");
+
+    const Size nSwaps = 100000;
+
+    const Date today = Settings::instance().evaluationDate();
+    RelinkableHandle<YieldTermStructure> curve(flatRate(today, 0.03, Actual365Fixed()));
+    const ext::shared_ptr<IborIndex> index = ext::make_shared<Euribor6M>(curve);
+
+    // the portfolio observes each of its swaps, and the index and
+    // the evaluation date are observed by each coupon
+    const ext::shared_ptr<CompositeInstrument> portfolio =
+        ext::make_shared<CompositeInstrument>();
+    portfolio->alwaysForwardNotifications();
+    for (Size i=0; i<nSwaps; ++i) {
+        ext::shared_ptr<VanillaSwap> swap =
+            MakeVanillaSwap(Period(1, Years), index, 0.03 + i * 1.0e-8);
+        portfolio->add(swap);
+    }
+
+    const ext::shared_ptr<UpdateCounter> observer = ext::make_shared<UpdateCounter>();
+    observer->registerWith(portfolio);
+
+    curve.linkTo(flatRate(today, 0.04, Actual365Fixed()));
+    if (observer->counter() == 0)
+        BOOST_FAIL("portfolio not notified of curve change");
+}
+
 BOOST_AUTO_TEST_CASE(testAddAndDeleteObserverDuringNotifyObservers) {
     BOOST_TEST_MESSAGE("Testing addition and deletion of observers during notifyObserver...");
 
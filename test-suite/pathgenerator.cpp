@@ -20,8 +20,13 @@
 #include "toplevelfixture.hpp"
 #include "utilities.hpp"
 #include <ql/methods/montecarlo/mctraits.hpp>
+#include <ql/methods/montecarlo/multipathbatchgenerator.hpp>
+#include <ql/processes/batesprocess.hpp>
 #include <ql/processes/blackscholesprocess.hpp>
+#include <ql/processes/g2process.hpp>
 #include <ql/processes/geometricbrownianprocess.hpp>
+#include <ql/processes/hestonprocess.hpp>
+#include <ql/processes/hullwhiteprocess.hpp>
 #include <ql/processes/ornsteinuhlenbeckprocess.hpp>
 #include <ql/processes/squarerootprocess.hpp>
 #include <ql/processes/stochasticprocessarray.hpp>
@@ -141,6 +146,55 @@ void testMultiple(const ext::shared_ptr<StochasticProcess>& process,
 }
 
 
+void testBatch(const ext::shared_ptr<StochasticProcess>& process,
+               const std::string& tag) {
+    typedef PseudoRandom::rsg_type rsg_type;
+
+    const Size paths = 9, steps = 6;
+    const Size n = process->size(), m = process->factors();
+    const TimeGrid grid(3.0, steps);
+    rsg_type rsg = PseudoRandom::make_sequence_generator(m*steps, 42);
+
+    std::vector<Array> single(paths, process->initialValues());
+    Array batch(n*paths), dw(m*paths);
+    for (Size i=0; i<n; ++i)
+        for (Size p=0; p<paths; ++p)
+            batch[i*paths+p] = single[p][i];
+
+    std::vector<Array> draws;
+    for (Size p=0; p<paths; ++p) {
+        const std::vector<Real>& sequence = rsg.nextSequence().value;
+        draws.emplace_back(sequence.begin(), sequence.end());
+    }
+
+    for (Size k=0; k<steps; ++k) {
+        const Time t = grid[k], dt = grid.dt(k);
+        Array w(m);
+        for (Size p=0; p<paths; ++p) {
+            std::copy(draws[p].begin()+k*m, draws[p].begin()+(k+1)*m,
+                      w.begin());
+            for (Size j=0; j<m; ++j)
+                dw[j*paths+p] = w[j];
+            single[p] = process->evolve(t, single[p], dt, w);
+        }
+        process->evolveBatch(t, paths, batch.begin(), dt, dw.begin());
+
+        for (Size p=0; p<paths; ++p) {
+            for (Size i=0; i<n; ++i) {
+                const Real expected = single[p][i];
+                const Real calculated = batch[i*paths+p];
+                if (std::fabs(calculated - expected)
+                        > 1e-14*std::max(1.0, std::fabs(expected)))
+                    BOOST_FAIL(tag << ": step " << k << ", path " << p
+                               << ", variable " << i << ":"
+                               << std::setprecision(16)
+                               << "\n    batched:    " << calculated
+                               << "\n    single:     " << expected);
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testPathGenerator) {
 
     BOOST_TEST_MESSAGE("Testing 1-D path generation against cached values...");
@@ -284,6 +338,184 @@ BOOST_AUTO_TEST_CASE(testMultiPathGenerator) {
     testMultiple(process, "square-root", result4, result4a);
 }
 
+BOOST_AUTO_TEST_CASE(testMultiPathBatchGenerator) {
+
+    BOOST_TEST_MESSAGE("Testing batched n-D path generation...");
+
+    Settings::instance().evaluationDate() = Date(26,April,2005);
+
+    Handle<Quote> x0(ext::shared_ptr<Quote>(new SimpleQuote(100.0)));
+    Handle<YieldTermStructure> r(flatRate(0.05, Actual360()));
+    Handle<YieldTermStructure> q(flatRate(0.02, Actual360()));
+    Handle<BlackVolTermStructure> sigma(flatVol(0.20, Actual360()));
+
+    Matrix correlation(3,3);
+    correlation[0][0] = 1.0; correlation[0][1] = 0.9; correlation[0][2] = 0.7;
+    correlation[1][0] = 0.9; correlation[1][1] = 1.0; correlation[1][2] = 0.4;
+    correlation[2][0] = 0.7; correlation[2][1] = 0.4; correlation[2][2] = 1.0;
+
+    std::vector<ext::shared_ptr<StochasticProcess1D> > processes = {
+        ext::make_shared<BlackScholesMertonProcess>(x0,q,r,sigma),
+        ext::make_shared<GeometricBrownianMotionProcess>(100.0, 0.03, 0.20),
+        ext::make_shared<SquareRootProcess>(0.1, 0.1, 0.20, 10.0)
+    };
+    ext::shared_ptr<StochasticProcess> process =
+        ext::make_shared<StochasticProcessArray>(processes, correlation);
+
+    typedef PseudoRandom::rsg_type rsg_type;
+
+    BigNatural seed = 42;
+    TimeGrid grid(10.0, 12);
+    Size assets = process->size();
+    Size batchSize = 7;
+    rsg_type rsg = PseudoRandom::make_sequence_generator(12*assets, seed);
+
+    MultiPathGenerator<rsg_type> generator(process, grid, rsg, false);
+    MultiPathBatchGenerator<rsg_type> batchGenerator(process, grid, rsg,
+                                                     batchSize);
+
+    // both generators consume a sequence per path; the one-path-at-a-time
+    // generator needs all the paths of a batch before the antithetics
+    for (Size k=0; k<3; ++k) {
+        std::vector<MultiPath> paths, antithetics;
+        for (Size p=0; p<batchSize; ++p) {
+            paths.push_back(generator.next().value);
+            antithetics.push_back(generator.antithetic().value);
+        }
+
+        const MultiPathBatch& batch = batchGenerator.next();
+        MultiPath path(assets, grid);
+        for (Size p=0; p<batchSize; ++p) {
+            batch.path(p, path);
+            for (Size j=0; j<assets; ++j) {
+                for (Size i=0; i<grid.size(); ++i) {
+                    if (path[j][i] != paths[p][j][i])
+                        BOOST_FAIL("batch " << k << ", path " << p
+                                   << ", asset " << j << ", time " << i
+                                   << ":" << std::setprecision(16)
+                                   << "\n    batched:    " << path[j][i]
+                                   << "\n    single:     " << paths[p][j][i]);
+                }
+            }
+        }
+
+        const MultiPathBatch& antithetic = batchGenerator.antithetic();
+        for (Size p=0; p<batchSize; ++p) {
+            for (Size j=0; j<assets; ++j) {
+                for (Size i=0; i<grid.size(); ++i) {
+                    if (antithetic(p, j, i) != antithetics[p][j][i])
+                        BOOST_FAIL("batch " << k << ", antithetic path " << p
+                                   << ", asset " << j << ", time " << i
+                                   << ":" << std::setprecision(16)
+                                   << "\n    batched:    " << antithetic(p, j, i)
+                                   << "\n    single:     " << antithetics[p][j][i]);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testBatchEvolution) {
+
+    BOOST_TEST_MESSAGE("Testing batch evolution of stochastic processes...");
+
+    Settings::instance().evaluationDate() = Date(26,April,2005);
+
+    Handle<Quote> x0(ext::shared_ptr<Quote>(new SimpleQuote(100.0)));
+    Handle<YieldTermStructure> r(flatRate(0.05, Actual360()));
+    Handle<YieldTermStructure> q(flatRate(0.02, Actual360()));
+    Handle<BlackVolTermStructure> sigma(flatVol(0.20, Actual360()));
+
+    testBatch(
+        ext::make_shared<BlackScholesMertonProcess>(x0,q,r,sigma),
+        "Black-Scholes-Merton");
+
+    const HestonProcess::Discretization schemes[] = {
+        HestonProcess::PartialTruncation,
+        HestonProcess::FullTruncation,
+        HestonProcess::Reflection,
+        HestonProcess::NonCentralChiSquareVariance,
+        HestonProcess::QuadraticExponential,
+        HestonProcess::QuadraticExponentialMartingale
+    };
+    for (auto scheme : schemes) {
+        std::ostringstream tag;
+        tag << "Heston (scheme " << Integer(scheme) << ")";
+        testBatch(
+            ext::make_shared<HestonProcess>(r, q, x0, 0.04, 1.5, 0.04,
+                                            0.6, -0.7, scheme),
+            tag.str());
+    }
+    testBatch(
+        ext::make_shared<BatesProcess>(r, q, x0, 0.04, 1.5, 0.04,
+                                       0.6, -0.7, 0.3, -0.05, 0.1),
+        "Bates");
+
+    testBatch(
+        ext::make_shared<HullWhiteProcess>(r, 0.1, 0.01), "Hull-White");
+    testBatch(
+        ext::make_shared<G2Process>(0.1, 0.01, 0.3, 0.015, -0.6), "G2");
+}
+
+BOOST_AUTO_TEST_CASE(testMultiPathBatchGeneratorWithBrownianBridge) {
+
+    BOOST_TEST_MESSAGE("Testing batched path generation "
+                       "with Brownian bridge...");
+
+    Settings::instance().evaluationDate() = Date(26,April,2005);
+
+    Handle<Quote> x0(ext::shared_ptr<Quote>(new SimpleQuote(100.0)));
+    Handle<YieldTermStructure> r(flatRate(0.05, Actual360()));
+    Handle<YieldTermStructure> q(flatRate(0.02, Actual360()));
+    Handle<BlackVolTermStructure> sigma(flatVol(0.20, Actual360()));
+
+    ext::shared_ptr<StochasticProcess1D> process =
+        ext::make_shared<BlackScholesMertonProcess>(x0,q,r,sigma);
+
+    typedef PseudoRandom::rsg_type rsg_type;
+
+    TimeGrid grid(1.0, 12);
+    Size batchSize = 5;
+    rsg_type rsg = PseudoRandom::make_sequence_generator(12, 42);
+
+    // with a single factor, the bridge is the same as in PathGenerator
+    PathGenerator<rsg_type> generator(process, grid, rsg, true);
+    MultiPathBatchGenerator<rsg_type> batchGenerator(process, grid, rsg,
+                                                     batchSize, true);
+
+    for (Size k=0; k<3; ++k) {
+        std::vector<Path> paths, antithetics;
+        for (Size p=0; p<batchSize; ++p) {
+            paths.push_back(generator.next().value);
+            antithetics.push_back(generator.antithetic().value);
+        }
+
+        const MultiPathBatch& batch = batchGenerator.next();
+        for (Size p=0; p<batchSize; ++p) {
+            for (Size i=0; i<grid.size(); ++i) {
+                if (batch(p, 0, i) != paths[p][i])
+                    BOOST_FAIL("batch " << k << ", path " << p
+                               << ", time " << i
+                               << ":" << std::setprecision(16)
+                               << "\n    batched:    " << batch(p, 0, i)
+                               << "\n    single:     " << paths[p][i]);
+            }
+        }
+
+        const MultiPathBatch& antithetic = batchGenerator.antithetic();
+        for (Size p=0; p<batchSize; ++p) {
+            for (Size i=0; i<grid.size(); ++i) {
+                if (antithetic(p, 0, i) != antithetics[p][i])
+                    BOOST_FAIL("batch " << k << ", antithetic path " << p
+                               << ", time " << i
+                               << ":" << std::setprecision(16)
+                               << "\n    batched:    " << antithetic(p, 0, i)
+                               << "\n    single:     " << antithetics[p][i]);
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -20,12 +20,16 @@
 #include "preconditions.hpp"
 #include "toplevelfixture.hpp"
 #include "utilities.hpp"
+#include <ql/cashflows/cashflows.hpp>
 #include <ql/cashflows/iborcoupon.hpp>
 #include <ql/indexes/bmaindex.hpp>
+#include <ql/indexes/ibor/estr.hpp>
 #include <ql/indexes/ibor/euribor.hpp>
 #include <ql/indexes/ibor/jpylibor.hpp>
 #include <ql/indexes/ibor/usdlibor.hpp>
+#include <ql/instruments/bonds/fixedratebond.hpp>
 #include <ql/instruments/forwardrateagreement.hpp>
+#include <ql/instruments/makeois.hpp>
 #include <ql/instruments/makevanillaswap.hpp>
 #include <ql/math/comparison.hpp>
 #include <ql/math/interpolations/backwardflatinterpolation.hpp>
@@ -38,9 +42,12 @@
 #include <ql/pricingengines/swap/discountingswapengine.hpp>
 #include <ql/quotes/simplequote.hpp>
 #include <ql/termstructures/globalbootstrap.hpp>
+#include <ql/termstructures/newtonbootstrap.hpp>
 #include <ql/termstructures/yield/bondhelpers.hpp>
 #include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/termstructures/yield/oisratehelper.hpp>
 #include <ql/termstructures/yield/piecewiseyieldcurve.hpp>
+#include <ql/termstructures/yield/pillarsensitivities.hpp>
 #include <ql/termstructures/yield/ratehelpers.hpp>
 #include <ql/time/asx.hpp>
 #include <ql/time/calendars/canada.hpp>
@@ -642,6 +649,179 @@ void testBMACurveConsistency(CommonVars& vars,
     }
 }
 
+template <class T, class I>
+void testPillarSensitivities(CommonVars& vars) {
+
+    typedef PiecewiseYieldCurve<T,I> Curve;
+    auto curve = ext::make_shared<Curve>(vars.settlement, vars.instruments,
+                                         Actual360());
+    RelinkableHandle<YieldTermStructure> curveHandle;
+    curveHandle.linkTo(curve);
+
+    auto euribor6m = ext::make_shared<Euribor6M>(curveHandle);
+    auto swapEngine = ext::make_shared<DiscountingSwapEngine>(curveHandle);
+    ext::shared_ptr<VanillaSwap> swap =
+        MakeVanillaSwap(7*Years, euribor6m, 0.035)
+        .withNominal(100.0)
+        .withPricingEngine(swapEngine);
+
+    Schedule schedule(vars.settlement, vars.settlement + 9*Years,
+                      Period(Annual), vars.calendar, Unadjusted, Unadjusted,
+                      DateGeneration::Backward, false);
+    auto bond = ext::make_shared<FixedRateBond>(
+        vars.bondSettlementDays, 100.0, schedule, std::vector<Rate>(1, 0.04),
+        vars.bondDayCounter);
+    auto bondEngine = ext::make_shared<DiscountingBondEngine>(curveHandle);
+    bond->setPricingEngine(bondEngine);
+
+    // gradients of the NPVs as calculated by the engines
+    const std::vector<std::pair<Date, Real> > swapGradient =
+        swapEngine->npvGradient(*swap);
+    const std::vector<std::pair<Date, Real> > bondGradient =
+        bondEngine->npvGradient(*bond);
+
+    const std::vector<Real> data = curve->data();
+    PillarSensitivities<Curve> sensitivities(curve);
+    const std::vector<Real> swapDeltas = sensitivities.sensitivities(swapGradient);
+    const std::vector<Real> bondDeltas = sensitivities.sensitivities(bondGradient);
+    // the curve itself is never bumped
+    BOOST_CHECK(curve->data() == data);
+    const auto& helpers = sensitivities.helpers();
+    BOOST_REQUIRE(helpers.size() == vars.instruments.size());
+
+    // compare with bump and rebuild
+    const Real h = 1.0e-6;
+    const Real tolerance = 5.0e-4;
+    for (Size j=0; j<helpers.size(); ++j) {
+        const auto k = std::find(vars.instruments.begin(),
+                                 vars.instruments.end(),
+                                 helpers[j]) - vars.instruments.begin();
+        BOOST_REQUIRE(Size(k) < vars.rates.size());
+        const ext::shared_ptr<SimpleQuote>& quote = vars.rates[k];
+        const Real value = quote->value();
+
+        quote->setValue(value + h);
+        const Real swapUp = swap->NPV(), bondUp = bond->NPV();
+        quote->setValue(value - h);
+        const Real swapDown = swap->NPV(), bondDown = bond->NPV();
+        quote->setValue(value);
+
+        const Real expectedSwap = (swapUp - swapDown) / (2.0*h);
+        const Real expectedBond = (bondUp - bondDown) / (2.0*h);
+        if (std::fabs(swapDeltas[j] - expectedSwap) > tolerance ||
+            std::fabs(bondDeltas[j] - expectedBond) > tolerance) {
+            BOOST_ERROR("failed to reproduce bump-and-rebuild sensitivities"
+                        << "\n    pillar:         " << helpers[j]->pillarDate()
+                        << std::setprecision(10)
+                        << "\n    swap adjoint:   " << swapDeltas[j]
+                        << "\n    swap bumped:    " << expectedSwap
+                        << "\n    bond adjoint:   " << bondDeltas[j]
+                        << "\n    bond bumped:    " << expectedBond
+                        << "\n    tolerance:      " << tolerance);
+        }
+    }
+}
+
+// forces the numerical path of PillarSensitivities
+class NumericalOISRateHelper : public OISRateHelper {
+  public:
+    using OISRateHelper::OISRateHelper;
+    bool impliedQuoteGradient(std::vector<Date>&,
+                              std::vector<Real>&) const override {
+        return false;
+    }
+    const YieldTermStructure* termStructure() const { return termStructure_; }
+};
+
+template <class Helper>
+void testFraAndOisPillarSensitivities(const CommonVars& vars) {
+
+    typedef PiecewiseYieldCurve<Discount,LogLinear> Curve;
+
+    RelinkableHandle<YieldTermStructure> curveHandle;
+    auto euribor3m = ext::make_shared<Euribor3M>();
+    auto estr = ext::make_shared<Estr>(curveHandle);
+
+    std::vector<ext::shared_ptr<SimpleQuote> > quotes;
+    std::vector<ext::shared_ptr<RateHelper> > helpers;
+    const Natural fraStarts[] = { 1, 3, 6, 9 };
+    for (Natural start : fraStarts) {
+        quotes.push_back(ext::make_shared<SimpleQuote>(0.030 + 0.0005*start/3));
+        helpers.push_back(ext::make_shared<FraRateHelper>(
+            Handle<Quote>(quotes.back()), start, euribor3m));
+    }
+    const Integer oisYears[] = { 2, 3, 5, 7, 10 };
+    for (Integer n : oisYears) {
+        quotes.push_back(ext::make_shared<SimpleQuote>(0.028 + 0.001*n));
+        helpers.push_back(ext::make_shared<Helper>(
+            2, n*Years, Handle<Quote>(quotes.back()),
+            ext::make_shared<Estr>()));
+    }
+
+    auto curve = ext::make_shared<Curve>(vars.settlement, helpers, Actual360());
+    curveHandle.linkTo(curve);
+
+    auto engine = ext::make_shared<DiscountingSwapEngine>(curveHandle);
+    ext::shared_ptr<OvernightIndexedSwap> ois =
+        MakeOIS(6*Years, estr, 0.032)
+        .withNominal(100.0)
+        .withPricingEngine(engine);
+    ext::shared_ptr<VanillaSwap> swap =
+        MakeVanillaSwap(4*Years, ext::make_shared<Euribor3M>(curveHandle), 0.033)
+        .withNominal(100.0)
+        .withPricingEngine(engine);
+
+    const std::vector<Real> data = curve->data();
+    PillarSensitivities<Curve> sensitivities(curve);
+    const std::vector<Real> oisDeltas =
+        sensitivities.sensitivities(engine->npvGradient(*ois));
+    const std::vector<Real> swapDeltas =
+        sensitivities.sensitivities(engine->npvGradient(*swap));
+    // the curve itself is never bumped...
+    BOOST_CHECK(curve->data() == data);
+    const auto& sortedHelpers = sensitivities.helpers();
+    BOOST_REQUIRE(sortedHelpers.size() == helpers.size());
+
+    const Real h = 1.0e-6;
+    const Real tolerance = 5.0e-4;
+    for (Size j=0; j<sortedHelpers.size(); ++j) {
+        const auto k = std::find(helpers.begin(), helpers.end(),
+                                 sortedHelpers[j]) - helpers.begin();
+        BOOST_REQUIRE(Size(k) < quotes.size());
+        const ext::shared_ptr<SimpleQuote>& quote = quotes[k];
+        const Real value = quote->value();
+
+        quote->setValue(value + h);
+        const Real oisUp = ois->NPV(), swapUp = swap->NPV();
+        quote->setValue(value - h);
+        const Real oisDown = ois->NPV(), swapDown = swap->NPV();
+        quote->setValue(value);
+
+        const Real expectedOis = (oisUp - oisDown) / (2.0*h);
+        const Real expectedSwap = (swapUp - swapDown) / (2.0*h);
+        if (std::fabs(oisDeltas[j] - expectedOis) > tolerance ||
+            std::fabs(swapDeltas[j] - expectedSwap) > tolerance) {
+            BOOST_ERROR("failed to reproduce bump-and-rebuild sensitivities"
+                        << "\n    pillar:         " << sortedHelpers[j]->pillarDate()
+                        << std::setprecision(10)
+                        << "\n    OIS adjoint:    " << oisDeltas[j]
+                        << "\n    OIS bumped:     " << expectedOis
+                        << "\n    swap adjoint:   " << swapDeltas[j]
+                        << "\n    swap bumped:    " << expectedSwap
+                        << "\n    tolerance:      " << tolerance);
+        }
+    }
+
+    // ...and the helpers repriced on its copy are linked back to it
+    sensitivities.sensitivities(engine->npvGradient(*ois));
+    for (const auto& helper : helpers) {
+        auto numerical = ext::dynamic_pointer_cast<NumericalOISRateHelper>(helper);
+        if (numerical != nullptr && numerical->termStructure() != curve.get())
+            BOOST_ERROR("helper not linked back to the curve"
+                        << "\n    pillar:         " << helper->pillarDate());
+    }
+}
+
 
 //Unstable
 //BOOST_AUTO_TEST_CASE(testLogCubicDiscountConsistency) {
@@ -779,6 +959,206 @@ BOOST_AUTO_TEST_CASE(testLocalBootstrapConsistency) {
                                               vars, ConvexMonotone(), 1.0e-7);
 }
 
+BOOST_AUTO_TEST_CASE(testNewtonBootstrapConsistency) {
+    BOOST_TEST_MESSAGE(
+        "Testing consistency of Newton-bootstrap algorithm...");
+
+    CommonVars vars;
+    testCurveConsistency<Discount,LogLinear,NewtonBootstrap>(vars);
+    testBMACurveConsistency<Discount,LogLinear,NewtonBootstrap>(vars);
+
+    testCurveConsistency<ZeroYield,Cubic,NewtonBootstrap>(
+                   vars,
+                   Cubic(CubicInterpolation::Spline, true,
+                         CubicInterpolation::SecondDerivative, 0.0,
+                         CubicInterpolation::SecondDerivative, 0.0));
+}
+
+BOOST_AUTO_TEST_CASE(testImpliedQuoteGradients) {
+    BOOST_TEST_MESSAGE(
+        "Testing analytic gradients of rate-helper implied quotes...");
+
+    CommonVars vars;
+
+    const Rate r = 0.03;
+    auto rate = ext::make_shared<SimpleQuote>(r);
+    FlatForward curve(vars.settlement, Handle<Quote>(rate), Actual360());
+
+    std::vector<ext::shared_ptr<RateHelper> > helpers = vars.instruments;
+    for (bool useIndexedFra : {true, false}) {
+        std::vector<ext::shared_ptr<RateHelper> > fras =
+            vars.fraHelpers(useIndexedFra);
+        helpers.insert(helpers.end(), fras.begin(), fras.end());
+    }
+
+    // overnight-indexed swaps, with and without exogenous discounting
+    auto estr = ext::make_shared<Estr>();
+    auto discountRate = ext::make_shared<SimpleQuote>(0.025);
+    Handle<YieldTermStructure> exogenousDiscount(
+        ext::make_shared<FlatForward>(vars.settlement,
+                                      Handle<Quote>(discountRate),
+                                      Actual360()));
+    Handle<Quote> oisRate(ext::make_shared<SimpleQuote>(0.03));
+    for (Integer years : {1, 5}) {
+        helpers.push_back(ext::make_shared<OISRateHelper>(
+            2, years*Years, oisRate, estr));
+        helpers.push_back(ext::make_shared<OISRateHelper>(
+            2, years*Years, oisRate, estr, exogenousDiscount));
+    }
+    helpers.push_back(ext::make_shared<OISRateHelper>(
+        2, 3*Years, oisRate, estr, Handle<YieldTermStructure>(), true));
+    // forward-starting, so that the looked-back fixings are
+    // after the reference date of the curve
+    helpers.push_back(ext::make_shared<OISRateHelper>(
+        2, 2*Years, oisRate, estr, Handle<YieldTermStructure>(), false, 0,
+        Following, Annual, Calendar(), 1*Months, 0.0,
+        Pillar::LastRelevantDate, Date(), RateAveraging::Compound,
+        ext::nullopt, ext::nullopt, Calendar(), 2));
+    helpers.push_back(ext::make_shared<OISRateHelper>(
+        2, 2*Years, oisRate, estr, Handle<YieldTermStructure>(), false, 0,
+        Following, Annual, Calendar(), 0*Days, 0.0,
+        Pillar::LastRelevantDate, Date(), RateAveraging::Compound,
+        ext::nullopt, ext::nullopt, Calendar(), Null<Natural>(), 2));
+    helpers.push_back(ext::make_shared<DatedOISRateHelper>(
+        vars.settlement + 3*Months, vars.settlement + 27*Months,
+        oisRate, estr));
+
+    const Real h = 1.0e-5;
+    const Real tolerance = 1.0e-8;
+    for (const auto& helper : helpers) {
+        helper->setTermStructure(&curve);
+
+        std::vector<Date> dates;
+        std::vector<Real> gradient;
+        if (!helper->impliedQuoteGradient(dates, gradient)) {
+            BOOST_ERROR("no analytic gradient for the helper with pillar "
+                        << helper->pillarDate());
+            continue;
+        }
+
+        // derivative with respect to the flat rate
+        Real calculated = 0.0;
+        for (Size i=0; i<dates.size(); ++i)
+            calculated -= gradient[i] * curve.timeFromReference(dates[i])
+                * curve.discount(dates[i]);
+
+        rate->setValue(r + h);
+        const Real up = helper->impliedQuote();
+        rate->setValue(r - h);
+        const Real down = helper->impliedQuote();
+        rate->setValue(r);
+        const Real expected = (up - down) / (2.0 * h);
+
+        if (std::fabs(calculated - expected) > tolerance) {
+            BOOST_ERROR("failed to reproduce implied-quote sensitivity"
+                        << "\n    pillar:     " << helper->pillarDate()
+                        << std::setprecision(12)
+                        << "\n    calculated: " << calculated
+                        << "\n    expected:   " << expected
+                        << "\n    tolerance:  " << tolerance);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testIncrementalBootstrap) {
+    BOOST_TEST_MESSAGE(
+        "Testing incremental re-bootstrap after a quote change...");
+
+    CommonVars vars;
+
+    typedef PiecewiseYieldCurve<Discount, LogLinear> Curve;
+    for (bool moving : {false, true}) {
+        auto makeCurve = [&]() {
+            return moving
+                ? ext::make_shared<Curve>(vars.settlementDays, vars.calendar,
+                                          vars.instruments, Actual360())
+                : ext::make_shared<Curve>(vars.settlement,
+                                          vars.instruments, Actual360());
+        };
+
+        const ext::shared_ptr<Curve> curve = makeCurve();
+        curve->discount(1.0);
+
+        const IterativeBootstrap<Curve>& bootstrap = curve->bootstrap();
+        BOOST_CHECK_EQUAL(bootstrap.skippedSolves(), Size(0));
+
+        const Size bumped = vars.deposits + vars.swaps/2;
+        const Real tolerance = 1.0e-10;
+        // bump the quote and then restore it
+        for (Real bump : {1.0e-4, -1.0e-4}) {
+            const Size skippedBefore = bootstrap.skippedSolves();
+            vars.rates[bumped]->setValue(vars.rates[bumped]->value() + bump);
+            const std::vector<Real> data = curve->data();
+
+            // the pillars before the bumped one are not solved again
+            const Size skipped = bootstrap.skippedSolves() - skippedBefore;
+            if (skipped != bumped) {
+                BOOST_ERROR("unexpected number of skipped pillar solves"
+                            << "\n    moving:   " << moving
+                            << "\n    skipped:  " << skipped
+                            << "\n    expected: " << bumped);
+            }
+
+            const std::vector<Real> expected = makeCurve()->data();
+            for (Size i=0; i<data.size(); ++i) {
+                if (std::fabs(data[i] - expected[i]) > tolerance) {
+                    BOOST_ERROR("incremental bootstrap differs from a full one"
+                                << "\n    moving:      " << moving
+                                << "\n    node:        " << i
+                                << std::setprecision(12)
+                                << "\n    incremental: " << data[i]
+                                << "\n    full:        " << expected[i]
+                                << "\n    tolerance:   " << tolerance);
+                }
+            }
+        }
+
+        if (moving) {
+            // the pillars move with the evaluation date, so that all
+            // of them must be solved again
+            const Date today = Settings::instance().evaluationDate();
+            Settings::instance().evaluationDate() = vars.calendar.advance(today, 1, Days);
+            const Size skippedBefore = bootstrap.skippedSolves();
+            const std::vector<Real> data = curve->data();
+            if (bootstrap.skippedSolves() != skippedBefore)
+                BOOST_ERROR("pillar solves skipped after a change "
+                            "of evaluation date");
+
+            const std::vector<Real> expected = makeCurve()->data();
+            for (Size i=0; i<data.size(); ++i) {
+                if (std::fabs(data[i] - expected[i]) > tolerance) {
+                    BOOST_ERROR("bootstrap after a change of evaluation date "
+                                "differs from a full one"
+                                << "\n    node:        " << i
+                                << std::setprecision(12)
+                                << "\n    incremental: " << data[i]
+                                << "\n    full:        " << expected[i]
+                                << "\n    tolerance:   " << tolerance);
+                }
+            }
+            Settings::instance().evaluationDate() = today;
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testAdjointPillarSensitivities) {
+    BOOST_TEST_MESSAGE(
+        "Testing adjoint sensitivities to the quotes of a bootstrapped curve...");
+
+    CommonVars vars;
+    testPillarSensitivities<Discount,LogLinear>(vars);
+    testPillarSensitivities<ZeroYield,Linear>(vars);
+}
+
+BOOST_AUTO_TEST_CASE(testAdjointFraAndOisPillarSensitivities) {
+    BOOST_TEST_MESSAGE(
+        "Testing adjoint sensitivities to FRA and OIS quotes...");
+
+    CommonVars vars;
+    testFraAndOisPillarSensitivities<OISRateHelper>(vars);
+    testFraAndOisPillarSensitivities<NumericalOISRateHelper>(vars);
+}
+
 BOOST_AUTO_TEST_CASE(testParFraRegression) {
     BOOST_TEST_MESSAGE("Testing regression for at-par FRA...");
 
@@ -40,6 +40,8 @@
 
 #include <ql/types.hpp>
 #include <ql/version.hpp>
+#include <ql/math/array.hpp>
+#include <ql/quotes/simplequote.hpp>
 
 #ifdef QL_ENABLE_PARALLEL_UNIT_TEST_RUNNER
 #include <boost/process.hpp>
@@ -431,6 +433,217 @@ namespace {
         };
 
 
+    /**
+     * Throughput of the vectorized Array kernels.  Each kernel is run on
+     * arrays of increasing size (from L1-resident to memory-bound) for
+     * roughly the same number of floating-point operations; the result
+     * is reported in GFLOP/s.
+     */
+    struct ArrayKernelBenchmark
+    {
+        template <class F>
+        static double gflops(F&& kernel, QuantLib::Size flopsPerCall) {
+            const QuantLib::Size calls =
+                std::max<QuantLib::Size>(1, QuantLib::Size(400000000) / flopsPerCall);
+            auto startTime = std::chrono::steady_clock::now();
+            for (QuantLib::Size i=0; i<calls; ++i)
+                kernel();
+            auto stopTime = std::chrono::steady_clock::now();
+            const double seconds =
+                std::chrono::duration<double>(stopTime - startTime).count();
+            return double(calls) * double(flopsPerCall) / seconds * 1e-9;
+        }
+
+        static void run()
+        {
+            using namespace QuantLib;
+
+            std::cout << std::endl;
+            std::cout << std::string(84,'-') << "\n";
+            std::cout << "Array kernels, "
+                      << detail::arrayKernelsInstructionSet()
+                      << " instruction set, GFLOP/s\n";
+            std::cout << std::string(84,'-') << "\n";
+
+            const std::vector<Size> sizes = { 1000, 100000, 10000000 };
+
+            std::cout << std::setw(20) << std::left << "kernel";
+            for (Size n : sizes)
+                std::cout << std::setw(16) << std::right << ("n=" + std::to_string(n));
+            std::cout << "\n";
+
+            const std::vector<std::string> names = {
+                "DotProduct", "Norm2", "operator+=", "operator-=",
+                "operator*=", "operator/=", "operator*= (scalar)",
+                "VectorizedDotProduct", "VectorizedNorm2" };
+
+            std::vector<std::vector<double> > results(names.size());
+            volatile Real sink = 0.0;
+            for (Size n : sizes) {
+                // values close to 1 keep repeated products and
+                // quotients away from overflow and denormals
+                Array x(n, 1.0, 1e-12), y(n, 1.0, -1e-12);
+
+                results[0].push_back(gflops([&] { sink = DotProduct(x, y); }, 2*n));
+                results[1].push_back(gflops([&] { sink = Norm2(x); }, 2*n));
+                results[2].push_back(gflops([&] { x += y; }, n));
+                results[3].push_back(gflops([&] { x -= y; }, n));
+                results[4].push_back(gflops([&] { x *= y; }, n));
+                results[5].push_back(gflops([&] { x /= y; }, n));
+                results[6].push_back(gflops([&] { x *= 1.0000001; }, n));
+                results[7].push_back(gflops([&] {
+                    sink = VectorizedDotProduct(x, y); }, 2*n));
+                results[8].push_back(gflops([&] {
+                    sink = VectorizedNorm2(x); }, 2*n));
+                sink = sink + x[0];
+            }
+
+            for (Size k=0; k<names.size(); ++k) {
+                std::cout << std::setw(20) << std::left << names[k];
+                for (double r : results[k])
+                    std::cout << std::setw(16) << std::right
+                              << std::fixed << std::setprecision(2) << r;
+                std::cout << "\n";
+            }
+            std::cout << std::string(84,'-') << std::endl;
+        }
+    };
+
+
+#ifdef QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN
+    /*
+     * Throughput of the thread-safe observer pattern.  Each thread
+     * bumps its own quote, observed by a few observers of its own, so
+     * that the only contention is on the global observable settings;
+     * the result is reported in millions of notifications per second
+     * for an increasing number of threads, with updates enabled and
+     * with updates deferred.  The throughput of registrations is
+     * measured likewise, with each thread registering and then
+     * unregistering a few thousand observers with either a quote of
+     * its own or a quote shared by all threads.
+     */
+    struct ObserverBenchmark
+    {
+        class Counter : public QuantLib::Observer {
+          public:
+            void update() override { ++updates; }
+            QuantLib::Size updates = 0;
+        };
+
+        static double throughput(unsigned int nThreads, bool deferred) {
+            using namespace QuantLib;
+
+            const Size notifications = 20000, observersPerQuote = 4;
+
+            if (deferred)
+                ObservableSettings::instance().disableUpdates(true);
+
+            std::vector<std::thread> threads;
+            auto startTime = std::chrono::steady_clock::now();
+            for (unsigned int i=0; i<nThreads; ++i) {
+                threads.emplace_back([=]() {
+                    auto quote = ext::make_shared<SimpleQuote>(0.0);
+                    std::vector<ext::shared_ptr<Counter> > counters;
+                    for (Size j=0; j<observersPerQuote; ++j) {
+                        counters.push_back(ext::make_shared<Counter>());
+                        counters.back()->registerWith(quote);
+                    }
+                    for (Size j=0; j<notifications; ++j)
+                        quote->setValue(Real(j));
+                });
+            }
+            for (auto& thread : threads)
+                thread.join();
+            auto stopTime = std::chrono::steady_clock::now();
+
+            // the deferred notifications are flushed outside the timing
+            if (deferred)
+                ObservableSettings::instance().enableUpdates();
+
+            const double seconds =
+                std::chrono::duration<double>(stopTime - startTime).count();
+            return double(nThreads) * double(notifications) / seconds * 1e-6;
+        }
+
+        static double registrations(unsigned int nThreads, bool shared) {
+            using namespace QuantLib;
+
+            const Size observersPerThread = 5000;
+
+            const auto sharedQuote = ext::make_shared<SimpleQuote>(0.0);
+            std::vector<std::vector<ext::shared_ptr<Counter> > > counters(nThreads);
+            for (auto& c : counters) {
+                for (Size j=0; j<observersPerThread; ++j)
+                    c.push_back(ext::make_shared<Counter>());
+            }
+
+            std::vector<std::thread> threads;
+            auto startTime = std::chrono::steady_clock::now();
+            for (unsigned int i=0; i<nThreads; ++i) {
+                threads.emplace_back([&, i]() {
+                    const ext::shared_ptr<Quote> quote = shared ?
+                        sharedQuote : ext::make_shared<SimpleQuote>(0.0);
+                    for (const auto& counter : counters[i])
+                        counter->registerWith(quote);
+                    for (const auto& counter : counters[i])
+                        counter->unregisterWith(quote);
+                });
+            }
+            for (auto& thread : threads)
+                thread.join();
+            auto stopTime = std::chrono::steady_clock::now();
+
+            const double seconds =
+                std::chrono::duration<double>(stopTime - startTime).count();
+            return double(nThreads) * double(observersPerThread) / seconds * 1e-6;
+        }
+
+        static void run()
+        {
+            std::cout << std::endl;
+            std::cout << std::string(84,'-') << "\n";
+            std::cout << "Observer notifications, millions per second\n";
+            std::cout << std::string(84,'-') << "\n";
+
+            std::cout << std::setw(20) << std::left << "threads"
+                      << std::setw(16) << std::right << "enabled"
+                      << std::setw(16) << std::right << "deferred" << "\n";
+
+            for (unsigned int nThreads=1; nThreads<=64; nThreads*=2) {
+                const double enabled = throughput(nThreads, false);
+                const double deferred = throughput(nThreads, true);
+                std::cout << std::setw(20) << std::left << nThreads
+                          << std::setw(16) << std::right
+                          << std::fixed << std::setprecision(2) << enabled
+                          << std::setw(16) << std::right
+                          << std::fixed << std::setprecision(2) << deferred
+                          << "\n";
+            }
+            std::cout << std::string(84,'-') << "\n";
+
+            std::cout << "Observer registrations, millions per second\n";
+            std::cout << std::string(84,'-') << "\n";
+
+            std::cout << std::setw(20) << std::left << "threads"
+                      << std::setw(16) << std::right << "own quote"
+                      << std::setw(16) << std::right << "shared quote" << "\n";
+
+            for (unsigned int nThreads=1; nThreads<=64; nThreads*=2) {
+                const double own = registrations(nThreads, false);
+                const double shared = registrations(nThreads, true);
+                std::cout << std::setw(20) << std::left << nThreads
+                          << std::setw(16) << std::right
+                          << std::fixed << std::setprecision(2) << own
+                          << std::setw(16) << std::right
+                          << std::fixed << std::setprecision(2) << shared
+                          << "\n";
+            }
+            std::cout << std::string(84,'-') << std::endl;
+        }
+    };
+#endif
+
+
     // The messages sent from workers to master across boost IPC queues
     struct IPCResultMsg
     {
@@ -572,6 +785,13 @@ QL_BENCHMARK_DECLARE(RoundingTests, testFloor, 100000, 0.1);
 QL_BENCHMARK_DECLARE(RoundingTests, testDown, 100000, 0.1);
 QL_BENCHMARK_DECLARE(RoundingTests, testClosest, 100000, 0.1);
 
+// Patterns
+QL_BENCHMARK_DECLARE(ObservableTests, testManyObservers, 20, 0.5);
+QL_BENCHMARK_DECLARE(ObservableTests, testSwapPortfolio, 1, 2.0);
+#ifdef QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN
+QL_BENCHMARK_DECLARE(ObservableTests, testMultiThreadedRegistrationAndNotification, 1, 1.0);
+#endif
+
 
 
 
@@ -671,10 +891,28 @@ int main(int argc, char* argv[] )  // NOLINT(bugprone-exception-escape)
                 << "\n"
                 << "--verbose=<0|1|2|3>\t controls verbosity of output, default value is verbose=" << BenchmarkSupport::verbose << "\n"
                 << "\n"
+                << "--kernels          \t report the throughput of the vectorized Array\n"
+                << "                   \t kernels in GFLOP/s and exit\n"
+                << "\n"
+#ifdef QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN
+                << "--observers        \t report the throughput of observer notifications\n"
+                << "                   \t and registrations on 1 to 64 threads and exit\n"
+                << "\n"
+#endif
                 << "-?, --help         \t display this help and exit"
                 << std::endl;
             return 0;
         }
+        else if (arg == "--kernels") {
+            ArrayKernelBenchmark::run();
+            return 0;
+        }
+#ifdef QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN
+        else if (arg == "--observers") {
+            ObserverBenchmark::run();
+            return 0;
+        }
+#endif
         else if (arg == clientModeStr)  {
             clientMode = true;
         }
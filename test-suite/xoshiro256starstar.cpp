@@ -227,6 +227,38 @@ BOOST_AUTO_TEST_CASE(testAgainstReferenceImplementationInC) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testJumpAgainstReferenceImplementationInC) {
+    BOOST_TEST_MESSAGE(
+        "Testing Xoshiro256StarStarUniformRng::jump() against reference implementation in C...");
+
+    static const auto s0 = 6043068446171522962ULL;
+    static const auto s1 = 18274946675476036270ULL;
+    static const auto s2 = 16504445955133574805ULL;
+    static const auto s3 = 96311065249897859ULL;
+
+    s[0] = s0;
+    s[1] = s1;
+    s[2] = s2;
+    s[3] = s3;
+
+    Xoshiro256StarStarUniformRng rng(s0, s1, s2, s3);
+    for (auto j = 0; j < 3; j++) {
+        jump();
+        rng.jump();
+        for (auto i = 0; i < 100; i++) {
+            auto nextRefImpl = next();
+            auto nextFromRng = rng.nextInt64();
+            if (nextRefImpl != nextFromRng) {
+                BOOST_FAIL("Test failed at index "
+                           << i << " after " << j + 1 << " jumps"
+                           << " (expected from reference implementation: " << nextRefImpl
+                           << "ULL, from Xoshiro256StarStarUniformRng: " << nextFromRng
+                           << "ULL)");
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testAbsenceOfInteractionBetweenInstances) {
     BOOST_TEST_MESSAGE(
         "Testing Xoshiro256StarStarUniformRng for absence of interaction between instances...");